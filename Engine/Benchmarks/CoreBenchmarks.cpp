@@ -0,0 +1,59 @@
+#include "MicroBenchmark.h"
+
+#include "Core/Delegate.h"
+#include "Utils/Profiler.h"
+
+namespace Utils
+{
+    struct SDelegateListener
+    {
+        void OnEvent(uint32_t Value)
+        {
+            Sum += Value;
+        }
+
+        uint64_t Sum = 0;
+    };
+}
+
+REGISTER_MICRO_BENCHMARK(DelegateBroadcast)
+{
+    constexpr uint32_t ListenerCount = 8;
+
+    std::vector<Utils::SDelegateListener> Listeners(ListenerCount);
+
+    PDelegate<uint32_t> Delegate;
+    for (Utils::SDelegateListener& Listener : Listeners)
+    {
+        Delegate.Bind(&Listener, &Utils::SDelegateListener::OnEvent);
+    }
+
+    State.SetItemsPerIteration(ListenerCount);
+    State.Measure([&]()
+    {
+        Delegate.Broadcast(1);
+    });
+
+    DoNotOptimize(Listeners[0].Sum);
+}
+
+REGISTER_MICRO_BENCHMARK(ProfilerEventBlock)
+{
+    static constexpr SProfilerSourceLocation Location { "MicroBenchmark", __FILE__, __LINE__ };
+
+    // Two events per iteration. The ring is drained regularly, otherwise most events would take the cheaper dropped path.
+    uint64_t Iteration = 0;
+    State.SetItemsPerIteration(2);
+    State.Measure([&]()
+    {
+        PProfiler::StartEventBlock(&Location);
+        PProfiler::EndEventBlock(&Location);
+
+        if ((++Iteration & 0x3FFF) == 0)
+        {
+            PProfiler::Reset();
+        }
+    });
+
+    PProfiler::Reset();
+}
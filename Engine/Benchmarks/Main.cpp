@@ -0,0 +1,87 @@
+#include <fstream>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+#include "MicroBenchmark.h"
+#include "Core/CommandLine.h"
+#include "Core/Logger.h"
+#include "Utils/Statistics.h"
+
+// Runs every registered micro-benchmark (or those whose name contains --filter <Text>) and writes the per-call
+// timings in nanoseconds to --output <Path>. --warmup <Batches> and --batches <Batches> control the sampling.
+// Returns non-zero if any benchmark failed.
+int main(int argc, char** argv)
+{
+    PCommandLine::Init(argc, argv);
+    PLogger::Init();
+
+    SMicroBenchmarkSettings Settings;
+    Settings.WarmupBatchCount = PCommandLine::GetUInt32Value("--warmup", Settings.WarmupBatchCount);
+    Settings.BatchCount = PCommandLine::GetUInt32Value("--batches", Settings.BatchCount);
+
+    const std::string Filter = PCommandLine::GetValue("--filter").value_or("");
+    const std::string OutputPath = PCommandLine::GetValue("--output").value_or("microbenchmarks.json");
+
+    rapidjson::StringBuffer Buffer;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> Writer(Buffer);
+
+    Writer.StartObject();
+    Writer.Key("WarmupBatches"); Writer.Uint(Settings.WarmupBatchCount);
+    Writer.Key("Batches"); Writer.Uint(Settings.BatchCount);
+    Writer.Key("Benchmarks");
+    Writer.StartObject();
+
+    uint32_t FailedCount = 0;
+    for (const SMicroBenchmark& Benchmark : SMicroBenchmarkStaticRegistry::GetStaticRegistry().GetBenchmarks())
+    {
+        if (!Filter.empty() && std::string(Benchmark.Name).find(Filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        PMicroBenchmarkState State(Settings);
+        Benchmark.Func(State);
+
+        if (State.HasFailed())
+        {
+            RK_LOG_ERROR("{:<32} failed: {}", Benchmark.Name, State.GetFailure());
+            FailedCount++;
+
+            Writer.Key(Benchmark.Name);
+            Writer.StartObject();
+            Writer.Key("Failure"); Writer.String(State.GetFailure().c_str());
+            Writer.EndObject();
+            continue;
+        }
+
+        const SSampleStatistics Summary = Statistics::Summarize(State.GetSamples());
+        RK_LOG_INFO("{:<32} {:>12.2f} ns  (p95 {:.2f} ns, stddev {:.2f} ns, {} iterations/batch)", Benchmark.Name, Summary.P50, Summary.P95, Summary.StandardDeviation, State.GetIterationsPerBatch());
+
+        Writer.Key(Benchmark.Name);
+        Writer.StartObject();
+        Writer.Key("IterationsPerBatch"); Writer.Uint64(State.GetIterationsPerBatch());
+        if (State.GetItemsPerIteration() > 0)
+        {
+            Writer.Key("ItemsPerIteration"); Writer.Uint64(State.GetItemsPerIteration());
+        }
+        Writer.Key("Nanoseconds"); Statistics::WriteJSON(Writer, State.GetSamples());
+        Writer.EndObject();
+    }
+
+    Writer.EndObject();
+    Writer.EndObject();
+
+    std::ofstream File(OutputPath);
+    File << Buffer.GetString();
+    File.close();
+
+    RK_LOG_INFO("Micro-benchmark results written to {}", OutputPath);
+
+    if (FailedCount > 0)
+    {
+        RK_LOG_ERROR("{} micro-benchmark(s) failed", FailedCount);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,398 @@
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+
+#include "MicroBenchmark.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <iterator>
+#include <string>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Math/BVH.h"
+#include "Math/FrustumCull.h"
+#include "Math/MeshSimplify.h"
+#include "Math/OcclusionBuffer.h"
+#include "Math/SIMD.h"
+#include "Math/Transform.h"
+#include "Math/TransformBatch.h"
+#include "Utils/Random.h"
+
+namespace Utils
+{
+    static STransform CreateRandomTransform()
+    {
+        STransform Transform;
+        Transform.Translation = glm::vec3(SRandom::GetFloatValue(-100.0f, 100.0f), SRandom::GetFloatValue(-100.0f, 100.0f), SRandom::GetFloatValue(-100.0f, 100.0f));
+        Transform.Rotation = glm::vec3(SRandom::GetFloatValue(-3.0f, 3.0f), SRandom::GetFloatValue(-3.0f, 3.0f), SRandom::GetFloatValue(-3.0f, 3.0f));
+        Transform.Scale = glm::vec3(SRandom::GetFloatValue(0.5f, 2.0f));
+        return Transform;
+    }
+
+    static SAABB CreateRandomBox()
+    {
+        const glm::vec3 Center(SRandom::GetFloatValue(-1000.0f, 1000.0f), SRandom::GetFloatValue(-1000.0f, 1000.0f), SRandom::GetFloatValue(-1000.0f, 1000.0f));
+        const glm::vec3 Extent(SRandom::GetFloatValue(0.5f, 2.0f));
+        return SAABB(Center - Extent, Center + Extent);
+    }
+
+    // Kernels the CPU can run, the scalar reference first
+    template<typename TKernel>
+    static std::vector<TKernel> GetSupportedKernels()
+    {
+        std::vector<TKernel> Kernels = { TKernel::Scalar };
+#if RK_SIMD_X86
+        Kernels.push_back(TKernel::SSE);
+        if (SIMD::HasAVX2())
+        {
+            Kernels.push_back(TKernel::AVX2);
+        }
+#endif
+        return Kernels;
+    }
+
+    // Relative to the larger of 1 and the expected value, so large translations tolerate proportionally more rounding.
+    static bool IsNearlyEqual(const glm::mat4& Value, const glm::mat4& Expected, float Tolerance)
+    {
+        for (int Column = 0; Column < 4; ++Column)
+        {
+            for (int Row = 0; Row < 4; ++Row)
+            {
+                if (std::abs(Value[Column][Row] - Expected[Column][Row]) > Tolerance * std::max(1.0f, std::abs(Expected[Column][Row])))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Smallest Distance + min(BoxRadius, Radius) over the frustum planes as FrustumCull evaluates it, negative if the
+    // element is culled.
+    static float GetCullMargin(const SFrustum& Frustum, const SBoundsStreams& Streams, size_t Index)
+    {
+        float Margin = FLT_MAX;
+        for (const glm::vec4& Plane : Frustum.Planes)
+        {
+            const float Distance = Plane.x * Streams.CenterX[Index] + Plane.y * Streams.CenterY[Index] + Plane.z * Streams.CenterZ[Index] + Plane.w;
+            const float BoxRadius = std::abs(Plane.x) * Streams.ExtentX[Index] + std::abs(Plane.y) * Streams.ExtentY[Index] + std::abs(Plane.z) * Streams.ExtentZ[Index];
+            Margin = std::min(Margin, Distance + std::min(BoxRadius, Streams.Radius[Index]));
+        }
+        return Margin;
+    }
+
+    static void FillBVH(PBVH& BVH, size_t ProxyCount)
+    {
+        SRandom::SetSeed(1);
+        for (size_t Index = 0; Index < ProxyCount; ++Index)
+        {
+            BVH.CreateProxy(CreateRandomBox(), static_cast<uint32_t>(Index));
+        }
+        BVH.Update();
+    }
+
+    // Culls 100k random boxes per iteration against a frustum that sees roughly a tenth of them.
+    static void MeasureFrustumCull(PMicroBenchmarkState& State, EFrustumCullKernel Kernel)
+    {
+        constexpr size_t ElementCount = 100000;
+
+        SRandom::SetSeed(1);
+
+        SBoundsStreams Streams;
+        Streams.Resize(ElementCount);
+        for (size_t Index = 0; Index < ElementCount; ++Index)
+        {
+            const SAABB Box = CreateRandomBox();
+            SBoundingSphere Sphere;
+            Sphere.Center = Box.GetCenter();
+            Sphere.Radius = glm::length(Box.GetExtent());
+            Streams.Set(Index, Box, Sphere);
+        }
+
+        const glm::mat4 View = glm::lookAt(glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        const SFrustum Frustum = SFrustum::FromMatrix(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 2000.0f) * View);
+
+        std::vector<uint32_t> VisibleIndices(ElementCount);
+
+        // Every SIMD kernel must find the scalar visible set. The kernels sum the plane distance in a different order,
+        // so they may only disagree on elements that touch a plane within rounding.
+        std::vector<uint32_t> Expected(ElementCount);
+        Expected.resize(FrustumCull::Cull(Frustum, Streams, 0, ElementCount, Expected.data(), EFrustumCullKernel::Scalar));
+        for (EFrustumCullKernel VerifiedKernel : GetSupportedKernels<EFrustumCullKernel>())
+        {
+            const size_t VisibleCount = FrustumCull::Cull(Frustum, Streams, 0, ElementCount, VisibleIndices.data(), VerifiedKernel);
+
+            std::vector<uint32_t> Mismatches;
+            std::set_symmetric_difference(Expected.begin(), Expected.end(), VisibleIndices.begin(), VisibleIndices.begin() + VisibleCount, std::back_inserter(Mismatches));
+            for (uint32_t Index : Mismatches)
+            {
+                if (std::abs(GetCullMargin(Frustum, Streams, Index)) > 1e-2f)
+                {
+                    State.Fail(std::string(FrustumCull::GetKernelName(VerifiedKernel)) + " kernel disagrees with Scalar on element " + std::to_string(Index));
+                    return;
+                }
+            }
+        }
+
+        State.SetItemsPerIteration(ElementCount);
+        State.Measure([&]()
+        {
+            DoNotOptimize(FrustumCull::Cull(Frustum, Streams, 0, ElementCount, VisibleIndices.data(), Kernel));
+        });
+    }
+
+    // Rasterizes 1000 random boxes (12k triangles) in front of the camera into a buffer of the occlusion culler's size.
+    static void MeasureOcclusionRaster(PMicroBenchmarkState& State, EOcclusionRasterKernel Kernel)
+    {
+        constexpr size_t OccluderCount = 1000;
+
+        SRandom::SetSeed(1);
+
+        const std::vector<glm::vec3> Positions = { { -1.0f, -1.0f, -1.0f }, { 1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, -1.0f }, { -1.0f, 1.0f, -1.0f },
+                                                   { -1.0f, -1.0f, 1.0f }, { 1.0f, -1.0f, 1.0f }, { 1.0f, 1.0f, 1.0f }, { -1.0f, 1.0f, 1.0f } };
+        const std::vector<uint32_t> Indices = { 0, 1, 2, 0, 2, 3, 4, 6, 5, 4, 7, 6, 0, 4, 5, 0, 5, 1, 3, 2, 6, 3, 6, 7, 0, 3, 7, 0, 7, 4, 1, 5, 6, 1, 6, 2 };
+
+        const glm::mat4 View = glm::lookAt(glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        const glm::mat4 ViewProjection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 2000.0f) * View;
+
+        std::vector<glm::mat4> ClipMatrices(OccluderCount);
+        for (glm::mat4& ClipMatrix : ClipMatrices)
+        {
+            const glm::vec3 Center(SRandom::GetFloatValue(20.0f, 200.0f), SRandom::GetFloatValue(-50.0f, 50.0f), SRandom::GetFloatValue(-80.0f, 80.0f));
+            ClipMatrix = ViewProjection * glm::scale(glm::translate(glm::mat4(1.0f), Center), glm::vec3(SRandom::GetFloatValue(1.0f, 5.0f)));
+        }
+
+        POcclusionBuffer Buffer;
+        Buffer.Resize(256, 144);
+
+        const auto Rasterize = [&](EOcclusionRasterKernel RasterKernel)
+        {
+            Buffer.Clear();
+            for (const glm::mat4& ClipMatrix : ClipMatrices)
+            {
+                Buffer.AddOccluder(ClipMatrix, Positions.data(), Positions.size(), Indices.data(), Indices.size());
+            }
+            for (uint32_t Band = 0; Band < Buffer.GetBandCount(); ++Band)
+            {
+                Buffer.RasterizeBand(Band, RasterKernel);
+            }
+        };
+
+        // Every SIMD kernel must produce the scalar depths. They sum in the same order, but a build that contracts
+        // multiply-adds into FMA may round differently, so depths are compared within a tolerance and a handful of
+        // pixels whose center lies on an edge may change coverage.
+        Rasterize(EOcclusionRasterKernel::Scalar);
+        const std::vector<float> Expected = Buffer.GetDepth();
+        for (EOcclusionRasterKernel VerifiedKernel : GetSupportedKernels<EOcclusionRasterKernel>())
+        {
+            Rasterize(VerifiedKernel);
+
+            size_t MismatchCount = 0;
+            for (size_t Pixel = 0; Pixel < Expected.size(); ++Pixel)
+            {
+                MismatchCount += std::abs(Buffer.GetDepth()[Pixel] - Expected[Pixel]) > 1e-5f;
+            }
+
+            if (MismatchCount > Expected.size() / 1000)
+            {
+                State.Fail(std::string(OcclusionRaster::GetKernelName(VerifiedKernel)) + " kernel differs from Scalar at " + std::to_string(MismatchCount) + " pixels");
+                return;
+            }
+        }
+
+        State.SetItemsPerIteration(OccluderCount * Indices.size() / 3);
+        State.Measure([&]()
+        {
+            Rasterize(Kernel);
+            DoNotOptimize(Buffer.GetDepth()[0]);
+        });
+    }
+
+    // Converts every transform per iteration, the output is as large as a storage buffer holding them.
+    static void MeasureTransformBatch(PMicroBenchmarkState& State, size_t TransformCount, ETransformBatchKernel Kernel)
+    {
+        SRandom::SetSeed(1);
+
+        STransformStreams Streams;
+        Streams.Resize(TransformCount);
+        for (size_t Index = 0; Index < TransformCount; ++Index)
+        {
+            Streams.Set(Index, CreateRandomTransform());
+        }
+
+        std::vector<STransformMatrices> Matrices(TransformCount);
+
+        // Every SIMD kernel must match the scalar one up to rounding, the normal matrix of the SIMD kernels multiplies
+        // by the reciprocal of the scale instead of dividing.
+        std::vector<STransformMatrices> Expected(TransformCount);
+        TransformBatch::ComputeMatrices(Streams, 0, TransformCount, Expected.data(), ETransformBatchKernel::Scalar);
+        for (ETransformBatchKernel VerifiedKernel : GetSupportedKernels<ETransformBatchKernel>())
+        {
+            TransformBatch::ComputeMatrices(Streams, 0, TransformCount, Matrices.data(), VerifiedKernel);
+            for (size_t Index = 0; Index < TransformCount; ++Index)
+            {
+                if (!IsNearlyEqual(Matrices[Index].ModelMatrix, Expected[Index].ModelMatrix, 1e-5f) || !IsNearlyEqual(Matrices[Index].NormalMatrix, Expected[Index].NormalMatrix, 1e-5f))
+                {
+                    State.Fail(std::string(TransformBatch::GetKernelName(VerifiedKernel)) + " kernel differs from Scalar at transform " + std::to_string(Index));
+                    return;
+                }
+            }
+        }
+
+        State.SetItemsPerIteration(TransformCount);
+        State.Measure([&]()
+        {
+            TransformBatch::ComputeMatrices(Streams, 0, TransformCount, Matrices.data(), Kernel);
+            DoNotOptimize(Matrices.back());
+        });
+    }
+}
+
+REGISTER_MICRO_BENCHMARK(TransformToMatrix)
+{
+    constexpr size_t TransformCount = 1024;
+
+    SRandom::SetSeed(1);
+
+    std::vector<STransform> Transforms(TransformCount);
+    for (STransform& Transform : Transforms)
+    {
+        Transform = Utils::CreateRandomTransform();
+    }
+
+    size_t Index = 0;
+    State.Measure([&]()
+    {
+        DoNotOptimize(Transforms[Index++ % TransformCount].ToMatrix());
+    });
+}
+
+REGISTER_MICRO_BENCHMARK(TransformBatchScalar100k)
+{
+    Utils::MeasureTransformBatch(State, 100000, ETransformBatchKernel::Scalar);
+}
+
+REGISTER_MICRO_BENCHMARK(TransformBatchSIMD100k)
+{
+    Utils::MeasureTransformBatch(State, 100000, TransformBatch::GetBestKernel());
+}
+
+REGISTER_MICRO_BENCHMARK(TransformBatchScalar1M)
+{
+    Utils::MeasureTransformBatch(State, 1000000, ETransformBatchKernel::Scalar);
+}
+
+REGISTER_MICRO_BENCHMARK(TransformBatchSIMD1M)
+{
+    Utils::MeasureTransformBatch(State, 1000000, TransformBatch::GetBestKernel());
+}
+
+REGISTER_MICRO_BENCHMARK(FrustumCullScalar100k)
+{
+    Utils::MeasureFrustumCull(State, EFrustumCullKernel::Scalar);
+}
+
+REGISTER_MICRO_BENCHMARK(FrustumCullSIMD100k)
+{
+    Utils::MeasureFrustumCull(State, FrustumCull::GetBestKernel());
+}
+
+REGISTER_MICRO_BENCHMARK(OcclusionRasterScalar12k)
+{
+    Utils::MeasureOcclusionRaster(State, EOcclusionRasterKernel::Scalar);
+}
+
+REGISTER_MICRO_BENCHMARK(OcclusionRasterSIMD12k)
+{
+    Utils::MeasureOcclusionRaster(State, OcclusionRaster::GetBestKernel());
+}
+
+REGISTER_MICRO_BENCHMARK(BVHRebuild100k)
+{
+    PBVH BVH;
+    Utils::FillBVH(BVH, 100000);
+
+    State.SetItemsPerIteration(BVH.GetProxyCount());
+    State.Measure([&]()
+    {
+        BVH.Rebuild();
+    });
+}
+
+// A tenth of the proxies move by a small step each iteration, as the dynamic share of a scene does every frame.
+REGISTER_MICRO_BENCHMARK(BVHRefit100k)
+{
+    constexpr uint32_t ProxyCount = 100000;
+    constexpr uint32_t MovedCount = ProxyCount / 10;
+
+    PBVH BVH;
+    Utils::FillBVH(BVH, ProxyCount);
+
+    const glm::vec3 Step(0.1f, 0.0f, 0.05f);
+    uint32_t FirstMoved = 0;
+
+    State.SetItemsPerIteration(MovedCount);
+    State.Measure([&]()
+    {
+        for (uint32_t Index = 0; Index < MovedCount; ++Index)
+        {
+            const uint32_t ProxyID = (FirstMoved + Index * 10) % ProxyCount;
+            const SAABB& Bounds = BVH.GetBounds(ProxyID);
+            BVH.MoveProxy(ProxyID, SAABB(Bounds.Min + Step, Bounds.Max + Step));
+        }
+        BVH.Update();
+        FirstMoved++;
+    });
+}
+
+REGISTER_MICRO_BENCHMARK(BVHFrustumQuery100k)
+{
+    PBVH BVH;
+    Utils::FillBVH(BVH, 100000);
+
+    const glm::mat4 View = glm::lookAt(glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const SFrustum Frustum = SFrustum::FromMatrix(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 500.0f) * View);
+
+    uint32_t VisibleCount = 0;
+    State.Measure([&]()
+    {
+        VisibleCount = 0;
+        BVH.QueryFrustum(Frustum, [&](uint32_t) { VisibleCount++; });
+        DoNotOptimize(VisibleCount);
+    });
+}
+
+// Halves a 128x128 quad grid (32k triangles) per iteration, as GLTF import does for a LOD level.
+REGISTER_MICRO_BENCHMARK(MeshSimplifyGrid32k)
+{
+    constexpr uint32_t GridSize = 129;
+
+    std::vector<glm::vec3> Positions;
+    for (uint32_t Y = 0; Y < GridSize; ++Y)
+    {
+        for (uint32_t X = 0; X < GridSize; ++X)
+        {
+            Positions.emplace_back(static_cast<float>(X), std::sin(X * 0.2f) * std::cos(Y * 0.2f), static_cast<float>(Y));
+        }
+    }
+
+    std::vector<uint32_t> Indices;
+    for (uint32_t Y = 0; Y + 1 < GridSize; ++Y)
+    {
+        for (uint32_t X = 0; X + 1 < GridSize; ++X)
+        {
+            const uint32_t Corner = Y * GridSize + X;
+            Indices.insert(Indices.end(), { Corner, Corner + GridSize, Corner + 1, Corner + 1, Corner + GridSize, Corner + GridSize + 1 });
+        }
+    }
+
+    std::vector<uint32_t> SimplifiedIndices;
+
+    State.SetItemsPerIteration(Indices.size() / 3);
+    State.Measure([&]()
+    {
+        DoNotOptimize(MeshSimplify::Simplify(Indices.data(), Indices.size(), Positions.data(), sizeof(glm::vec3), Indices.size() / 2, FLT_MAX, SimplifiedIndices));
+        DoNotOptimize(SimplifiedIndices.size());
+    });
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+struct SMicroBenchmarkSettings
+{
+    // Batches run before sampling starts (caches, branch predictors, allocator growth)
+    uint32_t WarmupBatchCount = 3;
+    uint32_t BatchCount = 20;
+
+    // Iterations per batch are doubled until a single batch takes at least this long
+    double MinBatchSeconds = 0.01;
+};
+
+// Keeps the compiler from discarding a value that is otherwise unused. Values that fit into a register are passed in
+// one, without a memory round-trip, larger ones are passed by address.
+template<typename T>
+inline void DoNotOptimize(const T& Value)
+{
+#if defined(_MSC_VER)
+    const volatile T* Sink = &Value;
+    (void)Sink;
+#else
+    if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(void*))
+    {
+        asm volatile("" : : "r"(Value) : "memory");
+    }
+    else
+    {
+        asm volatile("" : : "m"(Value) : "memory");
+    }
+#endif
+}
+
+// Handed to every micro-benchmark. Setup code runs before Measure and is not part of the sampled time.
+class PMicroBenchmarkState
+{
+public:
+    explicit PMicroBenchmarkState(const SMicroBenchmarkSettings& InSettings)
+        : Settings(InSettings)
+    {
+    }
+
+    // Calls Func repeatedly in batches and records nanoseconds per call for every sampled batch.
+    template<typename TFunc>
+    void Measure(TFunc&& Func);
+
+    // Optional, reported alongside the timings (e.g. bytes or entities processed per call).
+    void SetItemsPerIteration(uint64_t Items)
+    {
+        ItemsPerIteration = Items;
+    }
+
+    [[nodiscard]] const std::vector<double>& GetSamples() const
+    {
+        return Samples;
+    }
+
+    [[nodiscard]] uint64_t GetIterationsPerBatch() const
+    {
+        return IterationsPerBatch;
+    }
+
+    [[nodiscard]] uint64_t GetItemsPerIteration() const
+    {
+        return ItemsPerIteration;
+    }
+
+    // Marks the benchmark as failed, e.g. when setup finds that the code under test computes wrong results. Checked
+    // by the runner, unlike RK_ASSERT it is not compiled out of release builds.
+    void Fail(const std::string& Message)
+    {
+        Failure = Message;
+    }
+
+    [[nodiscard]] bool HasFailed() const
+    {
+        return !Failure.empty();
+    }
+
+    [[nodiscard]] const std::string& GetFailure() const
+    {
+        return Failure;
+    }
+
+private:
+    template<typename TFunc>
+    double RunBatch(TFunc& Func, uint64_t Iterations) const;
+
+    SMicroBenchmarkSettings Settings;
+
+    std::vector<double> Samples;
+    uint64_t IterationsPerBatch = 0;
+    uint64_t ItemsPerIteration = 0;
+    std::string Failure;
+};
+
+template<typename TFunc>
+double PMicroBenchmarkState::RunBatch(TFunc& Func, uint64_t Iterations) const
+{
+    const auto Start = std::chrono::steady_clock::now();
+    for (uint64_t Iteration = 0; Iteration < Iterations; ++Iteration)
+    {
+        Func();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+}
+
+template<typename TFunc>
+void PMicroBenchmarkState::Measure(TFunc&& Func)
+{
+    // Calibration doubles as the first part of the warm-up.
+    uint64_t Iterations = 1;
+    while (RunBatch(Func, Iterations) < Settings.MinBatchSeconds && Iterations < (1ull << 40))
+    {
+        Iterations *= 2;
+    }
+    IterationsPerBatch = Iterations;
+
+    for (uint32_t Batch = 0; Batch < Settings.WarmupBatchCount; ++Batch)
+    {
+        RunBatch(Func, Iterations);
+    }
+
+    Samples.clear();
+    Samples.reserve(Settings.BatchCount);
+    for (uint32_t Batch = 0; Batch < Settings.BatchCount; ++Batch)
+    {
+        Samples.push_back(RunBatch(Func, Iterations) * 1e9 / static_cast<double>(Iterations));
+    }
+}
+
+using FMicroBenchmarkFunc = void (*)(PMicroBenchmarkState&);
+
+struct SMicroBenchmark
+{
+    const char* Name;
+    FMicroBenchmarkFunc Func;
+};
+
+struct SMicroBenchmarkStaticRegistry
+{
+public:
+    static SMicroBenchmarkStaticRegistry& GetStaticRegistry()
+    {
+        static SMicroBenchmarkStaticRegistry StaticRegistry;
+        return StaticRegistry;
+    }
+
+    std::vector<SMicroBenchmark>& GetBenchmarks()
+    {
+        return Benchmarks;
+    }
+
+    void AddBenchmark(const char* Name, FMicroBenchmarkFunc Func)
+    {
+        Benchmarks.push_back({ Name, Func });
+    }
+
+private:
+    std::vector<SMicroBenchmark> Benchmarks;
+};
+
+#define REGISTER_MICRO_BENCHMARK(Name) \
+    static void Name(PMicroBenchmarkState& State); \
+    static struct Name##AutoRegister \
+    { \
+        Name##AutoRegister() \
+        { \
+            SMicroBenchmarkStaticRegistry::GetStaticRegistry().AddBenchmark(#Name, &Name); \
+        } \
+    } Name##AutoRegisterInstance; \
+    static void Name(PMicroBenchmarkState& State)
@@ -0,0 +1,75 @@
+#include "MicroBenchmark.h"
+
+#include "Scene/Component.h"
+#include "Scene/Registry.h"
+#include "Scene/Entity.h"
+
+REGISTER_MICRO_BENCHMARK(RegistryView)
+{
+    constexpr uint32_t EntityCount = 10000;
+
+    PRegistry Registry;
+    for (uint32_t Index = 0; Index < EntityCount; ++Index)
+    {
+        const SEntityID EntityID = Registry.CreateEntity().GetEntityID();
+
+        STransform Transform;
+        Transform.Translation = glm::vec3(static_cast<float>(Index));
+        Registry.AddComponent<STransformComponent>(EntityID, Transform);
+
+        // Every other entity is filtered out by the two-component view.
+        if (Index % 2 == 0)
+        {
+            Registry.AddComponent<STagComponent>(EntityID);
+        }
+    }
+
+    State.SetItemsPerIteration(EntityCount / 2);
+    State.Measure([&]()
+    {
+        glm::vec3 Sum(0.0f);
+        Registry.View<STransformComponent, STagComponent>([&](STransformComponent& TransformComponent, STagComponent&)
+        {
+            Sum += TransformComponent.Transform.Translation;
+        });
+        DoNotOptimize(Sum);
+    });
+}
+
+REGISTER_MICRO_BENCHMARK(TransformHierarchyUpdate)
+{
+    constexpr uint32_t RootCount = 100;
+    constexpr uint32_t ChildCount = 99;
+
+    // Roots with one level of children, one root moves per iteration and drags its subtree along.
+    PRegistry Registry;
+    std::vector<SEntityID> Roots;
+    for (uint32_t RootIndex = 0; RootIndex < RootCount; ++RootIndex)
+    {
+        const SEntityID RootID = Registry.CreateEntity().GetEntityID();
+        Registry.AddComponent<STransformComponent>(RootID);
+        Roots.push_back(RootID);
+
+        for (uint32_t ChildIndex = 0; ChildIndex < ChildCount; ++ChildIndex)
+        {
+            const SEntityID ChildID = Registry.CreateEntity().GetEntityID();
+
+            STransform Transform;
+            Transform.Translation = glm::vec3(static_cast<float>(ChildIndex), 0.0f, 0.0f);
+            Registry.AddComponent<STransformComponent>(ChildID, Transform);
+            Registry.SetParent(ChildID, RootID);
+        }
+    }
+    Registry.UpdateTransforms();
+
+    size_t Index = 0;
+    State.SetItemsPerIteration(ChildCount + 1);
+    State.Measure([&]()
+    {
+        const SEntityID RootID = Roots[Index++ % RootCount];
+        STransform Transform = Registry.GetComponent<STransformComponent>(RootID).Transform;
+        Transform.Rotation.y += 0.01f;
+        Registry.SetTransform(RootID, Transform);
+        Registry.UpdateTransforms();
+    });
+}
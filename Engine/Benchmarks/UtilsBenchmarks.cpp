@@ -0,0 +1,78 @@
+#include "MicroBenchmark.h"
+
+#include <filesystem>
+
+#include "Utils/FileSystem.h"
+#include "Utils/Hash.h"
+#include "Utils/Random.h"
+#include "Utils/Stats.h"
+
+REGISTER_MICRO_BENCHMARK(FNV1aHashString)
+{
+    const std::string String = "Renderer/Vulkan/VulkanSceneRenderer.SSBO";
+
+    State.SetItemsPerIteration(String.size());
+    State.Measure([&]()
+    {
+        DoNotOptimize(FNV1aHash(String));
+    });
+}
+
+REGISTER_MICRO_BENCHMARK(FNV1aHashUInt32)
+{
+    uint32_t Value = 0;
+    State.Measure([&]()
+    {
+        DoNotOptimize(FNV1aHash(Value++));
+    });
+}
+
+REGISTER_MICRO_BENCHMARK(StatsAdd)
+{
+    State.Measure([]()
+    {
+        PStats::Add(EStat::DrawCalls);
+    });
+}
+
+REGISTER_MICRO_BENCHMARK(RandomUInt32)
+{
+    SRandom::SetSeed(1);
+
+    State.Measure([]()
+    {
+        DoNotOptimize(SRandom::GetUInt32Value());
+    });
+}
+
+REGISTER_MICRO_BENCHMARK(RandomFloatRange)
+{
+    SRandom::SetSeed(1);
+
+    State.Measure([]()
+    {
+        DoNotOptimize(SRandom::GetFloatValue(-1.0f, 1.0f));
+    });
+}
+
+REGISTER_MICRO_BENCHMARK(FileSystemReadFileBinary)
+{
+    constexpr size_t FileSize = 1024 * 1024;
+
+    const std::filesystem::path Path = std::filesystem::temp_directory_path() / "RocketMicroBenchmark.bin";
+    {
+        std::vector<char> Data(FileSize, 'R');
+        std::ofstream File(Path, std::ios::binary);
+        File.write(Data.data(), static_cast<std::streamsize>(Data.size()));
+    }
+
+    // Served from the page cache after the first read, so this measures the engine side of the read path.
+    const std::string PathString = Path.string();
+    State.SetItemsPerIteration(FileSize);
+    State.Measure([&]()
+    {
+        DoNotOptimize(PFileSystem::ReadFileBinary(PathString).Data.size());
+    });
+
+    std::filesystem::remove(Path);
+}
@@ -0,0 +1,42 @@
+// Builds one level of the depth pyramid read by GPUCull.hlsl: every texel holds the farthest depth under its
+// footprint in the level above, the depth image for the first level.
+
+[[vk::binding(0, 0)]]
+Texture2D<float> Source;
+
+[[vk::binding(1, 0)]]
+RWTexture2D<float> Destination;
+
+struct PushConstant
+{
+    uint2 SourceSize;
+    uint2 DestinationSize;
+};
+
+[[vk::push_constant]]
+PushConstant pushConstant;
+
+[numthreads(8, 8, 1)]
+void main(uint3 DispatchThreadID : SV_DispatchThreadID)
+{
+    if (any(DispatchThreadID.xy >= pushConstant.DestinationSize))
+    {
+        return;
+    }
+
+    // Exactly 2x2 texels between levels, up to 3x3 for the first level, whose size is the depth image's rounded
+    // down to a power of two.
+    uint2 Begin = DispatchThreadID.xy * pushConstant.SourceSize / pushConstant.DestinationSize;
+    uint2 End = min(((DispatchThreadID.xy + 1) * pushConstant.SourceSize + pushConstant.DestinationSize - 1) / pushConstant.DestinationSize, pushConstant.SourceSize);
+
+    float Depth = 0.0;
+    for (uint Y = Begin.y; Y < End.y; ++Y)
+    {
+        for (uint X = Begin.x; X < End.x; ++X)
+        {
+            Depth = max(Depth, Source.Load(int3(X, Y, 0)));
+        }
+    }
+
+    Destination[DispatchThreadID.xy] = Depth;
+}
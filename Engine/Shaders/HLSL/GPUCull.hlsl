@@ -0,0 +1,230 @@
+// Culls every instance slot against the frustum and the depth pyramid, and compacts the survivors into one indirect
+// draw per mesh and phase (see PVulkanGPUCuller). Instances of a mesh occupy a fixed range of VisibleInstances, the
+// draw's instance count grows atomically and its firstInstance points at the range.
+
+struct SShaderStorageBufferObject
+{
+    float4x4 ModelMatrix;
+    float4x4 NormalMatrix;
+};
+
+// Must match SGPUCullMesh in VulkanGPUCuller.cpp
+struct SCullMesh
+{
+    float3 Center;
+    uint IndexCount;
+    float3 Extent;
+    uint InstanceBase;
+    uint InstanceCount;
+    uint3 Padding;
+};
+
+// VkDrawIndexedIndirectCommand
+struct SDrawCommand
+{
+    uint IndexCount;
+    uint InstanceCount;
+    uint FirstIndex;
+    int VertexOffset;
+    uint FirstInstance;
+};
+
+[[vk::binding(0, 0)]]
+StructuredBuffer<SShaderStorageBufferObject> Instances;
+
+[[vk::binding(1, 0)]]
+StructuredBuffer<uint> InstanceMeshes;
+
+[[vk::binding(2, 0)]]
+StructuredBuffer<SCullMesh> Meshes;
+
+[[vk::binding(3, 0)]]
+RWStructuredBuffer<SDrawCommand> DrawCommands;
+
+[[vk::binding(4, 0)]]
+RWStructuredBuffer<uint> VisibleInstances;
+
+// Set by the early pass for instances inside the frustum that the previous frame's pyramid rejected
+[[vk::binding(5, 0)]]
+RWStructuredBuffer<uint> LateCandidates;
+
+// Farthest depth of every texel's footprint, see DepthPyramid.hlsl
+[[vk::binding(6, 0)]]
+Texture2D<float> DepthPyramid;
+
+// Must match the passes in VulkanGPUCuller.cpp
+static const uint PassReset = 0;
+static const uint PassEarly = 1;
+static const uint PassLate = 2;
+
+static const uint InvalidMeshIndex = 0xFFFFFFFF;
+
+struct PushConstant
+{
+    float4x4 ViewProjection;
+    uint2 PyramidSize;
+    uint PyramidLevels;
+    uint SlotCount;
+    uint MeshCount;
+    uint Pass;
+    uint bOcclusion;
+
+    // Where the late pass's ranges begin in VisibleInstances, after those of the early pass
+    uint LateInstanceBase;
+};
+
+[[vk::push_constant]]
+PushConstant pushConstant;
+
+bool IsInsideFrustum(float3 Center, float3 Extent)
+{
+    // Gribb-Hartmann planes from the rows of the matrix, the sign test does not need them normalized.
+    float4x4 M = pushConstant.ViewProjection;
+    float4 Planes[6] = { M[3] + M[0], M[3] - M[0], M[3] + M[1], M[3] - M[1], M[2], M[3] - M[2] };
+
+    [unroll]
+    for (uint Index = 0; Index < 6; ++Index)
+    {
+        if (dot(Planes[Index].xyz, Center) + Planes[Index].w < -dot(abs(Planes[Index].xyz), Extent))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+float LoadPyramid(int2 Texel, uint Level)
+{
+    return DepthPyramid.Load(int3(Texel, Level));
+}
+
+bool IsOccluded(float3 Center, float3 Extent)
+{
+    float3 MinNDC = float3(1.0, 1.0, 1.0);
+    float3 MaxNDC = float3(-1.0, -1.0, 0.0);
+
+    [unroll]
+    for (uint Corner = 0; Corner < 8; ++Corner)
+    {
+        float3 Sign = float3((Corner & 1) ? 1.0 : -1.0, (Corner & 2) ? 1.0 : -1.0, (Corner & 4) ? 1.0 : -1.0);
+        float4 Clip = mul(pushConstant.ViewProjection, float4(Center + Sign * Extent, 1.0));
+
+        // Boxes reaching behind the camera are kept, their projection is unbounded.
+        if (Clip.w <= 1e-5)
+        {
+            return false;
+        }
+
+        float3 NDC = Clip.xyz / Clip.w;
+        MinNDC = min(MinNDC, NDC);
+        MaxNDC = max(MaxNDC, NDC);
+    }
+
+    float2 MinUV = saturate(MinNDC.xy * 0.5 + 0.5);
+    float2 MaxUV = saturate(MaxNDC.xy * 0.5 + 0.5);
+
+    // The level at which the rectangle is at most one texel wide, so it touches at most 2x2 texels.
+    float2 Size = (MaxUV - MinUV) * float2(pushConstant.PyramidSize);
+    uint Level = min((uint)ceil(log2(max(max(Size.x, Size.y), 1.0))), pushConstant.PyramidLevels - 1);
+
+    int2 LevelSize = int2(max(pushConstant.PyramidSize >> Level, uint2(1, 1)));
+    int2 MinTexel = min(int2(MinUV * float2(LevelSize)), LevelSize - 1);
+    int2 MaxTexel = min(int2(MaxUV * float2(LevelSize)), LevelSize - 1);
+
+    float Depth = max(max(LoadPyramid(MinTexel, Level), LoadPyramid(int2(MaxTexel.x, MinTexel.y), Level)),
+                      max(LoadPyramid(int2(MinTexel.x, MaxTexel.y), Level), LoadPyramid(MaxTexel, Level)));
+
+    // Depth is [0, 1] with less passing, the box is hidden if its nearest point is behind everything drawn there.
+    return MinNDC.z > Depth;
+}
+
+void Append(uint CommandIndex, SCullMesh Mesh, uint Slot)
+{
+    uint Offset;
+    InterlockedAdd(DrawCommands[CommandIndex].InstanceCount, 1, Offset);
+
+    // The range holds every instance of the mesh unless the CPU's instance counts fell behind the slots' mesh indices.
+    // Past it the increment is taken back, so the draw never reads the next mesh's slots. The count cannot drop below
+    // the range while overflowing increments are outstanding, so in range offsets stay unique.
+    if (Offset < Mesh.InstanceCount)
+    {
+        VisibleInstances[DrawCommands[CommandIndex].FirstInstance + Offset] = Slot;
+    }
+    else
+    {
+        InterlockedAdd(DrawCommands[CommandIndex].InstanceCount, 0xFFFFFFFF);
+    }
+}
+
+[numthreads(64, 1, 1)]
+void main(uint3 DispatchThreadID : SV_DispatchThreadID)
+{
+    uint Index = DispatchThreadID.x;
+
+    if (pushConstant.Pass == PassReset)
+    {
+        if (Index >= pushConstant.MeshCount * 2)
+        {
+            return;
+        }
+
+        bool bLate = Index >= pushConstant.MeshCount;
+        SCullMesh Mesh = Meshes[bLate ? Index - pushConstant.MeshCount : Index];
+
+        SDrawCommand Command;
+        Command.IndexCount = Mesh.IndexCount;
+        Command.InstanceCount = 0;
+        Command.FirstIndex = 0;
+        Command.VertexOffset = 0;
+        Command.FirstInstance = Mesh.InstanceBase + (bLate ? pushConstant.LateInstanceBase : 0);
+        DrawCommands[Index] = Command;
+        return;
+    }
+
+    if (Index >= pushConstant.SlotCount)
+    {
+        return;
+    }
+
+    if (pushConstant.Pass == PassLate && LateCandidates[Index] == 0)
+    {
+        return;
+    }
+
+    uint MeshIndex = InstanceMeshes[Index];
+    if (MeshIndex == InvalidMeshIndex)
+    {
+        LateCandidates[Index] = 0;
+        return;
+    }
+
+    SCullMesh Mesh = Meshes[MeshIndex];
+    float4x4 ModelMatrix = Instances[Index].ModelMatrix;
+
+    // Arvo: the world box around the transformed local box.
+    float3 Center = mul(ModelMatrix, float4(Mesh.Center, 1.0)).xyz;
+    float3 Extent = mul(abs((float3x3)ModelMatrix), Mesh.Extent);
+
+    if (pushConstant.Pass == PassEarly)
+    {
+        if (!IsInsideFrustum(Center, Extent))
+        {
+            LateCandidates[Index] = 0;
+            return;
+        }
+
+        // Rejected by last frame's depth, the late pass decides with this frame's.
+        bool bOccluded = pushConstant.bOcclusion != 0 && IsOccluded(Center, Extent);
+        LateCandidates[Index] = bOccluded ? 1 : 0;
+        if (!bOccluded)
+        {
+            Append(MeshIndex, Mesh, Index);
+        }
+        return;
+    }
+
+    if (!IsOccluded(Center, Extent))
+    {
+        Append(pushConstant.MeshCount + MeshIndex, Mesh, Index);
+    }
+}
@@ -0,0 +1,49 @@
+// Scatters the instances that changed since the last upload into the persistent instance buffer (see PVulkanSceneBuffer).
+
+struct SShaderStorageBufferObject
+{
+    float4x4 ModelMatrix;
+    float4x4 NormalMatrix;
+};
+
+// Must match SInstanceUpdate in VulkanSceneBuffer.h
+struct SInstanceUpdate
+{
+    uint Slot;
+    uint MeshIndex;
+    uint2 Padding;
+    float4x4 ModelMatrix;
+    float4x4 NormalMatrix;
+};
+
+[[vk::binding(0, 0)]]
+StructuredBuffer<SInstanceUpdate> Updates;
+
+[[vk::binding(1, 0)]]
+RWStructuredBuffer<SShaderStorageBufferObject> Instances;
+
+// Mesh of every slot, read by GPU culling (see PVulkanGPUCuller)
+[[vk::binding(2, 0)]]
+RWStructuredBuffer<uint> InstanceMeshes;
+
+struct PushConstant
+{
+    uint UpdateCount;
+};
+
+[[vk::push_constant]]
+PushConstant pushConstant;
+
+[numthreads(64, 1, 1)]
+void main(uint3 DispatchThreadID : SV_DispatchThreadID)
+{
+    if (DispatchThreadID.x >= pushConstant.UpdateCount)
+    {
+        return;
+    }
+
+    SInstanceUpdate Update = Updates[DispatchThreadID.x];
+    Instances[Update.Slot].ModelMatrix = Update.ModelMatrix;
+    Instances[Update.Slot].NormalMatrix = Update.NormalMatrix;
+    InstanceMeshes[Update.Slot] = Update.MeshIndex;
+}
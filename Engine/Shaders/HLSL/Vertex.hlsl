@@ -19,6 +19,9 @@ struct SShaderStorageBufferObject
 
 StructuredBuffer<SShaderStorageBufferObject> SSBO : register(t0, space0);
 
+// Slots of the instances that survived GPU culling, indirect draws start at their mesh's range with firstInstance
+StructuredBuffer<uint> VisibleInstances : register(t1, space0);
+
 // A cbuffer is fixed in size, and is NOT an array.
 cbuffer UBO : register(b0, space1) // Binding 1 in Vulkan
 {
@@ -32,15 +35,19 @@ struct PushConstant
 {
     uint64_t BufferDeviceAddress;
     uint ObjectID;
+    uint bVisibleInstances;
 };
 
 [[vk::push_constant]]
 PushConstant pushConstant;
 
-VS_OUTPUT main(uint vertexIndex : SV_VertexID) 
+VS_OUTPUT main(uint vertexIndex : SV_VertexID, uint instanceIndex : SV_InstanceID) 
 {
     VS_OUTPUT output;
 
+    // SV_InstanceID includes firstInstance when compiled to SPIR-V
+    uint objectID = pushConstant.bVisibleInstances != 0 ? VisibleInstances[instanceIndex] : pushConstant.ObjectID;
+
     // Size of a single vertex in the buffer
     uint vertexSize = 96;
     
@@ -55,16 +62,18 @@ VS_OUTPUT main(uint vertexIndex : SV_VertexID)
     float3 Tangent = vk::RawBufferLoad<float3>(pushConstant.BufferDeviceAddress + vertexOffset + 64);
     float3 Bitangent = vk::RawBufferLoad<float3>(pushConstant.BufferDeviceAddress + vertexOffset + 80);
 
-    float4 worldPosition = mul(SSBO[pushConstant.ObjectID].ModelMatrix, float4(pos, 1.0));
-    float3 worldNormal = normalize(mul(SSBO[pushConstant.ObjectID].NormalMatrix, normal));  // Transform transpose inverse normal to world space
+    float4 worldPosition = mul(SSBO[objectID].ModelMatrix, float4(pos, 1.0));
+    float3 worldNormal = normalize(mul(SSBO[objectID].NormalMatrix, normal));  // Transform transpose inverse normal to world space
     float4 viewPosition = mul(m_ViewMatrix, worldPosition);
     output.worldPosition = worldPosition;
-    output.Position = mul(m_ProjectionMatrix, viewPosition);
+    // The depth pre-pass runs this shader in another pipeline, precise keeps its depth bit-identical for the equal test
+    precise float4 clipPosition = mul(m_ProjectionMatrix, viewPosition);
+    output.Position = clipPosition;
     output.TexCoord = uv;
     output.Normal = worldNormal;
     output.Color = color.xyz;
-    output.Tangent = mul((float3x3)SSBO[pushConstant.ObjectID].ModelMatrix, Tangent);
-    output.Bitangent = mul((float3x3)SSBO[pushConstant.ObjectID].ModelMatrix, Bitangent);
+    output.Tangent = mul((float3x3)SSBO[objectID].ModelMatrix, Tangent);
+    output.Bitangent = mul((float3x3)SSBO[objectID].ModelMatrix, Bitangent);
 
     return output;
 }
\ No newline at end of file
@@ -0,0 +1,469 @@
+#include "EnginePCH.h"
+#include "Benchmark.h"
+
+#include <filesystem>
+#include <fstream>
+#include <rapidjson/document.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+#ifdef RK_PLATFORM_LINUX
+	#include <sys/resource.h>
+#endif
+
+#include "Format/GLTF.h"
+#include "Format/HLSL.h"
+#include "Renderer/Common/Material.h"
+#include "Renderer/Common/Mesh.h"
+#include "Renderer/Common/Resource.h"
+#include "Renderer/Common/Shader.h"
+#include "Renderer/Vulkan/VulkanAllocator.h"
+#include "Renderer/Vulkan/VulkanDevice.h"
+#include "Renderer/Vulkan/VulkanFrame.h"
+#include "Renderer/Vulkan/VulkanImage.h"
+#include "Renderer/Vulkan/VulkanQuery.h"
+#include "Renderer/Vulkan/VulkanSceneRenderer.h"
+#include "Renderer/Vulkan/VulkanSwapchain.h"
+#include "Scene/OcclusionCuller.h"
+#include "Utils/JSON.h"
+#include "Utils/Statistics.h"
+#include "Utils/Stats.h"
+
+namespace Utils
+{
+	static std::string ResolvePath(const std::filesystem::path& Directory, const std::string& Path)
+	{
+		const std::filesystem::path FilePath(Path);
+		return FilePath.is_absolute() ? FilePath.string() : (Directory / FilePath).lexically_normal().string();
+	}
+}
+
+const char* GetBuildConfiguration()
+{
+#if defined(RK_DEBUG)
+	return "Debug";
+#elif defined(RK_RELEASE)
+	return "Release";
+#elif defined(RK_DIST)
+	return "Dist";
+#else
+	return "Unknown";
+#endif
+}
+
+PBenchmark::PBenchmark(const std::string& InScenarioPath, const std::string& InReportPath)
+	: ScenarioPath(InScenarioPath), ReportPath(InReportPath)
+{
+}
+
+void PBenchmark::Start()
+{
+	LoadScenario();
+
+	// Simulation only depends on the frame index from here on, which makes runs comparable across builds and machines.
+	GetEngine()->Timestep.SetFixedDeltaTime(Scenario.Timestep);
+	GetEngine()->FramePacer.SetAlwaysActive(true);
+
+	PCamera* Camera = GetScene()->GetCamera();
+	Camera->Settings.ProjectionMode = ECameraProjectionMode::Perspective;
+	Camera->Settings.FoVY = Scenario.FoVY;
+	Camera->Settings.ZNear = Scenario.ZNear;
+	Camera->Settings.ZFar = Scenario.ZFar;
+	Camera->ApplySettings();
+
+	DeviceName = GetRHI()->GetDevice()->GetPhysicalDeviceProperties().deviceName;
+
+	const size_t SampleCount = Scenario.FrameCount;
+	CPUFrameTimes.reserve(SampleCount);
+	GPUFrameTimes.reserve(SampleCount);
+	DrawCounts.reserve(SampleCount);
+	TriangleCounts.reserve(SampleCount);
+	VisibleRatios.reserve(SampleCount);
+
+	RK_LOG_INFO("Benchmark '{}': {} warm-up frames, {} frames at {:.4f}s timestep", Scenario.Name, Scenario.WarmupFrameCount, Scenario.FrameCount, Scenario.Timestep);
+}
+
+void PBenchmark::LoadScenario()
+{
+	const SBlob Blob = PFileSystem::ReadFileBinary(ScenarioPath);
+	RK_ASSERT(!Blob.Data.empty(), "Failed to read benchmark scenario.");
+
+	rapidjson::Document Document;
+	Document.Parse(reinterpret_cast<const char*>(Blob.Data.data()), Blob.Data.size());
+	RK_ASSERT(!Document.HasParseError() && Document.IsObject(), "Failed to parse benchmark scenario.");
+
+	const std::filesystem::path ScenarioDirectory = std::filesystem::path(ScenarioPath).parent_path();
+
+	Scenario.Name = Document.HasMember("Name") ? Document["Name"].GetString() : Blob.Name;
+	Scenario.WarmupFrameCount = Document.HasMember("WarmupFrames") ? Document["WarmupFrames"].GetUint() : Scenario.WarmupFrameCount;
+	Scenario.FrameCount = Document.HasMember("Frames") ? Document["Frames"].GetUint() : Scenario.FrameCount;
+	Scenario.Timestep = Document.HasMember("Timestep") ? Document["Timestep"].GetFloat() : Scenario.Timestep;
+
+	if (Document.HasMember("DepthPrePass"))
+	{
+		GetScene()->SetDepthPrePass(Document["DepthPrePass"].GetBool());
+	}
+
+	if (Document.HasMember("Camera"))
+	{
+		const rapidjson::Value& Camera = Document["Camera"];
+		Scenario.FoVY = Camera.HasMember("FoVY") ? Camera["FoVY"].GetFloat() : Scenario.FoVY;
+		Scenario.ZNear = Camera.HasMember("ZNear") ? Camera["ZNear"].GetFloat() : Scenario.ZNear;
+		Scenario.ZFar = Camera.HasMember("ZFar") ? Camera["ZFar"].GetFloat() : Scenario.ZFar;
+	}
+
+	// Shader pairs are compiled once per material, meshes reference materials and entities reference meshes by name.
+	if (Document.HasMember("Materials"))
+	{
+		for (const rapidjson::Value& MaterialObject : Document["Materials"].GetArray())
+		{
+			const std::string Name = MaterialObject["Name"].GetString();
+			const std::string VertexPath = MaterialObject.HasMember("VertexShader") ? Utils::ResolvePath(ScenarioDirectory, MaterialObject["VertexShader"].GetString()) : RK_ENGINE_DIR "/Shaders/HLSL/Vertex.hlsl";
+			const std::string PixelPath = MaterialObject.HasMember("PixelShader") ? Utils::ResolvePath(ScenarioDirectory, MaterialObject["PixelShader"].GetString()) : RK_ENGINE_DIR "/Shaders/HLSL/Pixel.hlsl";
+
+			const FHLSL VertexShader = Format::ImportHLSL(VertexPath, "main", "vs_6_0");
+			const FHLSL PixelShader = Format::ImportHLSL(PixelPath, "main", "ps_6_0");
+
+			IShader* Shader = NewObject<IShader>();
+			Shader->CreateShader({ { VertexShader.Data, VertexShader.Size }, { PixelShader.Data, PixelShader.Size } });
+
+			IMaterial* Material = NewObject<IMaterial>();
+			Material->SetShader(Shader);
+
+			Shaders[Name] = Shader;
+			Materials[Name] = Material;
+		}
+	}
+
+	if (Document.HasMember("Meshes"))
+	{
+		for (const rapidjson::Value& MeshObject : Document["Meshes"].GetArray())
+		{
+			const std::string Name = MeshObject["Name"].GetString();
+			const std::string MaterialName = MeshObject["Material"].GetString();
+			RK_ASSERT(Materials.count(MaterialName), "Benchmark mesh references an unknown material.");
+
+			SMeshLODSettings LODSettings;
+			if (MeshObject.HasMember("LODRatios"))
+			{
+				for (const rapidjson::Value& Ratio : MeshObject["LODRatios"].GetArray())
+				{
+					LODSettings.TargetRatios.push_back(Ratio.GetFloat());
+				}
+			}
+			LODSettings.MaxError = MeshObject.HasMember("LODMaxError") ? MeshObject["LODMaxError"].GetFloat() : LODSettings.MaxError;
+
+			SMeshBinaryData MeshBinaryData;
+			PGLTF::ImportGLTF(Utils::ResolvePath(ScenarioDirectory, MeshObject["Path"].GetString()), MeshBinaryData, LODSettings);
+
+			IMesh* Mesh = NewObject<IMesh>();
+			Mesh->SetMaterial(Materials[MaterialName]);
+			Mesh->CreateMesh(MeshBinaryData);
+
+			Meshes[Name] = Mesh;
+
+			const bool bOccluder = MeshObject.HasMember("Occluder") ? MeshObject["Occluder"].GetBool() : MeshBinaryData.bOccluder;
+			if (bOccluder)
+			{
+				OccluderGeometries[Name] = POcclusionCuller::CreateGeometry(MeshBinaryData);
+			}
+
+			// Generated levels switch where their recorded error grows past LODScreenError of the screen height.
+			if (!MeshBinaryData.LODs.empty())
+			{
+				const float ScreenError = MeshObject.HasMember("LODScreenError") ? MeshObject["LODScreenError"].GetFloat() : DefaultLODScreenError;
+
+				SLODChain& Chain = LODChains[Name];
+				Chain.Levels.push_back({ Mesh, 0.0f });
+				for (size_t Level = 0; Level < MeshBinaryData.LODs.size(); ++Level)
+				{
+					IMesh* LODMesh = NewObject<IMesh>();
+					LODMesh->SetMaterial(Materials[MaterialName]);
+					LODMesh->CreateMesh(MeshBinaryData.ExtractLOD(Level));
+
+					Chain.Levels.back().ScreenSize = PLODSelector::GetScreenSizeForError(MeshBinaryData.LODs[Level].Error, MeshBinaryData.LocalBoundingSphere.Radius, ScreenError);
+					Chain.Levels.push_back({ LODMesh, 0.0f });
+				}
+			}
+			else if (MeshObject.HasMember("LODs"))
+			{
+				SLODChain& Chain = LODChains[Name];
+				Chain.Levels.push_back({ Mesh, 0.0f });
+				for (const rapidjson::Value& LODObject : MeshObject["LODs"].GetArray())
+				{
+					SMeshBinaryData LODBinaryData;
+					PGLTF::ImportGLTF(Utils::ResolvePath(ScenarioDirectory, LODObject["Path"].GetString()), LODBinaryData);
+
+					IMesh* LODMesh = NewObject<IMesh>();
+					LODMesh->SetMaterial(Materials[MaterialName]);
+					LODMesh->CreateMesh(LODBinaryData);
+
+					// Where the level takes over is where the finer one stops
+					Chain.Levels.back().ScreenSize = LODObject["ScreenSize"].GetFloat();
+					Chain.Levels.push_back({ LODMesh, 0.0f });
+				}
+			}
+
+			if (LODChains.count(Name))
+			{
+				SLODChain& Chain = LODChains[Name];
+				Chain.MinScreenSize = MeshObject.HasMember("MinScreenSize") ? MeshObject["MinScreenSize"].GetFloat() : Chain.MinScreenSize;
+			}
+		}
+	}
+
+	if (Document.HasMember("Entities"))
+	{
+		for (const rapidjson::Value& EntityObject : Document["Entities"].GetArray())
+		{
+			const std::string MeshName = EntityObject["Mesh"].GetString();
+			RK_ASSERT(Meshes.count(MeshName), "Benchmark entity references an unknown mesh.");
+
+			STransform Transform;
+			Transform.Translation = JSON::ReadVector3(EntityObject, "Translation", glm::vec3(0.0f));
+			Transform.Rotation = glm::radians(JSON::ReadVector3(EntityObject, "Rotation", glm::vec3(0.0f)));
+			Transform.Scale = JSON::ReadVector3(EntityObject, "Scale", glm::vec3(1.0f));
+
+			SEntity Entity = GetScene()->GetRegistry()->CreateEntity();
+			Entity.AddComponent<STransformComponent>(Transform);
+			Entity.AddComponent<SMeshComponent>(Meshes[MeshName]);
+
+			if (OccluderGeometries.count(MeshName))
+			{
+				Entity.AddComponent<SOccluderComponent>(&OccluderGeometries[MeshName]);
+			}
+
+			if (LODChains.count(MeshName))
+			{
+				Entity.AddComponent<SLODComponent>(&LODChains[MeshName]);
+			}
+		}
+	}
+
+	if (Document.HasMember("CameraPath"))
+	{
+		const rapidjson::Value& CameraPath = Document["CameraPath"];
+		Scenario.bLoopCameraPath = CameraPath.HasMember("Loop") ? CameraPath["Loop"].GetBool() : Scenario.bLoopCameraPath;
+
+		// Rotations are recorded as pitch/yaw/roll in degrees, matching PCamera::CalculateViewMatrix after conversion.
+		for (const rapidjson::Value& Key : CameraPath["Keys"].GetArray())
+		{
+			const float Time = Key["Time"].GetFloat();
+			Scenario.CameraPositionPath.AddKey(Time, JSON::ReadVector3(Key, "Position", glm::vec3(0.0f)));
+			Scenario.CameraRotationPath.AddKey(Time, glm::radians(JSON::ReadVector3(Key, "Rotation", glm::vec3(0.0f))));
+		}
+	}
+
+	RK_LOG_INFO("Loaded benchmark scenario '{}': {} materials, {} meshes", Scenario.Name, Materials.size(), Meshes.size());
+}
+
+void PBenchmark::BeginFrame()
+{
+	if (Scenario.CameraPositionPath.IsEmpty())
+	{
+		return;
+	}
+
+	// Derived from the frame index instead of accumulated delta time, so floating point drift cannot differ between runs.
+	float Time = static_cast<float>(FrameIndex) * Scenario.Timestep;
+	const float Duration = Scenario.CameraPositionPath.GetDuration();
+	if (Scenario.bLoopCameraPath && Duration > 0.0f)
+	{
+		Time = Scenario.CameraPositionPath.GetStartTime() + std::fmod(Time, Duration);
+	}
+
+	GetScene()->GetCamera()->CalculateViewMatrix(Scenario.CameraPositionPath.Evaluate(Time), Scenario.CameraRotationPath.Evaluate(Time));
+}
+
+void PBenchmark::EndFrame(double FrameSeconds, double UpdateSeconds, double RenderSeconds)
+{
+	PVulkanFramePool* FramePool = GetRHI()->GetSceneRenderer()->GetParallelFramePool();
+	PVulkanFrame* Frame = FramePool->GetPreviousFrame();
+
+	const uint32_t FramesInFlight = static_cast<uint32_t>(std::distance(FramePool->begin(), FramePool->end()));
+
+	// GPU timings are resolved when a frame slot is reused, so they belong to the frame submitted one pool cycle earlier.
+	if (FrameIndex >= Scenario.WarmupFrameCount + FramesInFlight)
+	{
+		SampleGPUTimings(Frame->GetTimestampQueryPool()->GetResults());
+	}
+
+	if (FrameIndex >= Scenario.WarmupFrameCount)
+	{
+		CPUFrameTimes.push_back(FrameSeconds * 1e3);
+		CPUPassTimes["Update"].push_back(UpdateSeconds * 1e3);
+		CPUPassTimes["Render"].push_back(RenderSeconds * 1e3);
+		CPUPassTimes["Cull"].push_back(GetScene()->GetFrustumCuller()->GetLastCullSeconds() * 1e3);
+		DrawCounts.push_back(static_cast<double>(PStats::GetLastFrame()[EStat::DrawCalls]));
+		TriangleCounts.push_back(static_cast<double>(PStats::GetLastFrame()[EStat::Triangles]));
+
+		const uint64_t SubmittedObjects = PStats::GetLastFrame()[EStat::CullSubmittedObjects];
+		VisibleRatios.push_back(SubmittedObjects > 0 ? static_cast<double>(PStats::GetLastFrame()[EStat::CullVisibleObjects]) / static_cast<double>(SubmittedObjects) : 1.0);
+	}
+
+	// Allocations made during warm-up count towards the high-water mark as well.
+	SampleMemory();
+
+	FrameIndex++;
+}
+
+void PBenchmark::SampleGPUTimings(const std::vector<SGPUTimestampScope>& Scopes)
+{
+	// Render graph commands of different materials share a name, their times are summed per frame.
+	std::map<std::string, double> PassTimes;
+	std::map<std::string, uint64_t> PassFragmentInvocations;
+	for (const SGPUTimestampScope& Scope : Scopes)
+	{
+		if (Scope.Depth == 0)
+		{
+			GPUFrameTimes.push_back(Scope.DurationMilliseconds);
+		}
+		else
+		{
+			PassTimes[Scope.Name] += Scope.DurationMilliseconds;
+		}
+
+		if (Scope.bHasPipelineStatistics)
+		{
+			PassFragmentInvocations[Scope.Name] += Scope.FragmentShaderInvocations;
+		}
+	}
+
+	for (const auto& [Name, Milliseconds] : PassTimes)
+	{
+		GPUPassTimes[Name].push_back(Milliseconds);
+	}
+
+	const VkExtent2D Extent = GetRHI()->GetSceneRenderer()->GetDrawImage()->GetImageExtent2D();
+	const double PixelCount = static_cast<double>(Extent.width) * static_cast<double>(Extent.height);
+	for (const auto& [Name, Invocations] : PassFragmentInvocations)
+	{
+		FragmentInvocationCounts[Name].push_back(static_cast<double>(Invocations));
+		Overdraws[Name].push_back(static_cast<double>(Invocations) / PixelCount);
+	}
+}
+
+void PBenchmark::SampleMemory()
+{
+	const SVulkanMemoryUsage Usage = GetRHI()->GetSceneRenderer()->GetAllocator()->GetMemoryUsage();
+
+	DeviceLocalHighWater = std::max(DeviceLocalHighWater, Usage.DeviceLocal);
+	HostVisibleHighWater = std::max(HostVisibleHighWater, Usage.HostVisible);
+	AllocationHighWater = std::max(AllocationHighWater, Usage.Allocated);
+}
+
+bool PBenchmark::IsFinished() const
+{
+	return FrameIndex >= Scenario.WarmupFrameCount + Scenario.FrameCount;
+}
+
+void PBenchmark::Finish()
+{
+	// The last frames in flight have not been resolved yet, wait for them so every sampled frame has GPU timings.
+	vkDeviceWaitIdle(GetRHI()->GetDevice()->GetVkDevice());
+
+	PVulkanFramePool* FramePool = GetRHI()->GetSceneRenderer()->GetParallelFramePool();
+	const uint32_t FramesInFlight = static_cast<uint32_t>(std::distance(FramePool->begin(), FramePool->end()));
+	const uint32_t DrainedFrames = std::min(FramesInFlight, FrameIndex);
+
+	// Oldest first, matching the order the frames were submitted in.
+	for (uint32_t Offset = DrainedFrames; Offset > 0; --Offset)
+	{
+		const uint32_t SubmittedFrame = FrameIndex - Offset;
+		if (SubmittedFrame < Scenario.WarmupFrameCount)
+		{
+			continue;
+		}
+
+		PVulkanFrame* Frame = *(FramePool->begin() + (SubmittedFrame % FramesInFlight));
+		Frame->GetTimestampQueryPool()->Resolve();
+		SampleGPUTimings(Frame->GetTimestampQueryPool()->GetResults());
+	}
+
+	WriteReport();
+}
+
+void PBenchmark::WriteReport() const
+{
+	rapidjson::StringBuffer Buffer;
+	rapidjson::PrettyWriter<rapidjson::StringBuffer> Writer(Buffer);
+
+	const VkExtent2D Extent = GetRHI()->GetSceneRenderer()->GetSwapchain()->GetVkExtent();
+
+	Writer.StartObject();
+
+	Writer.Key("Scenario"); Writer.String(Scenario.Name.c_str());
+	Writer.Key("Build"); Writer.String(GetBuildConfiguration());
+	Writer.Key("Device"); Writer.String(DeviceName.c_str());
+	Writer.Key("Headless"); Writer.Bool(GetWindow()->IsHeadless());
+	Writer.Key("Resolution");
+	Writer.StartArray(); Writer.Uint(Extent.width); Writer.Uint(Extent.height); Writer.EndArray();
+	Writer.Key("WarmupFrames"); Writer.Uint(Scenario.WarmupFrameCount);
+	Writer.Key("Frames"); Writer.Uint(Scenario.FrameCount);
+	Writer.Key("Timestep"); Writer.Double(Scenario.Timestep);
+	Writer.Key("DepthPrePass"); Writer.Bool(GetScene()->IsDepthPrePassEnabled());
+
+	// All times are in milliseconds
+	Writer.Key("CPUFrameTime"); Statistics::WriteJSON(Writer, CPUFrameTimes);
+	Writer.Key("GPUFrameTime"); Statistics::WriteJSON(Writer, GPUFrameTimes);
+
+	Writer.Key("Passes");
+	Writer.StartObject();
+	Writer.Key("CPU");
+	Writer.StartObject();
+	for (const auto& [Name, Samples] : CPUPassTimes)
+	{
+		Writer.Key(Name.c_str()); Statistics::WriteJSON(Writer, Samples);
+	}
+	Writer.EndObject();
+	Writer.Key("GPU");
+	Writer.StartObject();
+	for (const auto& [Name, Samples] : GPUPassTimes)
+	{
+		Writer.Key(Name.c_str()); Statistics::WriteJSON(Writer, Samples);
+	}
+	Writer.EndObject();
+	Writer.EndObject();
+
+	Writer.Key("DrawCalls"); Statistics::WriteJSON(Writer, DrawCounts);
+	Writer.Key("Triangles"); Statistics::WriteJSON(Writer, TriangleCounts);
+	Writer.Key("VisibleRatio"); Statistics::WriteJSON(Writer, VisibleRatios);
+
+	Writer.Key("FragmentInvocations");
+	Writer.StartObject();
+	for (const auto& [Name, Samples] : FragmentInvocationCounts)
+	{
+		Writer.Key(Name.c_str()); Statistics::WriteJSON(Writer, Samples);
+	}
+	Writer.EndObject();
+	Writer.Key("Overdraw");
+	Writer.StartObject();
+	for (const auto& [Name, Samples] : Overdraws)
+	{
+		Writer.Key(Name.c_str()); Statistics::WriteJSON(Writer, Samples);
+	}
+	Writer.EndObject();
+
+	Writer.Key("Memory");
+	Writer.StartObject();
+	Writer.Key("DeviceLocalHighWater"); Writer.Uint64(DeviceLocalHighWater);
+	Writer.Key("HostVisibleHighWater"); Writer.Uint64(HostVisibleHighWater);
+	Writer.Key("AllocationHighWater"); Writer.Uint64(AllocationHighWater);
+#ifdef RK_PLATFORM_LINUX
+	rusage Usage{};
+	getrusage(RUSAGE_SELF, &Usage);
+	// Reported in kilobytes on Linux
+	Writer.Key("ProcessResidentHighWater"); Writer.Uint64(static_cast<uint64_t>(Usage.ru_maxrss) * 1024);
+#endif
+	Writer.EndObject();
+
+	Writer.EndObject();
+
+	std::ofstream File(ReportPath);
+	File << Buffer.GetString();
+	File.close();
+
+	const SSampleStatistics CPUSummary = Statistics::Summarize(CPUFrameTimes);
+	const SSampleStatistics GPUSummary = Statistics::Summarize(GPUFrameTimes);
+	RK_LOG_INFO("Benchmark '{}' written to {}: CPU p50 {:.3f}ms p99 {:.3f}ms, GPU p50 {:.3f}ms p99 {:.3f}ms", Scenario.Name, ReportPath, CPUSummary.P50, CPUSummary.P99, GPUSummary.P50, GPUSummary.P99);
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Math/OcclusionBuffer.h"
+#include "Math/Spline.h"
+#include "Scene/LODSelector.h"
+
+class IMaterial;
+class IMesh;
+class IShader;
+
+struct SGPUTimestampScope;
+
+// Name of the configuration the engine was compiled in, recorded in benchmark reports.
+const char* GetBuildConfiguration();
+
+// Drives an automated run from the engine loop, implemented by the scripted benchmark and the stress test.
+class IBenchmarkRunner
+{
+public:
+	virtual ~IBenchmarkRunner() = default;
+
+	// Populates the scene. Requires the RHI and scene to be initialized.
+	virtual void Start() = 0;
+
+	// Called after the timestep has been advanced, before subsystems are updated.
+	virtual void BeginFrame() = 0;
+
+	// Samples the frame that was just rendered, times are in seconds.
+	virtual void EndFrame(double FrameSeconds, double UpdateSeconds, double RenderSeconds) = 0;
+
+	virtual bool IsFinished() const = 0;
+
+	// Drains in-flight GPU timings and writes the report. Call before the RHI is shut down.
+	virtual void Finish() = 0;
+};
+
+struct SBenchmarkScenario
+{
+	std::string Name;
+
+	// Frames rendered before sampling starts (pipeline warm-up, allocator growth)
+	uint32_t WarmupFrameCount = 60;
+	uint32_t FrameCount = 1000;
+
+	// Fixed simulation timestep, in seconds
+	float Timestep = 1.0f / 60.0f;
+
+	float FoVY = 66.0f;
+	float ZNear = 0.1f;
+	float ZFar = 100.0f;
+
+	// Restarts the camera path once the last key has been reached
+	bool bLoopCameraPath = true;
+
+	TSpline<glm::vec3> CameraPositionPath;
+	TSpline<glm::vec3> CameraRotationPath;
+};
+
+// Scripted, deterministic benchmark run (--benchmark <Scenario>). Loads the scenario into the scene, flies the camera
+// along the recorded path with a fixed timestep and writes frame time percentiles to a JSON report (--benchmark-output <Path>).
+//
+// Scenario files are JSON with the optional keys Name, Frames, WarmupFrames, Timestep, DepthPrePass, Camera { FoVY, ZNear, ZFar },
+// Materials [{ Name, VertexShader, PixelShader }], Meshes [{ Name, Path, Material, Occluder, LODs [{ Path, ScreenSize }], LODRatios,
+// LODMaxError, LODScreenError, MinScreenSize }], Entities [{ Mesh, Translation, Rotation, Scale }]
+// and CameraPath { Loop, Keys [{ Time, Position, Rotation }] }. Paths are relative to the scenario file, rotations are in degrees.
+// Entities of meshes with Occluder set, or imported from meshes marked as occluders, are rasterized by the occlusion culler.
+// LODs lists coarser levels of a mesh, finest first, each replacing the previous one below its ScreenSize. LODRatios
+// instead generates them at import (see SMeshLODSettings), switching where their error exceeds LODScreenError.
+// With --pipeline-statistics the report also holds the fragment shader invocations and overdraw of every scene pass.
+class PBenchmark : public IBenchmarkRunner
+{
+public:
+	// About a pixel at 1080p
+	static constexpr float DefaultLODScreenError = 1.0f / 1080.0f;
+
+	PBenchmark(const std::string& InScenarioPath, const std::string& InReportPath);
+
+	// Loads the scenario and populates the scene.
+	virtual void Start() override;
+
+	// Moves the camera to the position for the current frame.
+	virtual void BeginFrame() override;
+
+	virtual void EndFrame(double FrameSeconds, double UpdateSeconds, double RenderSeconds) override;
+
+	virtual bool IsFinished() const override;
+
+	virtual void Finish() override;
+
+private:
+	void LoadScenario();
+	void SampleGPUTimings(const std::vector<SGPUTimestampScope>& Scopes);
+	void SampleMemory();
+	void WriteReport() const;
+
+	std::string ScenarioPath;
+	std::string ReportPath;
+
+	SBenchmarkScenario Scenario;
+
+	std::map<std::string, IShader*> Shaders;
+	std::map<std::string, IMaterial*> Materials;
+	std::map<std::string, IMesh*> Meshes;
+
+	// Of the meshes used as occluders, referenced by their entities' SOccluderComponent
+	std::map<std::string, SOccluderGeometry> OccluderGeometries;
+
+	// Of the meshes with LODs, referenced by their entities' SLODComponent
+	std::map<std::string, SLODChain> LODChains;
+
+	uint32_t FrameIndex = 0;
+
+	std::vector<double> CPUFrameTimes;
+	std::vector<double> GPUFrameTimes;
+	std::map<std::string, std::vector<double>> CPUPassTimes;
+	std::map<std::string, std::vector<double>> GPUPassTimes;
+	std::vector<double> DrawCounts;
+	std::vector<double> TriangleCounts;
+
+	// Visible share of the objects submitted to frustum culling
+	std::vector<double> VisibleRatios;
+
+	// Of the scopes collecting pipeline statistics, overdraw is fragment shader invocations per pixel
+	std::map<std::string, std::vector<double>> FragmentInvocationCounts;
+	std::map<std::string, std::vector<double>> Overdraws;
+
+	uint64_t DeviceLocalHighWater = 0;
+	uint64_t HostVisibleHighWater = 0;
+	uint64_t AllocationHighWater = 0;
+
+	std::string DeviceName;
+};
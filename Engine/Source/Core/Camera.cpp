@@ -35,6 +35,11 @@ void PCamera::CalculateViewMatrix(const glm::vec3& NewPosition, const glm::vec3&
     const glm::vec3 Right = glm::normalize(glm::cross(glm::vec3(0.0f, 1.0f, 0.0f), Direction));
     const glm::vec3 Up = glm::cross(Direction, Right);
 
+    if (NewPosition != Position || NewRotation != Rotation)
+    {
+        GetEngine()->FramePacer.RequestRedraw();
+    }
+
     ViewMatrix = glm::lookAt(NewPosition, NewPosition + Direction, Up);
     Position = NewPosition;
     Rotation = NewRotation;
@@ -42,9 +47,17 @@ void PCamera::CalculateViewMatrix(const glm::vec3& NewPosition, const glm::vec3&
 
 void PCamera::ApplySettings()
 {
+    const glm::mat4 PreviousProjection = Projection;
+
     switch (Settings.ProjectionMode)
     {
         case ECameraProjectionMode::Orthographic: SetOrthographicProjection(glm::radians(Settings.FoVY), GetWindow()->GetAspectRatio(), Settings.ZNear, Settings.ZFar); break;
         case ECameraProjectionMode::Perspective: SetPerspectiveProjection(glm::radians(Settings.FoVY), GetWindow()->GetAspectRatio(), Settings.ZNear, Settings.ZFar); break;
     }
+
+    // Called every overlay frame, so only an actual change may wake up on-demand rendering.
+    if (PreviousProjection != Projection)
+    {
+        GetEngine()->FramePacer.RequestRedraw();
+    }
 }
\ No newline at end of file
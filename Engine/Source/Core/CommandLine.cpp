@@ -0,0 +1,42 @@
+#include "EnginePCH.h"
+#include "CommandLine.h"
+
+std::vector<std::string> PCommandLine::Arguments;
+
+void PCommandLine::Init(int32_t ArgumentCount, char** InArguments)
+{
+	Arguments.clear();
+
+	// Skip the executable path
+	for (int32_t Index = 1; Index < ArgumentCount; ++Index)
+	{
+		Arguments.emplace_back(InArguments[Index]);
+	}
+}
+
+bool PCommandLine::HasOption(const std::string& Option)
+{
+	return std::find(Arguments.begin(), Arguments.end(), Option) != Arguments.end();
+}
+
+std::optional<std::string> PCommandLine::GetValue(const std::string& Option)
+{
+	auto Iterator = std::find(Arguments.begin(), Arguments.end(), Option);
+	if (Iterator == Arguments.end() || std::next(Iterator) == Arguments.end())
+	{
+		return std::nullopt;
+	}
+
+	return *std::next(Iterator);
+}
+
+uint32_t PCommandLine::GetUInt32Value(const std::string& Option, uint32_t DefaultValue)
+{
+	std::optional<std::string> Value = GetValue(Option);
+	if (!Value.has_value())
+	{
+		return DefaultValue;
+	}
+
+	return static_cast<uint32_t>(std::strtoul(Value->c_str(), nullptr, 10));
+}
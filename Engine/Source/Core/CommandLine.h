@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+class PCommandLine
+{
+public:
+	static void Init(int32_t ArgumentCount, char** Arguments);
+
+	// True if the option (e.g. "--headless") was passed.
+	static bool HasOption(const std::string& Option);
+
+	// Returns the argument following the option (e.g. "--resolution 1920x1080"), if any.
+	static std::optional<std::string> GetValue(const std::string& Option);
+
+	static uint32_t GetUInt32Value(const std::string& Option, uint32_t DefaultValue);
+
+private:
+	static std::vector<std::string> Arguments;
+};
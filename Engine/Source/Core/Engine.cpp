@@ -1,13 +1,24 @@
 #include "EnginePCH.h"
 #include "Engine.h"
 
+#include "Core/Benchmark.h"
+#include "Core/CommandLine.h"
+#include "Core/StressTest.h"
 #include "Core/Subsystem.h"
 #include "Platform/Generic/GenericWindow.h"
+#include "Platform/Headless/HeadlessWindow.h"
+#include "Renderer/Vulkan/VulkanAllocator.h"
+#include "Renderer/Vulkan/VulkanSceneRenderer.h"
 #include "Renderer/VulkanRHI.h"
 #include "Utils/Profiler.h"
+#include "Utils/Stats.h"
 #include <chrono>
 #include <thread>
 
+#ifdef RK_PLATFORM_LINUX
+	#include <sys/resource.h>
+#endif
+
 PEngine* PEngine::GEngine = nullptr;
 
 void PEngine::Start()
@@ -16,9 +27,63 @@ void PEngine::Start()
 
 	PLogger::Init();
 
+#ifdef RK_PROFILE
+	// --sample-rate <Hz> adds sampled call stacks of the engine threads to the capture (Linux only).
+	if (const uint32_t SampleRate = PCommandLine::GetUInt32Value("--sample-rate", 0))
+	{
+		PProfiler::StartSampling(SampleRate);
+	}
+
+	// Streamed while running, convert with TraceConverter <Capture> <Output.json>.
+	// --no-profile-capture keeps events in memory only, for the overlay and the flight recorder.
+	if (!PCommandLine::HasOption("--no-profile-capture"))
+	{
+		PProfiler::StartCapture(PCommandLine::GetValue("--profile-output").value_or("trace.rktrace"));
+	}
+	PProfiler::AddEventListener(&ProfilerHistory);
+
+	// --hitch-budget <Milliseconds> and --hitch-output <Directory> configure the hitch dumps.
+	SFlightRecorderSettings FlightRecorderSettings;
+	FlightRecorderSettings.BudgetMilliseconds = PCommandLine::GetUInt32Value("--hitch-budget", static_cast<uint32_t>(FlightRecorderSettings.BudgetMilliseconds));
+	FlightRecorderSettings.OutputDirectory = PCommandLine::GetValue("--hitch-output").value_or(FlightRecorderSettings.OutputDirectory);
+	FlightRecorder.Configure(FlightRecorderSettings);
+	PProfiler::AddEventListener(&FlightRecorder);
+
+	// --profile-stream <Socket> serves live events to TraceRecorder or a viewer, which can attach at any time.
+	if (std::optional<std::string> StreamSocket = PCommandLine::GetValue("--profile-stream"))
+	{
+		if (ProfilerStream.Start(*StreamSocket))
+		{
+			PProfiler::AddEventListener(&ProfilerStream);
+		}
+	}
+#endif
+
 	SWindowSpecification WindowSpecification { VIEWPORT_NAME, VIEWPORT_WIDTH, VIEWPORT_HEIGHT };
+
+	if (PCommandLine::HasOption("--headless"))
+	{
+		// --resolution <Width>x<Height> sets the offscreen image size, --frames <N> stops the run after N frames.
+		if (std::optional<std::string> Resolution = PCommandLine::GetValue("--resolution"))
+		{
+			std::sscanf(Resolution->c_str(), "%ux%u", &WindowSpecification.Width, &WindowSpecification.Height);
+		}
+
+		Window = new PHeadlessWindow(WindowSpecification);
+		MaxFrameCount = PCommandLine::GetUInt32Value("--frames", 0);
+
+		// Nothing requests redraws without input, on-demand pacing would render once and then only sleep.
+		FramePacer.SetAlwaysActive(true);
+	}
+	else
+	{
+		Window = new PGenericWindow(WindowSpecification);
+	}
 	
-	Window = new PGenericWindow(WindowSpecification);
+	// The main thread takes part in every parallel range, it counts as one of the hardware threads.
+	const uint32_t HardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+	WorkerPool.Start(PCommandLine::GetUInt32Value("--worker-threads", HardwareThreads - 1));
+
 	RHI = new PVulkanRHI();
 	Scene = new PScene();
 
@@ -30,31 +95,121 @@ void PEngine::Start()
 	{
 		Subsystem->OnAttach();
 	}
+
+	if (std::optional<std::string> Scenario = PCommandLine::GetValue("--benchmark"))
+	{
+		Benchmark = new PBenchmark(*Scenario, PCommandLine::GetValue("--benchmark-output").value_or("benchmark.json"));
+	}
+	else if (std::optional<std::string> Configuration = PCommandLine::GetValue("--stress"))
+	{
+		Benchmark = new PStressTest(*Configuration, PCommandLine::GetValue("--stress-output").value_or("stress.json"));
+	}
+
+	if (Benchmark)
+	{
+		Benchmark->Start();
+	}
+
+	// --metrics-port <Port> serves Prometheus metrics on localhost, --metrics-output <Path> rewrites them into a file
+	// every --metrics-interval <Seconds>. Hitches are counted against --hitch-budget as in profile builds.
+	SMetricsSettings MetricsSettings;
+	MetricsSettings.Port = static_cast<uint16_t>(PCommandLine::GetUInt32Value("--metrics-port", 0));
+	MetricsSettings.OutputPath = PCommandLine::GetValue("--metrics-output").value_or("");
+	MetricsSettings.WriteIntervalSeconds = PCommandLine::GetUInt32Value("--metrics-interval", static_cast<uint32_t>(MetricsSettings.WriteIntervalSeconds));
+	MetricsSettings.HitchBudgetMilliseconds = PCommandLine::GetUInt32Value("--hitch-budget", static_cast<uint32_t>(MetricsSettings.HitchBudgetMilliseconds));
+	Metrics.Start(MetricsSettings);
 }
 
 void PEngine::Run()
 {
 	while (!Window->ShouldClose())
 	{
+#ifdef RK_PROFILE
+		// Events are drained by the profiler's flush thread, the frame thread only delimits frames.
+		ProfilerHistory.MarkFrame(PProfiler::GetTimestamp());
+#endif
+
 		PROFILE_FUNC_SCOPE("PEngine::Run")
 
+		STimer FrameTimer;
+
+		// Polls events, or blocks on them while minimized, unfocused or idle in on-demand mode.
+		const bool bRender = FramePacer.BeginFrame(Window);
+
+		// Measured after the pacer, time spent waiting for events is not a hitch.
+		const uint64_t FrameStartTimestamp = PProfiler::GetTimestamp();
+
 		Timestep.Reset();
 
-		Window->Poll();
+		if (Benchmark)
+		{
+			Benchmark->BeginFrame();
+		}
 		
+		STimer UpdateTimer;
 		for (ISubsystem* Subsystem : SSubsystemStaticRegistry::GetStaticRegistry().GetSubsystems())
 		{
 			Subsystem->OnUpdate(Timestep.GetDeltaTime());
 		}
+		Scene->Update();
+		const double UpdateSeconds = UpdateTimer.GetElapsedTimeAsSeconds();
+
+		double RenderSeconds = 0.0;
+		if (bRender)
+		{
+			STimer RenderTimer;
+			RHI->Render();
+			RenderSeconds = RenderTimer.GetElapsedTimeAsSeconds();
+		}
+
+		FramePacer.EndFrame(RenderSeconds);
+
+		if (bRender)
+		{
+			PStats::EndFrame();
+
+			const uint64_t FrameEndTimestamp = PProfiler::GetTimestamp();
+			const SStatsFrame& Stats = PStats::GetLastFrame();
+			Metrics.EndFrame(PTickClock::TicksToSeconds(FrameEndTimestamp - FrameStartTimestamp), Scene->GetRegistry()->GetEntityCount(),
+				Stats[EStat::StagingBufferBytes], Stats[EStat::StorageBufferBytes], Stats[EStat::UniformBufferBytes]);
+
+#ifdef RK_PROFILE
+			if (FlightRecorder.EndFrame(FrameStartTimestamp, FrameEndTimestamp))
+			{
+				PProfiler::Flush();
+				FlightRecorder.Dump(GetHitchContext());
+			}
+#endif
+		}
 
-		RHI->Render();
+		if (Benchmark && bRender)
+		{
+			Benchmark->EndFrame(FrameTimer.GetElapsedTimeAsSeconds(), UpdateSeconds, RenderSeconds);
+			if (Benchmark->IsFinished())
+			{
+				Window->SetShouldClose(true);
+			}
+		}
 
-		//std::this_thread::sleep_for(std::chrono::milliseconds(16));
+		if (bRender && MaxFrameCount > 0 && ++RenderedFrameCount >= MaxFrameCount)
+		{
+			Window->SetShouldClose(true);
+		}
 	}
 }
 
 void PEngine::Stop()
 {
+	if (Benchmark)
+	{
+		Benchmark->Finish();
+		delete Benchmark;
+		Benchmark = nullptr;
+	}
+
+	// Queries the allocator until it stops
+	Metrics.Stop();
+
 	for (ISubsystem* Subsystem : SSubsystemStaticRegistry::GetStaticRegistry().GetSubsystems())
 	{
 		Subsystem->OnDetach();
@@ -68,7 +223,43 @@ void PEngine::Stop()
 	delete RHI;
 	delete Window;
 
-	PProfiler::Flush();
+	WorkerPool.Stop();
+
+	// Only on request, a normal run leaves no files behind in the working directory.
+	if (const std::optional<std::string> StatsOutputPath = PCommandLine::GetValue("--stats-output"))
+	{
+		PStats::WriteSummary(*StatsOutputPath);
+	}
+	PProfiler::StopSampling();
+	PProfiler::StopCapture();
+	PProfiler::RemoveEventListener(&ProfilerHistory);
+	PProfiler::RemoveEventListener(&FlightRecorder);
+	PProfiler::RemoveEventListener(&ProfilerStream);
+	ProfilerStream.Stop();
+	FlightRecorder.Wait();
+	FramePacer.Report();
 
 	GEngine = nullptr;
 }
+
+SFlightRecorderContext PEngine::GetHitchContext() const
+{
+	SFlightRecorderContext Context;
+	Context.emplace_back("Build", GetBuildConfiguration());
+	Context.emplace_back("FramePacing", GetFramePacingModeName(FramePacer.GetMode()));
+	Context.emplace_back("EntityCount", std::to_string(Scene->GetRegistry()->GetEntityCount()));
+
+	const SVulkanMemoryUsage MemoryUsage = ::GetRHI()->GetSceneRenderer()->GetAllocator()->GetMemoryUsage();
+	Context.emplace_back("GPUDeviceLocalBytes", std::to_string(MemoryUsage.DeviceLocal));
+	Context.emplace_back("GPUHostVisibleBytes", std::to_string(MemoryUsage.HostVisible));
+	Context.emplace_back("GPUAllocatedBytes", std::to_string(MemoryUsage.Allocated));
+
+#ifdef RK_PLATFORM_LINUX
+	rusage Usage{};
+	getrusage(RUSAGE_SELF, &Usage);
+	// Reported in kilobytes on Linux
+	Context.emplace_back("ProcessResidentHighWaterBytes", std::to_string(static_cast<uint64_t>(Usage.ru_maxrss) * 1024));
+#endif
+
+	return Context;
+}
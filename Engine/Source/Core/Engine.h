@@ -2,6 +2,12 @@
 
 #include <cstdint>
 
+#include "Core/FramePacer.h"
+#include "Core/Metrics.h"
+#include "Core/WorkerPool.h"
+#include "Utils/ProfilerFlightRecorder.h"
+#include "Utils/ProfilerHistory.h"
+#include "Utils/ProfilerStream.h"
 #include "Utils/Timer.h"
 
 #define GLM_FORCE_RADIANS
@@ -10,6 +16,7 @@
 class PScene;
 class IWindow;
 class IRHI;
+class IBenchmarkRunner;
 
 static const char* VIEWPORT_NAME = "Rocket Engine";
 static constexpr uint32_t VIEWPORT_WIDTH = 1440;
@@ -20,6 +27,10 @@ class PEngine
 public:
 	STimer Time;
 	STimestep Timestep;
+	PFramePacer FramePacer;
+
+	// Recent frames of profiler scopes, shown by the overlay's profiler panel
+	PProfilerHistory ProfilerHistory;
 	
 	void Start();
 	void Run();
@@ -28,14 +39,37 @@ public:
 	inline PScene* GetScene();
 	inline IWindow* GetWindow();
 	inline IRHI* GetRHI();
+	inline PWorkerPool* GetWorkerPool();
 	
 	inline friend PEngine* GetEngine();
 	
 private:
+	// Scene and memory state written into hitch dumps
+	SFlightRecorderContext GetHitchContext() const;
+
 	PScene* Scene;
 	IWindow* Window;
 	IRHI* RHI;
 
+	// Only set for scripted benchmark runs (--benchmark <Scenario>)
+	IBenchmarkRunner* Benchmark = nullptr;
+
+	// Rendered frames before the run stops, 0 runs until the window closes (--frames <N>, headless only)
+	uint32_t MaxFrameCount = 0;
+	uint32_t RenderedFrameCount = 0;
+
+	// Always recording in profile builds, writes the seconds before a hitch to disk
+	PProfilerFlightRecorder FlightRecorder;
+
+	// Only listening with --profile-stream <Socket>
+	PProfilerStream ProfilerStream;
+
+	// Fleet metrics, only exported with --metrics-port or --metrics-output
+	PMetrics Metrics;
+
+	// Data-parallel frame work such as culling, --worker-threads <N> (default: one less than the hardware threads)
+	PWorkerPool WorkerPool;
+
 	static PEngine* GEngine;
 };
 
@@ -49,6 +83,11 @@ inline IRHI* PEngine::GetRHI()
 	return RHI;
 }
 
+inline PWorkerPool* PEngine::GetWorkerPool()
+{
+	return &WorkerPool;
+}
+
 inline IWindow* PEngine::GetWindow()
 {
 	return Window;
@@ -1,7 +1,10 @@
 #include "Engine.h"
+#include "CommandLine.h"
 
-int main()
+int main(int argc, char** argv)
 {
+    PCommandLine::Init(argc, argv);
+
     PEngine* Engine = new PEngine();
 
     Engine->Start();
@@ -0,0 +1,215 @@
+#include "EnginePCH.h"
+#include "FramePacer.h"
+
+#include <chrono>
+#include <ctime>
+
+#include "Core/Window.h"
+#include "Scene/Scene.h"
+#include "Scene/Registry.h"
+
+namespace Utils
+{
+	static double GetWallTimeSeconds()
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// Process CPU time (all threads), used to derive CPU utilization per pacing mode.
+	static double GetCPUTimeSeconds()
+	{
+		return static_cast<double>(std::clock()) / static_cast<double>(CLOCKS_PER_SEC);
+	}
+}
+
+const char* GetFramePacingModeName(EFramePacingMode Mode)
+{
+	switch (Mode)
+	{
+		case EFramePacingMode::Active: return "Active";
+		case EFramePacingMode::Throttled: return "Throttled";
+		case EFramePacingMode::Minimized: return "Minimized";
+		case EFramePacingMode::OnDemand: return "OnDemand";
+		default: return "Unknown";
+	}
+}
+
+PFramePacer::PFramePacer()
+{
+	Mode = EFramePacingMode::Active;
+	LastRenderTime = 0.0;
+	FrameBeginWallTime = 0.0;
+	FrameBeginCPUTime = 0.0;
+	bRedrawRequested = true;
+	bRender = true;
+	bAlwaysActive = false;
+
+#ifdef RK_TOOLS
+	bOnDemand = true;
+#else
+	bOnDemand = false;
+#endif
+}
+
+EFramePacingMode PFramePacer::SelectMode(IWindow* Window) const
+{
+	if (Window->IsMinimized())
+	{
+		return EFramePacingMode::Minimized;
+	}
+
+	if (bAlwaysActive)
+	{
+		return EFramePacingMode::Active;
+	}
+
+	if (bOnDemand)
+	{
+		return EFramePacingMode::OnDemand;
+	}
+
+	if (!Window->IsFocused())
+	{
+		return EFramePacingMode::Throttled;
+	}
+
+	return EFramePacingMode::Active;
+}
+
+bool PFramePacer::BeginFrame(IWindow* Window)
+{
+	FrameBeginWallTime = Utils::GetWallTimeSeconds();
+	FrameBeginCPUTime = Utils::GetCPUTimeSeconds();
+
+	Mode = SelectMode(Window);
+
+	switch (Mode)
+	{
+		case EFramePacingMode::Active:
+		{
+			Window->Poll();
+			bRender = true;
+			break;
+		}
+		case EFramePacingMode::Throttled:
+		{
+			const double FrameInterval = 1.0 / UNFOCUSED_FRAME_RATE;
+			const double Remaining = FrameInterval - (Utils::GetWallTimeSeconds() - LastRenderTime);
+			if (Remaining > 0.0)
+			{
+				// Returns early if an event arrives, in which case the frame is only rendered once the interval has passed.
+				Window->WaitEventOrTimeout(static_cast<float>(Remaining));
+			}
+			else
+			{
+				Window->Poll();
+			}
+			bRender = Utils::GetWallTimeSeconds() - LastRenderTime >= FrameInterval;
+			break;
+		}
+		case EFramePacingMode::Minimized:
+		{
+			// Swapchain extent is zero while minimized, so there is nothing to render into.
+			Window->WaitEventOrTimeout(IDLE_WAIT_TIMEOUT);
+			bRender = false;
+			break;
+		}
+		case EFramePacingMode::OnDemand:
+		{
+			const bool bDirty = bRedrawRequested || GetScene()->GetRegistry()->IsDirty();
+			if (bDirty)
+			{
+				Window->Poll();
+			}
+			else
+			{
+				// Input callbacks raise the redraw flag, so waking up on an event is enough to pick up changes.
+				Window->WaitEventOrTimeout(IDLE_WAIT_TIMEOUT);
+			}
+			bRender = bRedrawRequested || GetScene()->GetRegistry()->IsDirty();
+			break;
+		}
+		default: break;
+	}
+
+	return bRender;
+}
+
+void PFramePacer::EndFrame(double RenderSeconds)
+{
+	SFramePacingStatistics& ModeStatistics = Statistics[static_cast<size_t>(Mode)];
+
+	const double WallTime = Utils::GetWallTimeSeconds();
+	ModeStatistics.WallTime += WallTime - FrameBeginWallTime;
+	ModeStatistics.CPUTime += Utils::GetCPUTimeSeconds() - FrameBeginCPUTime;
+	ModeStatistics.RenderTime += RenderSeconds;
+
+	if (bRender)
+	{
+		ModeStatistics.FramesRendered++;
+		LastRenderTime = WallTime;
+		bRedrawRequested = false;
+		GetScene()->GetRegistry()->ClearDirty();
+	}
+	else
+	{
+		ModeStatistics.FramesSkipped++;
+	}
+}
+
+void PFramePacer::RequestRedraw()
+{
+	bRedrawRequested = true;
+}
+
+void PFramePacer::SetOnDemand(bool bEnabled)
+{
+	bOnDemand = bEnabled;
+	bRedrawRequested = true;
+}
+
+bool PFramePacer::IsOnDemand() const
+{
+	return bOnDemand;
+}
+
+void PFramePacer::SetAlwaysActive(bool bEnabled)
+{
+	bAlwaysActive = bEnabled;
+}
+
+EFramePacingMode PFramePacer::GetMode() const
+{
+	return Mode;
+}
+
+const SFramePacingStatistics& PFramePacer::GetStatistics(EFramePacingMode InMode) const
+{
+	return Statistics[static_cast<size_t>(InMode)];
+}
+
+void PFramePacer::Report() const
+{
+	for (size_t Index = 0; Index < Statistics.size(); ++Index)
+	{
+		const SFramePacingStatistics& ModeStatistics = Statistics[Index];
+		if (ModeStatistics.WallTime <= 0.0)
+		{
+			continue;
+		}
+
+		// CPU utilization is relative to a single core, GPU load is approximated by the submission rate and the time spent recording and submitting frames.
+		const double CPUUtilization = 100.0 * ModeStatistics.CPUTime / ModeStatistics.WallTime;
+		const double RenderUtilization = 100.0 * ModeStatistics.RenderTime / ModeStatistics.WallTime;
+		const double SubmitRate = static_cast<double>(ModeStatistics.FramesRendered) / ModeStatistics.WallTime;
+
+		RK_LOG_INFO("Frame pacing ({}): {:.1f}s, {} rendered, {} skipped, CPU {:.1f}%, GPU submit {:.1f} fps, render {:.1f}%",
+			GetFramePacingModeName(static_cast<EFramePacingMode>(Index)),
+			ModeStatistics.WallTime,
+			ModeStatistics.FramesRendered,
+			ModeStatistics.FramesSkipped,
+			CPUUtilization,
+			SubmitRate,
+			RenderUtilization);
+	}
+}
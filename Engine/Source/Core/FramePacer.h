@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+class IWindow;
+
+// Frame rate used while the window is visible but has lost focus.
+static constexpr float UNFOCUSED_FRAME_RATE = 10.0f;
+
+// Upper bound for how long the engine sleeps waiting for events while minimized or idle on-demand.
+static constexpr float IDLE_WAIT_TIMEOUT = 0.25f;
+
+enum class EFramePacingMode : uint8_t
+{
+	Active,		// Focused window, renders every iteration
+	Throttled,	// Unfocused window, renders at UNFOCUSED_FRAME_RATE
+	Minimized,	// Nothing is visible, rendering is skipped entirely
+	OnDemand,	// Tool builds, renders only when the scene, camera or overlay changed
+	Count
+};
+
+struct SFramePacingStatistics
+{
+	uint64_t FramesRendered = 0;
+	uint64_t FramesSkipped = 0;
+
+	// Wall clock time spent in this mode, in seconds
+	double WallTime = 0.0;
+
+	// Process CPU time spent in this mode, in seconds
+	double CPUTime = 0.0;
+
+	// Wall clock time spent inside IRHI::Render, in seconds
+	double RenderTime = 0.0;
+};
+
+class PFramePacer
+{
+public:
+	PFramePacer();
+
+	// Polls or waits for window events depending on the current mode. Returns true if this iteration should render.
+	bool BeginFrame(IWindow* Window);
+	void EndFrame(double RenderSeconds);
+
+	// Marks the frame as dirty, forcing the next on-demand iteration to render.
+	void RequestRedraw();
+
+	void SetOnDemand(bool bEnabled);
+	bool IsOnDemand() const;
+
+	// Renders every iteration regardless of focus and on-demand state (e.g. benchmark runs).
+	void SetAlwaysActive(bool bEnabled);
+
+	EFramePacingMode GetMode() const;
+	const SFramePacingStatistics& GetStatistics(EFramePacingMode Mode) const;
+
+	// Logs CPU utilization and GPU submission rate for every mode that was entered.
+	void Report() const;
+
+private:
+	EFramePacingMode SelectMode(IWindow* Window) const;
+
+	std::array<SFramePacingStatistics, static_cast<size_t>(EFramePacingMode::Count)> Statistics;
+
+	EFramePacingMode Mode;
+
+	double LastRenderTime;
+	double FrameBeginWallTime;
+	double FrameBeginCPUTime;
+
+	bool bOnDemand;
+	bool bAlwaysActive;
+	bool bRedrawRequested;
+	bool bRender;
+};
+
+const char* GetFramePacingModeName(EFramePacingMode Mode);
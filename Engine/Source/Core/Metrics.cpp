@@ -0,0 +1,277 @@
+#include "EnginePCH.h"
+#include "Metrics.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include "Renderer/Vulkan/VulkanAllocator.h"
+#include "Renderer/Vulkan/VulkanSceneRenderer.h"
+#include "Renderer/VulkanRHI.h"
+
+#ifdef RK_PLATFORM_LINUX
+	#include <netinet/in.h>
+	#include <poll.h>
+	#include <sys/socket.h>
+#endif
+
+namespace Utils
+{
+	// Upper bound of the listener's reaction time to Stop and to the file deadline
+	static constexpr int PollTimeoutMilliseconds = 100;
+
+	static void AppendMetric(std::string& Text, const char* Name, const char* Type, const char* Help)
+	{
+		Text += std::format("# HELP {} {}\n# TYPE {} {}\n", Name, Help, Name, Type);
+	}
+
+#ifdef RK_PLATFORM_LINUX
+	// Every request is answered with the metrics, the path and headers are not inspected.
+	static void ServeRequest(int Socket, const std::string& Text)
+	{
+		// A client that never sends its request must not hold up the listener.
+		timeval Timeout = {};
+		Timeout.tv_sec = 1;
+		setsockopt(Socket, SOL_SOCKET, SO_RCVTIMEO, &Timeout, sizeof(Timeout));
+
+		std::string Request;
+		char Buffer[1024];
+		while (Request.find("\r\n\r\n") == std::string::npos && Request.size() < 8192)
+		{
+			const ssize_t Received = recv(Socket, Buffer, sizeof(Buffer), 0);
+			if (Received <= 0)
+			{
+				return;
+			}
+			Request.append(Buffer, static_cast<size_t>(Received));
+		}
+
+		const std::string Response = std::format("HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: {}\r\nConnection: close\r\n\r\n{}", Text.size(), Text);
+		for (size_t Offset = 0; Offset < Response.size();)
+		{
+			const ssize_t Sent = send(Socket, Response.data() + Offset, Response.size() - Offset, MSG_NOSIGNAL);
+			if (Sent <= 0)
+			{
+				return;
+			}
+			Offset += static_cast<size_t>(Sent);
+		}
+	}
+#endif
+}
+
+PMetrics::~PMetrics()
+{
+	Stop();
+}
+
+void PMetrics::Start(const SMetricsSettings& InSettings)
+{
+	Settings = InSettings;
+	if (Settings.Port == 0 && Settings.OutputPath.empty())
+	{
+		return;
+	}
+
+#ifdef RK_PLATFORM_LINUX
+	if (Settings.Port != 0)
+	{
+		sockaddr_in Address = {};
+		Address.sin_family = AF_INET;
+		Address.sin_port = htons(Settings.Port);
+		Address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+		const int Reuse = 1;
+		ListenSocket = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		if (ListenSocket < 0
+			|| setsockopt(ListenSocket, SOL_SOCKET, SO_REUSEADDR, &Reuse, sizeof(Reuse)) != 0
+			|| bind(ListenSocket, reinterpret_cast<const sockaddr*>(&Address), sizeof(Address)) != 0
+			|| listen(ListenSocket, 4) != 0)
+		{
+			RK_LOG_ERROR("Failed to serve metrics on port {}: {}", Settings.Port, std::strerror(errno));
+			if (ListenSocket >= 0)
+			{
+				close(ListenSocket);
+				ListenSocket = -1;
+			}
+		}
+		else
+		{
+			RK_LOG_INFO("Serving metrics on http://127.0.0.1:{}/metrics", Settings.Port);
+		}
+	}
+#else
+	if (Settings.Port != 0)
+	{
+		RK_LOG_WARNING("The metrics listener is not supported on this platform, only the output file is written");
+	}
+#endif
+
+	if (ListenSocket < 0 && Settings.OutputPath.empty())
+	{
+		return;
+	}
+
+	bRunning = true;
+	Thread = std::thread(&PMetrics::Run, this);
+}
+
+void PMetrics::Stop()
+{
+	if (!Thread.joinable())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		bRunning = false;
+	}
+	Condition.notify_one();
+	Thread.join();
+
+#ifdef RK_PLATFORM_LINUX
+	if (ListenSocket >= 0)
+	{
+		close(ListenSocket);
+		ListenSocket = -1;
+	}
+#endif
+
+	// The last values of the run, scrapers of the file see the final totals.
+	if (!Settings.OutputPath.empty())
+	{
+		WriteFile(Render());
+	}
+}
+
+void PMetrics::EndFrame(double FrameSeconds, uint64_t InEntityCount, uint64_t StagingBytes, uint64_t StorageBytes, uint64_t UniformBytes)
+{
+	// Prometheus buckets are cumulative, a frame counts towards every bucket it fits in.
+	for (size_t Index = 0; Index < FrameTimeBuckets.size(); ++Index)
+	{
+		if (FrameSeconds <= FrameTimeBuckets[Index])
+		{
+			FrameTimeBucketCounts[Index].fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+	FrameTimeBucketCounts.back().fetch_add(1, std::memory_order_relaxed);
+
+	FrameTimeSumNanoseconds.fetch_add(static_cast<uint64_t>(FrameSeconds * 1e9), std::memory_order_relaxed);
+	FrameCount.fetch_add(1, std::memory_order_relaxed);
+
+	if (FrameSeconds * 1e3 > Settings.HitchBudgetMilliseconds)
+	{
+		HitchCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	EntityCount.store(InEntityCount, std::memory_order_relaxed);
+	StagingBytesTotal.fetch_add(StagingBytes, std::memory_order_relaxed);
+	StorageBytesTotal.fetch_add(StorageBytes, std::memory_order_relaxed);
+	UniformBytesTotal.fetch_add(UniformBytes, std::memory_order_relaxed);
+}
+
+void PMetrics::Run()
+{
+	const auto WriteInterval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(Settings.WriteIntervalSeconds));
+	auto NextWrite = std::chrono::steady_clock::now();
+
+	std::unique_lock<std::mutex> Lock(Mutex);
+	while (bRunning)
+	{
+		Lock.unlock();
+
+		if (!Settings.OutputPath.empty() && std::chrono::steady_clock::now() >= NextWrite)
+		{
+			WriteFile(Render());
+			NextWrite += WriteInterval;
+		}
+
+#ifdef RK_PLATFORM_LINUX
+		if (ListenSocket >= 0)
+		{
+			pollfd PollDescriptor = { ListenSocket, POLLIN, 0 };
+			if (poll(&PollDescriptor, 1, Utils::PollTimeoutMilliseconds) > 0 && (PollDescriptor.revents & POLLIN))
+			{
+				const int Socket = accept4(ListenSocket, nullptr, nullptr, SOCK_CLOEXEC);
+				if (Socket >= 0)
+				{
+					Utils::ServeRequest(Socket, Render());
+					close(Socket);
+				}
+			}
+
+			Lock.lock();
+			continue;
+		}
+#endif
+
+		Lock.lock();
+		Condition.wait_until(Lock, NextWrite, [this]() { return !bRunning; });
+	}
+}
+
+std::string PMetrics::Render() const
+{
+	std::string Text;
+
+	Utils::AppendMetric(Text, "rk_frame_time_seconds", "histogram", "CPU time of rendered frames, excluding idle waits of the frame pacer.");
+	for (size_t Index = 0; Index < FrameTimeBuckets.size(); ++Index)
+	{
+		Text += std::format("rk_frame_time_seconds_bucket{{le=\"{}\"}} {}\n", FrameTimeBuckets[Index], FrameTimeBucketCounts[Index].load(std::memory_order_relaxed));
+	}
+	Text += std::format("rk_frame_time_seconds_bucket{{le=\"+Inf\"}} {}\n", FrameTimeBucketCounts.back().load(std::memory_order_relaxed));
+	Text += std::format("rk_frame_time_seconds_sum {}\n", static_cast<double>(FrameTimeSumNanoseconds.load(std::memory_order_relaxed)) * 1e-9);
+	Text += std::format("rk_frame_time_seconds_count {}\n", FrameCount.load(std::memory_order_relaxed));
+
+	Utils::AppendMetric(Text, "rk_hitches_total", "counter", "Rendered frames over the hitch budget.");
+	Text += std::format("rk_hitches_total {}\n", HitchCount.load(std::memory_order_relaxed));
+
+	Utils::AppendMetric(Text, "rk_hitch_budget_seconds", "gauge", "Frame time above which a frame counts as a hitch.");
+	Text += std::format("rk_hitch_budget_seconds {}\n", Settings.HitchBudgetMilliseconds * 1e-3);
+
+	Utils::AppendMetric(Text, "rk_entities", "gauge", "Entities in the scene as of the last rendered frame.");
+	Text += std::format("rk_entities {}\n", EntityCount.load(std::memory_order_relaxed));
+
+	Utils::AppendMetric(Text, "rk_upload_bytes_total", "counter", "Bytes uploaded to the GPU, by kind of buffer.");
+	Text += std::format("rk_upload_bytes_total{{kind=\"staging\"}} {}\n", StagingBytesTotal.load(std::memory_order_relaxed));
+	Text += std::format("rk_upload_bytes_total{{kind=\"storage\"}} {}\n", StorageBytesTotal.load(std::memory_order_relaxed));
+	Text += std::format("rk_upload_bytes_total{{kind=\"uniform\"}} {}\n", UniformBytesTotal.load(std::memory_order_relaxed));
+
+	// VMA budget queries are internally synchronized, so they can run here rather than on the main thread.
+	PVulkanRHI* VulkanRHI = ::GetRHI();
+	if (VulkanRHI && VulkanRHI->GetSceneRenderer())
+	{
+		const SVulkanMemoryUsage MemoryUsage = VulkanRHI->GetSceneRenderer()->GetAllocator()->GetMemoryUsage();
+
+		Utils::AppendMetric(Text, "rk_gpu_memory_usage_bytes", "gauge", "GPU memory used by the process, per heap type.");
+		Text += std::format("rk_gpu_memory_usage_bytes{{heap=\"device_local\"}} {}\n", MemoryUsage.DeviceLocal);
+		Text += std::format("rk_gpu_memory_usage_bytes{{heap=\"host_visible\"}} {}\n", MemoryUsage.HostVisible);
+
+		Utils::AppendMetric(Text, "rk_gpu_memory_budget_bytes", "gauge", "GPU memory available to the process according to the driver, per heap type.");
+		Text += std::format("rk_gpu_memory_budget_bytes{{heap=\"device_local\"}} {}\n", MemoryUsage.DeviceLocalBudget);
+		Text += std::format("rk_gpu_memory_budget_bytes{{heap=\"host_visible\"}} {}\n", MemoryUsage.HostVisibleBudget);
+
+		Utils::AppendMetric(Text, "rk_gpu_memory_allocated_bytes", "gauge", "Bytes of live allocations made through VMA.");
+		Text += std::format("rk_gpu_memory_allocated_bytes {}\n", MemoryUsage.Allocated);
+	}
+
+	return Text;
+}
+
+void PMetrics::WriteFile(const std::string& Text) const
+{
+	// Renamed into place, so readers never see a partially written file.
+	const std::string TemporaryPath = Settings.OutputPath + ".tmp";
+	{
+		std::ofstream File(TemporaryPath, std::ios::trunc);
+		if (!File.is_open())
+		{
+			RK_LOG_ERROR("Failed to write metrics to {}", TemporaryPath);
+			return;
+		}
+		File << Text;
+	}
+
+	std::error_code ErrorCode;
+	std::filesystem::rename(TemporaryPath, Settings.OutputPath, ErrorCode);
+}
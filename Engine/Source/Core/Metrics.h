@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+struct SMetricsSettings
+{
+	// Serves GET requests on 127.0.0.1, 0 disables the listener
+	uint16_t Port = 0;
+
+	// Rewritten every WriteIntervalSeconds (e.g. for node_exporter's textfile collector), empty disables the file
+	std::string OutputPath;
+	double WriteIntervalSeconds = 10.0;
+
+	// Frames over this count as hitches, the same budget the flight recorder dumps at
+	double HitchBudgetMilliseconds = 50.0;
+};
+
+// Fleet metrics in the Prometheus text exposition format. The main thread publishes a few values per frame
+// through relaxed atomics. A background thread queries the GPU memory budgets, renders the text and serves it.
+class PMetrics
+{
+public:
+	// Upper bounds of the frame time histogram, in seconds
+	static constexpr std::array<double, 9> FrameTimeBuckets = { 0.004, 0.008, 0.0167, 0.0333, 0.05, 0.1, 0.25, 0.5, 1.0 };
+
+	~PMetrics();
+
+	// Starts the background thread if a port or output path is set.
+	void Start(const SMetricsSettings& InSettings);
+	void Stop();
+
+	// Records a rendered frame. FrameSeconds excludes idle waits of the frame pacer,
+	// the byte counts are this frame's uploads as counted by PStats.
+	void EndFrame(double FrameSeconds, uint64_t InEntityCount, uint64_t StagingBytes, uint64_t StorageBytes, uint64_t UniformBytes);
+
+private:
+	void Run();
+	std::string Render() const;
+	void WriteFile(const std::string& Text) const;
+
+	SMetricsSettings Settings;
+
+	// Cumulative, published by EndFrame, the last bucket is +Inf
+	std::array<std::atomic<uint64_t>, FrameTimeBuckets.size() + 1> FrameTimeBucketCounts = {};
+	std::atomic<uint64_t> FrameTimeSumNanoseconds = 0;
+	std::atomic<uint64_t> FrameCount = 0;
+	std::atomic<uint64_t> HitchCount = 0;
+	std::atomic<uint64_t> EntityCount = 0;
+	std::atomic<uint64_t> StagingBytesTotal = 0;
+	std::atomic<uint64_t> StorageBytesTotal = 0;
+	std::atomic<uint64_t> UniformBytesTotal = 0;
+
+	int ListenSocket = -1;
+	std::thread Thread;
+
+	std::mutex Mutex;
+	std::condition_variable Condition;
+	bool bRunning = false;
+};
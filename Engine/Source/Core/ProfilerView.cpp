@@ -0,0 +1,299 @@
+#include "EnginePCH.h"
+#include "ProfilerView.h"
+
+#include <unordered_map>
+
+#include "Utils/Hash.h"
+
+namespace Utils
+{
+    static ImU32 GetScopeColor(const SProfilerSourceLocation* Location)
+    {
+        // Stable per name, kept dark enough for white labels
+        const uint32_t Hash = FNV1aHash(std::string(Location->Name));
+        return IM_COL32(64 + (Hash & 0x7F), 64 + ((Hash >> 8) & 0x7F), 64 + ((Hash >> 16) & 0x7F), 255);
+    }
+}
+
+void PProfilerView::OnImGuiRender()
+{
+    ImGui::Begin("Profiler");
+
+#ifndef RK_PROFILE
+    ImGui::TextUnformatted("Scopes are only recorded in builds with RK_BUILD_PROFILE.");
+#endif
+
+    if (!bPaused)
+    {
+        GetEngine()->ProfilerHistory.GetSnapshot(Snapshot);
+    }
+
+    ImGui::Checkbox("Pause", &bPaused);
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(120.0f);
+    ImGui::DragFloat("Hitch Threshold (ms)", &HitchThresholdMilliseconds, 0.1f, 1.0f, 1000.0f, "%.1f");
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(120.0f);
+    ImGui::SliderInt("Statistics Frames", &StatisticsFrameCount, 1, static_cast<int>(PProfilerHistory::MaxFrameCount));
+
+    if (Snapshot.Frames.empty())
+    {
+        ImGui::End();
+        return;
+    }
+
+    size_t SelectedIndex = Snapshot.Frames.size() - 1;
+    for (size_t Index = 0; Index < Snapshot.Frames.size(); ++Index)
+    {
+        if (Snapshot.Frames[Index].Start == SelectedFrameStart)
+        {
+            SelectedIndex = Index;
+        }
+    }
+
+    // Hitch marker, the newest frame over the threshold
+    for (size_t Index = Snapshot.Frames.size(); Index-- > 0;)
+    {
+        const double Milliseconds = PTickClock::TicksToMilliseconds(Snapshot.Frames[Index].End - Snapshot.Frames[Index].Start);
+        if (Milliseconds > HitchThresholdMilliseconds)
+        {
+            ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "Last hitch: %.2f ms, %zu frames ago", Milliseconds, Snapshot.Frames.size() - 1 - Index);
+            ImGui::SameLine();
+            if (ImGui::SmallButton("Select"))
+            {
+                SelectedFrameStart = Snapshot.Frames[Index].Start;
+                SelectedIndex = Index;
+                bPaused = true;
+            }
+            break;
+        }
+    }
+
+    DrawFrameGraph(SelectedIndex);
+
+    const SProfilerFrame& Frame = Snapshot.Frames[SelectedIndex];
+    ImGui::Text("Frame %zu of %zu: %.3f ms", SelectedIndex + 1, Snapshot.Frames.size(), PTickClock::TicksToMilliseconds(Frame.End - Frame.Start));
+
+    if (ImGui::CollapsingHeader("Timeline", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        DrawTimeline(Frame);
+    }
+
+    if (ImGui::CollapsingHeader("Statistics", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        DrawStatistics(Snapshot.Frames.size() - std::min<size_t>(Snapshot.Frames.size(), static_cast<size_t>(StatisticsFrameCount)));
+    }
+
+    ImGui::End();
+}
+
+void PProfilerView::DrawFrameGraph(size_t& SelectedIndex)
+{
+    const ImVec2 Origin = ImGui::GetCursorScreenPos();
+    const ImVec2 Size = ImVec2(ImGui::GetContentRegionAvail().x, 60.0f);
+    ImGui::InvisibleButton("FrameGraph", Size);
+
+    double MaxMilliseconds = HitchThresholdMilliseconds * 1.5;
+    for (const SProfilerFrame& Frame : Snapshot.Frames)
+    {
+        MaxMilliseconds = std::max(MaxMilliseconds, PTickClock::TicksToMilliseconds(Frame.End - Frame.Start));
+    }
+
+    ImDrawList* DrawList = ImGui::GetWindowDrawList();
+    DrawList->AddRectFilled(Origin, ImVec2(Origin.x + Size.x, Origin.y + Size.y), IM_COL32(30, 30, 30, 255));
+
+    // Right-aligned, the newest frame is always the last bar
+    const float BarWidth = Size.x / static_cast<float>(PProfilerHistory::MaxFrameCount);
+    const float FirstBarX = Origin.x + Size.x - BarWidth * static_cast<float>(Snapshot.Frames.size());
+
+    for (size_t Index = 0; Index < Snapshot.Frames.size(); ++Index)
+    {
+        const double Milliseconds = PTickClock::TicksToMilliseconds(Snapshot.Frames[Index].End - Snapshot.Frames[Index].Start);
+        const float Height = static_cast<float>(Milliseconds / MaxMilliseconds) * Size.y;
+        const float X = FirstBarX + BarWidth * static_cast<float>(Index);
+
+        ImU32 Color = Milliseconds > HitchThresholdMilliseconds ? IM_COL32(220, 60, 60, 255) : IM_COL32(90, 170, 90, 255);
+        if (Index == SelectedIndex)
+        {
+            Color = IM_COL32(240, 200, 60, 255);
+        }
+
+        DrawList->AddRectFilled(ImVec2(X, Origin.y + Size.y - Height), ImVec2(X + std::max(BarWidth - 1.0f, 1.0f), Origin.y + Size.y), Color);
+    }
+
+    const float ThresholdY = Origin.y + Size.y - static_cast<float>(HitchThresholdMilliseconds / MaxMilliseconds) * Size.y;
+    DrawList->AddLine(ImVec2(Origin.x, ThresholdY), ImVec2(Origin.x + Size.x, ThresholdY), IM_COL32(220, 60, 60, 128));
+
+    if (ImGui::IsItemHovered())
+    {
+        const float MouseX = ImGui::GetIO().MousePos.x;
+        if (MouseX >= FirstBarX)
+        {
+            const size_t Index = std::min(static_cast<size_t>((MouseX - FirstBarX) / BarWidth), Snapshot.Frames.size() - 1);
+            ImGui::SetTooltip("%.3f ms", PTickClock::TicksToMilliseconds(Snapshot.Frames[Index].End - Snapshot.Frames[Index].Start));
+
+            // Selecting a frame pauses the view, otherwise it would scroll away on the next frame.
+            if (ImGui::IsMouseClicked(ImGuiMouseButton_Left))
+            {
+                SelectedFrameStart = Snapshot.Frames[Index].Start;
+                SelectedIndex = Index;
+                bPaused = true;
+            }
+        }
+    }
+}
+
+void PProfilerView::DrawTimeline(const SProfilerFrame& Frame)
+{
+    constexpr float RowHeight = 18.0f;
+
+    const float Width = ImGui::GetContentRegionAvail().x;
+    const double TicksToPixels = static_cast<double>(Width) / static_cast<double>(std::max<uint64_t>(Frame.End - Frame.Start, 1));
+
+    for (const SProfilerThreadHistory& Thread : Snapshot.Threads)
+    {
+        uint32_t MaxDepth = 0;
+        bool bHasScopes = false;
+        for (const SProfilerScopeRecord& Scope : Thread.Scopes)
+        {
+            if (Scope.End >= Frame.Start && Scope.Start <= Frame.End)
+            {
+                MaxDepth = std::max(MaxDepth, Scope.Depth);
+                bHasScopes = true;
+            }
+        }
+
+        if (!bHasScopes)
+        {
+            continue;
+        }
+
+        if (Thread.ThreadID == PProfiler::GPUThreadID)
+        {
+            ImGui::TextUnformatted("GPU (aligned to the submit of the frame it was recorded in)");
+        }
+        else
+        {
+            ImGui::Text("Thread %u", Thread.ThreadID);
+        }
+
+        const ImVec2 Origin = ImGui::GetCursorScreenPos();
+        const ImVec2 Size = ImVec2(Width, RowHeight * static_cast<float>(MaxDepth + 1));
+        ImGui::PushID(static_cast<int>(Thread.ThreadID));
+        ImGui::InvisibleButton("Track", Size);
+        ImGui::PopID();
+
+        const bool bHovered = ImGui::IsItemHovered();
+        const ImVec2 MousePosition = ImGui::GetIO().MousePos;
+
+        ImDrawList* DrawList = ImGui::GetWindowDrawList();
+        DrawList->PushClipRect(Origin, ImVec2(Origin.x + Size.x, Origin.y + Size.y), true);
+
+        for (const SProfilerScopeRecord& Scope : Thread.Scopes)
+        {
+            if (Scope.End < Frame.Start || Scope.Start > Frame.End)
+            {
+                continue;
+            }
+
+            const float X0 = Origin.x + static_cast<float>(static_cast<double>(std::max(Scope.Start, Frame.Start) - Frame.Start) * TicksToPixels);
+            const float X1 = Origin.x + static_cast<float>(static_cast<double>(std::min(Scope.End, Frame.End) - Frame.Start) * TicksToPixels);
+            const float Y0 = Origin.y + RowHeight * static_cast<float>(Scope.Depth);
+            const ImVec2 Min = ImVec2(X0, Y0);
+            const ImVec2 Max = ImVec2(std::max(X1, X0 + 1.0f), Y0 + RowHeight - 1.0f);
+
+            DrawList->AddRectFilled(Min, Max, Utils::GetScopeColor(Scope.Location));
+
+            if (Max.x - Min.x > ImGui::CalcTextSize(Scope.Location->Name).x + 4.0f)
+            {
+                DrawList->AddText(ImVec2(Min.x + 2.0f, Min.y + 2.0f), IM_COL32(255, 255, 255, 255), Scope.Location->Name);
+            }
+
+            if (bHovered && MousePosition.x >= Min.x && MousePosition.x < Max.x && MousePosition.y >= Min.y && MousePosition.y < Max.y)
+            {
+                ImGui::SetTooltip("%s\n%.3f ms (self %.3f ms)\n%s:%u", Scope.Location->Name, PTickClock::TicksToMilliseconds(Scope.End - Scope.Start), PTickClock::TicksToMilliseconds(Scope.SelfTicks), Scope.Location->File, Scope.Location->Line);
+            }
+        }
+
+        DrawList->PopClipRect();
+    }
+}
+
+void PProfilerView::DrawStatistics(size_t FirstFrameIndex)
+{
+    struct SScopeStatistics
+    {
+        uint64_t Calls = 0;
+        uint64_t TotalTicks = 0;
+        uint64_t SelfTicks = 0;
+        uint64_t MinTicks = UINT64_MAX;
+        uint64_t MaxTicks = 0;
+    };
+
+    const uint64_t WindowStart = Snapshot.Frames[FirstFrameIndex].Start;
+    const uint64_t WindowEnd = Snapshot.Frames.back().End;
+    const size_t FrameCount = Snapshot.Frames.size() - FirstFrameIndex;
+
+    // Keyed by location rather than name, so a GPU scope and a CPU scope of the same name stay apart
+    std::unordered_map<const SProfilerSourceLocation*, SScopeStatistics> ScopeStatistics;
+    for (const SProfilerThreadHistory& Thread : Snapshot.Threads)
+    {
+        for (const SProfilerScopeRecord& Scope : Thread.Scopes)
+        {
+            if (Scope.Start < WindowStart || Scope.Start >= WindowEnd)
+            {
+                continue;
+            }
+
+            const uint64_t Ticks = Scope.End - Scope.Start;
+
+            SScopeStatistics& Statistics = ScopeStatistics[Scope.Location];
+            Statistics.Calls++;
+            Statistics.TotalTicks += Ticks;
+            Statistics.SelfTicks += Scope.SelfTicks;
+            Statistics.MinTicks = std::min(Statistics.MinTicks, Ticks);
+            Statistics.MaxTicks = std::max(Statistics.MaxTicks, Ticks);
+        }
+    }
+
+    std::vector<std::pair<const SProfilerSourceLocation*, SScopeStatistics>> SortedStatistics(ScopeStatistics.begin(), ScopeStatistics.end());
+    std::sort(SortedStatistics.begin(), SortedStatistics.end(), [](const auto& A, const auto& B)
+    {
+        return A.second.TotalTicks > B.second.TotalTicks;
+    });
+
+    if (!ImGui::BeginTable("ScopeStatistics", 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable))
+    {
+        return;
+    }
+
+    ImGui::TableSetupColumn("Scope");
+    ImGui::TableSetupColumn("Calls/Frame");
+    ImGui::TableSetupColumn("Total/Frame (ms)");
+    ImGui::TableSetupColumn("Avg (ms)");
+    ImGui::TableSetupColumn("Min (ms)");
+    ImGui::TableSetupColumn("Max (ms)");
+    ImGui::TableSetupColumn("Self/Frame (ms)");
+    ImGui::TableHeadersRow();
+
+    for (const auto& [Location, Statistics] : SortedStatistics)
+    {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::Text("%s%s", std::strcmp(Location->File, "GPU") == 0 ? "[GPU] " : "", Location->Name);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.1f", static_cast<double>(Statistics.Calls) / static_cast<double>(FrameCount));
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", PTickClock::TicksToMilliseconds(Statistics.TotalTicks) / static_cast<double>(FrameCount));
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", PTickClock::TicksToMilliseconds(Statistics.TotalTicks) / static_cast<double>(Statistics.Calls));
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", PTickClock::TicksToMilliseconds(Statistics.MinTicks));
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", PTickClock::TicksToMilliseconds(Statistics.MaxTicks));
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", PTickClock::TicksToMilliseconds(Statistics.SelfTicks) / static_cast<double>(FrameCount));
+    }
+
+    ImGui::EndTable();
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Utils/ProfilerHistory.h"
+
+// ImGui panel over PEngine::ProfilerHistory: a frame time graph with hitch markers, a per-thread flame graph
+// of the selected frame (CPU threads and the GPU track) and per-scope statistics over the recent frames.
+class PProfilerView
+{
+public:
+    void OnImGuiRender();
+
+private:
+    void DrawFrameGraph(size_t& SelectedIndex);
+    void DrawTimeline(const SProfilerFrame& Frame);
+    void DrawStatistics(size_t FirstFrameIndex);
+
+    SProfilerHistorySnapshot Snapshot;
+
+    // Start of the selected frame, zero follows the newest frame
+    uint64_t SelectedFrameStart = 0;
+
+    bool bPaused = false;
+    float HitchThresholdMilliseconds = 33.3f;
+    int StatisticsFrameCount = 120;
+};
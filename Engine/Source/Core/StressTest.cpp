@@ -0,0 +1,269 @@
+#include "EnginePCH.h"
+#include "StressTest.h"
+
+#include <fstream>
+#include <rapidjson/document.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+#include "Renderer/Vulkan/VulkanDevice.h"
+#include "Renderer/Vulkan/VulkanFrame.h"
+#include "Renderer/Vulkan/VulkanQuery.h"
+#include "Renderer/Vulkan/VulkanSceneBuffer.h"
+#include "Renderer/Vulkan/VulkanSceneRenderer.h"
+#include "Renderer/Vulkan/VulkanSwapchain.h"
+#include "Utils/JSON.h"
+#include "Utils/Statistics.h"
+#include "Utils/Stats.h"
+
+namespace Utils
+{
+	template<typename T, typename TFunc>
+	static std::vector<T> ReadArray(const rapidjson::Value& Object, const char* Name, const std::vector<T>& Default, TFunc&& Func)
+	{
+		if (!Object.HasMember(Name) || !Object[Name].IsArray())
+		{
+			return Default;
+		}
+
+		std::vector<T> Result;
+		for (const rapidjson::Value& Element : Object[Name].GetArray())
+		{
+			Result.push_back(Func(Element));
+		}
+		return Result;
+	}
+
+	static uint32_t GetFramesInFlight()
+	{
+		PVulkanFramePool* FramePool = GetRHI()->GetSceneRenderer()->GetParallelFramePool();
+		return static_cast<uint32_t>(std::distance(FramePool->begin(), FramePool->end()));
+	}
+}
+
+PStressTest::PStressTest(const std::string& InConfigurationPath, const std::string& InReportPath)
+	: ConfigurationPath(InConfigurationPath), ReportPath(InReportPath)
+{
+}
+
+void PStressTest::Start()
+{
+	LoadConfiguration();
+
+	// GPU timings lag behind by one pool cycle, a shorter warm-up would attribute them to the previous configuration.
+	WarmupFrameCount = std::max(WarmupFrameCount, Utils::GetFramesInFlight());
+
+	GetEngine()->Timestep.SetFixedDeltaTime(Timestep);
+	GetEngine()->FramePacer.SetAlwaysActive(true);
+
+	PCamera* Camera = GetScene()->GetCamera();
+	Camera->Settings.ProjectionMode = ECameraProjectionMode::Perspective;
+	Camera->Settings.FoVY = FoVY;
+	Camera->Settings.ZFar = ZFar;
+	Camera->ApplySettings();
+
+	DeviceName = GetRHI()->GetDevice()->GetPhysicalDeviceProperties().deviceName;
+
+	Generator.CreateAssets(MaterialCount, MeshCount);
+
+	RK_LOG_INFO("Stress test '{}': {} configurations, {} warm-up and {} sampled frames each", Name, Configurations.size(), WarmupFrameCount, FrameCount);
+
+	BeginConfiguration();
+}
+
+void PStressTest::LoadConfiguration()
+{
+	const SBlob Blob = PFileSystem::ReadFileBinary(ConfigurationPath);
+	RK_ASSERT(!Blob.Data.empty(), "Failed to read stress test configuration.");
+
+	rapidjson::Document Document;
+	Document.Parse(reinterpret_cast<const char*>(Blob.Data.data()), Blob.Data.size());
+	RK_ASSERT(!Document.HasParseError() && Document.IsObject(), "Failed to parse stress test configuration.");
+
+	Name = Document.HasMember("Name") ? Document["Name"].GetString() : Blob.Name;
+	MaterialCount = Document.HasMember("Materials") ? Document["Materials"].GetUint() : MaterialCount;
+	MeshCount = Document.HasMember("Meshes") ? Document["Meshes"].GetUint() : MeshCount;
+	WarmupFrameCount = Document.HasMember("WarmupFrames") ? Document["WarmupFrames"].GetUint() : WarmupFrameCount;
+	FrameCount = Document.HasMember("Frames") ? Document["Frames"].GetUint() : FrameCount;
+	Timestep = Document.HasMember("Timestep") ? Document["Timestep"].GetFloat() : Timestep;
+
+	SSceneGeneratorSettings BaseSettings;
+	BaseSettings.Seed = Document.HasMember("Seed") ? Document["Seed"].GetUint() : BaseSettings.Seed;
+	BaseSettings.Extent = Document.HasMember("Extent") ? Document["Extent"].GetFloat() : BaseSettings.Extent;
+	BaseSettings.ClusterCount = Document.HasMember("ClusterCount") ? Document["ClusterCount"].GetUint() : BaseSettings.ClusterCount;
+
+	// Looks at the volume from outside, far enough to keep all of it in view.
+	CameraPosition = glm::vec3(0.0f, 0.0f, BaseSettings.Extent * 2.5f);
+	CameraRotation = glm::vec3(0.0f, -90.0f, 0.0f);
+	ZFar = BaseSettings.Extent * 5.0f;
+
+	if (Document.HasMember("Camera"))
+	{
+		const rapidjson::Value& Camera = Document["Camera"];
+		CameraPosition = JSON::ReadVector3(Camera, "Position", CameraPosition);
+		CameraRotation = JSON::ReadVector3(Camera, "Rotation", CameraRotation);
+		FoVY = Camera.HasMember("FoVY") ? Camera["FoVY"].GetFloat() : FoVY;
+		ZFar = Camera.HasMember("ZFar") ? Camera["ZFar"].GetFloat() : ZFar;
+	}
+	CameraRotation = glm::radians(CameraRotation);
+
+	const std::vector<uint32_t> EntityCounts = Utils::ReadArray<uint32_t>(Document, "EntityCounts", { BaseSettings.EntityCount }, [](const rapidjson::Value& Value) { return Value.GetUint(); });
+	const std::vector<float> DynamicRatios = Utils::ReadArray<float>(Document, "DynamicRatios", { BaseSettings.DynamicRatio }, [](const rapidjson::Value& Value) { return std::clamp(Value.GetFloat(), 0.0f, 1.0f); });
+	const std::vector<ESpatialDistribution> Distributions = Utils::ReadArray<ESpatialDistribution>(Document, "Distributions", { BaseSettings.Distribution }, [](const rapidjson::Value& Value)
+	{
+		const std::optional<ESpatialDistribution> Distribution = ParseSpatialDistribution(Value.GetString());
+		RK_ASSERT(Distribution.has_value(), "Unknown spatial distribution in stress test configuration.");
+		return Distribution.value_or(ESpatialDistribution::Uniform);
+	});
+
+	for (ESpatialDistribution Distribution : Distributions)
+	{
+		for (float DynamicRatio : DynamicRatios)
+		{
+			for (uint32_t EntityCount : EntityCounts)
+			{
+				SSceneGeneratorSettings Settings = BaseSettings;
+				Settings.EntityCount = EntityCount;
+				Settings.DynamicRatio = DynamicRatio;
+				Settings.Distribution = Distribution;
+				Configurations.push_back(Settings);
+			}
+		}
+	}
+
+	Results.reserve(Configurations.size());
+}
+
+void PStressTest::BeginConfiguration()
+{
+	const SSceneGeneratorSettings& Settings = Configurations[ConfigurationIndex];
+
+	// The instance buffer cannot grow past what one storage buffer binding addresses.
+	const uint32_t MaxInstanceCount = GetRHI()->GetSceneRenderer()->GetSceneBuffer()->GetMaxCapacity();
+	if (Settings.EntityCount > MaxInstanceCount)
+	{
+		RK_LOG_ERROR("Stress test configuration has {} entities, more than the {} instances a storage buffer binding can address.", Settings.EntityCount, MaxInstanceCount);
+	}
+
+	Generator.Clear();
+	Generator.Generate(Settings);
+
+	SStressTestResult& Result = Results.emplace_back();
+	Result.Settings = Settings;
+	Result.CPUFrameTimes.reserve(FrameCount);
+	Result.UpdateTimes.reserve(FrameCount);
+	Result.RenderTimes.reserve(FrameCount);
+	Result.GPUFrameTimes.reserve(FrameCount);
+	Result.DrawCounts.reserve(FrameCount);
+	Result.TriangleCounts.reserve(FrameCount);
+
+	FrameIndex = 0;
+}
+
+void PStressTest::BeginFrame()
+{
+	GetScene()->GetCamera()->CalculateViewMatrix(CameraPosition, CameraRotation);
+}
+
+void PStressTest::EndFrame(double FrameSeconds, double UpdateSeconds, double RenderSeconds)
+{
+	if (IsFinished())
+	{
+		return;
+	}
+
+	PVulkanFrame* Frame = GetRHI()->GetSceneRenderer()->GetParallelFramePool()->GetPreviousFrame();
+	SStressTestResult& Result = Results.back();
+
+	if (FrameIndex >= WarmupFrameCount)
+	{
+		Result.CPUFrameTimes.push_back(FrameSeconds * 1e3);
+		Result.UpdateTimes.push_back(UpdateSeconds * 1e3);
+		Result.RenderTimes.push_back(RenderSeconds * 1e3);
+		Result.DrawCounts.push_back(static_cast<double>(PStats::GetLastFrame()[EStat::DrawCalls]));
+		Result.TriangleCounts.push_back(static_cast<double>(PStats::GetLastFrame()[EStat::Triangles]));
+
+		// Resolved from a frame submitted one pool cycle earlier, which the warm-up guarantees belongs to this configuration.
+		for (const SGPUTimestampScope& Scope : Frame->GetTimestampQueryPool()->GetResults())
+		{
+			if (Scope.Depth == 0)
+			{
+				Result.GPUFrameTimes.push_back(Scope.DurationMilliseconds);
+			}
+		}
+	}
+
+	FrameIndex++;
+
+	if (FrameIndex >= WarmupFrameCount + FrameCount)
+	{
+		const SSampleStatistics Summary = Statistics::Summarize(Result.CPUFrameTimes);
+		RK_LOG_INFO("Stress test configuration {}/{}: {} entities, CPU p50 {:.3f}ms p99 {:.3f}ms", ConfigurationIndex + 1, Configurations.size(), Result.Settings.EntityCount, Summary.P50, Summary.P99);
+
+		ConfigurationIndex++;
+		if (!IsFinished())
+		{
+			BeginConfiguration();
+		}
+	}
+}
+
+bool PStressTest::IsFinished() const
+{
+	return ConfigurationIndex >= Configurations.size();
+}
+
+void PStressTest::Finish()
+{
+	WriteReport();
+}
+
+void PStressTest::WriteReport() const
+{
+	rapidjson::StringBuffer Buffer;
+	rapidjson::PrettyWriter<rapidjson::StringBuffer> Writer(Buffer);
+
+	const VkExtent2D Extent = GetRHI()->GetSceneRenderer()->GetSwapchain()->GetVkExtent();
+
+	Writer.StartObject();
+
+	Writer.Key("StressTest"); Writer.String(Name.c_str());
+	Writer.Key("Build"); Writer.String(GetBuildConfiguration());
+	Writer.Key("Device"); Writer.String(DeviceName.c_str());
+	Writer.Key("Headless"); Writer.Bool(GetWindow()->IsHeadless());
+	Writer.Key("Resolution");
+	Writer.StartArray(); Writer.Uint(Extent.width); Writer.Uint(Extent.height); Writer.EndArray();
+	Writer.Key("Materials"); Writer.Uint64(Generator.GetMaterialCount());
+	Writer.Key("Meshes"); Writer.Uint64(Generator.GetMeshCount());
+	Writer.Key("WarmupFrames"); Writer.Uint(WarmupFrameCount);
+	Writer.Key("Frames"); Writer.Uint(FrameCount);
+	Writer.Key("Timestep"); Writer.Double(Timestep);
+
+	// All times are in milliseconds, incomplete configurations (window closed early) are reported as well.
+	Writer.Key("Configurations");
+	Writer.StartArray();
+	for (const SStressTestResult& Result : Results)
+	{
+		Writer.StartObject();
+		Writer.Key("Entities"); Writer.Uint(Result.Settings.EntityCount);
+		Writer.Key("DynamicRatio"); Writer.Double(Result.Settings.DynamicRatio);
+		Writer.Key("Distribution"); Writer.String(GetSpatialDistributionName(Result.Settings.Distribution));
+		Writer.Key("Seed"); Writer.Uint(Result.Settings.Seed);
+		Writer.Key("CPUFrameTime"); Statistics::WriteJSON(Writer, Result.CPUFrameTimes);
+		Writer.Key("Update"); Statistics::WriteJSON(Writer, Result.UpdateTimes);
+		Writer.Key("Render"); Statistics::WriteJSON(Writer, Result.RenderTimes);
+		Writer.Key("GPUFrameTime"); Statistics::WriteJSON(Writer, Result.GPUFrameTimes);
+		Writer.Key("DrawCalls"); Statistics::WriteJSON(Writer, Result.DrawCounts);
+		Writer.Key("Triangles"); Statistics::WriteJSON(Writer, Result.TriangleCounts);
+		Writer.EndObject();
+	}
+	Writer.EndArray();
+
+	Writer.EndObject();
+
+	std::ofstream File(ReportPath);
+	File << Buffer.GetString();
+	File.close();
+
+	RK_LOG_INFO("Stress test '{}' written to {}", Name, ReportPath);
+}
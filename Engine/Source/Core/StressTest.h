@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Core/Benchmark.h"
+#include "Scene/SceneGenerator.h"
+
+struct SStressTestResult
+{
+	SSceneGeneratorSettings Settings;
+
+	// Milliseconds
+	std::vector<double> CPUFrameTimes;
+	std::vector<double> UpdateTimes;
+	std::vector<double> RenderTimes;
+	std::vector<double> GPUFrameTimes;
+
+	std::vector<double> DrawCounts;
+	std::vector<double> TriangleCounts;
+};
+
+// Procedural load test (--stress <Configuration>). Sweeps every combination of entity count, dynamic ratio and spatial
+// distribution over a shared set of generated materials and meshes, and writes per-configuration frame time statistics
+// to a JSON report (--stress-output <Path>).
+//
+// Configuration files are JSON with the optional keys Name, Seed, Materials, Meshes, WarmupFrames, Frames, Timestep,
+// Extent, ClusterCount, EntityCounts [], DynamicRatios [], Distributions ["Uniform", "Grid", "Clustered"] and
+// Camera { Position, Rotation, FoVY, ZFar }. Rotations are in degrees.
+class PStressTest : public IBenchmarkRunner
+{
+public:
+	PStressTest(const std::string& InConfigurationPath, const std::string& InReportPath);
+
+	// Creates the shared assets and generates the first configuration.
+	virtual void Start() override;
+
+	// Keeps the camera fixed, so configurations only differ in scene content.
+	virtual void BeginFrame() override;
+
+	// Samples the frame and advances to the next configuration once enough frames have been recorded.
+	virtual void EndFrame(double FrameSeconds, double UpdateSeconds, double RenderSeconds) override;
+
+	virtual bool IsFinished() const override;
+
+	virtual void Finish() override;
+
+private:
+	void LoadConfiguration();
+	void BeginConfiguration();
+	void WriteReport() const;
+
+	std::string ConfigurationPath;
+	std::string ReportPath;
+
+	std::string Name;
+	uint32_t MaterialCount = 4;
+	uint32_t MeshCount = 8;
+	uint32_t WarmupFrameCount = 60;
+	uint32_t FrameCount = 300;
+	float Timestep = 1.0f / 60.0f;
+
+	float FoVY = 66.0f;
+	float ZFar = 500.0f;
+	glm::vec3 CameraPosition = glm::vec3(0.0f);
+	glm::vec3 CameraRotation = glm::vec3(0.0f);
+
+	PSceneGenerator Generator;
+
+	std::vector<SSceneGeneratorSettings> Configurations;
+	std::vector<SStressTestResult> Results;
+
+	size_t ConfigurationIndex = 0;
+	uint32_t FrameIndex = 0;
+
+	std::string DeviceName;
+};
@@ -38,12 +38,16 @@ public:
 	virtual void Poll() = 0;
 
 	virtual bool ShouldClose() const = 0;
+	virtual void SetShouldClose(bool bClose) = 0;
 	virtual bool IsMinimized() const = 0;
 	virtual bool IsFocused() const = 0;
 	virtual void SetIsMinimized(bool bMinimized) = 0;
 	virtual void SetIsFocused(bool bFocused) = 0;
 	virtual void WaitEventOrTimeout(float TimeoutSeconds) = 0;
 
+	// Headless windows have no native window or surface, the renderer falls back to offscreen images.
+	virtual bool IsHeadless() const { return false; }
+
 	inline void* GetNativeWindow() const;
 	inline SWindowSpecification& GetWindowSpecification();
 	inline SWindowUserData& GetWindowUserData();
@@ -0,0 +1,109 @@
+#include "EnginePCH.h"
+#include "WorkerPool.h"
+
+PWorkerPool::~PWorkerPool()
+{
+	Stop();
+}
+
+void PWorkerPool::Start(uint32_t WorkerCount)
+{
+	RK_ASSERT(Workers.empty(), "The worker pool has already been started.");
+
+	bStopping = false;
+	Workers.reserve(WorkerCount);
+	for (uint32_t Index = 0; Index < WorkerCount; ++Index)
+	{
+		Workers.emplace_back(&PWorkerPool::Run, this);
+	}
+}
+
+void PWorkerPool::Stop()
+{
+	if (Workers.empty())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		bStopping = true;
+	}
+	WakeCondition.notify_all();
+
+	for (std::thread& Worker : Workers)
+	{
+		Worker.join();
+	}
+	Workers.clear();
+}
+
+void PWorkerPool::Dispatch(size_t Count, size_t BatchSize, TBatchFunc Func, void* Context)
+{
+	{
+		std::unique_lock<std::mutex> Lock(Mutex);
+
+		// A worker that woke up late for the previous range may still be looking for batches.
+		DoneCondition.wait(Lock, [this]() { return BusyWorkers == 0; });
+
+		BatchFunc = Func;
+		BatchContext = Context;
+		RangeCount = Count;
+		RangeBatchSize = BatchSize;
+		BatchCount = (Count + BatchSize - 1) / BatchSize;
+		NextBatch.store(0, std::memory_order_relaxed);
+		FinishedBatches.store(0, std::memory_order_relaxed);
+		Generation++;
+	}
+	WakeCondition.notify_all();
+
+	RunBatches();
+
+	std::unique_lock<std::mutex> Lock(Mutex);
+	DoneCondition.wait(Lock, [this]() { return FinishedBatches.load(std::memory_order_acquire) == BatchCount; });
+}
+
+void PWorkerPool::RunBatches()
+{
+	size_t Finished = 0;
+	for (size_t Batch = NextBatch.fetch_add(1, std::memory_order_relaxed); Batch < BatchCount; Batch = NextBatch.fetch_add(1, std::memory_order_relaxed))
+	{
+		const size_t Begin = Batch * RangeBatchSize;
+		BatchFunc(BatchContext, Begin, std::min(Begin + RangeBatchSize, RangeCount));
+		Finished++;
+	}
+
+	if (Finished > 0 && FinishedBatches.fetch_add(Finished, std::memory_order_acq_rel) + Finished == BatchCount)
+	{
+		// Taking the lock orders the notification after the caller started waiting or checked the count.
+		std::lock_guard<std::mutex> Lock(Mutex);
+		DoneCondition.notify_all();
+	}
+}
+
+void PWorkerPool::Run()
+{
+	uint64_t SeenGeneration = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> Lock(Mutex);
+			WakeCondition.wait(Lock, [&]() { return bStopping || Generation != SeenGeneration; });
+			if (bStopping)
+			{
+				return;
+			}
+
+			SeenGeneration = Generation;
+			BusyWorkers++;
+		}
+
+		RunBatches();
+
+		std::lock_guard<std::mutex> Lock(Mutex);
+		if (--BusyWorkers == 0)
+		{
+			DoneCondition.notify_all();
+		}
+	}
+}
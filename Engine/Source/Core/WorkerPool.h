@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Persistent worker threads for data-parallel frame work. ParallelFor splits a range into batches that the workers
+// and the calling thread claim until none are left, it returns once all of them have run. One range at a time,
+// ParallelFor must not be called from inside a batch.
+class PWorkerPool
+{
+public:
+	~PWorkerPool();
+
+	// 0 workers runs every batch on the calling thread.
+	void Start(uint32_t WorkerCount);
+	void Stop();
+
+	// Threads that run batches, the workers and the calling thread
+	[[nodiscard]] uint32_t GetThreadCount() const
+	{
+		return static_cast<uint32_t>(Workers.size()) + 1;
+	}
+
+	// Func(Begin, End) for consecutive batches of at most BatchSize elements of [0, Count).
+	template<typename TFunc>
+	void ParallelFor(size_t Count, size_t BatchSize, TFunc&& Func);
+
+private:
+	using TBatchFunc = void (*)(void* Context, size_t Begin, size_t End);
+
+	void Dispatch(size_t Count, size_t BatchSize, TBatchFunc Func, void* Context);
+	void RunBatches();
+	void Run();
+
+	std::vector<std::thread> Workers;
+
+	std::mutex Mutex;
+	std::condition_variable WakeCondition;
+	std::condition_variable DoneCondition;
+
+	// Bumped for every range, workers wake up for each new value
+	uint64_t Generation = 0;
+	bool bStopping = false;
+
+	// Workers between picking up a range and running out of batches, the range is not replaced before they leave.
+	uint32_t BusyWorkers = 0;
+
+	TBatchFunc BatchFunc = nullptr;
+	void* BatchContext = nullptr;
+	size_t RangeCount = 0;
+	size_t RangeBatchSize = 0;
+	size_t BatchCount = 0;
+	std::atomic<size_t> NextBatch = 0;
+	std::atomic<size_t> FinishedBatches = 0;
+};
+
+template<typename TFunc>
+void PWorkerPool::ParallelFor(size_t Count, size_t BatchSize, TFunc&& Func)
+{
+	if (Count == 0)
+	{
+		return;
+	}
+
+	if (Workers.empty() || Count <= BatchSize)
+	{
+		Func(size_t(0), Count);
+		return;
+	}
+
+	using TFuncType = std::remove_reference_t<TFunc>;
+	Dispatch(Count, BatchSize, [](void* Context, size_t Begin, size_t End)
+	{
+		(*static_cast<TFuncType*>(Context))(Begin, End);
+	}, const_cast<void*>(static_cast<const void*>(&Func)));
+}
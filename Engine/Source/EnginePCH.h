@@ -1,4 +1,6 @@
 #define IMGUI_DEFINE_MATH_OPERATORS
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
 
 #pragma once
 
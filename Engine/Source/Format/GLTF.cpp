@@ -1,7 +1,66 @@
 #include "EnginePCH.h"
 #include "GLTF.h"
 
-void PGLTF::ImportGLTF(const std::string& Path, SMeshBinaryData& MeshBinaryObject)
+#include "Core/WorkerPool.h"
+#include "Math/MeshSimplify.h"
+
+namespace Utils
+{
+    // Indices of one primitive in the merged index buffer
+    struct SIndexRange
+    {
+        size_t First;
+        size_t Count;
+    };
+
+    // Every primitive is simplified on its own, so the work spreads over the worker pool one primitive and level at
+    // a time. Each level starts from the full primitive, its error is measured against what is actually rendered.
+    static void GenerateLODs(SMeshBinaryData& MeshData, const std::vector<SIndexRange>& Ranges, const SMeshLODSettings& Settings)
+    {
+        PROFILE_FUNC_SCOPE("PGLTF::GenerateLODs")
+
+        const size_t LevelCount = Settings.TargetRatios.size();
+        const float MaxError = Settings.MaxError * MeshData.LocalBoundingSphere.Radius;
+
+        std::vector<std::vector<uint32_t>> TaskIndices(Ranges.size() * LevelCount);
+        std::vector<float> TaskErrors(Ranges.size() * LevelCount, 0.0f);
+        GetEngine()->GetWorkerPool()->ParallelFor(TaskIndices.size(), 1, [&](size_t Begin, size_t End)
+        {
+            for (size_t Task = Begin; Task < End; ++Task)
+            {
+                const SIndexRange& Range = Ranges[Task / LevelCount];
+                const float Ratio = Settings.TargetRatios[Task % LevelCount];
+                const size_t TargetIndexCount = static_cast<size_t>(static_cast<float>(Range.Count / 3) * Ratio) * 3;
+                TaskErrors[Task] = MeshSimplify::Simplify(&MeshData.Indices[Range.First], Range.Count, &MeshData.Vertices[0].Position,
+                    sizeof(SVertex), TargetIndexCount, MaxError, TaskIndices[Task]);
+            }
+        });
+
+        for (size_t Level = 0; Level < LevelCount; ++Level)
+        {
+            SMeshLOD LOD;
+            for (size_t Range = 0; Range < Ranges.size(); ++Range)
+            {
+                const size_t Task = Range * LevelCount + Level;
+                LOD.Indices.insert(LOD.Indices.end(), TaskIndices[Task].begin(), TaskIndices[Task].end());
+                LOD.Error = std::max(LOD.Error, TaskErrors[Task]);
+            }
+
+            // A level the error bound kept from getting any coarser than the previous one would only cost memory.
+            const size_t PreviousIndexCount = MeshData.LODs.empty() ? MeshData.Indices.size() : MeshData.LODs.back().Indices.size();
+            if (LOD.Indices.size() >= PreviousIndexCount)
+            {
+                break;
+            }
+
+            // Runtime selection expects the error to grow with the level.
+            LOD.Error = MeshData.LODs.empty() ? LOD.Error : std::max(LOD.Error, MeshData.LODs.back().Error);
+            MeshData.LODs.push_back(std::move(LOD));
+        }
+    }
+}
+
+void PGLTF::ImportGLTF(const std::string& Path, SMeshBinaryData& MeshBinaryObject, const SMeshLODSettings& LODSettings)
 {
     const SBlob& Blob = PFileSystem::ReadFileBinary(Path);
 
@@ -13,8 +72,15 @@ void PGLTF::ImportGLTF(const std::string& Path, SMeshBinaryData& MeshBinaryObjec
 
     Loader.LoadBinaryFromMemory(&Model, &Error, &Warning, Blob.Data.data(), Blob.Data.size());
 
+    std::vector<Utils::SIndexRange> PrimitiveRanges;
+
     for (const auto& Mesh : Model.meshes)
     {
+        // Occluders are marked by artists with an "Occluder" extra or an _Occluder name suffix.
+        const bool bOccluderExtra = Mesh.extras.Has("Occluder") && Mesh.extras.Get("Occluder").IsBool() && Mesh.extras.Get("Occluder").Get<bool>();
+        const bool bOccluderName = Mesh.name.size() >= 9 && Mesh.name.compare(Mesh.name.size() - 9, 9, "_Occluder") == 0;
+        MeshBinaryObject.bOccluder |= bOccluderExtra || bOccluderName;
+
         for (const auto& Primitive : Mesh.primitives)
         {
             const float* Positions = nullptr;
@@ -71,6 +137,9 @@ void PGLTF::ImportGLTF(const std::string& Path, SMeshBinaryData& MeshBinaryObjec
                 ColorStride = Accessor.ByteStride(BufferView) ? Accessor.ByteStride(BufferView) : sizeof(glm::vec4);
             }
 
+            // Primitives index their own vertices, which are appended after those of the previous primitives.
+            const uint32_t BaseVertex = static_cast<uint32_t>(MeshBinaryObject.Vertices.size());
+
             for (size_t Index = 0; Index < VertexCount; ++Index)
             {
                 SVertex Vertex;
@@ -113,6 +182,11 @@ void PGLTF::ImportGLTF(const std::string& Path, SMeshBinaryData& MeshBinaryObjec
                 TriangleCount = indexAccessor.count / 3;
             }
 
+            if (IndexCount > 0)
+            {
+                PrimitiveRanges.push_back({ MeshBinaryObject.Indices.size(), IndexCount });
+            }
+
             for (size_t Index = 0; Index < IndexCount; ++Index)
             {
                 uint32_t IndexValue;
@@ -139,7 +213,7 @@ void PGLTF::ImportGLTF(const std::string& Path, SMeshBinaryData& MeshBinaryObjec
                     }
                 }
 
-                MeshBinaryObject.Indices.push_back(IndexValue);
+                MeshBinaryObject.Indices.push_back(BaseVertex + IndexValue);
             }
         }
     }
@@ -209,4 +283,11 @@ void PGLTF::ImportGLTF(const std::string& Path, SMeshBinaryData& MeshBinaryObjec
             b = b * -1.0f;
         }
     }
-}
\ No newline at end of file
+
+    MeshBinaryObject.ComputeBounds();
+
+    if (!LODSettings.TargetRatios.empty() && !MeshBinaryObject.Indices.empty())
+    {
+        Utils::GenerateLODs(MeshBinaryObject, PrimitiveRanges, LODSettings);
+    }
+}
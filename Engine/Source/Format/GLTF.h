@@ -1,7 +1,21 @@
 #pragma once
 
+#include <vector>
+
+// LOD generation of PGLTF::ImportGLTF, see MeshSimplify::Simplify
+struct SMeshLODSettings
+{
+    // Share of the full mesh's triangles each level aims for, one level per ratio, decreasing
+    std::vector<float> TargetRatios;
+
+    // Collapses that would move the surface further than this share of the bounding sphere radius are not made,
+    // so a level may keep more triangles than its ratio asks for.
+    float MaxError = 0.02f;
+};
+
 class PGLTF
 {
 public:
-    static void ImportGLTF(const std::string& Path, SMeshBinaryData& MeshBinaryObject);
+    // Generates the levels of LODSettings into MeshBinaryObject.LODs, none by default.
+    static void ImportGLTF(const std::string& Path, SMeshBinaryData& MeshBinaryObject, const SMeshLODSettings& LODSettings = {});
 };
\ No newline at end of file
@@ -0,0 +1,439 @@
+#include "EnginePCH.h"
+#include "BVH.h"
+
+namespace Utils
+{
+    static constexpr uint32_t SAHBinCount = 12;
+
+    // Pending leaves beyond this share of the tree are cheaper to add with a rebuild than one by one.
+    static constexpr size_t BatchInsertDivisor = 4;
+}
+
+uint32_t PBVH::CreateProxy(const SAABB& Bounds, uint32_t UserData)
+{
+    uint32_t ProxyID;
+    if (!FreeProxies.empty())
+    {
+        ProxyID = FreeProxies.back();
+        FreeProxies.pop_back();
+    }
+    else
+    {
+        ProxyID = static_cast<uint32_t>(Proxies.size());
+        Proxies.emplace_back();
+    }
+
+    SProxy& Proxy = Proxies[ProxyID];
+    Proxy.Bounds = Bounds;
+    Proxy.UserData = UserData;
+    Proxy.Node = InvalidIndex;
+    Proxy.bAlive = true;
+    Proxy.bMoved = false;
+
+    PendingProxies.push_back(ProxyID);
+    ProxyCount++;
+    return ProxyID;
+}
+
+void PBVH::DestroyProxy(uint32_t ProxyID)
+{
+    SProxy& Proxy = Proxies[ProxyID];
+    RK_ASSERT(Proxy.bAlive, "Proxy has already been destroyed.");
+
+    // Proxies still pending are skipped by Update, there is no leaf to remove yet.
+    if (Proxy.Node != InvalidIndex)
+    {
+        RemoveLeaf(Proxy.Node);
+        FreeNode(Proxy.Node);
+        Proxy.Node = InvalidIndex;
+        ChangesSinceRebuild++;
+    }
+
+    Proxy.bAlive = false;
+    FreeProxies.push_back(ProxyID);
+    ProxyCount--;
+}
+
+void PBVH::MoveProxy(uint32_t ProxyID, const SAABB& Bounds)
+{
+    SProxy& Proxy = Proxies[ProxyID];
+    Proxy.Bounds = Bounds;
+
+    if (!Proxy.bMoved && Proxy.Node != InvalidIndex)
+    {
+        Proxy.bMoved = true;
+        MovedProxies.push_back(ProxyID);
+    }
+}
+
+void PBVH::Update()
+{
+    // A destroyed proxy may have been reused and queued again, only proxies without a leaf are inserted.
+    size_t PendingCount = 0;
+    for (uint32_t ProxyID : PendingProxies)
+    {
+        PendingCount += Proxies[ProxyID].bAlive && Proxies[ProxyID].Node == InvalidIndex;
+    }
+
+    if (Root == InvalidIndex || PendingCount > ProxyCount / Utils::BatchInsertDivisor)
+    {
+        if (PendingCount > 0)
+        {
+            Rebuild();
+        }
+        return;
+    }
+
+    for (uint32_t ProxyID : PendingProxies)
+    {
+        SProxy& Proxy = Proxies[ProxyID];
+        if (!Proxy.bAlive || Proxy.Node != InvalidIndex)
+        {
+            continue;
+        }
+
+        const uint32_t LeafIndex = AllocateNode();
+        Nodes[LeafIndex].Bounds = Proxy.Bounds;
+        Nodes[LeafIndex].Proxy = ProxyID;
+        Proxy.Node = LeafIndex;
+
+        InsertLeaf(LeafIndex);
+    }
+    PendingProxies.clear();
+
+    for (uint32_t ProxyID : MovedProxies)
+    {
+        SProxy& Proxy = Proxies[ProxyID];
+        if (!Proxy.bMoved)
+        {
+            continue;
+        }
+
+        Proxy.bMoved = false;
+        if (!Proxy.bAlive || Proxy.Node == InvalidIndex)
+        {
+            continue;
+        }
+
+        // Small motions only grow the ancestors a little, a leaf that jumped away would stretch them across the
+        // scene and is placed anew instead.
+        SNode& Leaf = Nodes[Proxy.Node];
+        const bool bJumped = !Leaf.Bounds.Overlaps(Proxy.Bounds);
+        Leaf.Bounds = Proxy.Bounds;
+        if (bJumped)
+        {
+            RemoveLeaf(Proxy.Node);
+            InsertLeaf(Proxy.Node);
+        }
+        else
+        {
+            Refit(Leaf.Parent);
+        }
+    }
+    ChangesSinceRebuild += PendingCount + MovedProxies.size();
+    MovedProxies.clear();
+
+    // Measuring the cost visits every node, so it is only done after as many changes as there are leaves.
+    if (ChangesSinceRebuild >= static_cast<size_t>(static_cast<float>(ProxyCount) * RebuildChangeRatio))
+    {
+        ChangesSinceRebuild = 0;
+        if (ComputeCost() > CostAfterRebuild * RebuildCostRatio)
+        {
+            Rebuild();
+        }
+    }
+}
+
+void PBVH::Rebuild()
+{
+    PROFILE_FUNC_SCOPE("PBVH::Rebuild")
+
+    Nodes.clear();
+    FreeNodes.clear();
+    Root = InvalidIndex;
+
+    std::vector<uint32_t> ProxyIndices;
+    ProxyIndices.reserve(ProxyCount);
+    for (uint32_t ProxyID = 0; ProxyID < Proxies.size(); ++ProxyID)
+    {
+        SProxy& Proxy = Proxies[ProxyID];
+        Proxy.Node = InvalidIndex;
+        Proxy.bMoved = false;
+        if (Proxy.bAlive)
+        {
+            ProxyIndices.push_back(ProxyID);
+        }
+    }
+
+    PendingProxies.clear();
+    MovedProxies.clear();
+    ChangesSinceRebuild = 0;
+
+    if (!ProxyIndices.empty())
+    {
+        Nodes.reserve(ProxyIndices.size() * 2 - 1);
+        Root = BuildRecursive(ProxyIndices, 0, ProxyIndices.size(), InvalidIndex);
+    }
+
+    CostAfterRebuild = ComputeCost();
+}
+
+float PBVH::ComputeCost() const
+{
+    if (Root == InvalidIndex || Nodes[Root].IsLeaf())
+    {
+        return 0.0f;
+    }
+
+    const float RootArea = Nodes[Root].Bounds.GetSurfaceArea();
+    if (RootArea <= 0.0f)
+    {
+        return 0.0f;
+    }
+
+    float Area = 0.0f;
+    std::vector<uint32_t> Stack = { Root };
+    while (!Stack.empty())
+    {
+        const SNode& Node = Nodes[Stack.back()];
+        Stack.pop_back();
+
+        if (!Node.IsLeaf())
+        {
+            Area += Node.Bounds.GetSurfaceArea();
+            Stack.push_back(Node.Children[0]);
+            Stack.push_back(Node.Children[1]);
+        }
+    }
+
+    return Area / RootArea;
+}
+
+uint32_t PBVH::AllocateNode()
+{
+    if (!FreeNodes.empty())
+    {
+        const uint32_t NodeIndex = FreeNodes.back();
+        FreeNodes.pop_back();
+        Nodes[NodeIndex] = SNode();
+        return NodeIndex;
+    }
+
+    Nodes.emplace_back();
+    return static_cast<uint32_t>(Nodes.size() - 1);
+}
+
+void PBVH::FreeNode(uint32_t NodeIndex)
+{
+    FreeNodes.push_back(NodeIndex);
+}
+
+void PBVH::InsertLeaf(uint32_t LeafIndex)
+{
+    if (Root == InvalidIndex)
+    {
+        Root = LeafIndex;
+        Nodes[LeafIndex].Parent = InvalidIndex;
+        return;
+    }
+
+    // Descends towards the sibling whose enlargement costs least, every ancestor grows by the inherited cost (Box2D's heuristic).
+    const SAABB LeafBounds = Nodes[LeafIndex].Bounds;
+    uint32_t SiblingIndex = Root;
+    while (!Nodes[SiblingIndex].IsLeaf())
+    {
+        const SNode& Node = Nodes[SiblingIndex];
+        const float Area = Node.Bounds.GetSurfaceArea();
+        const float CombinedArea = SAABB::Union(Node.Bounds, LeafBounds).GetSurfaceArea();
+
+        // Cost of pairing the leaf with this node, and of pushing it further down
+        const float Cost = 2.0f * CombinedArea;
+        const float InheritanceCost = 2.0f * (CombinedArea - Area);
+
+        float ChildCosts[2];
+        for (int Child = 0; Child < 2; ++Child)
+        {
+            const SNode& ChildNode = Nodes[Node.Children[Child]];
+            const float ChildCombinedArea = SAABB::Union(ChildNode.Bounds, LeafBounds).GetSurfaceArea();
+            ChildCosts[Child] = (ChildNode.IsLeaf() ? ChildCombinedArea : ChildCombinedArea - ChildNode.Bounds.GetSurfaceArea()) + InheritanceCost;
+        }
+
+        if (Cost < ChildCosts[0] && Cost < ChildCosts[1])
+        {
+            break;
+        }
+
+        SiblingIndex = ChildCosts[0] < ChildCosts[1] ? Node.Children[0] : Node.Children[1];
+    }
+
+    // The new parent takes the sibling's place
+    const uint32_t OldParentIndex = Nodes[SiblingIndex].Parent;
+    const uint32_t NewParentIndex = AllocateNode();
+
+    SNode& NewParent = Nodes[NewParentIndex];
+    NewParent.Parent = OldParentIndex;
+    NewParent.Bounds = SAABB::Union(Nodes[SiblingIndex].Bounds, LeafBounds);
+    NewParent.Children[0] = SiblingIndex;
+    NewParent.Children[1] = LeafIndex;
+
+    if (OldParentIndex == InvalidIndex)
+    {
+        Root = NewParentIndex;
+    }
+    else
+    {
+        SNode& OldParent = Nodes[OldParentIndex];
+        OldParent.Children[OldParent.Children[0] == SiblingIndex ? 0 : 1] = NewParentIndex;
+    }
+
+    Nodes[SiblingIndex].Parent = NewParentIndex;
+    Nodes[LeafIndex].Parent = NewParentIndex;
+
+    Refit(OldParentIndex);
+}
+
+void PBVH::RemoveLeaf(uint32_t LeafIndex)
+{
+    if (LeafIndex == Root)
+    {
+        Root = InvalidIndex;
+        return;
+    }
+
+    // The sibling takes the parent's place
+    const uint32_t ParentIndex = Nodes[LeafIndex].Parent;
+    const SNode& Parent = Nodes[ParentIndex];
+    const uint32_t GrandParentIndex = Parent.Parent;
+    const uint32_t SiblingIndex = Parent.Children[0] == LeafIndex ? Parent.Children[1] : Parent.Children[0];
+
+    if (GrandParentIndex == InvalidIndex)
+    {
+        Root = SiblingIndex;
+        Nodes[SiblingIndex].Parent = InvalidIndex;
+    }
+    else
+    {
+        SNode& GrandParent = Nodes[GrandParentIndex];
+        GrandParent.Children[GrandParent.Children[0] == ParentIndex ? 0 : 1] = SiblingIndex;
+        Nodes[SiblingIndex].Parent = GrandParentIndex;
+    }
+
+    FreeNode(ParentIndex);
+    Refit(GrandParentIndex);
+}
+
+void PBVH::Refit(uint32_t NodeIndex)
+{
+    while (NodeIndex != InvalidIndex)
+    {
+        SNode& Node = Nodes[NodeIndex];
+        const SAABB Bounds = SAABB::Union(Nodes[Node.Children[0]].Bounds, Nodes[Node.Children[1]].Bounds);
+        if (Bounds == Node.Bounds)
+        {
+            return;
+        }
+
+        Node.Bounds = Bounds;
+        NodeIndex = Node.Parent;
+    }
+}
+
+uint32_t PBVH::BuildRecursive(std::vector<uint32_t>& ProxyIndices, size_t Begin, size_t End, uint32_t Parent)
+{
+    const uint32_t NodeIndex = AllocateNode();
+    Nodes[NodeIndex].Parent = Parent;
+
+    if (End - Begin == 1)
+    {
+        const uint32_t ProxyID = ProxyIndices[Begin];
+        Nodes[NodeIndex].Bounds = Proxies[ProxyID].Bounds;
+        Nodes[NodeIndex].Proxy = ProxyID;
+        Proxies[ProxyID].Node = NodeIndex;
+        return NodeIndex;
+    }
+
+    SAABB Bounds;
+    SAABB CentroidBounds;
+    for (size_t Index = Begin; Index < End; ++Index)
+    {
+        const SAABB& ProxyBounds = Proxies[ProxyIndices[Index]].Bounds;
+        Bounds.Grow(ProxyBounds);
+        CentroidBounds.Grow(ProxyBounds.GetCenter());
+    }
+    Nodes[NodeIndex].Bounds = Bounds;
+
+    const glm::vec3 CentroidSize = CentroidBounds.Max - CentroidBounds.Min;
+    const int Axis = CentroidSize.x > CentroidSize.y ? (CentroidSize.x > CentroidSize.z ? 0 : 2) : (CentroidSize.y > CentroidSize.z ? 1 : 2);
+
+    size_t Middle = Begin + (End - Begin) / 2;
+    if (CentroidSize[Axis] > 0.0f)
+    {
+        // Binned surface area heuristic along the widest centroid axis
+        struct SBin
+        {
+            SAABB Bounds;
+            uint32_t Count = 0;
+        };
+
+        SBin Bins[Utils::SAHBinCount];
+        const float BinScale = static_cast<float>(Utils::SAHBinCount) / CentroidSize[Axis];
+        const auto GetBin = [&](uint32_t ProxyID)
+        {
+            const float Offset = (Proxies[ProxyID].Bounds.GetCenter()[Axis] - CentroidBounds.Min[Axis]) * BinScale;
+            return glm::min(static_cast<uint32_t>(Offset), Utils::SAHBinCount - 1);
+        };
+
+        for (size_t Index = Begin; Index < End; ++Index)
+        {
+            SBin& Bin = Bins[GetBin(ProxyIndices[Index])];
+            Bin.Bounds.Grow(Proxies[ProxyIndices[Index]].Bounds);
+            Bin.Count++;
+        }
+
+        // Sweep from the right for the cost of every right half, then from the left to pick the cheapest split.
+        float RightCosts[Utils::SAHBinCount] = {};
+        SAABB RightBounds;
+        uint32_t RightCount = 0;
+        for (uint32_t Split = Utils::SAHBinCount - 1; Split > 0; --Split)
+        {
+            RightBounds.Grow(Bins[Split].Bounds);
+            RightCount += Bins[Split].Count;
+            RightCosts[Split] = RightCount > 0 ? static_cast<float>(RightCount) * RightBounds.GetSurfaceArea() : 0.0f;
+        }
+
+        float BestCost = FLT_MAX;
+        uint32_t BestSplit = 0;
+        SAABB LeftBounds;
+        uint32_t LeftCount = 0;
+        for (uint32_t Split = 1; Split < Utils::SAHBinCount; ++Split)
+        {
+            LeftBounds.Grow(Bins[Split - 1].Bounds);
+            LeftCount += Bins[Split - 1].Count;
+
+            const float Cost = (LeftCount > 0 ? static_cast<float>(LeftCount) * LeftBounds.GetSurfaceArea() : 0.0f) + RightCosts[Split];
+            if (LeftCount > 0 && LeftCount < End - Begin && Cost < BestCost)
+            {
+                BestCost = Cost;
+                BestSplit = Split;
+            }
+        }
+
+        if (BestSplit > 0)
+        {
+            const auto SplitIterator = std::partition(ProxyIndices.begin() + Begin, ProxyIndices.begin() + End, [&](uint32_t ProxyID) { return GetBin(ProxyID) < BestSplit; });
+            Middle = static_cast<size_t>(SplitIterator - ProxyIndices.begin());
+        }
+    }
+
+    // Coincident centroids cannot be separated by bins, they are split in half by count instead.
+    if (Middle == Begin || Middle == End)
+    {
+        Middle = Begin + (End - Begin) / 2;
+    }
+
+    const uint32_t Left = BuildRecursive(ProxyIndices, Begin, Middle, NodeIndex);
+    const uint32_t Right = BuildRecursive(ProxyIndices, Middle, End, NodeIndex);
+    Nodes[NodeIndex].Children[0] = Left;
+    Nodes[NodeIndex].Children[1] = Right;
+    return NodeIndex;
+}
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Math/Bounds.h"
+
+struct SBVHRayHit
+{
+    uint32_t UserData;
+    float Distance;
+};
+
+// Bounding volume hierarchy over proxies, one box per leaf. Changes are collected and applied by Update: moved
+// leaves refit their ancestors, a few new leaves are inserted where they grow the tree least, and the tree is
+// rebuilt with the surface area heuristic once enough has changed that its cost degraded or many leaves arrive at once.
+// Queries visit O(log n) nodes plus the results, they may run concurrently but not while the tree is modified.
+class PBVH
+{
+public:
+    static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+    // Proxies are stable handles of leaves, node indices change with every rebuild. UserData is returned by queries.
+    uint32_t CreateProxy(const SAABB& Bounds, uint32_t UserData);
+    void DestroyProxy(uint32_t ProxyID);
+    void MoveProxy(uint32_t ProxyID, const SAABB& Bounds);
+
+    [[nodiscard]] const SAABB& GetBounds(uint32_t ProxyID) const
+    {
+        return Proxies[ProxyID].Bounds;
+    }
+
+    [[nodiscard]] uint32_t GetUserData(uint32_t ProxyID) const
+    {
+        return Proxies[ProxyID].UserData;
+    }
+
+    [[nodiscard]] size_t GetProxyCount() const
+    {
+        return ProxyCount;
+    }
+
+    // Applies the changes since the last update, queries see the proxies as of then.
+    void Update();
+    void Rebuild();
+
+    // Surface area of the internal nodes relative to the root, what the rebuild minimizes. 0 for fewer than two leaves.
+    [[nodiscard]] float ComputeCost() const;
+
+    // Func(UserData) for every proxy whose box is at least partially inside the frustum.
+    template<typename TFunc>
+    void QueryFrustum(const SFrustum& Frustum, TFunc&& Func) const;
+
+    // Func(UserData) for every proxy whose box overlaps Box.
+    template<typename TFunc>
+    void QueryOverlap(const SAABB& Box, TFunc&& Func) const;
+
+    // Closest hit within MaxDistance. Func(UserData, BoxDistance) returns the exact distance of a hit, or a negative
+    // value for a miss (e.g. to test the mesh), nodes farther than the closest hit so far are not visited.
+    template<typename TFunc>
+    bool RayCast(const SRay& Ray, float MaxDistance, TFunc&& Func, SBVHRayHit& Hit) const;
+
+    // Closest proxy box along the ray
+    bool RayCast(const SRay& Ray, float MaxDistance, SBVHRayHit& Hit) const
+    {
+        return RayCast(Ray, MaxDistance, [](uint32_t, float BoxDistance) { return BoxDistance; }, Hit);
+    }
+
+    // Rebuild once changes since the last one amount to this many leaves and the cost grew by RebuildCostRatio
+    static constexpr float RebuildChangeRatio = 1.0f;
+    static constexpr float RebuildCostRatio = 1.3f;
+
+private:
+    struct SNode
+    {
+        SAABB Bounds;
+        uint32_t Parent = InvalidIndex;
+        uint32_t Children[2] = { InvalidIndex, InvalidIndex };
+
+        // Set for leaves only
+        uint32_t Proxy = InvalidIndex;
+
+        [[nodiscard]] bool IsLeaf() const
+        {
+            return Proxy != InvalidIndex;
+        }
+    };
+
+    struct SProxy
+    {
+        SAABB Bounds;
+        uint32_t UserData = 0;
+
+        // InvalidIndex until the proxy is inserted by Update
+        uint32_t Node = InvalidIndex;
+
+        bool bAlive = false;
+        bool bMoved = false;
+    };
+
+    uint32_t AllocateNode();
+    void FreeNode(uint32_t NodeIndex);
+
+    void InsertLeaf(uint32_t LeafIndex);
+    void RemoveLeaf(uint32_t LeafIndex);
+
+    // Recomputes the bounds of NodeIndex and its ancestors, stops early once a node's bounds no longer change.
+    void Refit(uint32_t NodeIndex);
+
+    uint32_t BuildRecursive(std::vector<uint32_t>& ProxyIndices, size_t Begin, size_t End, uint32_t Parent);
+
+    std::vector<SNode> Nodes;
+    std::vector<uint32_t> FreeNodes;
+    uint32_t Root = InvalidIndex;
+
+    std::vector<SProxy> Proxies;
+    std::vector<uint32_t> FreeProxies;
+    size_t ProxyCount = 0;
+
+    std::vector<uint32_t> PendingProxies;
+    std::vector<uint32_t> MovedProxies;
+
+    size_t ChangesSinceRebuild = 0;
+    float CostAfterRebuild = 0.0f;
+};
+
+template<typename TFunc>
+void PBVH::QueryFrustum(const SFrustum& Frustum, TFunc&& Func) const
+{
+    if (Root == InvalidIndex)
+    {
+        return;
+    }
+
+    // Second element set for subtrees entirely inside the frustum, whose leaves are reported without further tests
+    std::vector<std::pair<uint32_t, bool>> Stack;
+    Stack.reserve(64);
+    Stack.emplace_back(Root, false);
+
+    while (!Stack.empty())
+    {
+        const auto [NodeIndex, bInside] = Stack.back();
+        Stack.pop_back();
+
+        const SNode& Node = Nodes[NodeIndex];
+
+        bool bChildrenInside = bInside;
+        if (!bInside)
+        {
+            const EFrustumTest Result = Frustum.Test(Node.Bounds);
+            if (Result == EFrustumTest::Outside)
+            {
+                continue;
+            }
+            bChildrenInside = Result == EFrustumTest::Inside;
+        }
+
+        if (Node.IsLeaf())
+        {
+            Func(Proxies[Node.Proxy].UserData);
+            continue;
+        }
+
+        Stack.emplace_back(Node.Children[0], bChildrenInside);
+        Stack.emplace_back(Node.Children[1], bChildrenInside);
+    }
+}
+
+template<typename TFunc>
+void PBVH::QueryOverlap(const SAABB& Box, TFunc&& Func) const
+{
+    if (Root == InvalidIndex)
+    {
+        return;
+    }
+
+    std::vector<uint32_t> Stack;
+    Stack.reserve(64);
+    Stack.push_back(Root);
+
+    while (!Stack.empty())
+    {
+        const SNode& Node = Nodes[Stack.back()];
+        Stack.pop_back();
+
+        if (!Node.Bounds.Overlaps(Box))
+        {
+            continue;
+        }
+
+        if (Node.IsLeaf())
+        {
+            Func(Proxies[Node.Proxy].UserData);
+            continue;
+        }
+
+        Stack.push_back(Node.Children[0]);
+        Stack.push_back(Node.Children[1]);
+    }
+}
+
+template<typename TFunc>
+bool PBVH::RayCast(const SRay& Ray, float MaxDistance, TFunc&& Func, SBVHRayHit& Hit) const
+{
+    float EntryDistance;
+    if (Root == InvalidIndex || !Ray.Intersects(Nodes[Root].Bounds, MaxDistance, EntryDistance))
+    {
+        return false;
+    }
+
+    bool bHit = false;
+    float ClosestDistance = MaxDistance;
+
+    std::vector<std::pair<uint32_t, float>> Stack;
+    Stack.reserve(64);
+    Stack.emplace_back(Root, EntryDistance);
+
+    while (!Stack.empty())
+    {
+        const auto [NodeIndex, NodeDistance] = Stack.back();
+        Stack.pop_back();
+
+        // A closer hit was found since the node was pushed
+        if (NodeDistance > ClosestDistance)
+        {
+            continue;
+        }
+
+        const SNode& Node = Nodes[NodeIndex];
+        if (Node.IsLeaf())
+        {
+            const float Distance = Func(Proxies[Node.Proxy].UserData, NodeDistance);
+            if (Distance >= 0.0f && Distance <= ClosestDistance)
+            {
+                ClosestDistance = Distance;
+                Hit.UserData = Proxies[Node.Proxy].UserData;
+                Hit.Distance = Distance;
+                bHit = true;
+            }
+            continue;
+        }
+
+        float Distances[2];
+        const bool bHits[2] = { Ray.Intersects(Nodes[Node.Children[0]].Bounds, ClosestDistance, Distances[0]), Ray.Intersects(Nodes[Node.Children[1]].Bounds, ClosestDistance, Distances[1]) };
+
+        // The nearer child is pushed last, so it is visited first.
+        const int Near = Distances[1] < Distances[0] ? 1 : 0;
+        const int Far = 1 - Near;
+        if (bHits[Far])
+        {
+            Stack.emplace_back(Node.Children[Far], Distances[Far]);
+        }
+        if (bHits[Near])
+        {
+            Stack.emplace_back(Node.Children[Near], Distances[Near]);
+        }
+    }
+
+    return bHit;
+}
@@ -0,0 +1,126 @@
+#include "EnginePCH.h"
+#include "Bounds.h"
+
+namespace Utils
+{
+    static const glm::vec3& GetPosition(const void* Positions, size_t Index, size_t Stride)
+    {
+        return *reinterpret_cast<const glm::vec3*>(static_cast<const uint8_t*>(Positions) + Index * Stride);
+    }
+}
+
+SAABB SAABB::Transform(const glm::mat4& Matrix) const
+{
+    if (!IsValid())
+    {
+        return *this;
+    }
+
+    // Arvo: the transformed extent along each axis is the extent projected onto the absolute matrix rows.
+    const glm::vec3 Center = glm::vec3(Matrix * glm::vec4(GetCenter(), 1.0f));
+    const glm::vec3 Extent = GetExtent();
+    const glm::mat3 Absolute(glm::abs(glm::vec3(Matrix[0])), glm::abs(glm::vec3(Matrix[1])), glm::abs(glm::vec3(Matrix[2])));
+    const glm::vec3 TransformedExtent = Absolute * Extent;
+
+    return SAABB(Center - TransformedExtent, Center + TransformedExtent);
+}
+
+SBoundingSphere SBoundingSphere::Transform(const glm::mat4& Matrix) const
+{
+    const float MaxScaleSquared = glm::max(glm::max(glm::dot(glm::vec3(Matrix[0]), glm::vec3(Matrix[0])), glm::dot(glm::vec3(Matrix[1]), glm::vec3(Matrix[1]))), glm::dot(glm::vec3(Matrix[2]), glm::vec3(Matrix[2])));
+
+    SBoundingSphere Sphere;
+    Sphere.Center = glm::vec3(Matrix * glm::vec4(Center, 1.0f));
+    Sphere.Radius = Radius * glm::sqrt(MaxScaleSquared);
+    return Sphere;
+}
+
+SFrustum SFrustum::FromMatrix(const glm::mat4& ViewProjection)
+{
+    // glm is column-major, the rows of the matrix are gathered from the columns.
+    const glm::mat4 Transposed = glm::transpose(ViewProjection);
+
+    SFrustum Frustum;
+    Frustum.Planes[0] = Transposed[3] + Transposed[0];
+    Frustum.Planes[1] = Transposed[3] - Transposed[0];
+    Frustum.Planes[2] = Transposed[3] + Transposed[1];
+    Frustum.Planes[3] = Transposed[3] - Transposed[1];
+    Frustum.Planes[4] = Transposed[2];
+    Frustum.Planes[5] = Transposed[3] - Transposed[2];
+
+    for (glm::vec4& Plane : Frustum.Planes)
+    {
+        Plane /= glm::length(glm::vec3(Plane));
+    }
+
+    return Frustum;
+}
+
+EFrustumTest SFrustum::Test(const SAABB& Box) const
+{
+    const glm::vec3 Center = Box.GetCenter();
+    const glm::vec3 Extent = Box.GetExtent();
+
+    EFrustumTest Result = EFrustumTest::Inside;
+    for (const glm::vec4& Plane : Planes)
+    {
+        const glm::vec3 Normal = glm::vec3(Plane);
+        const float Distance = glm::dot(Normal, Center) + Plane.w;
+        const float Radius = glm::dot(glm::abs(Normal), Extent);
+
+        if (Distance < -Radius)
+        {
+            return EFrustumTest::Outside;
+        }
+        if (Distance < Radius)
+        {
+            Result = EFrustumTest::Intersecting;
+        }
+    }
+
+    return Result;
+}
+
+bool SFrustum::Intersects(const SBoundingSphere& Sphere) const
+{
+    for (const glm::vec4& Plane : Planes)
+    {
+        if (glm::dot(glm::vec3(Plane), Sphere.Center) + Plane.w < -Sphere.Radius)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+SAABB Bounds::ComputeAABB(const void* Positions, size_t Count, size_t Stride)
+{
+    SAABB Box;
+    for (size_t Index = 0; Index < Count; ++Index)
+    {
+        Box.Grow(Utils::GetPosition(Positions, Index, Stride));
+    }
+    return Box;
+}
+
+SBoundingSphere Bounds::ComputeBoundingSphere(const void* Positions, size_t Count, size_t Stride, const SAABB& Box)
+{
+    SBoundingSphere Sphere;
+    if (!Box.IsValid())
+    {
+        return Sphere;
+    }
+
+    Sphere.Center = Box.GetCenter();
+
+    float RadiusSquared = 0.0f;
+    for (size_t Index = 0; Index < Count; ++Index)
+    {
+        const glm::vec3 Delta = Utils::GetPosition(Positions, Index, Stride) - Sphere.Center;
+        RadiusSquared = glm::max(RadiusSquared, glm::dot(Delta, Delta));
+    }
+    Sphere.Radius = glm::sqrt(RadiusSquared);
+
+    return Sphere;
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <array>
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+// Axis-aligned box. Default constructed boxes are empty (Min > Max), so growing one by a point yields that point.
+struct SAABB
+{
+    SAABB() = default;
+    SAABB(const glm::vec3& InMin, const glm::vec3& InMax) : Min(InMin), Max(InMax) {}
+
+    [[nodiscard]] bool IsValid() const
+    {
+        return Min.x <= Max.x && Min.y <= Max.y && Min.z <= Max.z;
+    }
+
+    [[nodiscard]] glm::vec3 GetCenter() const
+    {
+        return (Min + Max) * 0.5f;
+    }
+
+    // Half the size along each axis
+    [[nodiscard]] glm::vec3 GetExtent() const
+    {
+        return (Max - Min) * 0.5f;
+    }
+
+    [[nodiscard]] float GetSurfaceArea() const
+    {
+        const glm::vec3 Size = Max - Min;
+        return 2.0f * (Size.x * Size.y + Size.y * Size.z + Size.z * Size.x);
+    }
+
+    void Grow(const glm::vec3& Point)
+    {
+        Min = glm::min(Min, Point);
+        Max = glm::max(Max, Point);
+    }
+
+    void Grow(const SAABB& Other)
+    {
+        Min = glm::min(Min, Other.Min);
+        Max = glm::max(Max, Other.Max);
+    }
+
+    [[nodiscard]] bool Contains(const SAABB& Other) const
+    {
+        return glm::all(glm::lessThanEqual(Min, Other.Min)) && glm::all(glm::greaterThanEqual(Max, Other.Max));
+    }
+
+    [[nodiscard]] bool Overlaps(const SAABB& Other) const
+    {
+        return glm::all(glm::lessThanEqual(Min, Other.Max)) && glm::all(glm::greaterThanEqual(Max, Other.Min));
+    }
+
+    // Smallest axis-aligned box around the transformed box, without transforming its eight corners.
+    [[nodiscard]] SAABB Transform(const glm::mat4& Matrix) const;
+
+    static SAABB Union(const SAABB& A, const SAABB& B)
+    {
+        return SAABB(glm::min(A.Min, B.Min), glm::max(A.Max, B.Max));
+    }
+
+    bool operator==(const SAABB& Other) const
+    {
+        return Min == Other.Min && Max == Other.Max;
+    }
+
+    glm::vec3 Min = glm::vec3(FLT_MAX);
+    glm::vec3 Max = glm::vec3(-FLT_MAX);
+};
+
+struct SBoundingSphere
+{
+    // Encloses the transformed sphere, the radius grows by the largest scale of the matrix.
+    [[nodiscard]] SBoundingSphere Transform(const glm::mat4& Matrix) const;
+
+    [[nodiscard]] bool Overlaps(const SAABB& Box) const
+    {
+        const glm::vec3 Closest = glm::clamp(Center, Box.Min, Box.Max);
+        const glm::vec3 Delta = Closest - Center;
+        return glm::dot(Delta, Delta) <= Radius * Radius;
+    }
+
+    glm::vec3 Center = glm::vec3(0.0f);
+    float Radius = 0.0f;
+};
+
+struct SRay
+{
+    SRay() = default;
+    SRay(const glm::vec3& InOrigin, const glm::vec3& InDirection)
+        : Origin(InOrigin), Direction(InDirection), InverseDirection(1.0f / InDirection) {}
+
+    // Slab test. On a hit, Distance is where the ray enters the box, or 0 if it starts inside.
+    [[nodiscard]] bool Intersects(const SAABB& Box, float MaxDistance, float& Distance) const
+    {
+        const glm::vec3 T0 = (Box.Min - Origin) * InverseDirection;
+        const glm::vec3 T1 = (Box.Max - Origin) * InverseDirection;
+        const glm::vec3 TMin = glm::min(T0, T1);
+        const glm::vec3 TMax = glm::max(T0, T1);
+
+        const float Enter = glm::max(glm::max(TMin.x, TMin.y), glm::max(TMin.z, 0.0f));
+        const float Exit = glm::min(glm::min(TMax.x, TMax.y), glm::min(TMax.z, MaxDistance));
+        Distance = Enter;
+        return Enter <= Exit;
+    }
+
+    // Distances are in units of the direction's length, normalize it for world units.
+    glm::vec3 Origin = glm::vec3(0.0f);
+    glm::vec3 Direction = glm::vec3(0.0f, 0.0f, 1.0f);
+    glm::vec3 InverseDirection = glm::vec3(FLT_MAX, FLT_MAX, 1.0f);
+};
+
+enum class EFrustumTest : uint8_t
+{
+    Outside,
+    Intersecting,
+    Inside
+};
+
+struct SFrustum
+{
+    // Gribb-Hartmann extraction from a projection (times view) matrix with a [0, 1] depth range.
+    static SFrustum FromMatrix(const glm::mat4& ViewProjection);
+
+    // Conservative, boxes near a frustum corner may be reported as intersecting although they are outside.
+    [[nodiscard]] EFrustumTest Test(const SAABB& Box) const;
+
+    [[nodiscard]] bool Intersects(const SAABB& Box) const
+    {
+        return Test(Box) != EFrustumTest::Outside;
+    }
+
+    [[nodiscard]] bool Intersects(const SBoundingSphere& Sphere) const;
+
+    // Left, right, bottom, top, near and far, as (Normal, Distance) with normalized normals pointing inwards
+    std::array<glm::vec4, 6> Planes;
+};
+
+namespace Bounds
+{
+    // Positions are read as glm::vec3 every Stride bytes, e.g. SVertex::Position.
+    SAABB ComputeAABB(const void* Positions, size_t Count, size_t Stride);
+
+    // Centered on the box, with the radius of the farthest point, which is tighter than the box's half diagonal.
+    SBoundingSphere ComputeBoundingSphere(const void* Positions, size_t Count, size_t Stride, const SAABB& Box);
+}
@@ -0,0 +1,176 @@
+#include "EnginePCH.h"
+#include "FrustumCull.h"
+
+#include "Math/SIMD.h"
+
+void SBoundsStreams::Resize(size_t Size)
+{
+    for (std::vector<float>* Stream : { &CenterX, &CenterY, &CenterZ, &ExtentX, &ExtentY, &ExtentZ, &Radius })
+    {
+        Stream->resize(Size);
+    }
+}
+
+void SBoundsStreams::Set(size_t Index, const SAABB& Box, const SBoundingSphere& Sphere)
+{
+    const glm::vec3 Center = Box.GetCenter();
+    const glm::vec3 Extent = Box.GetExtent();
+
+    CenterX[Index] = Center.x;
+    CenterY[Index] = Center.y;
+    CenterZ[Index] = Center.z;
+    ExtentX[Index] = Extent.x;
+    ExtentY[Index] = Extent.y;
+    ExtentZ[Index] = Extent.z;
+    Radius[Index] = Sphere.Radius + glm::length(Sphere.Center - Center);
+}
+
+void SBoundsStreams::RemoveSwap(size_t Index)
+{
+    for (std::vector<float>* Stream : { &CenterX, &CenterY, &CenterZ, &ExtentX, &ExtentY, &ExtentZ, &Radius })
+    {
+        (*Stream)[Index] = Stream->back();
+        Stream->pop_back();
+    }
+}
+
+namespace Utils
+{
+    // An element is outside if it is entirely behind one plane: Distance + min(BoxRadius, SphereRadius) < 0,
+    // where BoxRadius is the box's extent projected onto the plane normal.
+    static size_t CullScalar(const SFrustum& Frustum, const SBoundsStreams& Streams, size_t First, size_t Count, uint32_t* VisibleIndices)
+    {
+        size_t VisibleCount = 0;
+        for (size_t Index = First; Index < First + Count; ++Index)
+        {
+            bool bOutside = false;
+            for (const glm::vec4& Plane : Frustum.Planes)
+            {
+                const float Distance = Plane.x * Streams.CenterX[Index] + Plane.y * Streams.CenterY[Index] + Plane.z * Streams.CenterZ[Index] + Plane.w;
+                const float BoxRadius = std::abs(Plane.x) * Streams.ExtentX[Index] + std::abs(Plane.y) * Streams.ExtentY[Index] + std::abs(Plane.z) * Streams.ExtentZ[Index];
+                bOutside |= Distance + std::min(BoxRadius, Streams.Radius[Index]) < 0.0f;
+            }
+
+            // Branchless compaction, the slot is overwritten unless the element is visible.
+            VisibleIndices[VisibleCount] = static_cast<uint32_t>(Index);
+            VisibleCount += !bOutside;
+        }
+        return VisibleCount;
+    }
+
+#if RK_SIMD_X86
+    static size_t CullSSE(const SFrustum& Frustum, const SBoundsStreams& Streams, size_t First, size_t Count, uint32_t* VisibleIndices)
+    {
+        const __m128 Zero = _mm_setzero_ps();
+
+        size_t VisibleCount = 0;
+        size_t Index = 0;
+        for (; Index + 4 <= Count; Index += 4)
+        {
+            const size_t Source = First + Index;
+
+            const __m128 CX = _mm_loadu_ps(&Streams.CenterX[Source]);
+            const __m128 CY = _mm_loadu_ps(&Streams.CenterY[Source]);
+            const __m128 CZ = _mm_loadu_ps(&Streams.CenterZ[Source]);
+            const __m128 EX = _mm_loadu_ps(&Streams.ExtentX[Source]);
+            const __m128 EY = _mm_loadu_ps(&Streams.ExtentY[Source]);
+            const __m128 EZ = _mm_loadu_ps(&Streams.ExtentZ[Source]);
+            const __m128 R = _mm_loadu_ps(&Streams.Radius[Source]);
+
+            __m128 Outside = Zero;
+            for (const glm::vec4& Plane : Frustum.Planes)
+            {
+                const __m128 Distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(Plane.x), CX), _mm_mul_ps(_mm_set1_ps(Plane.y), CY)),
+                    _mm_add_ps(_mm_mul_ps(_mm_set1_ps(Plane.z), CZ), _mm_set1_ps(Plane.w)));
+                const __m128 BoxRadius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(std::abs(Plane.x)), EX), _mm_mul_ps(_mm_set1_ps(std::abs(Plane.y)), EY)),
+                    _mm_mul_ps(_mm_set1_ps(std::abs(Plane.z)), EZ));
+                Outside = _mm_or_ps(Outside, _mm_cmplt_ps(_mm_add_ps(Distance, _mm_min_ps(BoxRadius, R)), Zero));
+            }
+
+            const int VisibleMask = ~_mm_movemask_ps(Outside);
+            for (int Lane = 0; Lane < 4; ++Lane)
+            {
+                VisibleIndices[VisibleCount] = static_cast<uint32_t>(Source + Lane);
+                VisibleCount += (VisibleMask >> Lane) & 1;
+            }
+        }
+
+        return VisibleCount + CullScalar(Frustum, Streams, First + Index, Count - Index, VisibleIndices + VisibleCount);
+    }
+
+    RK_TARGET_AVX2 static size_t CullAVX2(const SFrustum& Frustum, const SBoundsStreams& Streams, size_t First, size_t Count, uint32_t* VisibleIndices)
+    {
+        const __m256 Zero = _mm256_setzero_ps();
+
+        size_t VisibleCount = 0;
+        size_t Index = 0;
+        for (; Index + 8 <= Count; Index += 8)
+        {
+            const size_t Source = First + Index;
+
+            const __m256 CX = _mm256_loadu_ps(&Streams.CenterX[Source]);
+            const __m256 CY = _mm256_loadu_ps(&Streams.CenterY[Source]);
+            const __m256 CZ = _mm256_loadu_ps(&Streams.CenterZ[Source]);
+            const __m256 EX = _mm256_loadu_ps(&Streams.ExtentX[Source]);
+            const __m256 EY = _mm256_loadu_ps(&Streams.ExtentY[Source]);
+            const __m256 EZ = _mm256_loadu_ps(&Streams.ExtentZ[Source]);
+            const __m256 R = _mm256_loadu_ps(&Streams.Radius[Source]);
+
+            __m256 Outside = Zero;
+            for (const glm::vec4& Plane : Frustum.Planes)
+            {
+                const __m256 Distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(Plane.x), CX), _mm256_mul_ps(_mm256_set1_ps(Plane.y), CY)),
+                    _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(Plane.z), CZ), _mm256_set1_ps(Plane.w)));
+                const __m256 BoxRadius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(std::abs(Plane.x)), EX), _mm256_mul_ps(_mm256_set1_ps(std::abs(Plane.y)), EY)),
+                    _mm256_mul_ps(_mm256_set1_ps(std::abs(Plane.z)), EZ));
+                Outside = _mm256_or_ps(Outside, _mm256_cmp_ps(_mm256_add_ps(Distance, _mm256_min_ps(BoxRadius, R)), Zero, _CMP_LT_OQ));
+            }
+
+            const int VisibleMask = ~_mm256_movemask_ps(Outside);
+            for (int Lane = 0; Lane < 8; ++Lane)
+            {
+                VisibleIndices[VisibleCount] = static_cast<uint32_t>(Source + Lane);
+                VisibleCount += (VisibleMask >> Lane) & 1;
+            }
+        }
+
+        // The remainder takes the 4-wide path, which is valid in an AVX2 function.
+        return VisibleCount + CullSSE(Frustum, Streams, First + Index, Count - Index, VisibleIndices + VisibleCount);
+    }
+#endif
+}
+
+EFrustumCullKernel FrustumCull::GetBestKernel()
+{
+#if RK_SIMD_X86
+    static const EFrustumCullKernel Kernel = SIMD::HasAVX2() ? EFrustumCullKernel::AVX2 : EFrustumCullKernel::SSE;
+    return Kernel;
+#else
+    return EFrustumCullKernel::Scalar;
+#endif
+}
+
+const char* FrustumCull::GetKernelName(EFrustumCullKernel Kernel)
+{
+    switch (Kernel)
+    {
+        case EFrustumCullKernel::Scalar: return "Scalar";
+        case EFrustumCullKernel::SSE: return "SSE";
+        case EFrustumCullKernel::AVX2: return "AVX2";
+        default: return "Unknown";
+    }
+}
+
+size_t FrustumCull::Cull(const SFrustum& Frustum, const SBoundsStreams& Streams, size_t First, size_t Count, uint32_t* VisibleIndices, EFrustumCullKernel Kernel)
+{
+    RK_ASSERT(First + Count <= Streams.GetSize(), "Cull range exceeds the bounds streams.");
+
+    switch (Kernel)
+    {
+#if RK_SIMD_X86
+        case EFrustumCullKernel::AVX2: return Utils::CullAVX2(Frustum, Streams, First, Count, VisibleIndices);
+        case EFrustumCullKernel::SSE: return Utils::CullSSE(Frustum, Streams, First, Count, VisibleIndices);
+#endif
+        default: return Utils::CullScalar(Frustum, Streams, First, Count, VisibleIndices);
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Math/Bounds.h"
+
+// World bounds as structure-of-arrays streams, the layout the cull kernels load from. Each element is a box and a
+// sphere around the same center, a plane is tested against whichever of the two reaches less far towards it.
+struct SBoundsStreams
+{
+    std::vector<float> CenterX;
+    std::vector<float> CenterY;
+    std::vector<float> CenterZ;
+
+    // Half size of the box along each axis
+    std::vector<float> ExtentX;
+    std::vector<float> ExtentY;
+    std::vector<float> ExtentZ;
+
+    std::vector<float> Radius;
+
+    [[nodiscard]] size_t GetSize() const
+    {
+        return CenterX.size();
+    }
+
+    void Resize(size_t Size);
+
+    // The sphere is grown to be centered on the box if its own center differs.
+    void Set(size_t Index, const SAABB& Box, const SBoundingSphere& Sphere);
+
+    // Moves the last element into Index and drops the last.
+    void RemoveSwap(size_t Index);
+};
+
+enum class EFrustumCullKernel : uint8_t
+{
+    Scalar,     // Reference implementation, one element at a time
+    SSE,        // 4 elements per iteration, baseline on x86-64
+    AVX2        // 8 elements per iteration, selected at runtime
+};
+
+namespace FrustumCull
+{
+    // Fastest kernel the CPU supports
+    EFrustumCullKernel GetBestKernel();
+
+    const char* GetKernelName(EFrustumCullKernel Kernel);
+
+    // Writes the indices of the elements in [First, First + Count) that are at least partially inside the frustum to
+    // VisibleIndices, in ascending order, and returns how many there are. VisibleIndices needs room for Count.
+    size_t Cull(const SFrustum& Frustum, const SBoundsStreams& Streams, size_t First, size_t Count, uint32_t* VisibleIndices, EFrustumCullKernel Kernel);
+
+    inline size_t Cull(const SFrustum& Frustum, const SBoundsStreams& Streams, size_t First, size_t Count, uint32_t* VisibleIndices)
+    {
+        return Cull(Frustum, Streams, First, Count, VisibleIndices, GetBestKernel());
+    }
+}
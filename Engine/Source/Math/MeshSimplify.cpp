@@ -0,0 +1,428 @@
+#include "EnginePCH.h"
+#include "MeshSimplify.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+#include "Utils/Hash.h"
+
+namespace Utils
+{
+    // Border planes outweigh the surface's own, open outlines are the most visible part of a simplified mesh.
+    static constexpr double BorderPlaneWeight = 4.0;
+
+    // Triangles turned further than about 75 degrees by a collapse count as flipped, slivers turning on their side
+    // flip in all but name.
+    static constexpr float MaxNormalRotationCosine = 0.25f;
+
+    // Symmetric 4x4 matrix of the summed plane equations, of which the upper triangle is stored.
+    struct SQuadric
+    {
+        double A00 = 0.0, A01 = 0.0, A02 = 0.0, A11 = 0.0, A12 = 0.0, A22 = 0.0;
+        double B0 = 0.0, B1 = 0.0, B2 = 0.0;
+        double C = 0.0;
+
+        // Summed weights of the planes, errors are divided by it to be a mean squared distance
+        double Weight = 0.0;
+
+        void AddPlane(const glm::vec3& Normal, float Distance, double PlaneWeight)
+        {
+            const double X = Normal.x;
+            const double Y = Normal.y;
+            const double Z = Normal.z;
+            const double D = Distance;
+
+            A00 += PlaneWeight * X * X;
+            A01 += PlaneWeight * X * Y;
+            A02 += PlaneWeight * X * Z;
+            A11 += PlaneWeight * Y * Y;
+            A12 += PlaneWeight * Y * Z;
+            A22 += PlaneWeight * Z * Z;
+            B0 += PlaneWeight * X * D;
+            B1 += PlaneWeight * Y * D;
+            B2 += PlaneWeight * Z * D;
+            C += PlaneWeight * D * D;
+            Weight += PlaneWeight;
+        }
+
+        void Add(const SQuadric& Other)
+        {
+            A00 += Other.A00;
+            A01 += Other.A01;
+            A02 += Other.A02;
+            A11 += Other.A11;
+            A12 += Other.A12;
+            A22 += Other.A22;
+            B0 += Other.B0;
+            B1 += Other.B1;
+            B2 += Other.B2;
+            C += Other.C;
+            Weight += Other.Weight;
+        }
+
+        // Mean squared distance of Position to the planes
+        [[nodiscard]] double Evaluate(const glm::vec3& Position) const
+        {
+            const double X = Position.x;
+            const double Y = Position.y;
+            const double Z = Position.z;
+
+            const double Sum = A00 * X * X + A11 * Y * Y + A22 * Z * Z + 2.0 * (A01 * X * Y + A02 * X * Z + A12 * Y * Z)
+                + 2.0 * (B0 * X + B1 * Y + B2 * Z) + C;
+            return Weight > 0.0 ? std::max(Sum, 0.0) / Weight : 0.0;
+        }
+    };
+
+    enum class EVertexKind : uint8_t
+    {
+        Manifold,   // Moves onto any neighbor
+        Border,     // Moves along its border only
+        Locked      // On a seam or where the surface is not a manifold, never moves
+    };
+
+    struct SCollapse
+    {
+        uint32_t From;
+        uint32_t To;
+        double Error;
+    };
+
+    struct SPositionHash
+    {
+        size_t operator()(const glm::vec3& Position) const
+        {
+            // Adding zero turns -0 into +0, which compare equal and must hash alike.
+            const glm::vec3 Canonical = Position + 0.0f;
+
+            uint32_t Bits[3];
+            std::memcpy(Bits, &Canonical, sizeof(Bits));
+            return FNV1aHash(Bits[0]) ^ (FNV1aHash(Bits[1]) * 31u) ^ (FNV1aHash(Bits[2]) * 961u);
+        }
+    };
+
+    static glm::vec3 GetPosition(const void* Positions, size_t Index, size_t Stride)
+    {
+        return *reinterpret_cast<const glm::vec3*>(static_cast<const uint8_t*>(Positions) + Index * Stride);
+    }
+
+    static uint64_t GetEdgeKey(uint32_t A, uint32_t B)
+    {
+        return A < B ? (static_cast<uint64_t>(A) << 32) | B : (static_cast<uint64_t>(B) << 32) | A;
+    }
+}
+
+float MeshSimplify::Simplify(const uint32_t* Indices, size_t IndexCount, const void* Positions, size_t Stride,
+    size_t TargetIndexCount, float MaxError, std::vector<uint32_t>& OutIndices)
+{
+    PROFILE_FUNC_SCOPE("MeshSimplify::Simplify")
+
+    RK_ASSERT(IndexCount % 3 == 0, "Triangle lists need three indices per triangle.");
+
+    // Vertices are renumbered in the order they are referenced, the work only scales with the part of the buffer in use.
+    std::unordered_map<uint32_t, uint32_t> LocalIndices;
+    std::vector<uint32_t> GlobalIndices;
+    std::vector<uint32_t> Triangles(IndexCount);
+    for (size_t Index = 0; Index < IndexCount; ++Index)
+    {
+        const auto [It, bInserted] = LocalIndices.try_emplace(Indices[Index], static_cast<uint32_t>(GlobalIndices.size()));
+        if (bInserted)
+        {
+            GlobalIndices.push_back(Indices[Index]);
+        }
+        Triangles[Index] = It->second;
+    }
+
+    const size_t VertexCount = GlobalIndices.size();
+    std::vector<glm::vec3> VertexPositions(VertexCount);
+    for (size_t Vertex = 0; Vertex < VertexCount; ++Vertex)
+    {
+        VertexPositions[Vertex] = Utils::GetPosition(Positions, GlobalIndices[Vertex], Stride);
+    }
+
+    // Vertices at the same position are one point of the surface, topology is judged on points.
+    std::vector<uint32_t> VertexPoints(VertexCount);
+    std::vector<uint32_t> PointVertexCounts;
+    {
+        std::unordered_map<glm::vec3, uint32_t, Utils::SPositionHash> Points;
+        for (size_t Vertex = 0; Vertex < VertexCount; ++Vertex)
+        {
+            const auto [It, bInserted] = Points.try_emplace(VertexPositions[Vertex], static_cast<uint32_t>(PointVertexCounts.size()));
+            if (bInserted)
+            {
+                PointVertexCounts.push_back(0);
+            }
+            VertexPoints[Vertex] = It->second;
+            ++PointVertexCounts[It->second];
+        }
+    }
+
+    // Triangles per edge between points, 1 on borders and more than 2 where the surface is not a manifold
+    std::unordered_map<uint64_t, uint32_t> EdgeTriangleCounts;
+    const auto CountEdges = [&]()
+    {
+        EdgeTriangleCounts.clear();
+        for (size_t Index = 0; Index < Triangles.size(); Index += 3)
+        {
+            for (size_t Corner = 0; Corner < 3; ++Corner)
+            {
+                ++EdgeTriangleCounts[Utils::GetEdgeKey(VertexPoints[Triangles[Index + Corner]], VertexPoints[Triangles[Index + (Corner + 1) % 3]])];
+            }
+        }
+    };
+
+    const auto IsBorderEdge = [&](uint32_t A, uint32_t B)
+    {
+        const auto It = EdgeTriangleCounts.find(Utils::GetEdgeKey(VertexPoints[A], VertexPoints[B]));
+        return It != EdgeTriangleCounts.end() && It->second == 1;
+    };
+
+    CountEdges();
+
+    std::vector<Utils::EVertexKind> PointKinds(PointVertexCounts.size(), Utils::EVertexKind::Manifold);
+    std::vector<uint32_t> PointBorderEdgeCounts(PointVertexCounts.size(), 0);
+    for (const auto& [Key, TriangleCount] : EdgeTriangleCounts)
+    {
+        const uint32_t PointA = static_cast<uint32_t>(Key >> 32);
+        const uint32_t PointB = static_cast<uint32_t>(Key);
+        if (TriangleCount > 2)
+        {
+            PointKinds[PointA] = Utils::EVertexKind::Locked;
+            PointKinds[PointB] = Utils::EVertexKind::Locked;
+        }
+        else if (TriangleCount == 1)
+        {
+            ++PointBorderEdgeCounts[PointA];
+            ++PointBorderEdgeCounts[PointB];
+        }
+    }
+
+    for (size_t Point = 0; Point < PointKinds.size(); ++Point)
+    {
+        // Where borders touch or end, a border vertex has no single direction left to move in.
+        if (PointVertexCounts[Point] > 1 || (PointBorderEdgeCounts[Point] != 0 && PointBorderEdgeCounts[Point] != 2))
+        {
+            PointKinds[Point] = Utils::EVertexKind::Locked;
+        }
+        else if (PointKinds[Point] == Utils::EVertexKind::Manifold && PointBorderEdgeCounts[Point] == 2)
+        {
+            PointKinds[Point] = Utils::EVertexKind::Border;
+        }
+    }
+
+    std::vector<Utils::SQuadric> Quadrics(VertexCount);
+    for (size_t Index = 0; Index < Triangles.size(); Index += 3)
+    {
+        const glm::vec3 Normal = glm::cross(VertexPositions[Triangles[Index + 1]] - VertexPositions[Triangles[Index]],
+            VertexPositions[Triangles[Index + 2]] - VertexPositions[Triangles[Index]]);
+        const float Length = glm::length(Normal);
+        if (Length <= 0.0f)
+        {
+            continue;
+        }
+
+        const glm::vec3 UnitNormal = Normal / Length;
+        const float Distance = -glm::dot(UnitNormal, VertexPositions[Triangles[Index]]);
+        for (size_t Corner = 0; Corner < 3; ++Corner)
+        {
+            Quadrics[Triangles[Index + Corner]].AddPlane(UnitNormal, Distance, Length * 0.5);
+        }
+
+        for (size_t Corner = 0; Corner < 3; ++Corner)
+        {
+            const uint32_t A = Triangles[Index + Corner];
+            const uint32_t B = Triangles[Index + (Corner + 1) % 3];
+            if (!IsBorderEdge(A, B))
+            {
+                continue;
+            }
+
+            const glm::vec3 Edge = VertexPositions[B] - VertexPositions[A];
+            const float EdgeLength = glm::length(Edge);
+            if (EdgeLength <= 0.0f)
+            {
+                continue;
+            }
+
+            // Perpendicular to the triangle through the edge, moving across the border costs, moving along it does not.
+            const glm::vec3 BorderNormal = glm::normalize(glm::cross(Edge, UnitNormal));
+            const float BorderDistance = -glm::dot(BorderNormal, VertexPositions[A]);
+            const double BorderWeight = static_cast<double>(EdgeLength) * EdgeLength * Utils::BorderPlaneWeight;
+            Quadrics[A].AddPlane(BorderNormal, BorderDistance, BorderWeight);
+            Quadrics[B].AddPlane(BorderNormal, BorderDistance, BorderWeight);
+        }
+    }
+
+    const auto CanCollapse = [&](uint32_t From, uint32_t To, bool bBorderEdge)
+    {
+        const Utils::EVertexKind Kind = PointKinds[VertexPoints[From]];
+        return Kind == Utils::EVertexKind::Manifold || (Kind == Utils::EVertexKind::Border && bBorderEdge);
+    };
+
+    const auto GetCollapseError = [&](uint32_t From, uint32_t To)
+    {
+        Utils::SQuadric Quadric = Quadrics[From];
+        Quadric.Add(Quadrics[To]);
+        return Quadric.Evaluate(VertexPositions[To]);
+    };
+
+    const size_t TargetTriangleCount = TargetIndexCount / 3;
+    const double MaxErrorSquared = static_cast<double>(MaxError) * MaxError;
+    double ResultErrorSquared = 0.0;
+
+    std::vector<Utils::SCollapse> Collapses;
+    std::vector<uint32_t> Remap(VertexCount);
+    std::vector<uint8_t> Touched(VertexCount);
+    std::vector<uint32_t> VertexTriangleOffsets(VertexCount + 1);
+    std::vector<uint32_t> VertexTriangles;
+
+    bool bFirstPass = true;
+    while (Triangles.size() / 3 > TargetTriangleCount)
+    {
+        if (!bFirstPass)
+        {
+            CountEdges();
+        }
+        bFirstPass = false;
+
+        // Every edge once, in its cheaper direction. Interior edges appear in two triangles, borders in one.
+        Collapses.clear();
+        for (size_t Index = 0; Index < Triangles.size(); Index += 3)
+        {
+            for (size_t Corner = 0; Corner < 3; ++Corner)
+            {
+                const uint32_t A = Triangles[Index + Corner];
+                const uint32_t B = Triangles[Index + (Corner + 1) % 3];
+                const bool bBorderEdge = IsBorderEdge(A, B);
+                if ((A > B && !bBorderEdge) || VertexPoints[A] == VertexPoints[B])
+                {
+                    continue;
+                }
+
+                const double ErrorAB = CanCollapse(A, B, bBorderEdge) ? GetCollapseError(A, B) : DBL_MAX;
+                const double ErrorBA = CanCollapse(B, A, bBorderEdge) ? GetCollapseError(B, A) : DBL_MAX;
+                const Utils::SCollapse Collapse = ErrorAB <= ErrorBA ? Utils::SCollapse{ A, B, ErrorAB } : Utils::SCollapse{ B, A, ErrorBA };
+                if (Collapse.Error <= MaxErrorSquared)
+                {
+                    Collapses.push_back(Collapse);
+                }
+            }
+        }
+
+        if (Collapses.empty())
+        {
+            break;
+        }
+
+        std::sort(Collapses.begin(), Collapses.end(), [](const Utils::SCollapse& A, const Utils::SCollapse& B) { return A.Error < B.Error; });
+
+        std::fill(VertexTriangleOffsets.begin(), VertexTriangleOffsets.end(), 0);
+        for (uint32_t Vertex : Triangles)
+        {
+            ++VertexTriangleOffsets[Vertex + 1];
+        }
+        std::partial_sum(VertexTriangleOffsets.begin(), VertexTriangleOffsets.end(), VertexTriangleOffsets.begin());
+
+        VertexTriangles.resize(Triangles.size());
+        std::vector<uint32_t> VertexTriangleCursors(VertexTriangleOffsets.begin(), VertexTriangleOffsets.end() - 1);
+        for (size_t Index = 0; Index < Triangles.size(); ++Index)
+        {
+            VertexTriangles[VertexTriangleCursors[Triangles[Index]]++] = static_cast<uint32_t>(Index / 3);
+        }
+
+        std::iota(Remap.begin(), Remap.end(), 0u);
+        std::fill(Touched.begin(), Touched.end(), 0);
+
+        const size_t RemovableCount = Triangles.size() / 3 - TargetTriangleCount;
+        size_t RemovedCount = 0;
+        for (const Utils::SCollapse& Collapse : Collapses)
+        {
+            if (Touched[Collapse.From] || Touched[Collapse.To])
+            {
+                continue;
+            }
+
+            // Triangles that keep their area must keep roughly facing the same way, those on the edge disappear.
+            const uint32_t ToPoint = VertexPoints[Collapse.To];
+            size_t CollapsedCount = 0;
+            bool bFlips = false;
+            for (uint32_t Slot = VertexTriangleOffsets[Collapse.From]; Slot < VertexTriangleOffsets[Collapse.From + 1] && !bFlips; ++Slot)
+            {
+                const uint32_t* Corners = &Triangles[VertexTriangles[Slot] * 3];
+                if (VertexPoints[Corners[0]] == ToPoint || VertexPoints[Corners[1]] == ToPoint || VertexPoints[Corners[2]] == ToPoint)
+                {
+                    ++CollapsedCount;
+                    continue;
+                }
+
+                glm::vec3 Moved[3];
+                for (size_t Corner = 0; Corner < 3; ++Corner)
+                {
+                    Moved[Corner] = Corners[Corner] == Collapse.From ? VertexPositions[Collapse.To] : VertexPositions[Corners[Corner]];
+                }
+
+                const glm::vec3 Before = glm::cross(VertexPositions[Corners[1]] - VertexPositions[Corners[0]], VertexPositions[Corners[2]] - VertexPositions[Corners[0]]);
+                const glm::vec3 After = glm::cross(Moved[1] - Moved[0], Moved[2] - Moved[0]);
+                bFlips = glm::dot(Before, After) <= Utils::MaxNormalRotationCosine * glm::length(Before) * glm::length(After);
+            }
+
+            if (bFlips)
+            {
+                continue;
+            }
+
+            // The one-ring is frozen for the rest of the pass, so the checks above stay valid.
+            for (uint32_t Slot = VertexTriangleOffsets[Collapse.From]; Slot < VertexTriangleOffsets[Collapse.From + 1]; ++Slot)
+            {
+                const uint32_t* Corners = &Triangles[VertexTriangles[Slot] * 3];
+                Touched[Corners[0]] = 1;
+                Touched[Corners[1]] = 1;
+                Touched[Corners[2]] = 1;
+            }
+            Touched[Collapse.To] = 1;
+
+            Remap[Collapse.From] = Collapse.To;
+            Quadrics[Collapse.To].Add(Quadrics[Collapse.From]);
+            ResultErrorSquared = std::max(ResultErrorSquared, Collapse.Error);
+
+            RemovedCount += CollapsedCount;
+            if (RemovedCount >= RemovableCount)
+            {
+                break;
+            }
+        }
+
+        if (RemovedCount == 0)
+        {
+            break;
+        }
+
+        size_t TriangleWrite = 0;
+        for (size_t Index = 0; Index < Triangles.size(); Index += 3)
+        {
+            const uint32_t A = Remap[Triangles[Index]];
+            const uint32_t B = Remap[Triangles[Index + 1]];
+            const uint32_t C = Remap[Triangles[Index + 2]];
+            if (VertexPoints[A] == VertexPoints[B] || VertexPoints[B] == VertexPoints[C] || VertexPoints[C] == VertexPoints[A])
+            {
+                continue;
+            }
+
+            Triangles[TriangleWrite++] = A;
+            Triangles[TriangleWrite++] = B;
+            Triangles[TriangleWrite++] = C;
+        }
+        Triangles.resize(TriangleWrite);
+    }
+
+    OutIndices.resize(Triangles.size());
+    for (size_t Index = 0; Index < Triangles.size(); ++Index)
+    {
+        OutIndices[Index] = GlobalIndices[Triangles[Index]];
+    }
+
+    return static_cast<float>(std::sqrt(ResultErrorSquared));
+}
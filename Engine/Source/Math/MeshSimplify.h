@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Quadric error metric simplification (Garland and Heckbert) of indexed triangle lists. Edges are collapsed onto one
+// of their vertices, never onto a new one, so the result indexes the same vertex buffer and keeps its attributes.
+// Each vertex accumulates the area weighted planes of its triangles, and the cost of a collapse is the mean squared
+// distance of the kept vertex to the planes of both. Collapses run in passes, cheapest first, where a vertex takes
+// part in at most one collapse so every pass can be checked against the mesh as it was when the pass started.
+//
+// Vertices sharing a position (attribute seams, e.g. UV or normal discontinuities) never move, so seams stay
+// intact. Vertices on open borders only move along the border, and their quadrics include planes perpendicular to
+// the border edges that keep its outline. Collapses that would flip a triangle are rejected.
+namespace MeshSimplify
+{
+    // Collapses edges of the triangle list until at most TargetIndexCount indices are left, or the next collapse
+    // would move the surface further than MaxError. Positions are Stride bytes apart, as with Bounds::ComputeAABB.
+    // Returns the geometric error of the result, the largest estimated deviation from the input, in the units of
+    // the positions.
+    float Simplify(const uint32_t* Indices, size_t IndexCount, const void* Positions, size_t Stride,
+        size_t TargetIndexCount, float MaxError, std::vector<uint32_t>& OutIndices);
+}
@@ -0,0 +1,395 @@
+#include "EnginePCH.h"
+#include "OcclusionBuffer.h"
+
+#include "Math/SIMD.h"
+
+namespace Utils
+{
+    // Pixel centers are at half-integer coordinates.
+    static void RasterizeScalar(const SOcclusionTriangle& Triangle, int32_t MinY, int32_t MaxY, float* Depth, uint32_t Width)
+    {
+        for (int32_t Y = MinY; Y <= MaxY; ++Y)
+        {
+            const float PY = static_cast<float>(Y) + 0.5f;
+            float* Row = Depth + static_cast<size_t>(Y) * Width;
+
+            // Summed in the order of the SIMD kernels, so that all of them produce the same depths unless the compiler
+            // contracts the multiply-adds into FMA.
+            const glm::vec3 RowEdges = Triangle.EdgeB * PY + Triangle.EdgeC;
+            const float RowDepth = Triangle.DepthB * PY + Triangle.DepthC;
+
+            for (int32_t X = Triangle.MinX; X <= Triangle.MaxX; ++X)
+            {
+                const float PX = static_cast<float>(X) + 0.5f;
+                const glm::vec3 Edges = Triangle.EdgeA * PX + RowEdges;
+                if (Edges.x >= 0.0f && Edges.y >= 0.0f && Edges.z >= 0.0f)
+                {
+                    const float Z = glm::clamp(Triangle.DepthA * PX + RowDepth, 0.0f, 1.0f);
+                    Row[X] = std::min(Row[X], Z);
+                }
+            }
+        }
+    }
+
+#if RK_SIMD_X86
+    // Rows are a multiple of TileSize wide, so spans aligned to the vector width never leave the row. Lanes outside
+    // the triangle's bounds are outside the triangle and masked by the edge test.
+    static void RasterizeSSE(const SOcclusionTriangle& Triangle, int32_t MinY, int32_t MaxY, float* Depth, uint32_t Width)
+    {
+        const __m128 Zero = _mm_setzero_ps();
+        const __m128 One = _mm_set1_ps(1.0f);
+        const __m128 LaneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+        const __m128 A0 = _mm_set1_ps(Triangle.EdgeA.x);
+        const __m128 A1 = _mm_set1_ps(Triangle.EdgeA.y);
+        const __m128 A2 = _mm_set1_ps(Triangle.EdgeA.z);
+        const __m128 DA = _mm_set1_ps(Triangle.DepthA);
+
+        const int32_t FirstX = Triangle.MinX & ~3;
+        for (int32_t Y = MinY; Y <= MaxY; ++Y)
+        {
+            const float PY = static_cast<float>(Y) + 0.5f;
+            float* Row = Depth + static_cast<size_t>(Y) * Width;
+
+            const __m128 Row0 = _mm_set1_ps(Triangle.EdgeB.x * PY + Triangle.EdgeC.x);
+            const __m128 Row1 = _mm_set1_ps(Triangle.EdgeB.y * PY + Triangle.EdgeC.y);
+            const __m128 Row2 = _mm_set1_ps(Triangle.EdgeB.z * PY + Triangle.EdgeC.z);
+            const __m128 RowDepth = _mm_set1_ps(Triangle.DepthB * PY + Triangle.DepthC);
+
+            for (int32_t X = FirstX; X <= Triangle.MaxX; X += 4)
+            {
+                const __m128 PX = _mm_add_ps(_mm_set1_ps(static_cast<float>(X)), LaneOffsets);
+
+                const __m128 Inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(A0, PX), Row0), Zero),
+                    _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(A1, PX), Row1), Zero)), _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(A2, PX), Row2), Zero));
+                if (_mm_movemask_ps(Inside) == 0)
+                {
+                    continue;
+                }
+
+                const __m128 Z = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(DA, PX), RowDepth), Zero), One);
+                const __m128 Old = _mm_loadu_ps(Row + X);
+
+                // SSE2 has no blend, the covered lanes are selected with masks.
+                const __m128 New = _mm_or_ps(_mm_and_ps(Inside, _mm_min_ps(Old, Z)), _mm_andnot_ps(Inside, Old));
+                _mm_storeu_ps(Row + X, New);
+            }
+        }
+    }
+
+    RK_TARGET_AVX2 static void RasterizeAVX2(const SOcclusionTriangle& Triangle, int32_t MinY, int32_t MaxY, float* Depth, uint32_t Width)
+    {
+        const __m256 Zero = _mm256_setzero_ps();
+        const __m256 One = _mm256_set1_ps(1.0f);
+        const __m256 LaneOffsets = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+
+        const __m256 A0 = _mm256_set1_ps(Triangle.EdgeA.x);
+        const __m256 A1 = _mm256_set1_ps(Triangle.EdgeA.y);
+        const __m256 A2 = _mm256_set1_ps(Triangle.EdgeA.z);
+        const __m256 DA = _mm256_set1_ps(Triangle.DepthA);
+
+        const int32_t FirstX = Triangle.MinX & ~7;
+        for (int32_t Y = MinY; Y <= MaxY; ++Y)
+        {
+            const float PY = static_cast<float>(Y) + 0.5f;
+            float* Row = Depth + static_cast<size_t>(Y) * Width;
+
+            const __m256 Row0 = _mm256_set1_ps(Triangle.EdgeB.x * PY + Triangle.EdgeC.x);
+            const __m256 Row1 = _mm256_set1_ps(Triangle.EdgeB.y * PY + Triangle.EdgeC.y);
+            const __m256 Row2 = _mm256_set1_ps(Triangle.EdgeB.z * PY + Triangle.EdgeC.z);
+            const __m256 RowDepth = _mm256_set1_ps(Triangle.DepthB * PY + Triangle.DepthC);
+
+            for (int32_t X = FirstX; X <= Triangle.MaxX; X += 8)
+            {
+                const __m256 PX = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(X)), LaneOffsets);
+
+                const __m256 Inside = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(A0, PX), Row0), Zero, _CMP_GE_OQ),
+                    _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(A1, PX), Row1), Zero, _CMP_GE_OQ)), _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(A2, PX), Row2), Zero, _CMP_GE_OQ));
+                if (_mm256_movemask_ps(Inside) == 0)
+                {
+                    continue;
+                }
+
+                const __m256 Z = _mm256_min_ps(_mm256_max_ps(_mm256_add_ps(_mm256_mul_ps(DA, PX), RowDepth), Zero), One);
+                const __m256 Old = _mm256_loadu_ps(Row + X);
+                _mm256_storeu_ps(Row + X, _mm256_blendv_ps(Old, _mm256_min_ps(Old, Z), Inside));
+            }
+        }
+    }
+#endif
+
+    // Point where the edge from A to B crosses the near plane (z = 0 in clip space for a [0, 1] depth range).
+    static glm::vec4 IntersectNearPlane(const glm::vec4& A, const glm::vec4& B)
+    {
+        return glm::mix(A, B, A.z / (A.z - B.z));
+    }
+}
+
+void POcclusionBuffer::Resize(uint32_t InWidth, uint32_t InHeight)
+{
+    Width = (InWidth + TileSize - 1) / TileSize * TileSize;
+    Height = (InHeight + TileSize - 1) / TileSize * TileSize;
+    TileCountX = Width / TileSize;
+
+    Depth.assign(static_cast<size_t>(Width) * Height, 1.0f);
+    TileMaxDepth.assign(static_cast<size_t>(TileCountX) * (Height / TileSize), 1.0f);
+    Bins.resize(Height / TileSize);
+
+    Clear();
+}
+
+void POcclusionBuffer::Clear()
+{
+    Triangles.clear();
+    for (std::vector<uint32_t>& Bin : Bins)
+    {
+        Bin.clear();
+    }
+}
+
+void POcclusionBuffer::AddOccluder(const glm::mat4& ClipMatrix, const glm::vec3* Positions, size_t PositionCount, const uint32_t* Indices, size_t IndexCount)
+{
+    RK_ASSERT(Width > 0 && Height > 0, "Occlusion buffer was not resized.");
+
+    // Every position is transformed once, however many triangles share it.
+    ClipPositions.resize(PositionCount);
+    for (size_t Index = 0; Index < PositionCount; ++Index)
+    {
+        ClipPositions[Index] = ClipMatrix * glm::vec4(Positions[Index], 1.0f);
+    }
+
+    for (size_t Index = 0; Index + 2 < IndexCount; Index += 3)
+    {
+        const glm::vec4 Vertices[3] = { ClipPositions[Indices[Index]], ClipPositions[Indices[Index + 1]], ClipPositions[Indices[Index + 2]] };
+
+        const uint32_t InsideCount = (Vertices[0].z >= 0.0f) + (Vertices[1].z >= 0.0f) + (Vertices[2].z >= 0.0f);
+        if (InsideCount == 3)
+        {
+            AddTriangle(Vertices[0], Vertices[1], Vertices[2]);
+            continue;
+        }
+        if (InsideCount == 0)
+        {
+            continue;
+        }
+
+        // Sutherland-Hodgman against the near plane, one or two vertices are cut off and at most four remain.
+        glm::vec4 Clipped[4];
+        uint32_t ClippedCount = 0;
+        for (uint32_t Corner = 0; Corner < 3; ++Corner)
+        {
+            const glm::vec4& Current = Vertices[Corner];
+            const glm::vec4& Next = Vertices[(Corner + 1) % 3];
+
+            if (Current.z >= 0.0f)
+            {
+                Clipped[ClippedCount++] = Current;
+            }
+            if ((Current.z >= 0.0f) != (Next.z >= 0.0f))
+            {
+                Clipped[ClippedCount++] = Utils::IntersectNearPlane(Current, Next);
+            }
+        }
+
+        for (uint32_t Corner = 2; Corner < ClippedCount; ++Corner)
+        {
+            AddTriangle(Clipped[0], Clipped[Corner - 1], Clipped[Corner]);
+        }
+    }
+}
+
+void POcclusionBuffer::AddTriangle(const glm::vec4& Clip0, const glm::vec4& Clip1, const glm::vec4& Clip2)
+{
+    // Vertices on the near plane of a degenerate projection have no position on screen.
+    if (Clip0.w <= 0.0f || Clip1.w <= 0.0f || Clip2.w <= 0.0f)
+    {
+        return;
+    }
+
+    const glm::vec2 Scale(static_cast<float>(Width) * 0.5f, static_cast<float>(Height) * 0.5f);
+    glm::vec3 Screen[3];
+    const glm::vec4* Clips[3] = { &Clip0, &Clip1, &Clip2 };
+    for (uint32_t Corner = 0; Corner < 3; ++Corner)
+    {
+        const glm::vec4& Clip = *Clips[Corner];
+        const glm::vec3 NDC = glm::vec3(Clip) / Clip.w;
+        Screen[Corner] = glm::vec3((glm::vec2(NDC) + 1.0f) * Scale, NDC.z);
+    }
+
+    float Area = (Screen[1].x - Screen[0].x) * (Screen[2].y - Screen[0].y) - (Screen[2].x - Screen[0].x) * (Screen[1].y - Screen[0].y);
+    if (Area == 0.0f)
+    {
+        return;
+    }
+
+    // Back faces are turned around rather than culled, occluders need not be closed or consistently wound.
+    if (Area < 0.0f)
+    {
+        std::swap(Screen[1], Screen[2]);
+        Area = -Area;
+    }
+
+    const glm::vec2 Min = glm::min(glm::min(glm::vec2(Screen[0]), glm::vec2(Screen[1])), glm::vec2(Screen[2]));
+    const glm::vec2 Max = glm::max(glm::max(glm::vec2(Screen[0]), glm::vec2(Screen[1])), glm::vec2(Screen[2]));
+
+    // Clamped before converting, clipped vertices close to the near plane can be far off screen.
+    SOcclusionTriangle Triangle;
+    Triangle.MinX = static_cast<int32_t>(std::ceil(glm::clamp(Min.x - 0.5f, 0.0f, static_cast<float>(Width))));
+    Triangle.MinY = static_cast<int32_t>(std::ceil(glm::clamp(Min.y - 0.5f, 0.0f, static_cast<float>(Height))));
+    Triangle.MaxX = static_cast<int32_t>(std::floor(glm::clamp(Max.x - 0.5f, -1.0f, static_cast<float>(Width) - 1.0f)));
+    Triangle.MaxY = static_cast<int32_t>(std::floor(glm::clamp(Max.y - 0.5f, -1.0f, static_cast<float>(Height) - 1.0f)));
+    if (Triangle.MinX > Triangle.MaxX || Triangle.MinY > Triangle.MaxY)
+    {
+        return;
+    }
+
+    // Edge I is opposite of vertex I, its function divided by the area is the vertex's barycentric weight.
+    for (uint32_t Edge = 0; Edge < 3; ++Edge)
+    {
+        const glm::vec3& A = Screen[(Edge + 1) % 3];
+        const glm::vec3& B = Screen[(Edge + 2) % 3];
+        Triangle.EdgeA[Edge] = A.y - B.y;
+        Triangle.EdgeB[Edge] = B.x - A.x;
+        Triangle.EdgeC[Edge] = A.x * B.y - A.y * B.x;
+    }
+
+    const glm::vec3 Depths = glm::vec3(Screen[0].z, Screen[1].z, Screen[2].z) / Area;
+    Triangle.DepthA = glm::dot(Triangle.EdgeA, Depths);
+    Triangle.DepthB = glm::dot(Triangle.EdgeB, Depths);
+    Triangle.DepthC = glm::dot(Triangle.EdgeC, Depths);
+
+    // Inner conservative: an edge function at the center is at least 0.5 * (|A| + |B|) above its lowest value in the
+    // pixel, so with the edges moved in by that much a pixel passes only if the triangle covers all of it. The depth
+    // is moved back alike to the farthest point of the plane in the pixel. IsOccluded can then rely on every point of
+    // a pixel being hidden, not only its center.
+    Triangle.EdgeC -= 0.5f * (glm::abs(Triangle.EdgeA) + glm::abs(Triangle.EdgeB));
+    Triangle.DepthC += 0.5f * (std::abs(Triangle.DepthA) + std::abs(Triangle.DepthB));
+
+    const uint32_t TriangleIndex = static_cast<uint32_t>(Triangles.size());
+    Triangles.push_back(Triangle);
+
+    for (int32_t Band = Triangle.MinY / static_cast<int32_t>(TileSize); Band <= Triangle.MaxY / static_cast<int32_t>(TileSize); ++Band)
+    {
+        Bins[Band].push_back(TriangleIndex);
+    }
+}
+
+void POcclusionBuffer::RasterizeBand(uint32_t Band, EOcclusionRasterKernel Kernel)
+{
+    const int32_t BandMinY = static_cast<int32_t>(Band * TileSize);
+    const int32_t BandMaxY = BandMinY + static_cast<int32_t>(TileSize) - 1;
+
+    float* BandDepth = &Depth[static_cast<size_t>(BandMinY) * Width];
+    std::fill(BandDepth, BandDepth + static_cast<size_t>(TileSize) * Width, 1.0f);
+
+    for (const uint32_t TriangleIndex : Bins[Band])
+    {
+        const SOcclusionTriangle& Triangle = Triangles[TriangleIndex];
+        const int32_t MinY = std::max(Triangle.MinY, BandMinY);
+        const int32_t MaxY = std::min(Triangle.MaxY, BandMaxY);
+
+        switch (Kernel)
+        {
+#if RK_SIMD_X86
+            case EOcclusionRasterKernel::AVX2: Utils::RasterizeAVX2(Triangle, MinY, MaxY, Depth.data(), Width); break;
+            case EOcclusionRasterKernel::SSE: Utils::RasterizeSSE(Triangle, MinY, MaxY, Depth.data(), Width); break;
+#endif
+            default: Utils::RasterizeScalar(Triangle, MinY, MaxY, Depth.data(), Width); break;
+        }
+    }
+
+    for (uint32_t TileX = 0; TileX < TileCountX; ++TileX)
+    {
+        float MaxDepth = 0.0f;
+        for (uint32_t Y = 0; Y < TileSize; ++Y)
+        {
+            const float* Row = BandDepth + static_cast<size_t>(Y) * Width + TileX * TileSize;
+            for (uint32_t X = 0; X < TileSize; ++X)
+            {
+                MaxDepth = std::max(MaxDepth, Row[X]);
+            }
+        }
+        TileMaxDepth[static_cast<size_t>(Band) * TileCountX + TileX] = MaxDepth;
+    }
+}
+
+bool POcclusionBuffer::IsOccluded(const glm::mat4& ViewProjection, const SAABB& Box) const
+{
+    glm::vec2 Min(FLT_MAX);
+    glm::vec2 Max(-FLT_MAX);
+    float MinDepth = FLT_MAX;
+
+    for (uint32_t Corner = 0; Corner < 8; ++Corner)
+    {
+        const glm::vec3 Position((Corner & 1) ? Box.Max.x : Box.Min.x, (Corner & 2) ? Box.Max.y : Box.Min.y, (Corner & 4) ? Box.Max.z : Box.Min.z);
+        const glm::vec4 Clip = ViewProjection * glm::vec4(Position, 1.0f);
+        if (Clip.w <= 0.0f || Clip.z < 0.0f)
+        {
+            return false;
+        }
+
+        const glm::vec3 NDC = glm::vec3(Clip) / Clip.w;
+        Min = glm::min(Min, glm::vec2(NDC));
+        Max = glm::max(Max, glm::vec2(NDC));
+        MinDepth = std::min(MinDepth, NDC.z);
+    }
+
+    // Every pixel the rectangle touches counts, not only those whose center it covers. The rasterizer only writes
+    // pixels an occluder covers entirely, so a box reaching past an occluder's silhouette by less than a pixel still
+    // finds that pixel at the far plane.
+    const glm::vec2 Scale(static_cast<float>(Width) * 0.5f, static_cast<float>(Height) * 0.5f);
+    const glm::vec2 Size(static_cast<float>(Width) - 1.0f, static_cast<float>(Height) - 1.0f);
+    const glm::ivec2 MinPixel = glm::ivec2(glm::clamp((Min + 1.0f) * Scale, glm::vec2(0.0f), Size));
+    const glm::ivec2 MaxPixel = glm::ivec2(glm::clamp((Max + 1.0f) * Scale, glm::vec2(0.0f), Size));
+
+    for (int32_t TileY = MinPixel.y / static_cast<int32_t>(TileSize); TileY <= MaxPixel.y / static_cast<int32_t>(TileSize); ++TileY)
+    {
+        for (int32_t TileX = MinPixel.x / static_cast<int32_t>(TileSize); TileX <= MaxPixel.x / static_cast<int32_t>(TileSize); ++TileX)
+        {
+            if (TileMaxDepth[static_cast<size_t>(TileY) * TileCountX + TileX] < MinDepth)
+            {
+                continue;
+            }
+
+            const int32_t BeginY = std::max(MinPixel.y, TileY * static_cast<int32_t>(TileSize));
+            const int32_t EndY = std::min(MaxPixel.y, (TileY + 1) * static_cast<int32_t>(TileSize) - 1);
+            const int32_t BeginX = std::max(MinPixel.x, TileX * static_cast<int32_t>(TileSize));
+            const int32_t EndX = std::min(MaxPixel.x, (TileX + 1) * static_cast<int32_t>(TileSize) - 1);
+
+            for (int32_t Y = BeginY; Y <= EndY; ++Y)
+            {
+                const float* Row = &Depth[static_cast<size_t>(Y) * Width];
+                for (int32_t X = BeginX; X <= EndX; ++X)
+                {
+                    if (Row[X] >= MinDepth)
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+EOcclusionRasterKernel OcclusionRaster::GetBestKernel()
+{
+#if RK_SIMD_X86
+    static const EOcclusionRasterKernel Kernel = SIMD::HasAVX2() ? EOcclusionRasterKernel::AVX2 : EOcclusionRasterKernel::SSE;
+    return Kernel;
+#else
+    return EOcclusionRasterKernel::Scalar;
+#endif
+}
+
+const char* OcclusionRaster::GetKernelName(EOcclusionRasterKernel Kernel)
+{
+    switch (Kernel)
+    {
+        case EOcclusionRasterKernel::Scalar: return "Scalar";
+        case EOcclusionRasterKernel::SSE: return "SSE";
+        case EOcclusionRasterKernel::AVX2: return "AVX2";
+        default: return "Unknown";
+    }
+}
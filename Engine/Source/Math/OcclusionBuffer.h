@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Math/Bounds.h"
+
+// Simplified geometry that stands in for a mesh in the occlusion buffer, usually far fewer triangles than the mesh.
+// It must not reach beyond the surface it stands in for, or objects visible past the mesh are culled.
+struct SOccluderGeometry
+{
+    std::vector<glm::vec3> Positions;
+    std::vector<uint32_t> Indices;
+
+    SAABB LocalBounds;
+};
+
+// Triangle set up for rasterization, in pixels of the occlusion buffer.
+struct SOcclusionTriangle
+{
+    // Edge functions A * X + B * Y + C, all three are non-negative at the centers of pixels fully inside
+    glm::vec3 EdgeA;
+    glm::vec3 EdgeB;
+    glm::vec3 EdgeC;
+
+    // [0, 1] depth as a plane over the screen, DepthA * X + DepthB * Y + DepthC, at pixel centers the farthest depth
+    // within the pixel
+    float DepthA;
+    float DepthB;
+    float DepthC;
+
+    // Pixels whose centers may be covered, inclusive
+    int32_t MinX;
+    int32_t MinY;
+    int32_t MaxX;
+    int32_t MaxY;
+};
+
+enum class EOcclusionRasterKernel : uint8_t
+{
+    Scalar,     // Reference implementation, one pixel at a time
+    SSE,        // 4 pixels per iteration, baseline on x86-64
+    AVX2        // 8 pixels per iteration, selected at runtime
+};
+
+// Low resolution depth buffer that occluder triangles are rasterized into on the CPU, and that the screen space
+// bounds of other objects are tested against. Rasterization is inner conservative: a pixel only takes the depth of
+// a triangle covering all of it, and the farthest depth of the triangle within the pixel, so every point of the pixel
+// is hidden behind its value. Pixels along an edge shared by two triangles are covered by neither and stay at the far
+// plane, so occluders built from few large triangles hide more.
+// The buffer is split into bands of TileSize rows, each with its own list of the triangles that reach into it, so
+// bands can be rasterized on different threads. Every TileSize x TileSize tile also keeps the farthest depth of its
+// pixels, which decides most tests without reading the pixels.
+class POcclusionBuffer
+{
+public:
+    static constexpr uint32_t TileSize = 8;
+
+    // Rounded up to multiples of TileSize.
+    void Resize(uint32_t InWidth, uint32_t InHeight);
+
+    // Drops the triangles of the previous frame.
+    void Clear();
+
+    // Projects the triangles with ClipMatrix (view projection times world), clips them against the near plane and
+    // bins them into the bands they cover. Both faces of a triangle are rasterized, so any winding works.
+    void AddOccluder(const glm::mat4& ClipMatrix, const glm::vec3* Positions, size_t PositionCount, const uint32_t* Indices, size_t IndexCount);
+
+    // Clears the band to the far plane and rasterizes the triangles binned to it. Bands share no data.
+    void RasterizeBand(uint32_t Band, EOcclusionRasterKernel Kernel);
+
+    // True if the box is behind the rasterized occluders at every pixel its projection touches. Boxes reaching in
+    // front of the near plane are never occluded. Call once every band was rasterized.
+    [[nodiscard]] bool IsOccluded(const glm::mat4& ViewProjection, const SAABB& Box) const;
+
+    [[nodiscard]] uint32_t GetWidth() const
+    {
+        return Width;
+    }
+
+    [[nodiscard]] uint32_t GetHeight() const
+    {
+        return Height;
+    }
+
+    [[nodiscard]] uint32_t GetBandCount() const
+    {
+        return static_cast<uint32_t>(Bins.size());
+    }
+
+    // Triangles added since the last Clear, after clipping
+    [[nodiscard]] size_t GetTriangleCount() const
+    {
+        return Triangles.size();
+    }
+
+    // Row-major, Width x Height
+    [[nodiscard]] const std::vector<float>& GetDepth() const
+    {
+        return Depth;
+    }
+
+private:
+    void AddTriangle(const glm::vec4& Clip0, const glm::vec4& Clip1, const glm::vec4& Clip2);
+
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    uint32_t TileCountX = 0;
+
+    std::vector<float> Depth;
+    std::vector<float> TileMaxDepth;
+
+    std::vector<SOcclusionTriangle> Triangles;
+
+    // Indices into Triangles per band
+    std::vector<std::vector<uint32_t>> Bins;
+
+    // Scratch of AddOccluder, kept to avoid allocating for every occluder
+    std::vector<glm::vec4> ClipPositions;
+};
+
+namespace OcclusionRaster
+{
+    // Fastest kernel the CPU supports
+    EOcclusionRasterKernel GetBestKernel();
+
+    const char* GetKernelName(EOcclusionRasterKernel Kernel);
+}
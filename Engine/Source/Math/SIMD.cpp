@@ -0,0 +1,38 @@
+#include "EnginePCH.h"
+#include "SIMD.h"
+
+namespace Utils
+{
+    static bool QueryAVX2()
+    {
+    #if !RK_SIMD_X86
+        return false;
+    #elif defined(_MSC_VER)
+        // CPUID.07H:EBX[5], and the OS has to save the YMM registers (XCR0 bits 1 and 2)
+        int Registers[4] = {};
+        __cpuid(Registers, 0);
+        if (Registers[0] < 7)
+        {
+            return false;
+        }
+
+        __cpuid(Registers, 1);
+        const bool bOSXSave = (Registers[2] & (1 << 27)) != 0;
+        if (!bOSXSave || (_xgetbv(0) & 0x6) != 0x6)
+        {
+            return false;
+        }
+
+        __cpuidex(Registers, 7, 0);
+        return (Registers[1] & (1 << 5)) != 0;
+    #else
+        return __builtin_cpu_supports("avx2");
+    #endif
+    }
+}
+
+bool SIMD::HasAVX2()
+{
+    static const bool bHasAVX2 = Utils::QueryAVX2();
+    return bHasAVX2;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+// Intrinsics shared by the batch kernels. Only x86-64 has SIMD kernels, its baseline SSE2 needs no check while
+// AVX2 functions are compiled per function with RK_TARGET_AVX2 and only called if SIMD::HasAVX2().
+#if defined(__x86_64__) || defined(_M_X64)
+    #define RK_SIMD_X86 1
+
+    #ifdef _MSC_VER
+        #include <intrin.h>
+        #define RK_TARGET_AVX2
+    #else
+        #include <immintrin.h>
+        #define RK_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#else
+    #define RK_SIMD_X86 0
+#endif
+
+namespace SIMD
+{
+    // Whether the CPU and the OS support AVX2, checked once.
+    bool HasAVX2();
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+namespace Math
+{
+    /* https://en.wikipedia.org/wiki/Centripetal_Catmull%E2%80%93Rom_spline (uniform parameterization) */
+    template<typename TBase>
+    static TBase CatmullRom(const TBase& P0, const TBase& P1, const TBase& P2, const TBase& P3, float Alpha)
+    {
+        const float Alpha2 = Alpha * Alpha;
+        const float Alpha3 = Alpha2 * Alpha;
+
+        return 0.5f * ((2.0f * P1) + (-P0 + P2) * Alpha + (2.0f * P0 - 5.0f * P1 + 4.0f * P2 - P3) * Alpha2 + (-P0 + 3.0f * P1 - 3.0f * P2 + P3) * Alpha3);
+    }
+}
+
+// Timed control point of a spline, keys are expected to be sorted by time.
+template<typename TValue>
+struct TSplineKey
+{
+    float Time;
+    TValue Value;
+};
+
+// Catmull-Rom spline through timed keys, passes through every key and clamps outside of the key range.
+template<typename TValue>
+class TSpline
+{
+public:
+    void AddKey(float Time, const TValue& Value)
+    {
+        Keys.push_back({ Time, Value });
+    }
+
+    [[nodiscard]] bool IsEmpty() const
+    {
+        return Keys.empty();
+    }
+
+    // Time of the first key, where the spline starts and a looped evaluation restarts
+    [[nodiscard]] float GetStartTime() const
+    {
+        return Keys.empty() ? 0.0f : Keys.front().Time;
+    }
+
+    [[nodiscard]] float GetDuration() const
+    {
+        return Keys.empty() ? 0.0f : Keys.back().Time - Keys.front().Time;
+    }
+
+    [[nodiscard]] TValue Evaluate(float Time) const
+    {
+        if (Keys.size() == 1 || Time <= Keys.front().Time)
+        {
+            return Keys.front().Value;
+        }
+
+        if (Time >= Keys.back().Time)
+        {
+            return Keys.back().Value;
+        }
+
+        // First key after the requested time, the segment is [Index - 1, Index]
+        auto Iterator = std::upper_bound(Keys.begin(), Keys.end(), Time, [](float Value, const TSplineKey<TValue>& Key) { return Value < Key.Time; });
+        const size_t Index = static_cast<size_t>(std::distance(Keys.begin(), Iterator));
+
+        const TSplineKey<TValue>& Key1 = Keys[Index - 1];
+        const TSplineKey<TValue>& Key2 = Keys[Index];
+        const TSplineKey<TValue>& Key0 = Keys[Index >= 2 ? Index - 2 : Index - 1];
+        const TSplineKey<TValue>& Key3 = Keys[std::min(Index + 1, Keys.size() - 1)];
+
+        const float Alpha = (Time - Key1.Time) / std::max(Key2.Time - Key1.Time, 1e-6f);
+        return Math::CatmullRom(Key0.Value, Key1.Value, Key2.Value, Key3.Value, Alpha);
+    }
+
+private:
+    std::vector<TSplineKey<TValue>> Keys;
+};
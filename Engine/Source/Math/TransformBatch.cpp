@@ -0,0 +1,254 @@
+#include "EnginePCH.h"
+#include "TransformBatch.h"
+
+#include "Math/SIMD.h"
+
+void STransformStreams::Resize(size_t Size)
+{
+    for (std::vector<float>* Stream : { &TranslationX, &TranslationY, &TranslationZ, &RotationX, &RotationY, &RotationZ, &RotationW, &ScaleX, &ScaleY, &ScaleZ })
+    {
+        Stream->resize(Size);
+    }
+}
+
+void STransformStreams::Set(size_t Index, const STransform& Transform)
+{
+    const glm::quat Rotation = glm::quat(Transform.Rotation);
+
+    TranslationX[Index] = Transform.Translation.x;
+    TranslationY[Index] = Transform.Translation.y;
+    TranslationZ[Index] = Transform.Translation.z;
+    RotationX[Index] = Rotation.x;
+    RotationY[Index] = Rotation.y;
+    RotationZ[Index] = Rotation.z;
+    RotationW[Index] = Rotation.w;
+    ScaleX[Index] = Transform.Scale.x;
+    ScaleY[Index] = Transform.Scale.y;
+    ScaleZ[Index] = Transform.Scale.z;
+}
+
+namespace Utils
+{
+    static void ComputeMatricesScalar(const STransformStreams& Streams, size_t First, size_t Count, STransformMatrices* Output)
+    {
+        for (size_t Index = 0; Index < Count; ++Index)
+        {
+            const size_t Source = First + Index;
+
+            const float X = Streams.RotationX[Source];
+            const float Y = Streams.RotationY[Source];
+            const float Z = Streams.RotationZ[Source];
+            const float W = Streams.RotationW[Source];
+
+            // Same expansion as glm::toMat3
+            const glm::mat3 Rotation(
+                1.0f - 2.0f * (Y * Y + Z * Z), 2.0f * (X * Y + W * Z), 2.0f * (X * Z - W * Y),
+                2.0f * (X * Y - W * Z), 1.0f - 2.0f * (X * X + Z * Z), 2.0f * (Y * Z + W * X),
+                2.0f * (X * Z + W * Y), 2.0f * (Y * Z - W * X), 1.0f - 2.0f * (X * X + Y * Y));
+
+            const glm::vec3 Scale(Streams.ScaleX[Source], Streams.ScaleY[Source], Streams.ScaleZ[Source]);
+
+            STransformMatrices& Matrices = Output[Index];
+            Matrices.ModelMatrix = glm::mat4(glm::vec4(Rotation[0] * Scale.x, 0.0f), glm::vec4(Rotation[1] * Scale.y, 0.0f), glm::vec4(Rotation[2] * Scale.z, 0.0f),
+                glm::vec4(Streams.TranslationX[Source], Streams.TranslationY[Source], Streams.TranslationZ[Source], 1.0f));
+            Matrices.NormalMatrix = glm::mat4(glm::vec4(Rotation[0] / Scale.x, 0.0f), glm::vec4(Rotation[1] / Scale.y, 0.0f), glm::vec4(Rotation[2] / Scale.z, 0.0f),
+                glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+        }
+    }
+
+#if RK_TRANSFORM_BATCH_SIMD
+    // Rows hold one matrix element per transform. Transposed, they become one column of each of the 4 matrices.
+    static void StoreColumnSSE(STransformMatrices* Output, glm::mat4 STransformMatrices::* Matrix, int Column, __m128 A, __m128 B, __m128 C, __m128 D)
+    {
+        _MM_TRANSPOSE4_PS(A, B, C, D);
+        _mm_storeu_ps(&(Output[0].*Matrix)[Column][0], A);
+        _mm_storeu_ps(&(Output[1].*Matrix)[Column][0], B);
+        _mm_storeu_ps(&(Output[2].*Matrix)[Column][0], C);
+        _mm_storeu_ps(&(Output[3].*Matrix)[Column][0], D);
+    }
+
+    static void ComputeMatricesSSE(const STransformStreams& Streams, size_t First, size_t Count, STransformMatrices* Output)
+    {
+        const __m128 Zero = _mm_setzero_ps();
+        const __m128 One = _mm_set1_ps(1.0f);
+        const __m128 Two = _mm_set1_ps(2.0f);
+
+        size_t Index = 0;
+        for (; Index + 4 <= Count; Index += 4)
+        {
+            const size_t Source = First + Index;
+
+            const __m128 X = _mm_loadu_ps(&Streams.RotationX[Source]);
+            const __m128 Y = _mm_loadu_ps(&Streams.RotationY[Source]);
+            const __m128 Z = _mm_loadu_ps(&Streams.RotationZ[Source]);
+            const __m128 W = _mm_loadu_ps(&Streams.RotationW[Source]);
+
+            const __m128 X2 = _mm_mul_ps(X, Two);
+            const __m128 Y2 = _mm_mul_ps(Y, Two);
+            const __m128 Z2 = _mm_mul_ps(Z, Two);
+
+            const __m128 XX = _mm_mul_ps(X, X2);
+            const __m128 YY = _mm_mul_ps(Y, Y2);
+            const __m128 ZZ = _mm_mul_ps(Z, Z2);
+            const __m128 XY = _mm_mul_ps(X, Y2);
+            const __m128 XZ = _mm_mul_ps(X, Z2);
+            const __m128 YZ = _mm_mul_ps(Y, Z2);
+            const __m128 WX = _mm_mul_ps(W, X2);
+            const __m128 WY = _mm_mul_ps(W, Y2);
+            const __m128 WZ = _mm_mul_ps(W, Z2);
+
+            // Rotation matrix, RowColumn
+            const __m128 R00 = _mm_sub_ps(One, _mm_add_ps(YY, ZZ));
+            const __m128 R10 = _mm_add_ps(XY, WZ);
+            const __m128 R20 = _mm_sub_ps(XZ, WY);
+            const __m128 R01 = _mm_sub_ps(XY, WZ);
+            const __m128 R11 = _mm_sub_ps(One, _mm_add_ps(XX, ZZ));
+            const __m128 R21 = _mm_add_ps(YZ, WX);
+            const __m128 R02 = _mm_add_ps(XZ, WY);
+            const __m128 R12 = _mm_sub_ps(YZ, WX);
+            const __m128 R22 = _mm_sub_ps(One, _mm_add_ps(XX, YY));
+
+            const __m128 SX = _mm_loadu_ps(&Streams.ScaleX[Source]);
+            const __m128 SY = _mm_loadu_ps(&Streams.ScaleY[Source]);
+            const __m128 SZ = _mm_loadu_ps(&Streams.ScaleZ[Source]);
+            const __m128 InverseSX = _mm_div_ps(One, SX);
+            const __m128 InverseSY = _mm_div_ps(One, SY);
+            const __m128 InverseSZ = _mm_div_ps(One, SZ);
+
+            STransformMatrices* Destination = Output + Index;
+            StoreColumnSSE(Destination, &STransformMatrices::ModelMatrix, 0, _mm_mul_ps(R00, SX), _mm_mul_ps(R10, SX), _mm_mul_ps(R20, SX), Zero);
+            StoreColumnSSE(Destination, &STransformMatrices::ModelMatrix, 1, _mm_mul_ps(R01, SY), _mm_mul_ps(R11, SY), _mm_mul_ps(R21, SY), Zero);
+            StoreColumnSSE(Destination, &STransformMatrices::ModelMatrix, 2, _mm_mul_ps(R02, SZ), _mm_mul_ps(R12, SZ), _mm_mul_ps(R22, SZ), Zero);
+            StoreColumnSSE(Destination, &STransformMatrices::ModelMatrix, 3, _mm_loadu_ps(&Streams.TranslationX[Source]), _mm_loadu_ps(&Streams.TranslationY[Source]), _mm_loadu_ps(&Streams.TranslationZ[Source]), One);
+
+            StoreColumnSSE(Destination, &STransformMatrices::NormalMatrix, 0, _mm_mul_ps(R00, InverseSX), _mm_mul_ps(R10, InverseSX), _mm_mul_ps(R20, InverseSX), Zero);
+            StoreColumnSSE(Destination, &STransformMatrices::NormalMatrix, 1, _mm_mul_ps(R01, InverseSY), _mm_mul_ps(R11, InverseSY), _mm_mul_ps(R21, InverseSY), Zero);
+            StoreColumnSSE(Destination, &STransformMatrices::NormalMatrix, 2, _mm_mul_ps(R02, InverseSZ), _mm_mul_ps(R12, InverseSZ), _mm_mul_ps(R22, InverseSZ), Zero);
+            StoreColumnSSE(Destination, &STransformMatrices::NormalMatrix, 3, Zero, Zero, Zero, One);
+        }
+
+        ComputeMatricesScalar(Streams, First + Index, Count - Index, Output + Index);
+    }
+
+    // As StoreColumnSSE, the 128-bit halves are transposed independently and hold transforms 0-3 and 4-7.
+    RK_TARGET_AVX2 static void StoreColumnAVX2(STransformMatrices* Output, glm::mat4 STransformMatrices::* Matrix, int Column, __m256 A, __m256 B, __m256 C, __m256 D)
+    {
+        const __m256 AB0 = _mm256_unpacklo_ps(A, B);
+        const __m256 AB1 = _mm256_unpackhi_ps(A, B);
+        const __m256 CD0 = _mm256_unpacklo_ps(C, D);
+        const __m256 CD1 = _mm256_unpackhi_ps(C, D);
+
+        const __m256 Lane0 = _mm256_shuffle_ps(AB0, CD0, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m256 Lane1 = _mm256_shuffle_ps(AB0, CD0, _MM_SHUFFLE(3, 2, 3, 2));
+        const __m256 Lane2 = _mm256_shuffle_ps(AB1, CD1, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m256 Lane3 = _mm256_shuffle_ps(AB1, CD1, _MM_SHUFFLE(3, 2, 3, 2));
+
+        _mm_storeu_ps(&(Output[0].*Matrix)[Column][0], _mm256_castps256_ps128(Lane0));
+        _mm_storeu_ps(&(Output[1].*Matrix)[Column][0], _mm256_castps256_ps128(Lane1));
+        _mm_storeu_ps(&(Output[2].*Matrix)[Column][0], _mm256_castps256_ps128(Lane2));
+        _mm_storeu_ps(&(Output[3].*Matrix)[Column][0], _mm256_castps256_ps128(Lane3));
+        _mm_storeu_ps(&(Output[4].*Matrix)[Column][0], _mm256_extractf128_ps(Lane0, 1));
+        _mm_storeu_ps(&(Output[5].*Matrix)[Column][0], _mm256_extractf128_ps(Lane1, 1));
+        _mm_storeu_ps(&(Output[6].*Matrix)[Column][0], _mm256_extractf128_ps(Lane2, 1));
+        _mm_storeu_ps(&(Output[7].*Matrix)[Column][0], _mm256_extractf128_ps(Lane3, 1));
+    }
+
+    RK_TARGET_AVX2 static void ComputeMatricesAVX2(const STransformStreams& Streams, size_t First, size_t Count, STransformMatrices* Output)
+    {
+        const __m256 Zero = _mm256_setzero_ps();
+        const __m256 One = _mm256_set1_ps(1.0f);
+        const __m256 Two = _mm256_set1_ps(2.0f);
+
+        size_t Index = 0;
+        for (; Index + 8 <= Count; Index += 8)
+        {
+            const size_t Source = First + Index;
+
+            const __m256 X = _mm256_loadu_ps(&Streams.RotationX[Source]);
+            const __m256 Y = _mm256_loadu_ps(&Streams.RotationY[Source]);
+            const __m256 Z = _mm256_loadu_ps(&Streams.RotationZ[Source]);
+            const __m256 W = _mm256_loadu_ps(&Streams.RotationW[Source]);
+
+            const __m256 X2 = _mm256_mul_ps(X, Two);
+            const __m256 Y2 = _mm256_mul_ps(Y, Two);
+            const __m256 Z2 = _mm256_mul_ps(Z, Two);
+
+            const __m256 XX = _mm256_mul_ps(X, X2);
+            const __m256 YY = _mm256_mul_ps(Y, Y2);
+            const __m256 ZZ = _mm256_mul_ps(Z, Z2);
+            const __m256 XY = _mm256_mul_ps(X, Y2);
+            const __m256 XZ = _mm256_mul_ps(X, Z2);
+            const __m256 YZ = _mm256_mul_ps(Y, Z2);
+            const __m256 WX = _mm256_mul_ps(W, X2);
+            const __m256 WY = _mm256_mul_ps(W, Y2);
+            const __m256 WZ = _mm256_mul_ps(W, Z2);
+
+            const __m256 R00 = _mm256_sub_ps(One, _mm256_add_ps(YY, ZZ));
+            const __m256 R10 = _mm256_add_ps(XY, WZ);
+            const __m256 R20 = _mm256_sub_ps(XZ, WY);
+            const __m256 R01 = _mm256_sub_ps(XY, WZ);
+            const __m256 R11 = _mm256_sub_ps(One, _mm256_add_ps(XX, ZZ));
+            const __m256 R21 = _mm256_add_ps(YZ, WX);
+            const __m256 R02 = _mm256_add_ps(XZ, WY);
+            const __m256 R12 = _mm256_sub_ps(YZ, WX);
+            const __m256 R22 = _mm256_sub_ps(One, _mm256_add_ps(XX, YY));
+
+            const __m256 SX = _mm256_loadu_ps(&Streams.ScaleX[Source]);
+            const __m256 SY = _mm256_loadu_ps(&Streams.ScaleY[Source]);
+            const __m256 SZ = _mm256_loadu_ps(&Streams.ScaleZ[Source]);
+            const __m256 InverseSX = _mm256_div_ps(One, SX);
+            const __m256 InverseSY = _mm256_div_ps(One, SY);
+            const __m256 InverseSZ = _mm256_div_ps(One, SZ);
+
+            STransformMatrices* Destination = Output + Index;
+            StoreColumnAVX2(Destination, &STransformMatrices::ModelMatrix, 0, _mm256_mul_ps(R00, SX), _mm256_mul_ps(R10, SX), _mm256_mul_ps(R20, SX), Zero);
+            StoreColumnAVX2(Destination, &STransformMatrices::ModelMatrix, 1, _mm256_mul_ps(R01, SY), _mm256_mul_ps(R11, SY), _mm256_mul_ps(R21, SY), Zero);
+            StoreColumnAVX2(Destination, &STransformMatrices::ModelMatrix, 2, _mm256_mul_ps(R02, SZ), _mm256_mul_ps(R12, SZ), _mm256_mul_ps(R22, SZ), Zero);
+            StoreColumnAVX2(Destination, &STransformMatrices::ModelMatrix, 3, _mm256_loadu_ps(&Streams.TranslationX[Source]), _mm256_loadu_ps(&Streams.TranslationY[Source]), _mm256_loadu_ps(&Streams.TranslationZ[Source]), One);
+
+            StoreColumnAVX2(Destination, &STransformMatrices::NormalMatrix, 0, _mm256_mul_ps(R00, InverseSX), _mm256_mul_ps(R10, InverseSX), _mm256_mul_ps(R20, InverseSX), Zero);
+            StoreColumnAVX2(Destination, &STransformMatrices::NormalMatrix, 1, _mm256_mul_ps(R01, InverseSY), _mm256_mul_ps(R11, InverseSY), _mm256_mul_ps(R21, InverseSY), Zero);
+            StoreColumnAVX2(Destination, &STransformMatrices::NormalMatrix, 2, _mm256_mul_ps(R02, InverseSZ), _mm256_mul_ps(R12, InverseSZ), _mm256_mul_ps(R22, InverseSZ), Zero);
+            StoreColumnAVX2(Destination, &STransformMatrices::NormalMatrix, 3, Zero, Zero, Zero, One);
+        }
+
+        // The remainder takes the 4-wide path, which is valid in an AVX2 function.
+        ComputeMatricesSSE(Streams, First + Index, Count - Index, Output + Index);
+    }
+#endif
+}
+
+ETransformBatchKernel TransformBatch::GetBestKernel()
+{
+#if RK_TRANSFORM_BATCH_SIMD
+    static const ETransformBatchKernel Kernel = SIMD::HasAVX2() ? ETransformBatchKernel::AVX2 : ETransformBatchKernel::SSE;
+    return Kernel;
+#else
+    return ETransformBatchKernel::Scalar;
+#endif
+}
+
+const char* TransformBatch::GetKernelName(ETransformBatchKernel Kernel)
+{
+    switch (Kernel)
+    {
+        case ETransformBatchKernel::Scalar: return "Scalar";
+        case ETransformBatchKernel::SSE: return "SSE";
+        case ETransformBatchKernel::AVX2: return "AVX2";
+        default: return "Unknown";
+    }
+}
+
+void TransformBatch::ComputeMatrices(const STransformStreams& Streams, size_t First, size_t Count, STransformMatrices* Output, ETransformBatchKernel Kernel)
+{
+    RK_ASSERT(First + Count <= Streams.GetSize(), "Transform range exceeds the streams.");
+
+    switch (Kernel)
+    {
+#if RK_TRANSFORM_BATCH_SIMD
+        case ETransformBatchKernel::AVX2: Utils::ComputeMatricesAVX2(Streams, First, Count, Output); break;
+        case ETransformBatchKernel::SSE: Utils::ComputeMatricesSSE(Streams, First, Count, Output); break;
+#endif
+        default: Utils::ComputeMatricesScalar(Streams, First, Count, Output); break;
+    }
+}
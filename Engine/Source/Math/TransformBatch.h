@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Math/Transform.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define RK_TRANSFORM_BATCH_SIMD 1
+#else
+    #define RK_TRANSFORM_BATCH_SIMD 0
+#endif
+
+// Transforms as structure-of-arrays streams, the layout the batch kernels load from. Rotations are unit quaternions.
+struct STransformStreams
+{
+    std::vector<float> TranslationX;
+    std::vector<float> TranslationY;
+    std::vector<float> TranslationZ;
+
+    std::vector<float> RotationX;
+    std::vector<float> RotationY;
+    std::vector<float> RotationZ;
+    std::vector<float> RotationW;
+
+    std::vector<float> ScaleX;
+    std::vector<float> ScaleY;
+    std::vector<float> ScaleZ;
+
+    [[nodiscard]] size_t GetSize() const
+    {
+        return TranslationX.size();
+    }
+
+    void Resize(size_t Size);
+
+    // Converts the Euler rotation into a quaternion.
+    void Set(size_t Index, const STransform& Transform);
+};
+
+// Laid out like SShaderStorageBufferObject, so results can be written straight into a mapped storage buffer.
+struct STransformMatrices
+{
+    alignas(16) glm::mat4 ModelMatrix;
+
+    // Inverse transpose of the model matrix's upper 3x3, padded with identity
+    alignas(16) glm::mat4 NormalMatrix;
+};
+
+enum class ETransformBatchKernel : uint8_t
+{
+    Scalar,     // Reference implementation, one transform at a time
+    SSE,        // 4 transforms per iteration, baseline on x86-64
+    AVX2        // 8 transforms per iteration, selected at runtime
+};
+
+// Converts translation, rotation and scale into model matrices and their normal matrices. Scale is on the diagonal,
+// so the normal matrix is the rotation with its columns divided by the scale and no general inverse is needed.
+namespace TransformBatch
+{
+    // Fastest kernel the CPU supports
+    ETransformBatchKernel GetBestKernel();
+
+    const char* GetKernelName(ETransformBatchKernel Kernel);
+
+    // Converts Count transforms starting at First into Output[0, Count). Kernel must be supported by the CPU.
+    void ComputeMatrices(const STransformStreams& Streams, size_t First, size_t Count, STransformMatrices* Output, ETransformBatchKernel Kernel);
+
+    inline void ComputeMatrices(const STransformStreams& Streams, size_t First, size_t Count, STransformMatrices* Output)
+    {
+        ComputeMatrices(Streams, First, Count, Output, GetBestKernel());
+    }
+}
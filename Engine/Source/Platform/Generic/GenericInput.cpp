@@ -13,6 +13,11 @@ PInput* PInput::GInput = new PGenericInput();
 bool PGenericInput::GetKeyPressedImpl(int32_t KeyCode)
 {
     auto Window = static_cast<GLFWwindow*>(GetWindow()->GetNativeWindow());
+    if (!Window)
+    {
+        return false;
+    }
+
     auto State = glfwGetKey(Window, KeyCode);
 
     return State == GLFW_PRESS || State == GLFW_REPEAT;
@@ -21,6 +26,11 @@ bool PGenericInput::GetKeyPressedImpl(int32_t KeyCode)
 bool PGenericInput::GetMouseButtonPressedImpl(int32_t KeyCode)
 {
     auto Window = static_cast<GLFWwindow*>(GetWindow()->GetNativeWindow());
+    if (!Window)
+    {
+        return false;
+    }
+
     auto State = glfwGetMouseButton(Window, KeyCode);
 
     return State == GLFW_PRESS;
@@ -41,6 +51,11 @@ float PGenericInput::GetMouseYImpl()
 std::pair<float, float> PGenericInput::GetMousePositionImpl()
 {
     auto Window = static_cast<GLFWwindow*>(GetWindow()->GetNativeWindow());
+    if (!Window)
+    {
+        return { 0.0f, 0.0f };
+    }
+
     double MouseX, MouseY;
     glfwGetCursorPos(Window, &MouseX, &MouseY);
     return { (float)MouseX, (float)MouseY };
@@ -19,12 +19,38 @@ void PGenericWindow::CreateNativeWindow()
 
     glfwMakeContextCurrent((GLFWwindow*)NativeWindow);
 
+    // The focus callback only fires on changes, so seed the initial state for the frame pacer.
+    bIsFocused = glfwGetWindowAttrib((GLFWwindow*)NativeWindow, GLFW_FOCUSED);
+
 	glfwSetKeyCallback((GLFWwindow*)NativeWindow, [](GLFWwindow* Window, int32_t KeyCode, int32_t ScanCode, int32_t Action, int32_t Mod)
 	{
 		if (KeyCode == RK_KEY_ESCAPE)
 		{
 			glfwSetWindowShouldClose(Window, true);
 		}
+
+		GetEngine()->FramePacer.RequestRedraw();
+	});
+
+	// Any input may change the overlay or the camera, which on-demand rendering has to pick up.
+	glfwSetCursorPosCallback((GLFWwindow*)NativeWindow, [](GLFWwindow* Window, double PositionX, double PositionY)
+	{
+		GetEngine()->FramePacer.RequestRedraw();
+	});
+
+	glfwSetMouseButtonCallback((GLFWwindow*)NativeWindow, [](GLFWwindow* Window, int32_t Button, int32_t Action, int32_t Mods)
+	{
+		GetEngine()->FramePacer.RequestRedraw();
+	});
+
+	glfwSetScrollCallback((GLFWwindow*)NativeWindow, [](GLFWwindow* Window, double OffsetX, double OffsetY)
+	{
+		GetEngine()->FramePacer.RequestRedraw();
+	});
+
+	glfwSetCharCallback((GLFWwindow*)NativeWindow, [](GLFWwindow* Window, uint32_t Codepoint)
+	{
+		GetEngine()->FramePacer.RequestRedraw();
 	});
 
 	glfwSetFramebufferSizeCallback((GLFWwindow*)NativeWindow, [](GLFWwindow* GlfwWindow, int Width, int Height)
@@ -44,14 +70,15 @@ void PGenericWindow::CreateNativeWindow()
 		Window->GetWindowSpecification().Width = Width;
 		Window->GetWindowSpecification().Height = Height;
 
-		while (GetWindow()->IsMinimized())
+		// The frame pacer stops rendering while minimized, the swapchain is recreated once the window is restored.
+		if (Window->IsMinimized())
 		{
-			// Rough handling of window minimization.
-			glfwWaitEvents();
+			return;
 		}
 
 		GetScene()->GetCamera()->ApplySettings();
 		GetRHI()->Resize();
+		GetEngine()->FramePacer.RequestRedraw();
 	});
 
 	glfwSetWindowFocusCallback((GLFWwindow*)NativeWindow, [](GLFWwindow* Window, int32_t Focused)
@@ -68,6 +95,8 @@ void PGenericWindow::CreateNativeWindow()
 
 			GetWindow()->SetIsFocused(false);
 		}
+
+		GetEngine()->FramePacer.RequestRedraw();
 	});
 
 	glfwSetWindowPosCallback((GLFWwindow*)NativeWindow, [](GLFWwindow* Window, int32_t PositionX, int32_t PositionY)
@@ -93,6 +122,11 @@ bool PGenericWindow::ShouldClose() const
     return glfwWindowShouldClose((GLFWwindow*)NativeWindow);
 }
 
+void PGenericWindow::SetShouldClose(bool bClose)
+{
+	glfwSetWindowShouldClose((GLFWwindow*)NativeWindow, bClose);
+}
+
 bool PGenericWindow::IsMinimized() const
 {
     return bIsMinimized;
@@ -14,6 +14,7 @@ public:
 	virtual void DestroyNativeWindow() override;
 	virtual void Poll() override;
 	virtual bool ShouldClose() const override;
+	virtual void SetShouldClose(bool bClose) override;
 	virtual bool IsMinimized() const override;
 	virtual bool IsFocused() const override;
 	virtual void SetIsMinimized(bool bMinimized) override;
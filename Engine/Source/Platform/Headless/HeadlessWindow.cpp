@@ -0,0 +1,78 @@
+#include "EnginePCH.h"
+#include "HeadlessWindow.h"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+
+namespace Headless
+{
+	// Set from the signal handler, hence lock-free and outside of the window instance.
+	static std::atomic<bool> bInterrupted = false;
+
+	static void OnInterrupt(int32_t Signal)
+	{
+		bInterrupted = true;
+	}
+}
+
+void PHeadlessWindow::CreateNativeWindow()
+{
+	// Let Ctrl+C and job schedulers stop the run gracefully, so profiler data and reports are still written.
+	std::signal(SIGINT, Headless::OnInterrupt);
+	std::signal(SIGTERM, Headless::OnInterrupt);
+
+	RK_LOG_INFO("Running headless at {}x{}", WindowSpecification.Width, WindowSpecification.Height);
+}
+
+void PHeadlessWindow::DestroyNativeWindow()
+{
+	std::signal(SIGINT, SIG_DFL);
+	std::signal(SIGTERM, SIG_DFL);
+}
+
+void PHeadlessWindow::Poll()
+{
+	// No events to process, --frames is counted by the engine from rendered frames.
+}
+
+bool PHeadlessWindow::ShouldClose() const
+{
+	return bShouldClose || Headless::bInterrupted;
+}
+
+void PHeadlessWindow::SetShouldClose(bool bClose)
+{
+	bShouldClose = bClose;
+}
+
+bool PHeadlessWindow::IsMinimized() const
+{
+	return bIsMinimized;
+}
+
+bool PHeadlessWindow::IsFocused() const
+{
+	return bIsFocused;
+}
+
+bool PHeadlessWindow::IsHeadless() const
+{
+	return true;
+}
+
+void PHeadlessWindow::SetIsMinimized(bool bMinimized)
+{
+	bIsMinimized = bMinimized;
+}
+
+void PHeadlessWindow::SetIsFocused(bool bFocused)
+{
+	bIsFocused = bFocused;
+}
+
+void PHeadlessWindow::WaitEventOrTimeout(float TimeoutSeconds)
+{
+	// No event source, waiting degenerates to sleeping.
+	std::this_thread::sleep_for(std::chrono::duration<float>(TimeoutSeconds));
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Core/Window.h"
+
+// Window without a native surface. Used on display-less hosts, the renderer draws into offscreen images instead of a swapchain.
+class PHeadlessWindow : public IWindow
+{
+public:
+	PHeadlessWindow(const SWindowSpecification& InWindowSpecification)
+		: IWindow(InWindowSpecification)
+	{
+		bIsFocused = true;
+	}
+
+	virtual void CreateNativeWindow() override;
+	virtual void DestroyNativeWindow() override;
+	virtual void Poll() override;
+	virtual bool ShouldClose() const override;
+	virtual void SetShouldClose(bool bClose) override;
+	virtual bool IsMinimized() const override;
+	virtual bool IsFocused() const override;
+	virtual bool IsHeadless() const override;
+	virtual void SetIsMinimized(bool bMinimized) override;
+	virtual void SetIsFocused(bool bFocused) override;
+	virtual void WaitEventOrTimeout(float TimeoutSeconds) override;
+
+private:
+	bool bShouldClose = false;
+};
@@ -2,6 +2,7 @@
 
 #include <glm/glm.hpp>
 
+#include "Math/Bounds.h"
 #include "Renderer/Common/Material.h"
 
 struct STransform;
@@ -26,10 +27,63 @@ struct SVertex
     alignas(16) glm::vec3 Bitangent;
 };
 
+// Coarser version of a mesh over the same vertices, generated at import (see SMeshLODSettings).
+struct SMeshLOD
+{
+    std::vector<uint32_t> Indices;
+
+    // Largest estimated distance between the level's surface and the full mesh's, in object space
+    float Error = 0.0f;
+};
+
 struct SMeshBinaryData
 {
     std::vector<SVertex> Vertices;
     std::vector<uint32_t> Indices;
+
+    // Object space bounds of the vertices, filled by ComputeBounds once the positions are final (e.g. at import).
+    SAABB LocalBounds;
+    SBoundingSphere LocalBoundingSphere;
+
+    // Authored as an occluder, e.g. a building's simplified hull, see POcclusionCuller::CreateGeometry.
+    bool bOccluder = false;
+
+    // Finest first, with increasing Error
+    std::vector<SMeshLOD> LODs;
+
+    void ComputeBounds()
+    {
+        if (Vertices.empty())
+        {
+            LocalBounds = SAABB();
+            LocalBoundingSphere = SBoundingSphere();
+            return;
+        }
+
+        LocalBounds = Bounds::ComputeAABB(&Vertices[0].Position, Vertices.size(), sizeof(SVertex));
+        LocalBoundingSphere = Bounds::ComputeBoundingSphere(&Vertices[0].Position, Vertices.size(), sizeof(SVertex), LocalBounds);
+    }
+
+    // The level as a mesh of its own, with only the vertices its indices reference.
+    [[nodiscard]] SMeshBinaryData ExtractLOD(size_t Level) const
+    {
+        SMeshBinaryData LODData;
+        std::vector<uint32_t> Remap(Vertices.size(), UINT32_MAX);
+        LODData.Indices.reserve(LODs[Level].Indices.size());
+
+        for (uint32_t Index : LODs[Level].Indices)
+        {
+            if (Remap[Index] == UINT32_MAX)
+            {
+                Remap[Index] = static_cast<uint32_t>(LODData.Vertices.size());
+                LODData.Vertices.push_back(Vertices[Index]);
+            }
+            LODData.Indices.push_back(Remap[Index]);
+        }
+
+        LODData.ComputeBounds();
+        return LODData;
+    }
 };
 
 struct SMeshSettings
@@ -55,7 +109,11 @@ public:
     virtual void Destroy() = 0;
 
     virtual void UpdateDynamicMesh(const SMeshBinaryData& MeshData) = 0;
-    
+
+    // Bounds of the vertices the mesh was created or last updated with
+    virtual const SAABB& GetLocalBounds() const = 0;
+    virtual const SBoundingSphere& GetLocalBoundingSphere() const = 0;
+
     virtual IMaterial* GetMaterial() const = 0;
     virtual void SetMaterial(IMaterial* NewMaterial) = 0;
 
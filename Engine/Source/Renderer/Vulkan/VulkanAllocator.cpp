@@ -23,4 +23,31 @@ void PVulkanAllocator::Shutdown()
 VmaAllocator PVulkanAllocator::GetMemoryAllocator() const
 {
     return MemoryAllocator;
+}
+
+SVulkanMemoryUsage PVulkanAllocator::GetMemoryUsage() const
+{
+    const VkPhysicalDeviceMemoryProperties* MemoryProperties = nullptr;
+    vmaGetMemoryProperties(MemoryAllocator, &MemoryProperties);
+
+    VmaBudget Budgets[VK_MAX_MEMORY_HEAPS];
+    vmaGetHeapBudgets(MemoryAllocator, Budgets);
+
+    SVulkanMemoryUsage Usage;
+    for (uint32_t HeapIndex = 0; HeapIndex < MemoryProperties->memoryHeapCount; ++HeapIndex)
+    {
+        if (MemoryProperties->memoryHeaps[HeapIndex].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+        {
+            Usage.DeviceLocal += Budgets[HeapIndex].usage;
+            Usage.DeviceLocalBudget += Budgets[HeapIndex].budget;
+        }
+        else
+        {
+            Usage.HostVisible += Budgets[HeapIndex].usage;
+            Usage.HostVisibleBudget += Budgets[HeapIndex].budget;
+        }
+
+        Usage.Allocated += Budgets[HeapIndex].statistics.allocationBytes;
+    }
+    return Usage;
 }
\ No newline at end of file
@@ -1,5 +1,19 @@
 #pragma once
 
+#include <cstdint>
+
+// Bytes in use across all memory heaps, as reported by the allocator's budget
+struct SVulkanMemoryUsage
+{
+    uint64_t DeviceLocal = 0;
+    uint64_t HostVisible = 0;
+    uint64_t Allocated = 0;
+
+    // What the driver reports as available to the process, usage past it risks eviction or failed allocations
+    uint64_t DeviceLocalBudget = 0;
+    uint64_t HostVisibleBudget = 0;
+};
+
 class PVulkanAllocator
 {
 public:
@@ -8,6 +22,8 @@ public:
 
     VmaAllocator GetMemoryAllocator() const;
 
+    SVulkanMemoryUsage GetMemoryUsage() const;
+
 private:
     VmaAllocator MemoryAllocator;
 };
\ No newline at end of file
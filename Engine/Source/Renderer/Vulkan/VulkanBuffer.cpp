@@ -3,6 +3,7 @@
 
 #include "Renderer/Vulkan/VulkanSceneRenderer.h"
 #include "Renderer/Vulkan/VulkanAllocator.h"
+#include "Utils/Stats.h"
 
 void PVulkanBuffer::Allocate(size_t Size)
 {
@@ -33,4 +34,39 @@ void PVulkanBuffer::Submit(const void* Data, size_t Size, size_t Offset)
     vmaMapMemory(GetRHI()->GetSceneRenderer()->GetAllocator()->GetMemoryAllocator(), Allocation, &MappedData);
     memcpy(static_cast<uint8_t*>(MappedData) + Offset, Data, Size);
     vmaUnmapMemory(GetRHI()->GetSceneRenderer()->GetAllocator()->GetMemoryAllocator(), Allocation);
-}
\ No newline at end of file
+
+    PStats::Add(UsageFlags & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT ? EStat::StorageBufferBytes : EStat::UniformBufferBytes, Size);
+}
+
+void PVulkanRetiredBuffers::Retire(PVulkanBuffer* Buffer, uint32_t FrameCount)
+{
+    Buffers.push_back({ Buffer, FrameCount });
+}
+
+void PVulkanRetiredBuffers::Update()
+{
+    for (size_t Index = 0; Index < Buffers.size();)
+    {
+        if (--Buffers[Index].FramesLeft == 0)
+        {
+            Buffers[Index].Buffer->Free();
+            delete Buffers[Index].Buffer;
+            Buffers[Index] = Buffers.back();
+            Buffers.pop_back();
+        }
+        else
+        {
+            ++Index;
+        }
+    }
+}
+
+void PVulkanRetiredBuffers::Destroy()
+{
+    for (SRetiredBuffer& RetiredBuffer : Buffers)
+    {
+        RetiredBuffer.Buffer->Free();
+        delete RetiredBuffer.Buffer;
+    }
+    Buffers.clear();
+}
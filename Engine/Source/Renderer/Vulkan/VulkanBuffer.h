@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "Renderer/Common/Buffer.h"
 
 struct VkBuffer_T;
@@ -31,3 +33,29 @@ public:
     VkBufferUsageFlags UsageFlags;
     VmaMemoryUsage MemoryUsageFlags;
 };
+
+// Buffers replaced while frames in flight may still read them. Each is freed once that many frames have started
+// again, which waited on the fences of every frame that could use it.
+class PVulkanRetiredBuffers
+{
+public:
+    // Takes ownership, Buffer is freed after FrameCount calls of Update.
+    void Retire(PVulkanBuffer* Buffer, uint32_t FrameCount);
+
+    // Once per frame, after waiting on the frame's fence.
+    void Update();
+
+    // Frees every buffer right away, when no frame is in flight anymore.
+    void Destroy();
+
+private:
+    struct SRetiredBuffer
+    {
+        PVulkanBuffer* Buffer;
+
+        // Updates until no frame in flight can still read the buffer
+        uint32_t FramesLeft;
+    };
+
+    std::vector<SRetiredBuffer> Buffers;
+};
@@ -3,6 +3,8 @@
 
 #include "Renderer/Vulkan/VulkanBuffer.h"
 #include "Renderer/Vulkan/VulkanDevice.h"
+#include "Renderer/Vulkan/VulkanGPUCuller.h"
+#include "Renderer/Vulkan/VulkanSceneBuffer.h"
 #include "Renderer/Vulkan/VulkanSceneRenderer.h"
 #include "Renderer/Vulkan/VulkanFrame.h"
 #include "Renderer/Vulkan/VulkanMemory.h"
@@ -63,13 +65,23 @@ void PVulkanDescriptorSetLayout::CreateDescriptorSetLayout(const std::vector<SDe
 				DescriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
 				break;
 			}
+			case EDescriptorSetBindingType::SampledImage:
+			{
+				DescriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+				break;
+			}
+			case EDescriptorSetBindingType::StorageImage:
+			{
+				DescriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+				break;
+			}
 		}
 
 		VkDescriptorSetLayoutBinding DescriptorSetLayoutBinding = {};
 		DescriptorSetLayoutBinding.binding = Binding.Binding;
 		DescriptorSetLayoutBinding.descriptorType = DescriptorType;
 		DescriptorSetLayoutBinding.descriptorCount = 1;
-		DescriptorSetLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+		DescriptorSetLayoutBinding.stageFlags = Binding.Flag == EDescriptorSetBindingFlag::Compute ? VK_SHADER_STAGE_COMPUTE_BIT : VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
 
 		DescriptorSetLayoutBindings.push_back(DescriptorSetLayoutBinding);
 	}
@@ -125,6 +137,30 @@ void PVulkanDescriptorSet::CreateDescriptorSet(PVulkanDescriptorSetLayout* Descr
 		{
 			case EDescriptorSetBindingType::Storage: 
 			{
+				// The per-object data of every material lives in the shared instance buffer.
+				if (BindingLayout.Name == "SSBO")
+				{
+					SDescriptorSetBinding Binding;
+					Binding.Layout = &BindingLayout;
+					Binding.Data = nullptr;
+					Bindings.push_back(Binding);
+
+					GetRHI()->GetSceneRenderer()->GetSceneBuffer()->AddInstanceBinding(Frame, DescriptorSet, BindingLayout.Binding);
+					break;
+				}
+
+				// The slots of the instances that survived GPU culling, written by PVulkanGPUCuller.
+				if (BindingLayout.Name == "VisibleInstances")
+				{
+					SDescriptorSetBinding Binding;
+					Binding.Layout = &BindingLayout;
+					Binding.Data = nullptr;
+					Bindings.push_back(Binding);
+
+					GetRHI()->GetSceneRenderer()->GetGPUCuller()->AddVisibleInstanceBinding(Frame, DescriptorSet, BindingLayout.Binding);
+					break;
+				}
+
 				PVulkanBuffer* Buffer = new PVulkanBuffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
 				Buffer->Allocate(1024 * 1024);
 				
@@ -177,6 +213,16 @@ void PVulkanDescriptorSet::CreateDescriptorSet(PVulkanDescriptorSetLayout* Descr
 				vkUpdateDescriptorSets(GetRHI()->GetDevice()->GetVkDevice(), 1, &WriteDescriptorSet, 0, nullptr);
 				break;
 			}
+			case EDescriptorSetBindingType::SampledImage:
+			case EDescriptorSetBindingType::StorageImage:
+			{
+				// Images are written by whoever owns them, materials do not bind any yet.
+				SDescriptorSetBinding Binding;
+				Binding.Layout = &BindingLayout;
+				Binding.Data = nullptr;
+				Bindings.push_back(Binding);
+				break;
+			}
 		}
 	}
 }
@@ -190,8 +236,15 @@ void PVulkanDescriptorSet::DestroyDescriptorSet()
 			case EDescriptorSetBindingType::Uniform:
 			case EDescriptorSetBindingType::Storage:
 			{
-				PVulkanBuffer* Buffer = static_cast<PVulkanBuffer*>(Binding.Data);
-				Buffer->Free();
+				if (PVulkanBuffer* Buffer = static_cast<PVulkanBuffer*>(Binding.Data))
+				{
+					Buffer->Free();
+				}
+				break;
+			}
+			case EDescriptorSetBindingType::SampledImage:
+			case EDescriptorSetBindingType::StorageImage:
+			{
 				break;
 			}
 		}
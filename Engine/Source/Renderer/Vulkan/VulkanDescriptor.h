@@ -44,12 +44,12 @@ private:
 
 enum class EDescriptorSetBindingType : uint8_t
 {
-    Storage, Uniform
+    Storage, Uniform, SampledImage, StorageImage
 };
 
 enum class EDescriptorSetBindingFlag : uint8_t
 {
-    Vertex, Fragment
+    Vertex, Fragment, Compute
 };
 
 struct SDescriptorSetBindingMemberLayout
@@ -74,6 +74,8 @@ struct SDescriptorSetBindingLayout
 struct SDescriptorSetBinding
 {
     SDescriptorSetBindingLayout* Layout;
+
+    // Buffer owned by the descriptor set, nullptr for the scene's instance buffers and for images, which their owners write
     void* Data;
 };
 
@@ -11,6 +11,8 @@ void PVulkanDevice::Init()
 	std::vector<VkPhysicalDevice> PhysicalDevices(DeviceCount);
 	vkEnumeratePhysicalDevices(GetRHI()->GetInstance()->GetVkInstance(), &DeviceCount, PhysicalDevices.data());
 
+	const bool bHeadless = GetWindow()->IsHeadless();
+
 	for (VkPhysicalDevice PhysicalDevice : PhysicalDevices)
 	{
 		uint32_t QueueFamilyCount = 0;
@@ -23,11 +25,20 @@ void PVulkanDevice::Init()
 		{
 			const VkQueueFamilyProperties& FamilyProperty = QueueFamilies[Index];
 			VkBool32 PresentSupport = false;
-			vkGetPhysicalDeviceSurfaceSupportKHR(PhysicalDevice, Index, GetRHI()->GetInstance()->GetVkSurfaceKHR(), &PresentSupport);
+			if (!bHeadless)
+			{
+				vkGetPhysicalDeviceSurfaceSupportKHR(PhysicalDevice, Index, GetRHI()->GetInstance()->GetVkSurfaceKHR(), &PresentSupport);
+			}
 			
 			if (FamilyProperty.queueFlags & VK_QUEUE_GRAPHICS_BIT)
 			{
 				GraphicsFamily = Index;
+
+				// Without a surface the graphics queue doubles as the "present" queue.
+				if (bHeadless)
+				{
+					PresentSupport = true;
+				}
 			}
 
 			if (PresentSupport)
@@ -55,7 +66,18 @@ void PVulkanDevice::Init()
 			});
 		});
 
-		if (bExtensionSupport)
+		if (bExtensionSupport && bHeadless && GraphicsFamily.has_value())
+		{
+			VkPhysicalDeviceProperties PhysicalDeviceProperties;
+			vkGetPhysicalDeviceProperties(PhysicalDevice, &PhysicalDeviceProperties);
+
+			PLogger::Log(ELogCategory::LOG_INFO, "Using Physical Device (headless): {}", PhysicalDeviceProperties.deviceName);
+
+			GPU = PhysicalDevice;
+			break;
+		}
+
+		if (bExtensionSupport && !bHeadless)
 		{
 			uint32_t FormatCount;
 			uint32_t PresentModeCount;
@@ -118,9 +140,15 @@ void PVulkanDevice::Init()
 	// Chain the features together
 	Features_1_3.pNext = &Features_1_2;
 
+	VkPhysicalDeviceFeatures SupportedFeatures{};
+	vkGetPhysicalDeviceFeatures(GPU, &SupportedFeatures);
+	bPipelineStatisticsQuery = SupportedFeatures.pipelineStatisticsQuery == VK_TRUE;
+
 	VkPhysicalDeviceFeatures DeviceFeatures{};
 	DeviceFeatures.shaderInt64 = VK_TRUE;
 	DeviceFeatures.samplerAnisotropy = VK_TRUE;
+	DeviceFeatures.drawIndirectFirstInstance = VK_TRUE; // PVulkanGPUCuller offsets each mesh's instances with firstInstance
+	DeviceFeatures.pipelineStatisticsQuery = SupportedFeatures.pipelineStatisticsQuery;
 
 	VkDeviceCreateInfo DeviceCreateInfo{};
 	DeviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -198,3 +226,8 @@ VkPhysicalDeviceProperties PVulkanDevice::GetPhysicalDeviceProperties() const
 	vkGetPhysicalDeviceProperties(GPU, &PhysicalDeviceProperties);
 	return PhysicalDeviceProperties;
 }
+
+bool PVulkanDevice::IsPipelineStatisticsQuerySupported() const
+{
+	return bPipelineStatisticsQuery;
+}
@@ -44,6 +44,9 @@ public:
     VkSurfaceCapabilitiesKHR GetSurfaceCapabilities() const;
     VkPhysicalDeviceProperties GetPhysicalDeviceProperties() const;
 
+    // Enabled whenever the physical device supports it, used by the optional GPU pipeline statistics.
+    bool IsPipelineStatisticsQuerySupported() const;
+
 private:
     VkDevice Device;
     VkPhysicalDevice GPU;
@@ -56,4 +59,6 @@ private:
 
     std::vector<VkSurfaceFormatKHR> SurfaceFormats;
     std::vector<VkPresentModeKHR> PresentModes;
+
+    bool bPipelineStatisticsQuery = false;
 };
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include "Renderer/Vulkan/VulkanSwapchain.h"
 #include "Renderer/Vulkan/VulkanSceneRenderer.h"
 #include "Renderer/Vulkan/VulkanMemory.h"
+#include "Renderer/Vulkan/VulkanQuery.h"
 
 void PVulkanFrame::CreateFrame()
 {
@@ -19,6 +20,11 @@ void PVulkanFrame::CreateFrame()
 	Memory = new PVulkanMemory();
 	Memory->Init();
 
+	TimestampQueryPool = new PVulkanTimestampQueryPool();
+	TimestampQueryPool->Init();
+
+	TransientFrameData = {};
+
 	VkFenceCreateInfo FenceCreateInfo{};
 	FenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
 	FenceCreateInfo.pNext = nullptr;
@@ -49,6 +55,9 @@ void PVulkanFrame::DestroyFrame()
 
 	Memory->Shutdown();
 	delete Memory;
+
+	TimestampQueryPool->Shutdown();
+	delete TimestampQueryPool;
 }
 
 void PVulkanFrame::BeginFrame()
@@ -56,10 +65,12 @@ void PVulkanFrame::BeginFrame()
 	PROFILE_FUNC_SCOPE("PVulkanFrame::BeginFrame")
 
 	vkWaitForFences(GetRHI()->GetDevice()->GetVkDevice(), 1, &RenderFence, VK_TRUE, UINT64_MAX);
-	vkAcquireNextImageKHR(GetRHI()->GetDevice()->GetVkDevice(), GetRHI()->GetSceneRenderer()->GetSwapchain()->GetVkSwapchain(), UINT64_MAX, SwapchainSemaphore, nullptr, &TransientFrameData.NextImageIndex);
+	TimestampQueryPool->Resolve();
+	TransientFrameData.bWaitSwapchainSemaphore = GetRHI()->GetSceneRenderer()->GetSwapchain()->AcquireNextImage(SwapchainSemaphore, TransientFrameData.NextImageIndex);
 	vkResetFences(GetRHI()->GetDevice()->GetVkDevice(), 1, &RenderFence);
 	CommandBuffer->ResetCommandBuffer();
 	CommandBuffer->BeginCommandBuffer();
+	TimestampQueryPool->Reset(CommandBuffer);
 }
 
 void PVulkanFrame::EndFrame()
@@ -82,29 +93,27 @@ void PVulkanFrame::EndFrame()
 	SignalSemaphoreSubmitInfo.semaphore = RenderSemaphore;
 	SignalSemaphoreSubmitInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT;
 
+	PVulkanSwapchain* Swapchain = GetRHI()->GetSceneRenderer()->GetSwapchain();
+
+	// Offscreen images are never presented, frames are paced by the render fence alone.
 	VkSubmitInfo2 SubmitInfo = {};
 	SubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
-	SubmitInfo.waitSemaphoreInfoCount = 1;
+	SubmitInfo.waitSemaphoreInfoCount = TransientFrameData.bWaitSwapchainSemaphore ? 1 : 0;
 	SubmitInfo.pWaitSemaphoreInfos = &WaitSemaphoreSubmitInfo;
-	SubmitInfo.signalSemaphoreInfoCount = 1;
+	SubmitInfo.signalSemaphoreInfoCount = Swapchain->IsPresentable() ? 1 : 0;
 	SubmitInfo.pSignalSemaphoreInfos = &SignalSemaphoreSubmitInfo;
 	SubmitInfo.commandBufferInfoCount = 1;
 	SubmitInfo.pCommandBufferInfos = &CommandBufferSubmitInfo;
 
+	TimestampQueryPool->SetSubmitTimestamp(PProfiler::GetTimestamp());
+
 	VkResult Result = vkQueueSubmit2(GetRHI()->GetDevice()->GetGraphicsQueue(), 1, &SubmitInfo, RenderFence);
 	RK_ASSERT(Result == VK_SUCCESS, "Failed to submit command buffer to graphics queue.");
 
-	VkSwapchainKHR SwapchainPointer = GetRHI()->GetSceneRenderer()->GetSwapchain()->GetVkSwapchain();
-	VkPresentInfoKHR presentInfo = {};
-	presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-	presentInfo.pNext = nullptr;
-	presentInfo.pSwapchains = &SwapchainPointer;
-	presentInfo.swapchainCount = 1;
-	presentInfo.pWaitSemaphores = &RenderSemaphore;
-	presentInfo.waitSemaphoreCount = 1;
-	presentInfo.pImageIndices = &TransientFrameData.NextImageIndex;
-
-	vkQueuePresentKHR(GetRHI()->GetDevice()->GetGraphicsQueue(), &presentInfo);
+	if (Swapchain->IsPresentable())
+	{
+		Swapchain->Present(RenderSemaphore, TransientFrameData.NextImageIndex);
+	}
 }
 
 PVulkanCommandPool* PVulkanFrame::GetCommandPool() const
@@ -122,6 +131,11 @@ PVulkanMemory* PVulkanFrame::GetMemory() const
 	return Memory;
 }
 
+PVulkanTimestampQueryPool* PVulkanFrame::GetTimestampQueryPool() const
+{
+	return TimestampQueryPool;
+}
+
 VkSemaphore PVulkanFrame::GetSwapchainSemaphore() const
 {
 	return SwapchainSemaphore;
@@ -167,6 +181,11 @@ PVulkanFrame* PVulkanFramePool::GetCurrentFrame() const
 	return Pool[FrameIndex % PoolSize];
 }
 
+PVulkanFrame* PVulkanFramePool::GetPreviousFrame() const
+{
+	return Pool[(FrameIndex + PoolSize - 1) % PoolSize];
+}
+
 size_t PVulkanFramePool::GetCurrentFrameIndex() const
 {
 	return FrameIndex % PoolSize;
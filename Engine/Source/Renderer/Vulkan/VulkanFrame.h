@@ -8,10 +8,14 @@ class PVulkanCommandPool;
 class PVulkanRHI;
 class PVulkanCommandBuffer;
 class PVulkanMemory;
+class PVulkanTimestampQueryPool;
 
 struct FTransientFrameData
 {
 	uint32_t NextImageIndex;
+
+	// False when the image was acquired without signaling the swapchain semaphore (headless)
+	bool bWaitSwapchainSemaphore;
 };
 
 class PVulkanFrame
@@ -26,6 +30,7 @@ public:
 	PVulkanCommandPool* GetCommandPool() const;
 	PVulkanCommandBuffer* GetCommandBuffer() const;
 	PVulkanMemory* GetMemory() const;
+	PVulkanTimestampQueryPool* GetTimestampQueryPool() const;
 
 	VkSemaphore GetSwapchainSemaphore() const;
 	VkSemaphore GetRenderSemaphore() const;
@@ -40,6 +45,7 @@ private:
 	VkSemaphore RenderSemaphore;
 	VkFence RenderFence;
 	PVulkanMemory* Memory;
+	PVulkanTimestampQueryPool* TimestampQueryPool;
 	FTransientFrameData TransientFrameData;
 };
 
@@ -56,6 +62,9 @@ public:
 	void FreeFramePool();
 	
 	PVulkanFrame* GetCurrentFrame() const;
+
+	// Most recently submitted frame, its transient data stays valid until it begins again.
+	PVulkanFrame* GetPreviousFrame() const;
 	size_t GetCurrentFrameIndex() const;
 
     std::vector<PVulkanFrame*>::iterator begin() { return Pool.begin(); }
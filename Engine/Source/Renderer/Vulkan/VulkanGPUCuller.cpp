@@ -0,0 +1,552 @@
+#include "EnginePCH.h"
+#include "VulkanGPUCuller.h"
+
+#include <bit>
+
+#include "Core/CommandLine.h"
+#include "Format/HLSL.h"
+#include "Renderer/Vulkan/VulkanAllocator.h"
+#include "Renderer/Vulkan/VulkanBuffer.h"
+#include "Renderer/Vulkan/VulkanCommand.h"
+#include "Renderer/Vulkan/VulkanDescriptor.h"
+#include "Renderer/Vulkan/VulkanDevice.h"
+#include "Renderer/Vulkan/VulkanFrame.h"
+#include "Renderer/Vulkan/VulkanImage.h"
+#include "Renderer/Vulkan/VulkanMemory.h"
+#include "Renderer/Vulkan/VulkanMesh.h"
+#include "Renderer/Vulkan/VulkanPipeline.h"
+#include "Renderer/Vulkan/VulkanSceneBuffer.h"
+#include "Renderer/Vulkan/VulkanSceneRenderer.h"
+#include "Renderer/Vulkan/VulkanShader.h"
+#include "Renderer/Vulkan/VulkanUtils.h"
+#include "Utils/Stats.h"
+
+namespace Utils
+{
+	static constexpr uint32_t InitialInstanceCapacity = 16384;
+	static constexpr uint32_t InitialMeshCapacity = 256;
+
+	// Enough for depth images of up to 32768 texels on a side
+	static constexpr uint32_t MaxPyramidLevels = 16;
+
+	// Match numthreads in GPUCull.hlsl and DepthPyramid.hlsl
+	static constexpr uint32_t CullGroupSize = 64;
+	static constexpr uint32_t PyramidGroupSize = 8;
+
+	// Match the passes in GPUCull.hlsl
+	static constexpr uint32_t PassReset = 0;
+	static constexpr uint32_t PassEarly = 1;
+	static constexpr uint32_t PassLate = 2;
+
+	// Laid out like SCullMesh in GPUCull.hlsl
+	struct SGPUCullMesh
+	{
+		glm::vec3 Center;
+		uint32_t IndexCount;
+		glm::vec3 Extent;
+		uint32_t InstanceBase;
+		uint32_t InstanceCount;
+		uint32_t Padding[3];
+	};
+
+	// Laid out like PushConstant in GPUCull.hlsl
+	struct SCullPushConstant
+	{
+		glm::mat4 ViewProjection;
+		uint32_t PyramidSize[2];
+		uint32_t PyramidLevels;
+		uint32_t SlotCount;
+		uint32_t MeshCount;
+		uint32_t Pass;
+		uint32_t bOcclusion;
+		uint32_t LateInstanceBase;
+	};
+
+	// Laid out like PushConstant in DepthPyramid.hlsl
+	struct SPyramidPushConstant
+	{
+		uint32_t SourceSize[2];
+		uint32_t DestinationSize[2];
+	};
+
+	static void WriteImageDescriptor(VkDescriptorSet DescriptorSet, uint32_t Binding, VkDescriptorType DescriptorType, VkImageView ImageView, VkImageLayout ImageLayout)
+	{
+		VkDescriptorImageInfo DescriptorImageInfo{};
+		DescriptorImageInfo.sampler = VK_NULL_HANDLE;
+		DescriptorImageInfo.imageView = ImageView;
+		DescriptorImageInfo.imageLayout = ImageLayout;
+
+		VkWriteDescriptorSet WriteDescriptorSet{};
+		WriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		WriteDescriptorSet.dstSet = DescriptorSet;
+		WriteDescriptorSet.dstBinding = Binding;
+		WriteDescriptorSet.dstArrayElement = 0;
+		WriteDescriptorSet.descriptorType = DescriptorType;
+		WriteDescriptorSet.descriptorCount = 1;
+		WriteDescriptorSet.pImageInfo = &DescriptorImageInfo;
+
+		vkUpdateDescriptorSets(GetRHI()->GetDevice()->GetVkDevice(), 1, &WriteDescriptorSet, 0, nullptr);
+	}
+
+	static VkDescriptorSet AllocateDescriptorSet(PVulkanFrame* Frame, PVulkanShader* Shader)
+	{
+		VkDescriptorSetLayout DescriptorSetLayout = Shader->GetShaderModules()[0].DescriptorSetLayouts[0]->GetVkDescriptorSetLayout();
+
+		VkDescriptorSetAllocateInfo DescriptorSetAllocateInfo = {};
+		DescriptorSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		DescriptorSetAllocateInfo.pNext = nullptr;
+		DescriptorSetAllocateInfo.descriptorPool = Frame->GetMemory()->GetDescriptorPool()->GetVkDescriptorPool();
+		DescriptorSetAllocateInfo.descriptorSetCount = 1;
+		DescriptorSetAllocateInfo.pSetLayouts = &DescriptorSetLayout;
+
+		VkDescriptorSet DescriptorSet;
+		VkResult Result = vkAllocateDescriptorSets(GetRHI()->GetDevice()->GetVkDevice(), &DescriptorSetAllocateInfo, &DescriptorSet);
+		RK_ASSERT(Result == VK_SUCCESS, "Failed to allocate descriptor set.");
+
+		return DescriptorSet;
+	}
+
+	static PVulkanBuffer* CreateBuffer(uint32_t Count, size_t ElementSize, VkBufferUsageFlags Usage, VmaMemoryUsage MemoryUsage)
+	{
+		PVulkanBuffer* Buffer = new PVulkanBuffer(Usage, MemoryUsage);
+		Buffer->Allocate(static_cast<size_t>(Count) * ElementSize);
+		return Buffer;
+	}
+
+	static void DestroyBuffer(PVulkanBuffer*& Buffer)
+	{
+		if (Buffer)
+		{
+			Buffer->Free();
+			delete Buffer;
+			Buffer = nullptr;
+		}
+	}
+}
+
+void PVulkanGPUCuller::Init()
+{
+	bEnabled = PCommandLine::HasOption("--gpu-culling");
+
+	// Materials bind the list whether or not the GPU culls, their draws only read it when it does.
+	VisibleInstanceBuffer = Utils::CreateBuffer(Utils::InitialInstanceCapacity, sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+	VisibleInstanceCapacity = Utils::InitialInstanceCapacity;
+
+	if (!bEnabled)
+	{
+		return;
+	}
+
+	const FHLSL CullComputeShader = Format::ImportHLSL(RK_ENGINE_DIR "/Shaders/HLSL/GPUCull.hlsl", "main", "cs_6_0");
+	CullShader = new PVulkanShader();
+	CullShader->CreateShader({ { CullComputeShader.Data, CullComputeShader.Size } });
+	CullPipeline = new PVulkanComputePipeline();
+	CullPipeline->CreatePipeline(CullShader, sizeof(Utils::SCullPushConstant));
+
+	const FHLSL PyramidComputeShader = Format::ImportHLSL(RK_ENGINE_DIR "/Shaders/HLSL/DepthPyramid.hlsl", "main", "cs_6_0");
+	PyramidShader = new PVulkanShader();
+	PyramidShader->CreateShader({ { PyramidComputeShader.Data, PyramidComputeShader.Size } });
+	PyramidPipeline = new PVulkanComputePipeline();
+	PyramidPipeline->CreatePipeline(PyramidShader, sizeof(Utils::SPyramidPushConstant));
+
+	LateCandidateBuffer = Utils::CreateBuffer(Utils::InitialInstanceCapacity, sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+	LateCandidateCapacity = Utils::InitialInstanceCapacity;
+
+	DrawCommandBuffer = Utils::CreateBuffer(Utils::InitialMeshCapacity * 2, sizeof(VkDrawIndexedIndirectCommand), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+	DrawCommandCapacity = Utils::InitialMeshCapacity * 2;
+
+	CreateDepthPyramid();
+
+	for (PVulkanFrame* Frame : *GetRHI()->GetSceneRenderer()->GetParallelFramePool())
+	{
+		SFrameResources Resources;
+		Resources.Frame = Frame;
+		Resources.CullDescriptorSet = Utils::AllocateDescriptorSet(Frame, CullShader);
+		for (uint32_t Level = 0; Level < Utils::MaxPyramidLevels; ++Level)
+		{
+			Resources.PyramidDescriptorSets.push_back(Utils::AllocateDescriptorSet(Frame, PyramidShader));
+		}
+
+		FrameResources.push_back(Resources);
+	}
+}
+
+void PVulkanGPUCuller::Shutdown()
+{
+	for (SFrameResources& Resources : FrameResources)
+	{
+		Utils::DestroyBuffer(Resources.MeshBuffer);
+		Utils::DestroyBuffer(Resources.ReadbackBuffer);
+	}
+	FrameResources.clear();
+
+	RetiredBuffers.Destroy();
+
+	Utils::DestroyBuffer(VisibleInstanceBuffer);
+	Utils::DestroyBuffer(LateCandidateBuffer);
+	Utils::DestroyBuffer(DrawCommandBuffer);
+
+	if (!bEnabled)
+	{
+		return;
+	}
+
+	DestroyDepthPyramid();
+
+	CullPipeline->DestroyPipeline();
+	CullShader->DestroyShader();
+	PyramidPipeline->DestroyPipeline();
+	PyramidShader->DestroyShader();
+	delete CullPipeline;
+	delete CullShader;
+	delete PyramidPipeline;
+	delete PyramidShader;
+}
+
+void PVulkanGPUCuller::Resize()
+{
+	if (!bEnabled)
+	{
+		return;
+	}
+
+	DestroyDepthPyramid();
+	CreateDepthPyramid();
+}
+
+bool PVulkanGPUCuller::IsEnabled() const
+{
+	return bEnabled;
+}
+
+void PVulkanGPUCuller::AddVisibleInstanceBinding(PVulkanFrame* Frame, VkDescriptorSet DescriptorSet, uint32_t Binding)
+{
+	SVisibleInstanceBinding VisibleInstanceBinding;
+	VisibleInstanceBinding.Frame = Frame;
+	VisibleInstanceBinding.DescriptorSet = DescriptorSet;
+	VisibleInstanceBinding.Binding = Binding;
+	VisibleInstanceBinding.Generation = VisibleInstanceGeneration;
+	VulkanUtils::WriteStorageBufferDescriptor(DescriptorSet, Binding, VisibleInstanceBuffer->Buffer);
+
+	VisibleInstanceBindings.push_back(VisibleInstanceBinding);
+}
+
+void PVulkanGPUCuller::CullEarly(PVulkanFrame* Frame, const glm::mat4& InViewProjection)
+{
+	PROFILE_FUNC_SCOPE("PVulkanGPUCuller::CullEarly")
+
+	Phase = EPhase::Early;
+	ViewProjection = InViewProjection;
+
+	// Waiting on this frame's fence guaranteed that the frames which could read a retired buffer have completed.
+	RetiredBuffers.Update();
+
+	SFrameResources& Resources = *std::find_if(FrameResources.begin(), FrameResources.end(), [Frame](const SFrameResources& Resources) { return Resources.Frame == Frame; });
+	CurrentResources = &Resources;
+	ReadStats(Resources);
+
+	PVulkanSceneBuffer* SceneBuffer = GetRHI()->GetSceneRenderer()->GetSceneBuffer();
+	const std::vector<PVulkanSceneBuffer::SMeshRecord>& MeshRecords = SceneBuffer->GetMeshRecords();
+	MeshCount = static_cast<uint32_t>(MeshRecords.size());
+	SlotCount = SceneBuffer->GetSlotCount();
+
+	// The frame's previous meshes have been consumed, its buffer can be replaced right away.
+	if (MeshCount > Resources.MeshCapacity)
+	{
+		Utils::DestroyBuffer(Resources.MeshBuffer);
+		Resources.MeshCapacity = std::max({ MeshCount, Resources.MeshCapacity * 2, Utils::InitialMeshCapacity });
+		Resources.MeshBuffer = Utils::CreateBuffer(Resources.MeshCapacity, sizeof(Utils::SGPUCullMesh), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+	}
+
+	// Every mesh reserves a range of the visible instance list as large as its instance count, in mesh order.
+	Utils::SGPUCullMesh* CullMeshes = static_cast<Utils::SGPUCullMesh*>(Resources.MeshBuffer->AllocationInfo.pMappedData);
+	InstanceCount = 0;
+	for (uint32_t MeshIndex = 0; MeshIndex < MeshCount; ++MeshIndex)
+	{
+		const PVulkanMesh* Mesh = static_cast<const PVulkanMesh*>(MeshRecords[MeshIndex].Mesh);
+		const SAABB& Bounds = Mesh->GetLocalBounds();
+		const bool bValid = Bounds.IsValid();
+
+		Utils::SGPUCullMesh& CullMesh = CullMeshes[MeshIndex];
+		CullMesh.Center = bValid ? Bounds.GetCenter() : glm::vec3(0.0f);
+		CullMesh.Extent = bValid ? Bounds.GetExtent() : glm::vec3(0.0f);
+		CullMesh.IndexCount = bValid ? Mesh->GetIndexCount() : 0;
+		CullMesh.InstanceBase = InstanceCount;
+		CullMesh.InstanceCount = MeshRecords[MeshIndex].InstanceCount;
+
+		InstanceCount += CullMesh.InstanceCount;
+	}
+
+	const size_t MeshBytes = static_cast<size_t>(MeshCount) * sizeof(Utils::SGPUCullMesh);
+	vmaFlushAllocation(GetRHI()->GetSceneRenderer()->GetAllocator()->GetMemoryAllocator(), Resources.MeshBuffer->Allocation, 0, MeshBytes);
+	PStats::Add(EStat::StorageBufferBytes, MeshBytes);
+	PStats::Add(EStat::CullSubmittedObjects, InstanceCount);
+
+	if (Reserve(VisibleInstanceBuffer, VisibleInstanceCapacity, InstanceCount * 2, sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT))
+	{
+		VisibleInstanceGeneration++;
+	}
+	Reserve(LateCandidateBuffer, LateCandidateCapacity, SlotCount, sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+	Reserve(DrawCommandBuffer, DrawCommandCapacity, MeshCount * 2, sizeof(VkDrawIndexedIndirectCommand), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+
+	// Descriptor sets of the other frames may still be in use, they are rewritten when their frame comes around.
+	for (SVisibleInstanceBinding& VisibleInstanceBinding : VisibleInstanceBindings)
+	{
+		if (VisibleInstanceBinding.Frame == Frame && VisibleInstanceBinding.Generation != VisibleInstanceGeneration)
+		{
+			VulkanUtils::WriteStorageBufferDescriptor(VisibleInstanceBinding.DescriptorSet, VisibleInstanceBinding.Binding, VisibleInstanceBuffer->Buffer);
+			VisibleInstanceBinding.Generation = VisibleInstanceGeneration;
+		}
+	}
+
+	if (MeshCount == 0)
+	{
+		return;
+	}
+
+	// The instance buffers may have been reallocated by this frame's upload.
+	VulkanUtils::WriteStorageBufferDescriptor(Resources.CullDescriptorSet, 0, SceneBuffer->GetInstanceBuffer()->Buffer);
+	VulkanUtils::WriteStorageBufferDescriptor(Resources.CullDescriptorSet, 1, SceneBuffer->GetInstanceMeshBuffer()->Buffer);
+	VulkanUtils::WriteStorageBufferDescriptor(Resources.CullDescriptorSet, 2, Resources.MeshBuffer->Buffer);
+	VulkanUtils::WriteStorageBufferDescriptor(Resources.CullDescriptorSet, 3, DrawCommandBuffer->Buffer);
+	VulkanUtils::WriteStorageBufferDescriptor(Resources.CullDescriptorSet, 4, VisibleInstanceBuffer->Buffer);
+	VulkanUtils::WriteStorageBufferDescriptor(Resources.CullDescriptorSet, 5, LateCandidateBuffer->Buffer);
+	Utils::WriteImageDescriptor(Resources.CullDescriptorSet, 6, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, DepthPyramid->GetVkImageView(), VK_IMAGE_LAYOUT_GENERAL);
+
+	const VkCommandBuffer CommandBuffer = Frame->GetCommandBuffer()->GetVkCommandBuffer();
+
+	// The previous frame's draws may still read the commands and lists about to be reset, and its late phase wrote the pyramid.
+	VulkanUtils::InsertMemoryBarrier(CommandBuffer,
+		VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+		VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_SHADER_SAMPLED_READ_BIT);
+
+	CullPipeline->Bind({ Resources.CullDescriptorSet });
+	Dispatch(Frame, Utils::PassReset, MeshCount * 2);
+
+	VulkanUtils::InsertMemoryBarrier(CommandBuffer,
+		VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+		VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
+	Dispatch(Frame, Utils::PassEarly, SlotCount);
+
+	VulkanUtils::InsertMemoryBarrier(CommandBuffer,
+		VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+		VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+}
+
+void PVulkanGPUCuller::CullLate(PVulkanFrame* Frame)
+{
+	PROFILE_FUNC_SCOPE("PVulkanGPUCuller::CullLate")
+
+	Phase = EPhase::Late;
+	if (MeshCount == 0)
+	{
+		return;
+	}
+
+	BuildDepthPyramid(Frame);
+
+	const VkCommandBuffer CommandBuffer = Frame->GetCommandBuffer()->GetVkCommandBuffer();
+
+	CullPipeline->Bind({ CurrentResources->CullDescriptorSet });
+	Dispatch(Frame, Utils::PassLate, SlotCount);
+
+	VulkanUtils::InsertMemoryBarrier(CommandBuffer,
+		VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+		VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_TRANSFER_READ_BIT);
+
+	// The counts are final, they reach the stats once the frame's fence was waited on.
+	const uint32_t CommandCount = MeshCount * 2;
+	if (CommandCount > CurrentResources->ReadbackCapacity)
+	{
+		Utils::DestroyBuffer(CurrentResources->ReadbackBuffer);
+		CurrentResources->ReadbackCapacity = std::max(CommandCount, CurrentResources->ReadbackCapacity * 2);
+		CurrentResources->ReadbackBuffer = Utils::CreateBuffer(CurrentResources->ReadbackCapacity, sizeof(VkDrawIndexedIndirectCommand), VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU);
+	}
+
+	VkBufferCopy BufferCopy{};
+	BufferCopy.srcOffset = 0;
+	BufferCopy.dstOffset = 0;
+	BufferCopy.size = static_cast<VkDeviceSize>(CommandCount) * sizeof(VkDrawIndexedIndirectCommand);
+	vkCmdCopyBuffer(CommandBuffer, DrawCommandBuffer->Buffer, CurrentResources->ReadbackBuffer->Buffer, 1, &BufferCopy);
+	CurrentResources->ReadbackCount = CommandCount;
+}
+
+PVulkanGPUCuller::EPhase PVulkanGPUCuller::GetPhase() const
+{
+	return Phase;
+}
+
+VkBuffer PVulkanGPUCuller::GetDrawCommandBuffer() const
+{
+	return DrawCommandBuffer->Buffer;
+}
+
+VkDeviceSize PVulkanGPUCuller::GetDrawCommandOffset(uint32_t MeshIndex) const
+{
+	const uint32_t CommandIndex = Phase == EPhase::Late ? MeshCount + MeshIndex : MeshIndex;
+	return static_cast<VkDeviceSize>(CommandIndex) * sizeof(VkDrawIndexedIndirectCommand);
+}
+
+void PVulkanGPUCuller::CreateDepthPyramid()
+{
+	const VkExtent2D DepthExtent = GetRHI()->GetSceneRenderer()->GetDepthImage()->GetImageExtent2D();
+	const VkExtent2D Extent = { std::bit_floor(std::max(DepthExtent.width, 1u)), std::bit_floor(std::max(DepthExtent.height, 1u)) };
+	DepthPyramidLevels = std::min(static_cast<uint32_t>(std::bit_width(std::max(Extent.width, Extent.height))), Utils::MaxPyramidLevels);
+
+	DepthPyramid = new PVulkanImage();
+	DepthPyramid->Init(Extent, VK_FORMAT_R32_SFLOAT, DepthPyramidLevels);
+	DepthPyramid->CreateImage(VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+	DepthPyramid->CreateImageView(VK_IMAGE_ASPECT_COLOR_BIT);
+
+	// Each level is written through its own view while the one above is read.
+	for (uint32_t Level = 0; Level < DepthPyramidLevels; ++Level)
+	{
+		VkImageViewCreateInfo ImageViewCreateInfo{};
+		ImageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		ImageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		ImageViewCreateInfo.image = DepthPyramid->GetVkImage();
+		ImageViewCreateInfo.format = VK_FORMAT_R32_SFLOAT;
+		ImageViewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		ImageViewCreateInfo.subresourceRange.baseMipLevel = Level;
+		ImageViewCreateInfo.subresourceRange.levelCount = 1;
+		ImageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
+		ImageViewCreateInfo.subresourceRange.layerCount = 1;
+
+		VkImageView ImageView;
+		VkResult Result = vkCreateImageView(GetRHI()->GetDevice()->GetVkDevice(), &ImageViewCreateInfo, nullptr, &ImageView);
+		RK_ASSERT(Result == VK_SUCCESS, "Failed to create image view.");
+
+		DepthPyramidLevelViews.push_back(ImageView);
+	}
+
+	// The pyramid stays in the general layout, it is both written as storage and read as sampled image.
+	GetRHI()->GetSceneRenderer()->ImmediateSubmit([this](PVulkanCommandBuffer* CommandBuffer)
+	{
+		DepthPyramid->TransitionImageLayout(CommandBuffer, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL);
+	});
+
+	bDepthPyramidValid = false;
+}
+
+void PVulkanGPUCuller::DestroyDepthPyramid()
+{
+	for (VkImageView ImageView : DepthPyramidLevelViews)
+	{
+		vkDestroyImageView(GetRHI()->GetDevice()->GetVkDevice(), ImageView, nullptr);
+	}
+	DepthPyramidLevelViews.clear();
+
+	DepthPyramid->DestroyImageView();
+	DepthPyramid->DestroyImage();
+	delete DepthPyramid;
+	DepthPyramid = nullptr;
+}
+
+void PVulkanGPUCuller::BuildDepthPyramid(PVulkanFrame* Frame)
+{
+	PROFILE_FUNC_SCOPE("PVulkanGPUCuller::BuildDepthPyramid")
+
+	const VkCommandBuffer CommandBuffer = Frame->GetCommandBuffer()->GetVkCommandBuffer();
+	PVulkanImage* DepthImage = GetRHI()->GetSceneRenderer()->GetDepthImage();
+
+	DepthImage->TransitionImageLayout(Frame->GetCommandBuffer(), VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+	// The early phase read the previous pyramid.
+	VulkanUtils::InsertMemoryBarrier(CommandBuffer,
+		VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_NONE,
+		VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
+	VkExtent2D SourceExtent = DepthImage->GetImageExtent2D();
+	VkExtent2D Extent = DepthPyramid->GetImageExtent2D();
+	for (uint32_t Level = 0; Level < DepthPyramidLevels; ++Level)
+	{
+		const VkDescriptorSet DescriptorSet = CurrentResources->PyramidDescriptorSets[Level];
+		if (Level == 0)
+		{
+			Utils::WriteImageDescriptor(DescriptorSet, 0, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, DepthImage->GetVkImageView(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		}
+		else
+		{
+			Utils::WriteImageDescriptor(DescriptorSet, 0, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, DepthPyramidLevelViews[Level - 1], VK_IMAGE_LAYOUT_GENERAL);
+		}
+		Utils::WriteImageDescriptor(DescriptorSet, 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, DepthPyramidLevelViews[Level], VK_IMAGE_LAYOUT_GENERAL);
+
+		Utils::SPyramidPushConstant PushConstant;
+		PushConstant.SourceSize[0] = SourceExtent.width;
+		PushConstant.SourceSize[1] = SourceExtent.height;
+		PushConstant.DestinationSize[0] = Extent.width;
+		PushConstant.DestinationSize[1] = Extent.height;
+
+		PyramidPipeline->Bind({ DescriptorSet });
+		vkCmdPushConstants(CommandBuffer, PyramidPipeline->GetPipelineLayout()->GetVkPipelineLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstant), &PushConstant);
+		vkCmdDispatch(CommandBuffer, (Extent.width + Utils::PyramidGroupSize - 1) / Utils::PyramidGroupSize, (Extent.height + Utils::PyramidGroupSize - 1) / Utils::PyramidGroupSize, 1);
+
+		VulkanUtils::InsertMemoryBarrier(CommandBuffer,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+			VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
+		SourceExtent = Extent;
+		Extent = { std::max(Extent.width / 2, 1u), std::max(Extent.height / 2, 1u) };
+	}
+
+	DepthImage->TransitionImageLayout(Frame->GetCommandBuffer(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL);
+	bDepthPyramidValid = true;
+}
+
+void PVulkanGPUCuller::Dispatch(PVulkanFrame* Frame, uint32_t Pass, uint32_t ThreadCount)
+{
+	Utils::SCullPushConstant PushConstant;
+	PushConstant.ViewProjection = ViewProjection;
+	PushConstant.PyramidSize[0] = DepthPyramid->GetImageExtent2D().width;
+	PushConstant.PyramidSize[1] = DepthPyramid->GetImageExtent2D().height;
+	PushConstant.PyramidLevels = DepthPyramidLevels;
+	PushConstant.SlotCount = SlotCount;
+	PushConstant.MeshCount = MeshCount;
+	PushConstant.Pass = Pass;
+	PushConstant.bOcclusion = Pass == Utils::PassLate || bDepthPyramidValid ? 1 : 0;
+	PushConstant.LateInstanceBase = InstanceCount;
+
+	const VkCommandBuffer CommandBuffer = Frame->GetCommandBuffer()->GetVkCommandBuffer();
+	vkCmdPushConstants(CommandBuffer, CullPipeline->GetPipelineLayout()->GetVkPipelineLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstant), &PushConstant);
+	vkCmdDispatch(CommandBuffer, (ThreadCount + Utils::CullGroupSize - 1) / Utils::CullGroupSize, 1, 1);
+}
+
+void PVulkanGPUCuller::ReadStats(SFrameResources& Resources)
+{
+	if (Resources.ReadbackCount == 0)
+	{
+		return;
+	}
+
+	// Reported with the latency of the frames in flight.
+	vmaInvalidateAllocation(GetRHI()->GetSceneRenderer()->GetAllocator()->GetMemoryAllocator(), Resources.ReadbackBuffer->Allocation, 0, static_cast<VkDeviceSize>(Resources.ReadbackCount) * sizeof(VkDrawIndexedIndirectCommand));
+	const VkDrawIndexedIndirectCommand* Commands = static_cast<const VkDrawIndexedIndirectCommand*>(Resources.ReadbackBuffer->AllocationInfo.pMappedData);
+
+	uint64_t VisibleCount = 0;
+	uint64_t TriangleCount = 0;
+	for (uint32_t Index = 0; Index < Resources.ReadbackCount; ++Index)
+	{
+		VisibleCount += Commands[Index].instanceCount;
+		TriangleCount += static_cast<uint64_t>(Commands[Index].instanceCount) * (Commands[Index].indexCount / 3);
+	}
+
+	PStats::Add(EStat::CullVisibleObjects, VisibleCount);
+	PStats::Add(EStat::Triangles, TriangleCount);
+	Resources.ReadbackCount = 0;
+}
+
+bool PVulkanGPUCuller::Reserve(PVulkanBuffer*& Buffer, uint32_t& Capacity, uint32_t RequiredCount, size_t ElementSize, VkBufferUsageFlags Usage)
+{
+	if (RequiredCount <= Capacity)
+	{
+		return false;
+	}
+
+	// The previous frame may still be reading the old buffer.
+	RetiredBuffers.Retire(Buffer, static_cast<uint32_t>(FrameResources.size()));
+
+	Capacity = std::max(RequiredCount, Capacity * 2);
+	Buffer = Utils::CreateBuffer(Capacity, ElementSize, Usage, VMA_MEMORY_USAGE_GPU_ONLY);
+	return true;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+#include "Renderer/Vulkan/VulkanBuffer.h"
+
+class PVulkanComputePipeline;
+class PVulkanFrame;
+class PVulkanImage;
+class PVulkanShader;
+
+// Culls the instances of PVulkanSceneBuffer on the GPU, enabled with --gpu-culling in place of PFrustumCuller.
+// A compute pass tests every slot against the frustum and the depth pyramid of the previous frame, and compacts the
+// survivors into one indirect draw per mesh, so the CPU records the same draws however many instances there are.
+// Instances the pyramid rejected are tested again after the first rendering pass against a pyramid of its depth,
+// and the ones that turn out visible are drawn in a second pass. That pyramid is the one the next frame tests against.
+class PVulkanGPUCuller
+{
+public:
+	enum class EPhase : uint8_t
+	{
+		Early,
+		Late
+	};
+
+	void Init();
+	void Shutdown();
+
+	// Recreates the depth pyramid for the new extent of the depth image, the next frame culls without occlusion.
+	void Resize();
+
+	bool IsEnabled() const;
+
+	// Points the binding at the visible instance list. Rewritten before the frame renders again whenever the list was reallocated.
+	void AddVisibleInstanceBinding(PVulkanFrame* Frame, VkDescriptorSet DescriptorSet, uint32_t Binding);
+
+	// Records the early phase, after PVulkanSceneBuffer::Upload and outside of rendering.
+	void CullEarly(PVulkanFrame* Frame, const glm::mat4& ViewProjection);
+
+	// Records the depth pyramid of the early phase's depth and the late phase, between the two rendering passes.
+	void CullLate(PVulkanFrame* Frame);
+
+	// Phase whose draws the render graph is executing
+	EPhase GetPhase() const;
+
+	VkBuffer GetDrawCommandBuffer() const;
+
+	// Offset of the mesh's VkDrawIndexedIndirectCommand of the current phase, indexed like PVulkanSceneBuffer's mesh records.
+	VkDeviceSize GetDrawCommandOffset(uint32_t MeshIndex) const;
+
+private:
+	struct SVisibleInstanceBinding
+	{
+		PVulkanFrame* Frame;
+		VkDescriptorSet DescriptorSet;
+		uint32_t Binding;
+
+		// Generation of the visible instance list the descriptor points at
+		uint32_t Generation;
+	};
+
+	struct SFrameResources
+	{
+		PVulkanFrame* Frame;
+		VkDescriptorSet CullDescriptorSet;
+		std::vector<VkDescriptorSet> PyramidDescriptorSets;
+
+		// Host-visible mesh bounds and instance ranges, rewritten every frame
+		PVulkanBuffer* MeshBuffer = nullptr;
+		uint32_t MeshCapacity = 0;
+
+		// Draw commands of the frame, read back for stats once its fence was waited on
+		PVulkanBuffer* ReadbackBuffer = nullptr;
+		uint32_t ReadbackCapacity = 0;
+		uint32_t ReadbackCount = 0;
+	};
+
+	void CreateDepthPyramid();
+	void DestroyDepthPyramid();
+
+	void BuildDepthPyramid(PVulkanFrame* Frame);
+	void Dispatch(PVulkanFrame* Frame, uint32_t Pass, uint32_t ThreadCount);
+
+	void ReadStats(SFrameResources& Resources);
+
+	// Replaces Buffer by one of at least RequiredCount elements if it is smaller, the old one is retired. True if it was replaced.
+	bool Reserve(PVulkanBuffer*& Buffer, uint32_t& Capacity, uint32_t RequiredCount, size_t ElementSize, VkBufferUsageFlags Usage);
+
+	bool bEnabled = false;
+
+	PVulkanShader* CullShader = nullptr;
+	PVulkanComputePipeline* CullPipeline = nullptr;
+	PVulkanShader* PyramidShader = nullptr;
+	PVulkanComputePipeline* PyramidPipeline = nullptr;
+
+	// Slot lists of every mesh's early range followed by every mesh's late range
+	PVulkanBuffer* VisibleInstanceBuffer = nullptr;
+	uint32_t VisibleInstanceCapacity = 0;
+	uint32_t VisibleInstanceGeneration = 0;
+
+	PVulkanBuffer* LateCandidateBuffer = nullptr;
+	uint32_t LateCandidateCapacity = 0;
+
+	// Early commands of every mesh followed by the late ones
+	PVulkanBuffer* DrawCommandBuffer = nullptr;
+	uint32_t DrawCommandCapacity = 0;
+
+	// Power-of-two sized, so that every texel of a level covers exactly 2x2 texels of the one above
+	PVulkanImage* DepthPyramid = nullptr;
+	std::vector<VkImageView> DepthPyramidLevelViews;
+	uint32_t DepthPyramidLevels = 0;
+
+	// False until a pyramid was built since the last resize, the early phase then only culls against the frustum.
+	bool bDepthPyramidValid = false;
+
+	// Of the frame being recorded, the late phase reuses what the early one computed
+	glm::mat4 ViewProjection = glm::mat4(1.0f);
+	uint32_t MeshCount = 0;
+	uint32_t InstanceCount = 0;
+	uint32_t SlotCount = 0;
+	SFrameResources* CurrentResources = nullptr;
+	EPhase Phase = EPhase::Early;
+
+	std::vector<SVisibleInstanceBinding> VisibleInstanceBindings;
+	std::vector<SFrameResources> FrameResources;
+	PVulkanRetiredBuffers RetiredBuffers;
+};
@@ -0,0 +1,63 @@
+#include "EnginePCH.h"
+#include "VulkanHeadlessSwapchain.h"
+
+#include "Renderer/Vulkan/VulkanImage.h"
+
+// Matches the swapchain image count, so the frame in flight never writes to an image the previous frame still reads.
+static constexpr uint32_t HeadlessImageCount = 3;
+
+void PVulkanHeadlessSwapchain::Init()
+{
+	SwapchainKHR = VK_NULL_HANDLE;
+	SwapchainSurfaceFormat.format = VK_FORMAT_B8G8R8A8_UNORM;
+	SwapchainSurfaceFormat.colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+	SwapchainPresentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+	SwapchainImageExtent = { GetWindow()->GetWindowSpecification().Width, GetWindow()->GetWindowSpecification().Height };
+	NextImageIndex = 0;
+
+	SwapchainImages.resize(HeadlessImageCount);
+	for (size_t Index = 0; Index < HeadlessImageCount; ++Index)
+	{
+		// Transfer source allows reading the result back (e.g. screenshots in automated runs).
+		PVulkanImage* Image = new PVulkanImage();
+		Image->Init(SwapchainImageExtent, SwapchainSurfaceFormat.format);
+		Image->CreateImage(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+		Image->CreateImageView(VK_IMAGE_ASPECT_COLOR_BIT);
+		SwapchainImages[Index] = Image;
+	}
+}
+
+void PVulkanHeadlessSwapchain::Shutdown()
+{
+	while (SwapchainImages.size())
+	{
+		PVulkanImage* Image = SwapchainImages[0];
+		Image->DestroyImageView();
+		Image->DestroyImage();
+
+		delete Image;
+		SwapchainImages.erase(SwapchainImages.begin());
+	}
+}
+
+bool PVulkanHeadlessSwapchain::AcquireNextImage(VkSemaphore SignalSemaphore, uint32_t& ImageIndex)
+{
+	// The image is available as soon as the frame fence is signaled, there is no presentation engine to wait for.
+	ImageIndex = NextImageIndex;
+	NextImageIndex = (NextImageIndex + 1) % HeadlessImageCount;
+	return false;
+}
+
+void PVulkanHeadlessSwapchain::Present(VkSemaphore WaitSemaphore, uint32_t ImageIndex)
+{
+}
+
+VkImageLayout PVulkanHeadlessSwapchain::GetFinalImageLayout() const
+{
+	return VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+}
+
+bool PVulkanHeadlessSwapchain::IsPresentable() const
+{
+	return false;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Renderer/Vulkan/VulkanSwapchain.h"
+
+// Offscreen replacement for the swapchain when running without a surface. Images are plain device local
+// allocations cycled round-robin, nothing is presented and frames are paced by the render fence.
+class PVulkanHeadlessSwapchain : public PVulkanSwapchain
+{
+public:
+	virtual void Init() override;
+	virtual void Shutdown() override;
+
+	virtual bool AcquireNextImage(VkSemaphore SignalSemaphore, uint32_t& ImageIndex) override;
+	virtual void Present(VkSemaphore WaitSemaphore, uint32_t ImageIndex) override;
+
+	virtual VkImageLayout GetFinalImageLayout() const override;
+	virtual bool IsPresentable() const override;
+
+private:
+	uint32_t NextImageIndex = 0;
+};
@@ -6,11 +6,12 @@
 #include "Renderer/Vulkan/VulkanSceneRenderer.h"
 #include "Renderer/Vulkan/VulkanCommand.h"
 
-void PVulkanImage::Init(VkExtent2D Extent, VkFormat Format)
+void PVulkanImage::Init(VkExtent2D Extent, VkFormat Format, uint32_t InMipLevels)
 {
 	ImageFormat = Format;
 	ImageExtent = Extent;
 	ImageExtent3D = { Extent.width, Extent.height, 1 };
+	MipLevels = InMipLevels;
 }
 
 void PVulkanImage::Reset() 
@@ -21,6 +22,7 @@ void PVulkanImage::Reset()
 	ImageFormat = {};
 	ImageExtent = {};
 	ImageExtent3D = {};
+	MipLevels = 1;
 }
 
 void PVulkanImage::CreateImage(VkImageUsageFlags ImageUsageFlags)
@@ -30,7 +32,7 @@ void PVulkanImage::CreateImage(VkImageUsageFlags ImageUsageFlags)
 	ImageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
 	ImageCreateInfo.format = ImageFormat;
 	ImageCreateInfo.extent = ImageExtent3D;
-	ImageCreateInfo.mipLevels = 1;
+	ImageCreateInfo.mipLevels = MipLevels;
 	ImageCreateInfo.arrayLayers = 1;
 	ImageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
 	ImageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
@@ -55,7 +57,7 @@ void PVulkanImage::CreateImageView(VkImageAspectFlags ImageViewAspectFlags)
 	ImageViewCreateInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
 	ImageViewCreateInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
 	ImageViewCreateInfo.subresourceRange.baseMipLevel = 0;
-	ImageViewCreateInfo.subresourceRange.levelCount = 1;
+	ImageViewCreateInfo.subresourceRange.levelCount = MipLevels;
 	ImageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
 	ImageViewCreateInfo.subresourceRange.layerCount = 1;
 	ImageViewCreateInfo.subresourceRange.aspectMask = ImageViewAspectFlags;
@@ -89,7 +91,9 @@ void PVulkanImage::DestroyImageView()
 void PVulkanImage::TransitionImageLayout(PVulkanCommandBuffer* CommandBuffer, VkImageLayout CurrentLayout, VkImageLayout NewLayout)
 {
 	VkImageSubresourceRange SubresourceRange{};
-	SubresourceRange.aspectMask = (NewLayout == VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+	// Depth images keep the depth aspect in every layout, e.g. while the depth pyramid reads them.
+	const bool bDepth = NewLayout == VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL || ImageFormat == VK_FORMAT_D32_SFLOAT;
+	SubresourceRange.aspectMask = bDepth ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
 	SubresourceRange.baseMipLevel = 0;
 	SubresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
 	SubresourceRange.baseArrayLayer = 0;
@@ -18,7 +18,7 @@ class PVulkanCommandBuffer;
 class PVulkanImage
 {
 public:
-	void Init(VkExtent2D Extent, VkFormat Format);
+	void Init(VkExtent2D Extent, VkFormat Format, uint32_t InMipLevels = 1);
 	void Reset();
 
 	void ApplyImage(VkImage Image);
@@ -44,4 +44,5 @@ public:
 	VkFormat ImageFormat;
 	VkExtent2D ImageExtent;
 	VkExtent3D ImageExtent3D;
+	uint32_t MipLevels;
 };
\ No newline at end of file
@@ -40,10 +40,13 @@ namespace Utils
 
 void PVulkanInstance::Init()
 {
-	// GLFW required Vulkan extensions
-	uint32_t GlfwExtensionCount = 0;
-	const char** GlfwExtensions = glfwGetRequiredInstanceExtensions(&GlfwExtensionCount);
-	GetRHI()->Extensions.InstanceExtensions.insert(GetRHI()->Extensions.InstanceExtensions.end(), GlfwExtensions, GlfwExtensions + GlfwExtensionCount);
+	// GLFW required Vulkan extensions, a headless window has no surface to create
+	if (!GetWindow()->IsHeadless())
+	{
+		uint32_t GlfwExtensionCount = 0;
+		const char** GlfwExtensions = glfwGetRequiredInstanceExtensions(&GlfwExtensionCount);
+		GetRHI()->Extensions.InstanceExtensions.insert(GetRHI()->Extensions.InstanceExtensions.end(), GlfwExtensions, GlfwExtensions + GlfwExtensionCount);
+	}
 
 	VkApplicationInfo AppInfo{};
 	AppInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
@@ -76,13 +79,19 @@ void PVulkanInstance::Init()
 	RK_ASSERT(Result == VK_SUCCESS, "Failed to create debug messenger.");
 #endif
 
-	Result = glfwCreateWindowSurface(Instance, (GLFWwindow*)GetWindow()->GetNativeWindow(), nullptr, &Surface);
-	RK_ASSERT(Result == VK_SUCCESS, "Failed to create Vulkan surface.");
+	if (!GetWindow()->IsHeadless())
+	{
+		Result = glfwCreateWindowSurface(Instance, (GLFWwindow*)GetWindow()->GetNativeWindow(), nullptr, &Surface);
+		RK_ASSERT(Result == VK_SUCCESS, "Failed to create Vulkan surface.");
+	}
 }
 
 void PVulkanInstance::Shutdown()
 {
-	vkDestroySurfaceKHR(Instance, Surface, nullptr);
+	if (Surface)
+	{
+		vkDestroySurfaceKHR(Instance, Surface, nullptr);
+	}
 
 #if VALIDATION_LAYER
 	Utils::DestroyDebugUtilsMessengerEXT(Instance, DebugMessenger, nullptr);
@@ -12,6 +12,8 @@
 #include "Renderer/Vulkan/VulkanShader.h"
 #include "Renderer/Vulkan/VulkanRenderGraph.h"
 #include "Renderer/Vulkan/VulkanMemory.h"
+#include "Renderer/Vulkan/VulkanSceneBuffer.h"
+#include "Renderer/Vulkan/VulkanGPUCuller.h"
 
 void PVulkanMaterial::CreateMaterial(const SMaterialBinaryData& MaterialData)
 {
@@ -21,6 +23,7 @@ void PVulkanMaterial::CreateMaterial(const SMaterialBinaryData& MaterialData)
 void PVulkanMaterial::Destroy()
 {
     GraphicsPipeline->DestroyPipeline();
+    DepthPipeline->DestroyPipeline();
 
     PVulkanFramePool* FramePool = GetRHI()->GetSceneRenderer()->GetParallelFramePool();
     for (const auto& FrameData : *FramePool)
@@ -42,6 +45,12 @@ void PVulkanMaterial::Bind() const
         DescriptorSetData.push_back(DescriptorSet->GetVkDescriptorSet());
     }
 
+    if (GetRHI()->GetSceneRenderer()->GetScenePass() == EScenePass::DepthPrePass)
+    {
+        DepthPipeline->Bind(DescriptorSetData);
+        return;
+    }
+
     GraphicsPipeline->Bind(DescriptorSetData);
 }
 
@@ -69,7 +78,10 @@ void PVulkanMaterial::SetShader(IShader* Shader)
     GraphicsPipeline = new PVulkanGraphicsPipeline();
     GraphicsPipeline->CreatePipeline(Cast<PVulkanShader>(Shader));
 
-    GetRHI()->GetSceneRenderer()->GetRenderGraph()->AddCommand([&](PVulkanFrame* Frame)
+    DepthPipeline = new PVulkanGraphicsPipeline();
+    DepthPipeline->CreatePipeline(Cast<PVulkanShader>(Shader), EGraphicsPipelineMode::DepthOnly);
+
+    GetRHI()->GetSceneRenderer()->GetRenderGraph()->AddCommand("MaterialUniforms", [&](PVulkanFrame* Frame)
 	{
 		PCamera* Camera = GetScene()->GetCamera();
     	
@@ -80,49 +92,37 @@ void PVulkanMaterial::SetShader(IShader* Shader)
         SetUniformValue(1, "UBO", "m_ViewMatrix", Camera->GetViewMatrix());
         SetUniformValue(1, "UBO", "m_ProjectionMatrix", Camera->GetProjectionMatrix());
         SetUniformValue(1, "UBO", "CameraWorldPosition", Camera->GetPosition());
-	});
+	}, ERenderGraphCommandType::Setup);
     
-    GetRHI()->GetSceneRenderer()->GetRenderGraph()->AddCommand([this](PVulkanFrame* Frame)
+    GetRHI()->GetSceneRenderer()->GetRenderGraph()->AddCommand("MaterialDraw", [this](PVulkanFrame* Frame)
 	{
-		std::vector<SShaderStorageBufferObject> SSBOs;
-
-		GetScene()->GetRegistry()->View<STransformComponent, SMeshComponent>([&](const STransformComponent& TransformComponent, const SMeshComponent& MeshComponent)
-		{
-            PVulkanMesh* Mesh = static_cast<PVulkanMesh*>(MeshComponent.Mesh);
-            if (MeshComponent.Mesh->GetMaterial() == this)
-            {
-                glm::mat4 ModelMatrix = TransformComponent.Transform.ToMatrix();
-                glm::mat4 NormalMatrix = glm::transpose(glm::inverse(ModelMatrix));
-
-                SShaderStorageBufferObject SSBO;
-                SSBO.ModelMatrix = ModelMatrix;
-                SSBO.NormalMatrix = NormalMatrix;
+        // Instance data is uploaded by PVulkanSceneBuffer, draws only push the entity's slot.
+        PVulkanSceneBuffer* SceneBuffer = GetRHI()->GetSceneRenderer()->GetSceneBuffer();
 
-                SSBOs.push_back( SSBO );
-            }
-		});
-		
-        PVulkanFramePool* FramePool = GetRHI()->GetSceneRenderer()->GetParallelFramePool();
-        PVulkanDescriptorSet* DescriptorSet = FramePool->GetCurrentFrame()->GetMemory()->DescriptorSets[0];
-        for (const auto& Binding : DescriptorSet->GetBindings())
+        // One indirect draw per mesh, its instance count and slots were written by the culling pass.
+        PVulkanGPUCuller* GPUCuller = GetRHI()->GetSceneRenderer()->GetGPUCuller();
+        if (GPUCuller->IsEnabled())
         {
-            if (Binding.Layout->Name == "SSBO")
+            const std::vector<PVulkanSceneBuffer::SMeshRecord>& MeshRecords = SceneBuffer->GetMeshRecords();
+            for (uint32_t MeshIndex = 0; MeshIndex < MeshRecords.size(); ++MeshIndex)
             {
-                PVulkanBuffer* Buffer = static_cast<PVulkanBuffer*>(Binding.Data);
-                Buffer->Submit(SSBOs.data(), sizeof(SShaderStorageBufferObject) * SSBOs.size());
+                const PVulkanSceneBuffer::SMeshRecord& Record = MeshRecords[MeshIndex];
+                if (Record.InstanceCount > 0 && Record.Mesh->GetMaterial() == this)
+                {
+                    static_cast<PVulkanMesh*>(Record.Mesh)->DrawIndirect(GPUCuller->GetDrawCommandBuffer(), GPUCuller->GetDrawCommandOffset(MeshIndex));
+                }
             }
+            return;
         }
 
-		uint32_t ObjectID = 0;
-    	GetScene()->GetRegistry()->View<STransformComponent, SMeshComponent>([&](const STransformComponent& TransformComponent, const SMeshComponent& MeshComponent)
-    	{
-            if (MeshComponent.Mesh->GetMaterial() == this)
+        for (const SVisibleObject& VisibleObject : GetScene()->GetFrustumCuller()->GetVisibleObjects())
+        {
+            if (VisibleObject.Mesh->GetMaterial() == this)
             {
-                MeshComponent.Mesh->DrawIndirectInstanced(ObjectID);
-                ObjectID++;
+                VisibleObject.Mesh->DrawIndirectInstanced(SceneBuffer->GetInstanceSlot(VisibleObject.EntityID));
             }
-    	});
-	});
+        }
+	}, ERenderGraphCommandType::Draw, true);
 }
 
 void PVulkanMaterial::SetUniformValue(const uint32_t Set, const std::string& UniformName, const std::string& MemberName, glm::mat4 Value)
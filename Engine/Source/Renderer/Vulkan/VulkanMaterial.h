@@ -25,4 +25,6 @@ public:
 
 public:
     PVulkanGraphicsPipeline* GraphicsPipeline;
+    // Bound instead of GraphicsPipeline during the depth pre-pass
+    PVulkanGraphicsPipeline* DepthPipeline;
 };
@@ -18,6 +18,7 @@ void PVulkanMemory::Init()
 	// Create a descriptor pool that will hold 10 sets with 1 image each
 	std::vector<SVulkanDescriptorPoolRatio> Sizes = { 
 		{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1024 },
+		{ VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1024 },
 		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1024 },
 		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1024 },
 	};
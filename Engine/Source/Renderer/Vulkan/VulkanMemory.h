@@ -35,6 +35,9 @@ struct SUInt64PointerPushConstant
 {
 	VkDeviceAddress DeviceAddress;
 	uint32_t ObjectId;
+
+	// Set for indirect draws of PVulkanGPUCuller, whose instances read their slot from VisibleInstances instead of ObjectId
+	uint32_t bVisibleInstances;
 };
 
 class PVulkanMemory
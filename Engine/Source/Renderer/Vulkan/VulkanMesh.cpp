@@ -12,9 +12,12 @@
 #include "Renderer/Vulkan/VulkanPipeline.h"
 #include "Renderer/Vulkan/VulkanAllocator.h"
 #include "Utils/Profiler.h"
+#include "Utils/Stats.h"
 
 void PVulkanMesh::CreateMesh(const SMeshBinaryData& MeshBinaryObject)
 {
+    SetBounds(MeshBinaryObject);
+
     const size_t VertexBufferSize = MeshBinaryObject.Vertices.size() * sizeof(SVertex);
     const size_t IndexBufferSize = MeshBinaryObject.Indices.size() * sizeof(uint32_t);
 
@@ -31,6 +34,7 @@ void PVulkanMesh::CreateMesh(const SMeshBinaryData& MeshBinaryObject)
     memcpy(Data, MeshBinaryObject.Vertices.data(), VertexBufferSize);
     memcpy((char*)Data + VertexBufferSize, MeshBinaryObject.Indices.data(), IndexBufferSize);
     vmaUnmapMemory(GetRHI()->GetSceneRenderer()->GetAllocator()->GetMemoryAllocator(), StagingBuffer->Allocation);
+    PStats::Add(EStat::StagingBufferBytes, VertexBufferSize + IndexBufferSize);
 
     VkBufferDeviceAddressInfo BufferDeviceAddressInfo{};
     BufferDeviceAddressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
@@ -58,6 +62,8 @@ void PVulkanMesh::CreateMesh(const SMeshBinaryData& MeshBinaryObject)
 
 void PVulkanMesh::CreateDynamicMesh(const SMeshBinaryData& MeshBinaryObject) 
 {
+    SetBounds(MeshBinaryObject);
+
     const size_t VertexBufferSize = MeshBinaryObject.Vertices.size() * sizeof(SVertex);
     const size_t IndexBufferSize = MeshBinaryObject.Indices.size() * sizeof(uint32_t);
 
@@ -86,6 +92,8 @@ void PVulkanMesh::CreateDynamicMesh(const SMeshBinaryData& MeshBinaryObject)
 
 void PVulkanMesh::UpdateDynamicMesh(const SMeshBinaryData& MeshData)
 {
+    SetBounds(MeshData);
+
     const size_t VertexBufferSize = MeshData.Vertices.size() * sizeof(SVertex);
     const size_t IndexBufferSize = MeshData.Indices.size() * sizeof(uint32_t);
 
@@ -121,12 +129,40 @@ void PVulkanMesh::DrawIndirectInstanced(uint32_t ID)
     SUInt64PointerPushConstant PushConstant;
     PushConstant.DeviceAddress = DeviceAddress64;
     PushConstant.ObjectId = ID;
+    PushConstant.bVisibleInstances = 0;
+
+    Material->Bind();
+
+    vkCmdPushConstants(Frame->GetCommandBuffer()->GetVkCommandBuffer(), Material->GraphicsPipeline->GetPipelineLayout()->GetVkPipelineLayout(), VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(SUInt64PointerPushConstant), &PushConstant);
+    vkCmdBindIndexBuffer(Frame->GetCommandBuffer()->GetVkCommandBuffer(), IndexBuffer->Buffer, 0, VK_INDEX_TYPE_UINT32);
+    const uint32_t IndexCount = GetIndexCount();
+    vkCmdDrawIndexed(Frame->GetCommandBuffer()->GetVkCommandBuffer(), IndexCount, 1, 0, 0, 0);
+
+    PStats::Add(EStat::DrawCalls);
+    PStats::Add(EStat::Triangles, IndexCount / 3);
+
+    Material->Unbind();
+}
+
+void PVulkanMesh::DrawIndirect(VkBuffer CommandBuffer, VkDeviceSize Offset)
+{
+    PROFILE_FUNC_SCOPE("PVulkanMesh::DrawIndirect")
+
+    PVulkanFrame* Frame = GetRHI()->GetSceneRenderer()->GetParallelFramePool()->GetCurrentFrame();
+
+    SUInt64PointerPushConstant PushConstant;
+    PushConstant.DeviceAddress = DeviceAddress64;
+    PushConstant.ObjectId = 0;
+    PushConstant.bVisibleInstances = 1;
 
     Material->Bind();
 
     vkCmdPushConstants(Frame->GetCommandBuffer()->GetVkCommandBuffer(), Material->GraphicsPipeline->GetPipelineLayout()->GetVkPipelineLayout(), VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(SUInt64PointerPushConstant), &PushConstant);
     vkCmdBindIndexBuffer(Frame->GetCommandBuffer()->GetVkCommandBuffer(), IndexBuffer->Buffer, 0, VK_INDEX_TYPE_UINT32);
-    vkCmdDrawIndexed(Frame->GetCommandBuffer()->GetVkCommandBuffer(), static_cast<size_t>(IndexBuffer->AllocationInfo.size) / sizeof(uint32_t), 1, 0, 0, 0);
+    vkCmdDrawIndexedIndirect(Frame->GetCommandBuffer()->GetVkCommandBuffer(), CommandBuffer, Offset, 1, sizeof(VkDrawIndexedIndirectCommand));
+
+    // Triangles are counted by PVulkanGPUCuller once the instance count is read back.
+    PStats::Add(EStat::DrawCalls);
 
     Material->Unbind();
 }
@@ -159,4 +195,32 @@ void PVulkanMesh::SetVisibility(EVisibilityMode Mode)
 EVisibilityMode PVulkanMesh::GetVisibility() const
 {
     return VisibilityMode;
-}
\ No newline at end of file
+}
+
+uint32_t PVulkanMesh::GetIndexCount() const
+{
+    return static_cast<uint32_t>(static_cast<size_t>(IndexBuffer->AllocationInfo.size) / sizeof(uint32_t));
+}
+
+const SAABB& PVulkanMesh::GetLocalBounds() const
+{
+    return LocalBounds;
+}
+
+const SBoundingSphere& PVulkanMesh::GetLocalBoundingSphere() const
+{
+    return LocalBoundingSphere;
+}
+
+void PVulkanMesh::SetBounds(const SMeshBinaryData& MeshData)
+{
+    if (MeshData.LocalBounds.IsValid() || MeshData.Vertices.empty())
+    {
+        LocalBounds = MeshData.LocalBounds;
+        LocalBoundingSphere = MeshData.LocalBoundingSphere;
+        return;
+    }
+
+    LocalBounds = Bounds::ComputeAABB(&MeshData.Vertices[0].Position, MeshData.Vertices.size(), sizeof(SVertex));
+    LocalBoundingSphere = Bounds::ComputeBoundingSphere(&MeshData.Vertices[0].Position, MeshData.Vertices.size(), sizeof(SVertex), LocalBounds);
+}
@@ -5,7 +5,11 @@
 class PVulkanMaterial;
 class PVulkanBuffer;
 
+struct VkBuffer_T;
+
 typedef uint64_t VkDeviceAddress;
+typedef uint64_t VkDeviceSize;
+typedef VkBuffer_T* VkBuffer;
 
 class PVulkanMesh : public IMesh
 {
@@ -13,17 +17,28 @@ public:
     virtual void CreateMesh(const SMeshBinaryData& MeshBinaryObject) override;
     virtual void CreateDynamicMesh(const SMeshBinaryData& MeshBinaryObject) override;
     virtual void DrawIndirectInstanced(uint32_t ID) override;
+
+    // Draws with the VkDrawIndexedIndirectCommand at Offset, whose instances read their slot from VisibleInstances.
+    void DrawIndirect(VkBuffer CommandBuffer, VkDeviceSize Offset);
     virtual void Destroy() override;
 
     virtual void UpdateDynamicMesh(const SMeshBinaryData& MeshData) override;
 
+    virtual const SAABB& GetLocalBounds() const override;
+    virtual const SBoundingSphere& GetLocalBoundingSphere() const override;
+
     virtual IMaterial* GetMaterial() const override;
     virtual void SetMaterial(IMaterial* NewMaterial) override;
 
     virtual void SetVisibility(EVisibilityMode Mode) override;
     virtual EVisibilityMode GetVisibility() const override;
 
+    uint32_t GetIndexCount() const;
+
 private:
+    // Takes the bounds of the data, computing them if the producer did not.
+    void SetBounds(const SMeshBinaryData& MeshData);
+
     PVulkanMaterial* Material;
     PVulkanBuffer* VertexBuffer;
     PVulkanBuffer* IndexBuffer;
@@ -33,4 +48,7 @@ private:
     VkDeviceAddress DeviceAddress64;
 
     EVisibilityMode VisibilityMode;
+
+    SAABB LocalBounds;
+    SBoundingSphere LocalBoundingSphere;
 };
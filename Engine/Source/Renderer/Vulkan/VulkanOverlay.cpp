@@ -68,7 +68,12 @@ void PVulkanOverlay::Init()
 	VkFormat ColorAttachmentFormatPointer = GetRHI()->GetSceneRenderer()->GetSwapchain()->GetSurfaceFormat().format;
 
 	ImGui::CreateContext();
-	ImGui_ImplGlfw_InitForVulkan((GLFWwindow*)GetWindow()->GetNativeWindow(), true);
+
+	// Without a native window there is no platform backend, display size and delta time are fed manually each frame.
+	if (!GetWindow()->IsHeadless())
+	{
+		ImGui_ImplGlfw_InitForVulkan((GLFWwindow*)GetWindow()->GetNativeWindow(), true);
+	}
 
 	ImGui_ImplVulkan_InitInfo ImGuiInitInfo{};
 	ImGuiInitInfo.Instance = GetRHI()->GetInstance()->GetVkInstance();
@@ -87,10 +92,19 @@ void PVulkanOverlay::Init()
 	ImGui_ImplVulkan_Init(&ImGuiInitInfo);
 	ImGui_ImplVulkan_CreateFontsTexture();
 
-	GetRHI()->GetSceneRenderer()->GetOverlayRenderGraph()->AddCommand([&](PVulkanFrame* Frame) 
+	GetRHI()->GetSceneRenderer()->GetOverlayRenderGraph()->AddCommand("ImGui", [&](PVulkanFrame* Frame) 
 	{
 		ImGui_ImplVulkan_NewFrame();
-		ImGui_ImplGlfw_NewFrame();
+		if (GetWindow()->IsHeadless())
+		{
+			ImGuiIO& IO = ImGui::GetIO();
+			IO.DisplaySize = ImVec2(static_cast<float>(GetWindow()->GetWindowSpecification().Width), static_cast<float>(GetWindow()->GetWindowSpecification().Height));
+			IO.DeltaTime = std::max(GetEngine()->Timestep.GetDeltaTime(), 1e-4f);
+		}
+		else
+		{
+			ImGui_ImplGlfw_NewFrame();
+		}
 		ImGui::NewFrame();
 
     ImGui::Begin("Metrics");
@@ -112,9 +126,18 @@ void PVulkanOverlay::Init()
     ImGui::Text("Current Frame Time: %.3f ms", deltaTime * 1000.0f);
     ImGui::Text("Moving Average Frame Rate: %.1f FPS", avgFrameRate);
     ImGui::Text("Engine Time: %.3fs", GetEngine()->Time.GetElapsedTimeAsSeconds());
+    ImGui::Text("Frame Pacing: %s", GetFramePacingModeName(GetEngine()->FramePacer.GetMode()));
+
+    bool bOnDemand = GetEngine()->FramePacer.IsOnDemand();
+    if (ImGui::Checkbox("Render On Demand", &bOnDemand))
+    {
+        GetEngine()->FramePacer.SetOnDemand(bOnDemand);
+    }
 
     ImGui::End();
 
+		ProfilerView.OnImGuiRender();
+
 		OnRender.Broadcast();
 
 		ImGui::Render();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Core/ProfilerView.h"
 #include "Renderer/Common/Overlay.h"
 
 class PVulkanRHI;
@@ -14,4 +15,6 @@ public:
 
 private:
 	PVulkanDescriptorPool* DescriptorPool;
+
+	PProfilerView ProfilerView;
 };
\ No newline at end of file
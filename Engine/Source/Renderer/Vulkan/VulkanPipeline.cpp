@@ -10,6 +10,7 @@
 #include "Renderer/Vulkan/VulkanSceneRenderer.h"
 #include "Renderer/Vulkan/VulkanImage.h"
 #include "Renderer/Vulkan/VulkanCommand.h"
+#include "Utils/Stats.h"
 
 void PVulkanPipelineLayout::CreatePipelineLayout(const std::vector<PVulkanDescriptorSetLayout*> DescriptorSetLayouts, const std::vector<VkPushConstantRange>& PushConstantRanges)
 {
@@ -42,8 +43,10 @@ VkPipelineLayout PVulkanPipelineLayout::GetVkPipelineLayout() const
     return PipelineLayout;
 }
 
-void PVulkanGraphicsPipeline::CreatePipeline(PVulkanShader* Shader)
+void PVulkanGraphicsPipeline::CreatePipeline(PVulkanShader* Shader, EGraphicsPipelineMode Mode)
 {
+    const bool bDepthOnly = Mode == EGraphicsPipelineMode::DepthOnly;
+
     std::vector<VkPipelineShaderStageCreateInfo> ShaderStageCreateInfos;
     std::vector<PVulkanDescriptorSetLayout*> DescriptorSetLayouts;
 
@@ -56,7 +59,11 @@ void PVulkanGraphicsPipeline::CreatePipeline(PVulkanShader* Shader)
         ShaderStageCreateInfo.module = ShaderModule.ShaderModule;
         ShaderStageCreateInfo.stage = ShaderModule.Flag;
         
-        ShaderStageCreateInfos.push_back(ShaderStageCreateInfo);
+        // The layouts of skipped stages are still collected, the layout must match the color pipeline's.
+        if (!bDepthOnly || ShaderModule.Flag == VK_SHADER_STAGE_VERTEX_BIT)
+        {
+            ShaderStageCreateInfos.push_back(ShaderStageCreateInfo);
+        }
         
         DescriptorSetLayouts.resize(DescriptorSetLayouts.size() + ShaderModule.DescriptorSetLayouts.size());
         memcpy(DescriptorSetLayouts.data() + DescriptorSetLayouts.size() - ShaderModule.DescriptorSetLayouts.size(), ShaderModule.DescriptorSetLayouts.data(), ShaderModule.DescriptorSetLayouts.size() * sizeof(PVulkanDescriptorSetLayout*));
@@ -71,7 +78,7 @@ void PVulkanGraphicsPipeline::CreatePipeline(PVulkanShader* Shader)
     PipelineLayout->CreatePipelineLayout(DescriptorSetLayouts, { UInt64PointerPushConstantRange });
 
     VkFormat ColorAttachmentFormat = GetRHI()->GetSceneRenderer()->GetDrawImage()->GetVkFormat();
-    std::vector<VkDynamicState> DynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+    std::vector<VkDynamicState> DynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR, VK_DYNAMIC_STATE_DEPTH_COMPARE_OP, VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE };
 
     VkPipelineInputAssemblyStateCreateInfo InputAssemblyStateCreateInfo{};
     InputAssemblyStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
@@ -95,8 +102,9 @@ void PVulkanGraphicsPipeline::CreatePipeline(PVulkanShader* Shader)
     MultisampleStateCreateInfo.alphaToOneEnable = VK_FALSE;
 
     VkPipelineColorBlendAttachmentState ColorBlendAttachmentState{};
-    ColorBlendAttachmentState.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-    ColorBlendAttachmentState.blendEnable = VK_TRUE;
+    // The color attachment stays declared in depth only mode, the pipeline must match the rendering's attachment formats.
+    ColorBlendAttachmentState.colorWriteMask = bDepthOnly ? 0 : VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    ColorBlendAttachmentState.blendEnable = bDepthOnly ? VK_FALSE : VK_TRUE;
     ColorBlendAttachmentState.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
     ColorBlendAttachmentState.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
     ColorBlendAttachmentState.colorBlendOp = VK_BLEND_OP_ADD;
@@ -179,6 +187,9 @@ void PVulkanGraphicsPipeline::Bind(std::vector<VkDescriptorSet> DescriptorSetDat
 
     vkCmdBindPipeline(Frame->GetCommandBuffer()->GetVkCommandBuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS, Pipeline);
     vkCmdBindDescriptorSets(Frame->GetCommandBuffer()->GetVkCommandBuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS, PipelineLayout->GetVkPipelineLayout(), 0, DescriptorSetData.size(), DescriptorSetData.data(), 0, nullptr);
+
+    PStats::Add(EStat::PipelineBinds);
+    PStats::Add(EStat::DescriptorSetBinds, DescriptorSetData.size());
 }
 
 void PVulkanGraphicsPipeline::Unbind()
@@ -195,3 +206,67 @@ VkPipeline PVulkanGraphicsPipeline::GetVkPipeline() const
 {
     return Pipeline;
 }
+
+void PVulkanComputePipeline::CreatePipeline(PVulkanShader* Shader, uint32_t PushConstantSize)
+{
+    RK_ASSERT(Shader->GetShaderModules().size() == 1 && Shader->GetShaderModules()[0].Flag == VK_SHADER_STAGE_COMPUTE_BIT, "Compute pipelines require a single compute shader module.");
+    const SShaderModule& ShaderModule = Shader->GetShaderModules()[0];
+
+    std::vector<VkPushConstantRange> PushConstantRanges;
+    if (PushConstantSize > 0)
+    {
+        VkPushConstantRange PushConstantRange{};
+        PushConstantRange.offset = 0;
+        PushConstantRange.size = PushConstantSize;
+        PushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        PushConstantRanges.push_back(PushConstantRange);
+    }
+
+    PipelineLayout = new PVulkanPipelineLayout();
+    PipelineLayout->CreatePipelineLayout(ShaderModule.DescriptorSetLayouts, PushConstantRanges);
+
+    VkPipelineShaderStageCreateInfo ShaderStageCreateInfo{};
+    ShaderStageCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    ShaderStageCreateInfo.pNext = nullptr;
+    ShaderStageCreateInfo.pName = "main";
+    ShaderStageCreateInfo.module = ShaderModule.ShaderModule;
+    ShaderStageCreateInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkComputePipelineCreateInfo PipelineCreateInfo{};
+    PipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    PipelineCreateInfo.pNext = nullptr;
+    PipelineCreateInfo.stage = ShaderStageCreateInfo;
+    PipelineCreateInfo.layout = PipelineLayout->GetVkPipelineLayout();
+
+    VkResult Result = vkCreateComputePipelines(GetRHI()->GetDevice()->GetVkDevice(), VK_NULL_HANDLE, 1, &PipelineCreateInfo, nullptr, &Pipeline);
+    RK_ASSERT(Result == VK_SUCCESS, "Failed to create compute pipeline.");
+}
+
+void PVulkanComputePipeline::DestroyPipeline()
+{
+    PipelineLayout->DestroyPipelineLayout();
+    vkDestroyPipeline(GetRHI()->GetDevice()->GetVkDevice(), Pipeline, nullptr);
+
+    delete PipelineLayout;
+}
+
+void PVulkanComputePipeline::Bind(std::vector<VkDescriptorSet> DescriptorSetData)
+{
+    PVulkanFrame* Frame = GetRHI()->GetSceneRenderer()->GetParallelFramePool()->GetCurrentFrame();
+
+    vkCmdBindPipeline(Frame->GetCommandBuffer()->GetVkCommandBuffer(), VK_PIPELINE_BIND_POINT_COMPUTE, Pipeline);
+    vkCmdBindDescriptorSets(Frame->GetCommandBuffer()->GetVkCommandBuffer(), VK_PIPELINE_BIND_POINT_COMPUTE, PipelineLayout->GetVkPipelineLayout(), 0, DescriptorSetData.size(), DescriptorSetData.data(), 0, nullptr);
+
+    PStats::Add(EStat::PipelineBinds);
+    PStats::Add(EStat::DescriptorSetBinds, DescriptorSetData.size());
+}
+
+PVulkanPipelineLayout* PVulkanComputePipeline::GetPipelineLayout() const
+{
+    return PipelineLayout;
+}
+
+VkPipeline PVulkanComputePipeline::GetVkPipeline() const
+{
+    return Pipeline;
+}
@@ -19,10 +19,18 @@ private:
 	VkPipelineLayout PipelineLayout;
 };
 
+enum class EGraphicsPipelineMode : uint8_t
+{
+	Color,		// Every stage of the shader
+	DepthOnly	// Vertex stage only, writes no color, for depth pre-passes
+};
+
+// Depth compare op and depth writes are dynamic state, set per pass by PVulkanRenderGraph::SetDepthTest.
 class PVulkanGraphicsPipeline
 {
 public:
-	void CreatePipeline(PVulkanShader* Shader);
+	// Both modes create the same pipeline layout, so descriptor sets and push constants bound for one are valid for the other.
+	void CreatePipeline(PVulkanShader* Shader, EGraphicsPipelineMode Mode = EGraphicsPipelineMode::Color);
 	void DestroyPipeline();
 
 	void Bind(std::vector<VkDescriptorSet> Data);
@@ -36,4 +44,21 @@ protected:
 
 private:
 	VkPipeline Pipeline;
+};
+
+class PVulkanComputePipeline
+{
+public:
+	// PushConstantSize bytes of push constants are visible to the compute stage, 0 for none.
+	void CreatePipeline(PVulkanShader* Shader, uint32_t PushConstantSize);
+	void DestroyPipeline();
+
+	void Bind(std::vector<VkDescriptorSet> Data);
+
+	PVulkanPipelineLayout* GetPipelineLayout() const;
+	VkPipeline GetVkPipeline() const;
+
+private:
+	PVulkanPipelineLayout* PipelineLayout;
+	VkPipeline Pipeline;
 };
\ No newline at end of file
@@ -0,0 +1,261 @@
+#include "EnginePCH.h"
+#include "VulkanQuery.h"
+
+#include "Renderer/Vulkan/VulkanCommand.h"
+#include "Renderer/Vulkan/VulkanDevice.h"
+#include "Core/CommandLine.h"
+
+void PVulkanTimestampQueryPool::Init()
+{
+	const VkPhysicalDeviceProperties PhysicalDeviceProperties = GetRHI()->GetDevice()->GetPhysicalDeviceProperties();
+
+	uint32_t QueueFamilyCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(GetRHI()->GetDevice()->GetVkPhysicalDevice(), &QueueFamilyCount, nullptr);
+	std::vector<VkQueueFamilyProperties> QueueFamilies(QueueFamilyCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(GetRHI()->GetDevice()->GetVkPhysicalDevice(), &QueueFamilyCount, QueueFamilies.data());
+
+	// Zero valid bits means the graphics queue does not support timestamps at all.
+	const uint32_t ValidBits = QueueFamilies[GetRHI()->GetDevice()->GetGraphicsFamilyIndex().value()].timestampValidBits;
+	bSupported = ValidBits > 0 && PhysicalDeviceProperties.limits.timestampPeriod > 0.0f;
+	if (!bSupported)
+	{
+		RK_LOG_WARNING("GPU timestamps are not supported on the graphics queue.");
+		return;
+	}
+
+	TimestampPeriod = static_cast<double>(PhysicalDeviceProperties.limits.timestampPeriod);
+	TimestampMask = ValidBits >= 64 ? ~0ull : ((1ull << ValidBits) - 1);
+
+	VkQueryPoolCreateInfo QueryPoolCreateInfo{};
+	QueryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	QueryPoolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+	QueryPoolCreateInfo.queryCount = MAX_TIMESTAMP_QUERIES;
+
+	VkResult Result = vkCreateQueryPool(GetRHI()->GetDevice()->GetVkDevice(), &QueryPoolCreateInfo, nullptr, &QueryPool);
+	RK_ASSERT(Result == VK_SUCCESS, "Failed to create timestamp query pool.");
+
+	Timestamps.resize(MAX_TIMESTAMP_QUERIES);
+
+	bPipelineStatistics = PCommandLine::HasOption("--pipeline-statistics") && GetRHI()->GetDevice()->IsPipelineStatisticsQuerySupported();
+	if (bPipelineStatistics)
+	{
+		VkQueryPoolCreateInfo StatisticsQueryPoolCreateInfo{};
+		StatisticsQueryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		StatisticsQueryPoolCreateInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+		StatisticsQueryPoolCreateInfo.queryCount = MAX_PIPELINE_STATISTICS_QUERIES;
+		StatisticsQueryPoolCreateInfo.pipelineStatistics = VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT | VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+		Result = vkCreateQueryPool(GetRHI()->GetDevice()->GetVkDevice(), &StatisticsQueryPoolCreateInfo, nullptr, &StatisticsQueryPool);
+		RK_ASSERT(Result == VK_SUCCESS, "Failed to create pipeline statistics query pool.");
+
+		// Two counters per query, in bit order of the enabled statistics
+		PipelineStatistics.resize(MAX_PIPELINE_STATISTICS_QUERIES * 2);
+	}
+	else if (PCommandLine::HasOption("--pipeline-statistics"))
+	{
+		RK_LOG_WARNING("Pipeline statistics queries are not supported by this device.");
+	}
+}
+
+void PVulkanTimestampQueryPool::Shutdown()
+{
+	if (QueryPool)
+	{
+		vkDestroyQueryPool(GetRHI()->GetDevice()->GetVkDevice(), QueryPool, nullptr);
+		QueryPool = nullptr;
+	}
+
+	if (StatisticsQueryPool)
+	{
+		vkDestroyQueryPool(GetRHI()->GetDevice()->GetVkDevice(), StatisticsQueryPool, nullptr);
+		StatisticsQueryPool = nullptr;
+	}
+}
+
+void PVulkanTimestampQueryPool::Reset(PVulkanCommandBuffer* CommandBuffer)
+{
+	QueryCount = 0;
+	ReservedQueries = 0;
+	StatisticsQueryCount = 0;
+	bStatisticsQueryActive = false;
+	PendingScopes.clear();
+	OpenScopes.clear();
+
+	if (bSupported)
+	{
+		vkCmdResetQueryPool(CommandBuffer->GetVkCommandBuffer(), QueryPool, 0, MAX_TIMESTAMP_QUERIES);
+	}
+
+	if (bPipelineStatistics)
+	{
+		vkCmdResetQueryPool(CommandBuffer->GetVkCommandBuffer(), StatisticsQueryPool, 0, MAX_PIPELINE_STATISTICS_QUERIES);
+	}
+}
+
+void PVulkanTimestampQueryPool::BeginScope(PVulkanCommandBuffer* CommandBuffer, const char* Name, bool bCollectPipelineStatistics)
+{
+	if (!bSupported)
+	{
+		return;
+	}
+
+	// Every open scope holds on to one query for its end timestamp, scopes that do not fit are dropped.
+	if (QueryCount + ReservedQueries + 2 > MAX_TIMESTAMP_QUERIES)
+	{
+		OpenScopes.push_back(UINT32_MAX);
+		return;
+	}
+
+	SPendingScope Scope;
+	Scope.Name = Name;
+	Scope.Depth = static_cast<uint32_t>(OpenScopes.size());
+	Scope.BeginQuery = QueryCount++;
+	Scope.EndQuery = UINT32_MAX;
+	Scope.StatisticsQuery = UINT32_MAX;
+	ReservedQueries++;
+
+	vkCmdWriteTimestamp2(CommandBuffer->GetVkCommandBuffer(), VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, QueryPool, Scope.BeginQuery);
+
+	if (bCollectPipelineStatistics && bPipelineStatistics && !bStatisticsQueryActive && StatisticsQueryCount < MAX_PIPELINE_STATISTICS_QUERIES)
+	{
+		Scope.StatisticsQuery = StatisticsQueryCount++;
+		bStatisticsQueryActive = true;
+
+		vkCmdBeginQuery(CommandBuffer->GetVkCommandBuffer(), StatisticsQueryPool, Scope.StatisticsQuery, 0);
+	}
+
+	OpenScopes.push_back(static_cast<uint32_t>(PendingScopes.size()));
+	PendingScopes.push_back(Scope);
+}
+
+void PVulkanTimestampQueryPool::EndScope(PVulkanCommandBuffer* CommandBuffer)
+{
+	if (!bSupported || OpenScopes.empty())
+	{
+		return;
+	}
+
+	const uint32_t ScopeIndex = OpenScopes.back();
+	OpenScopes.pop_back();
+
+	if (ScopeIndex == UINT32_MAX)
+	{
+		return;
+	}
+
+	SPendingScope& Scope = PendingScopes[ScopeIndex];
+	Scope.EndQuery = QueryCount++;
+	ReservedQueries--;
+
+	if (Scope.StatisticsQuery != UINT32_MAX)
+	{
+		vkCmdEndQuery(CommandBuffer->GetVkCommandBuffer(), StatisticsQueryPool, Scope.StatisticsQuery);
+		bStatisticsQueryActive = false;
+	}
+
+	vkCmdWriteTimestamp2(CommandBuffer->GetVkCommandBuffer(), VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT, QueryPool, Scope.EndQuery);
+}
+
+void PVulkanTimestampQueryPool::Resolve()
+{
+	Results.clear();
+
+	if (!bSupported || QueryCount == 0)
+	{
+		return;
+	}
+
+	// The frame fence has been signaled, so the results are available and this does not wait.
+	VkResult Result = vkGetQueryPoolResults(GetRHI()->GetDevice()->GetVkDevice(), QueryPool, 0, QueryCount, sizeof(uint64_t) * QueryCount, Timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+	if (Result != VK_SUCCESS)
+	{
+		return;
+	}
+
+	bool bStatisticsAvailable = false;
+	if (StatisticsQueryCount > 0)
+	{
+		Result = vkGetQueryPoolResults(GetRHI()->GetDevice()->GetVkDevice(), StatisticsQueryPool, 0, StatisticsQueryCount, sizeof(uint64_t) * 2 * StatisticsQueryCount, PipelineStatistics.data(), sizeof(uint64_t) * 2, VK_QUERY_RESULT_64_BIT);
+		bStatisticsAvailable = Result == VK_SUCCESS;
+	}
+
+	const uint64_t Origin = Timestamps[0] & TimestampMask;
+	for (const SPendingScope& Scope : PendingScopes)
+	{
+		if (Scope.EndQuery == UINT32_MAX)
+		{
+			continue;
+		}
+
+		const uint64_t Begin = Timestamps[Scope.BeginQuery] & TimestampMask;
+		const uint64_t End = Timestamps[Scope.EndQuery] & TimestampMask;
+
+		SGPUTimestampScope Resolved;
+		Resolved.Name = Scope.Name;
+		Resolved.Depth = Scope.Depth;
+		Resolved.StartMilliseconds = static_cast<double>(Begin - Origin) * TimestampPeriod * 1e-6;
+		Resolved.DurationMilliseconds = static_cast<double>(End >= Begin ? End - Begin : 0) * TimestampPeriod * 1e-6;
+		Resolved.bHasPipelineStatistics = bStatisticsAvailable && Scope.StatisticsQuery != UINT32_MAX;
+		Resolved.VertexShaderInvocations = Resolved.bHasPipelineStatistics ? PipelineStatistics[Scope.StatisticsQuery * 2 + 0] : 0;
+		Resolved.FragmentShaderInvocations = Resolved.bHasPipelineStatistics ? PipelineStatistics[Scope.StatisticsQuery * 2 + 1] : 0;
+		Results.push_back(Resolved);
+	}
+
+#ifdef RK_PROFILE
+	RecordProfilerEvents();
+#endif
+}
+
+void PVulkanTimestampQueryPool::SetSubmitTimestamp(uint64_t Timestamp)
+{
+	SubmitTimestamp = Timestamp;
+}
+
+void PVulkanTimestampQueryPool::RecordProfilerEvents()
+{
+	// There is no shared clock between CPU and GPU, the frame's first GPU timestamp is placed at its submission time.
+	const auto ToProfilerTimestamp = [this](double Milliseconds)
+	{
+		return SubmitTimestamp + PTickClock::SecondsToTicks(Milliseconds * 1e-3);
+	};
+
+	// Results are in begin order, ends of enclosing scopes are emitted once a scope at the same or lower depth begins.
+	std::vector<const SGPUTimestampScope*> OpenScopeStack;
+	for (const SGPUTimestampScope& Scope : Results)
+	{
+		while (!OpenScopeStack.empty() && OpenScopeStack.back()->Depth >= Scope.Depth)
+		{
+			PProfiler::RecordGPUEvent(GetProfilerLocation(OpenScopeStack.back()->Name), EProfilerEventType::End, ToProfilerTimestamp(OpenScopeStack.back()->StartMilliseconds + OpenScopeStack.back()->DurationMilliseconds));
+			OpenScopeStack.pop_back();
+		}
+
+		PProfiler::RecordGPUEvent(GetProfilerLocation(Scope.Name), EProfilerEventType::Begin, ToProfilerTimestamp(Scope.StartMilliseconds));
+		OpenScopeStack.push_back(&Scope);
+	}
+
+	while (!OpenScopeStack.empty())
+	{
+		PProfiler::RecordGPUEvent(GetProfilerLocation(OpenScopeStack.back()->Name), EProfilerEventType::End, ToProfilerTimestamp(OpenScopeStack.back()->StartMilliseconds + OpenScopeStack.back()->DurationMilliseconds));
+		OpenScopeStack.pop_back();
+	}
+}
+
+const SProfilerSourceLocation* PVulkanTimestampQueryPool::GetProfilerLocation(const char* Name)
+{
+	const SProfilerSourceLocation*& Location = ProfilerLocations[Name];
+	if (!Location)
+	{
+		Location = PProfiler::GetNamedSourceLocation(Name, "GPU");
+	}
+	return Location;
+}
+
+bool PVulkanTimestampQueryPool::IsSupported() const
+{
+	return bSupported;
+}
+
+const std::vector<SGPUTimestampScope>& PVulkanTimestampQueryPool::GetResults() const
+{
+	return Results;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class PVulkanCommandBuffer;
+struct SProfilerSourceLocation;
+
+struct VkQueryPool_T;
+typedef struct VkQueryPool_T* VkQueryPool;
+
+// Maximum number of timestamps written per frame, every scope consumes two. Render graph commands scale with the material count.
+static constexpr uint32_t MAX_TIMESTAMP_QUERIES = 512;
+
+// Maximum number of scopes per frame that collect pipeline statistics.
+static constexpr uint32_t MAX_PIPELINE_STATISTICS_QUERIES = 32;
+
+struct SGPUTimestampScope
+{
+	// Static string, scopes are named by the pass that records them.
+	const char* Name;
+
+	// Nesting level, 0 for the outermost scope
+	uint32_t Depth;
+
+	// Relative to the first timestamp written in the frame, in milliseconds
+	double StartMilliseconds;
+	double DurationMilliseconds;
+
+	// Only valid if bHasPipelineStatistics, see PVulkanTimestampQueryPool::BeginScope
+	bool bHasPipelineStatistics;
+	uint64_t VertexShaderInvocations;
+	uint64_t FragmentShaderInvocations;
+};
+
+// Per-frame pool of GPU timestamps. Results are read back once the frame fence has been waited on,
+// so resolving never stalls the CPU, at the cost of the data being one frame pool cycle old.
+//
+// Pipeline statistics (vertex and fragment shader invocations) are collected when --pipeline-statistics is passed
+// and the device supports them. With RK_PROFILE, resolved scopes are also recorded on the profiler's GPU track.
+class PVulkanTimestampQueryPool
+{
+public:
+	void Init();
+	void Shutdown();
+
+	// Must be recorded at the start of the command buffer, before any scope.
+	void Reset(PVulkanCommandBuffer* CommandBuffer);
+
+	// bPipelineStatistics is ignored while another scope is collecting them, statistics queries cannot nest.
+	void BeginScope(PVulkanCommandBuffer* CommandBuffer, const char* Name, bool bPipelineStatistics = false);
+	void EndScope(PVulkanCommandBuffer* CommandBuffer);
+
+	// CPU time (PProfiler::GetTimestamp) the frame was submitted at, the first GPU timestamp is aligned to it.
+	void SetSubmitTimestamp(uint64_t Timestamp);
+
+	// Reads back the scopes recorded the last time this frame was submitted. Call after waiting on the frame fence.
+	void Resolve();
+
+	bool IsSupported() const;
+	const std::vector<SGPUTimestampScope>& GetResults() const;
+
+private:
+	void RecordProfilerEvents();
+
+	// Resolved once per scope name, resolving takes the profiler's lock.
+	const SProfilerSourceLocation* GetProfilerLocation(const char* Name);
+
+	struct SPendingScope
+	{
+		const char* Name;
+		uint32_t Depth;
+		uint32_t BeginQuery;
+		uint32_t EndQuery;
+		uint32_t StatisticsQuery;
+	};
+
+	VkQueryPool QueryPool = nullptr;
+	VkQueryPool StatisticsQueryPool = nullptr;
+
+	// Nanoseconds per timestamp tick
+	double TimestampPeriod = 0.0;
+	uint64_t TimestampMask = 0;
+
+	uint32_t QueryCount = 0;
+	uint32_t ReservedQueries = 0;
+	std::vector<SPendingScope> PendingScopes;
+	std::vector<uint32_t> OpenScopes;
+
+	uint32_t StatisticsQueryCount = 0;
+	bool bStatisticsQueryActive = false;
+
+	uint64_t SubmitTimestamp = 0;
+
+	std::vector<uint64_t> Timestamps;
+	std::vector<uint64_t> PipelineStatistics;
+	std::vector<SGPUTimestampScope> Results;
+
+	bool bSupported = false;
+	bool bPipelineStatistics = false;
+
+	// Profiler GPU track locations by scope name, scope names are static strings.
+	std::unordered_map<const char*, const SProfilerSourceLocation*> ProfilerLocations;
+};
@@ -5,13 +5,14 @@
 #include "Renderer/Vulkan/VulkanSceneRenderer.h"
 #include "Renderer/Vulkan/VulkanImage.h"
 #include "Renderer/Vulkan/VulkanCommand.h"
+#include "Renderer/Vulkan/VulkanQuery.h"
 
-void PVulkanRenderGraph::AddCommand(std::function<void(PVulkanFrame*)>&& Func)
+void PVulkanRenderGraph::AddCommand(const char* Name, std::function<void(PVulkanFrame*)>&& Func, ERenderGraphCommandType Type, bool bPipelineStatistics)
 {
-    Commands.push_back(std::move(Func));
+    Commands.push_back({ Name, std::move(Func), Type, bPipelineStatistics });
 }
 
-void PVulkanRenderGraph::BeginRendering() 
+void PVulkanRenderGraph::BeginRendering(bool bClear)
 {
     PROFILE_FUNC_SCOPE("PVulkanRenderGraph::BeginRendering")
 
@@ -20,7 +21,7 @@ void PVulkanRenderGraph::BeginRendering()
     ColorAttachment.pNext = nullptr;
     ColorAttachment.imageView = GetRHI()->GetSceneRenderer()->GetDrawImage()->GetVkImageView();
     ColorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-    ColorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    ColorAttachment.loadOp = bClear ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
     ColorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
     ColorAttachment.clearValue = { 0.0033f, 0.0033f, 0.0033f, 1.0f };
 
@@ -29,7 +30,7 @@ void PVulkanRenderGraph::BeginRendering()
     DepthAttachment.pNext = nullptr;
     DepthAttachment.imageView = GetRHI()->GetSceneRenderer()->GetDepthImage()->GetVkImageView();
     DepthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
-    DepthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    DepthAttachment.loadOp = bClear ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
     DepthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
     DepthAttachment.clearValue.depthStencil.depth = 1.0f;
 
@@ -61,6 +62,15 @@ void PVulkanRenderGraph::BeginRendering()
     vkCmdBeginRendering(Frame->GetCommandBuffer()->GetVkCommandBuffer(), &RenderingInfo);
     vkCmdSetViewport(Frame->GetCommandBuffer()->GetVkCommandBuffer(), 0, 1, &Viewport);
     vkCmdSetScissor(Frame->GetCommandBuffer()->GetVkCommandBuffer(), 0, 1, &Scissor);
+
+    SetDepthTest(VK_COMPARE_OP_LESS, true);
+}
+
+void PVulkanRenderGraph::SetDepthTest(VkCompareOp CompareOp, bool bWrite)
+{
+    PVulkanFrame* Frame = GetRHI()->GetSceneRenderer()->GetParallelFramePool()->GetCurrentFrame();
+    vkCmdSetDepthCompareOp(Frame->GetCommandBuffer()->GetVkCommandBuffer(), CompareOp);
+    vkCmdSetDepthWriteEnable(Frame->GetCommandBuffer()->GetVkCommandBuffer(), bWrite ? VK_TRUE : VK_FALSE);
 }
 
 void PVulkanRenderGraph::EndRendering()
@@ -71,10 +81,30 @@ void PVulkanRenderGraph::EndRendering()
     vkCmdEndRendering(Frame->GetCommandBuffer()->GetVkCommandBuffer());   
 }
 
+void PVulkanRenderGraph::ExecuteSetup(PVulkanFrame* Frame)
+{
+    ExecuteCommands(Frame, ERenderGraphCommandType::Setup);
+}
+
 void PVulkanRenderGraph::Execute(PVulkanFrame* Frame)
 {
-    for (const auto& Command : Commands)
+    ExecuteCommands(Frame, ERenderGraphCommandType::Draw);
+}
+
+void PVulkanRenderGraph::ExecuteCommands(PVulkanFrame* Frame, ERenderGraphCommandType Type)
+{
+    PVulkanTimestampQueryPool* TimestampQueryPool = Frame->GetTimestampQueryPool();
+
+    // Commands do not nest, so those that asked can collect pipeline statistics, unless the pass executing the graph already does.
+    for (const SRenderGraphCommand& Command : Commands)
     {
-        Command(Frame);
+        if (Command.Type != Type)
+        {
+            continue;
+        }
+
+        TimestampQueryPool->BeginScope(Frame->GetCommandBuffer(), Command.Name, Command.bPipelineStatistics);
+        Command.Func(Frame);
+        TimestampQueryPool->EndScope(Frame->GetCommandBuffer());
     }
 }
\ No newline at end of file
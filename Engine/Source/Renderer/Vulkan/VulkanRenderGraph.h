@@ -4,15 +4,40 @@
 
 class PVulkanFrame;
 
+enum class ERenderGraphCommandType : uint8_t
+{
+    Setup,      // Prepares the frame's draws (e.g. uniforms), run once per frame by ExecuteSetup
+    Draw        // Records draws, run by every Execute of the frame
+};
+
 class PVulkanRenderGraph
 {
 public:
-    void AddCommand(std::function<void(PVulkanFrame*)>&& Func);
+    // Name must be a static string, it labels the command's GPU timestamp scope. With bPipelineStatistics the scope
+    // also counts the command's draws, each of those scopes takes one of the frame's few statistics queries.
+    void AddCommand(const char* Name, std::function<void(PVulkanFrame*)>&& Func, ERenderGraphCommandType Type = ERenderGraphCommandType::Draw,
+        bool bPipelineStatistics = false);
 
-    void BeginRendering();
+    // Without bClear the attachments keep what earlier passes of the frame rendered. The depth test starts as less with writes.
+    void BeginRendering(bool bClear = true);
+    // Only valid between BeginRendering and EndRendering.
+    void SetDepthTest(VkCompareOp CompareOp, bool bWrite);
+    // Runs the setup commands, once per frame before the first Execute.
+    void ExecuteSetup(PVulkanFrame* Frame);
+    // Runs the draw commands, once per pass that renders the graph.
     void Execute(PVulkanFrame* Frame);
     void EndRendering();
 
 private:
-    std::vector<std::function<void(PVulkanFrame*)>> Commands;
+    struct SRenderGraphCommand
+    {
+        const char* Name;
+        std::function<void(PVulkanFrame*)> Func;
+        ERenderGraphCommandType Type;
+        bool bPipelineStatistics;
+    };
+
+    void ExecuteCommands(PVulkanFrame* Frame, ERenderGraphCommandType Type);
+
+    std::vector<SRenderGraphCommand> Commands;
 };
\ No newline at end of file
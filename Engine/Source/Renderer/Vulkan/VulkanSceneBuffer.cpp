@@ -0,0 +1,412 @@
+#include "EnginePCH.h"
+#include "VulkanSceneBuffer.h"
+
+#include "Format/HLSL.h"
+#include "Renderer/Vulkan/VulkanBuffer.h"
+#include "Renderer/Vulkan/VulkanCommand.h"
+#include "Renderer/Vulkan/VulkanDescriptor.h"
+#include "Renderer/Vulkan/VulkanDevice.h"
+#include "Renderer/Vulkan/VulkanFrame.h"
+#include "Renderer/Vulkan/VulkanMemory.h"
+#include "Renderer/Vulkan/VulkanPipeline.h"
+#include "Renderer/Vulkan/VulkanSceneRenderer.h"
+#include "Renderer/Vulkan/VulkanShader.h"
+#include "Renderer/Vulkan/VulkanUtils.h"
+#include "Renderer/Vulkan/VulkanAllocator.h"
+#include "Utils/Stats.h"
+
+namespace Utils
+{
+	// The 1 MiB the storage buffer of every material used to be
+	static constexpr uint32_t InitialCapacity = 8192;
+	static constexpr uint32_t InitialUpdateCapacity = 1024;
+
+	// Matches numthreads in InstanceScatter.hlsl
+	static constexpr uint32_t ScatterGroupSize = 64;
+
+	static PVulkanBuffer* CreateInstanceBuffer(uint32_t Capacity)
+	{
+		PVulkanBuffer* Buffer = new PVulkanBuffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+		Buffer->Allocate(static_cast<size_t>(Capacity) * sizeof(SShaderStorageBufferObject));
+		return Buffer;
+	}
+
+	static PVulkanBuffer* CreateInstanceMeshBuffer(uint32_t Capacity)
+	{
+		PVulkanBuffer* Buffer = new PVulkanBuffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+		Buffer->Allocate(static_cast<size_t>(Capacity) * sizeof(uint32_t));
+		return Buffer;
+	}
+}
+
+void PVulkanSceneBuffer::Init()
+{
+	const FHLSL ComputeShader = Format::ImportHLSL(RK_ENGINE_DIR "/Shaders/HLSL/InstanceScatter.hlsl", "main", "cs_6_0");
+
+	ScatterShader = new PVulkanShader();
+	ScatterShader->CreateShader({ { ComputeShader.Data, ComputeShader.Size } });
+
+	ScatterPipeline = new PVulkanComputePipeline();
+	ScatterPipeline->CreatePipeline(ScatterShader, sizeof(uint32_t));
+
+	InstanceBuffer = Utils::CreateInstanceBuffer(Utils::InitialCapacity);
+	InstanceMeshBuffer = Utils::CreateInstanceMeshBuffer(Utils::InitialCapacity);
+	Capacity = Utils::InitialCapacity;
+
+	// Slots without a mesh are skipped by GPU culling, until the scatter writes their mesh index.
+	GetRHI()->GetSceneRenderer()->ImmediateSubmit([this](PVulkanCommandBuffer* CommandBuffer)
+	{
+		vkCmdFillBuffer(CommandBuffer->GetVkCommandBuffer(), InstanceMeshBuffer->Buffer, 0, VK_WHOLE_SIZE, InvalidMeshIndex);
+	});
+
+	VkDescriptorSetLayout ScatterDescriptorSetLayout = ScatterShader->GetShaderModules()[0].DescriptorSetLayouts[0]->GetVkDescriptorSetLayout();
+	for (PVulkanFrame* Frame : *GetRHI()->GetSceneRenderer()->GetParallelFramePool())
+	{
+		SFrameResources Resources;
+		Resources.Frame = Frame;
+
+		VkDescriptorSetAllocateInfo DescriptorSetAllocateInfo = {};
+		DescriptorSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		DescriptorSetAllocateInfo.pNext = nullptr;
+		DescriptorSetAllocateInfo.descriptorPool = Frame->GetMemory()->GetDescriptorPool()->GetVkDescriptorPool();
+		DescriptorSetAllocateInfo.descriptorSetCount = 1;
+		DescriptorSetAllocateInfo.pSetLayouts = &ScatterDescriptorSetLayout;
+
+		VkResult Result = vkAllocateDescriptorSets(GetRHI()->GetDevice()->GetVkDevice(), &DescriptorSetAllocateInfo, &Resources.ScatterDescriptorSet);
+		RK_ASSERT(Result == VK_SUCCESS, "Failed to allocate descriptor set.");
+
+		FrameResources.push_back(Resources);
+	}
+}
+
+void PVulkanSceneBuffer::Shutdown()
+{
+	Disconnect();
+
+	for (SFrameResources& Resources : FrameResources)
+	{
+		if (Resources.UpdateBuffer)
+		{
+			Resources.UpdateBuffer->Free();
+			delete Resources.UpdateBuffer;
+		}
+	}
+	FrameResources.clear();
+
+	RetiredBuffers.Destroy();
+
+	InstanceBuffer->Free();
+	delete InstanceBuffer;
+	InstanceBuffer = nullptr;
+
+	InstanceMeshBuffer->Free();
+	delete InstanceMeshBuffer;
+	InstanceMeshBuffer = nullptr;
+
+	ScatterPipeline->DestroyPipeline();
+	ScatterShader->DestroyShader();
+	delete ScatterPipeline;
+	delete ScatterShader;
+}
+
+void PVulkanSceneBuffer::AddInstanceBinding(PVulkanFrame* Frame, VkDescriptorSet DescriptorSet, uint32_t Binding)
+{
+	SInstanceBinding InstanceBinding;
+	InstanceBinding.Frame = Frame;
+	InstanceBinding.DescriptorSet = DescriptorSet;
+	InstanceBinding.Binding = Binding;
+	WriteInstanceBinding(InstanceBinding);
+
+	InstanceBindings.push_back(InstanceBinding);
+}
+
+void PVulkanSceneBuffer::Upload(PVulkanFrame* Frame)
+{
+	PROFILE_FUNC_SCOPE("PVulkanSceneBuffer::Upload")
+
+	// The scene is created after the renderer, entities that already have a mesh are picked up on connecting.
+	if (!Registry)
+	{
+		Connect(GetScene()->GetRegistry());
+	}
+
+	// Waiting on this frame's fence guaranteed that the frames which could read a retired buffer have completed.
+	RetiredBuffers.Update();
+
+	const VkCommandBuffer CommandBuffer = Frame->GetCommandBuffer()->GetVkCommandBuffer();
+
+	if (SlotEntities.size() > Capacity)
+	{
+		GrowInstanceBuffer(CommandBuffer, static_cast<uint32_t>(SlotEntities.size()));
+	}
+
+	// Descriptor sets of the other frames may still be in use, they are rewritten when their frame comes around.
+	for (SInstanceBinding& InstanceBinding : InstanceBindings)
+	{
+		if (InstanceBinding.Frame == Frame && InstanceBinding.Generation != Generation)
+		{
+			WriteInstanceBinding(InstanceBinding);
+		}
+	}
+
+	if (PendingUpdates.empty())
+	{
+		return;
+	}
+
+	SFrameResources& Resources = *std::find_if(FrameResources.begin(), FrameResources.end(), [Frame](const SFrameResources& Resources) { return Resources.Frame == Frame; });
+	const uint32_t UpdateCount = static_cast<uint32_t>(PendingUpdates.size());
+
+	// The frame's previous updates have been consumed, its buffer can be replaced right away.
+	if (UpdateCount > Resources.UpdateCapacity)
+	{
+		if (Resources.UpdateBuffer)
+		{
+			Resources.UpdateBuffer->Free();
+			delete Resources.UpdateBuffer;
+		}
+
+		Resources.UpdateCapacity = std::max({ UpdateCount, Resources.UpdateCapacity * 2, Utils::InitialUpdateCapacity });
+		Resources.UpdateBuffer = new PVulkanBuffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+		Resources.UpdateBuffer->Allocate(static_cast<size_t>(Resources.UpdateCapacity) * sizeof(SInstanceUpdate));
+	}
+
+	const size_t UpdateBytes = static_cast<size_t>(UpdateCount) * sizeof(SInstanceUpdate);
+	memcpy(Resources.UpdateBuffer->AllocationInfo.pMappedData, PendingUpdates.data(), UpdateBytes);
+	vmaFlushAllocation(GetRHI()->GetSceneRenderer()->GetAllocator()->GetMemoryAllocator(), Resources.UpdateBuffer->Allocation, 0, UpdateBytes);
+
+	VulkanUtils::WriteStorageBufferDescriptor(Resources.ScatterDescriptorSet, 0, Resources.UpdateBuffer->Buffer);
+	VulkanUtils::WriteStorageBufferDescriptor(Resources.ScatterDescriptorSet, 1, InstanceBuffer->Buffer);
+	VulkanUtils::WriteStorageBufferDescriptor(Resources.ScatterDescriptorSet, 2, InstanceMeshBuffer->Buffer);
+
+	// Earlier frames may still read the slots about to be overwritten, or write them in their own scatter.
+	VulkanUtils::InsertMemoryBarrier(CommandBuffer,
+		VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+		VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
+	ScatterPipeline->Bind({ Resources.ScatterDescriptorSet });
+	vkCmdPushConstants(CommandBuffer, ScatterPipeline->GetPipelineLayout()->GetVkPipelineLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(uint32_t), &UpdateCount);
+	vkCmdDispatch(CommandBuffer, (UpdateCount + Utils::ScatterGroupSize - 1) / Utils::ScatterGroupSize, 1, 1);
+
+	VulkanUtils::InsertMemoryBarrier(CommandBuffer,
+		VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+		VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+
+	PStats::Add(EStat::StorageBufferBytes, UpdateBytes);
+
+	for (const SInstanceUpdate& Update : PendingUpdates)
+	{
+		SlotUpdateIndices[Update.Slot] = InvalidSlot;
+	}
+	PendingUpdates.clear();
+}
+
+uint32_t PVulkanSceneBuffer::GetInstanceSlot(SEntityID EntityID) const
+{
+	const size_t EntityIndex = static_cast<size_t>(entt::to_entity(EntityID));
+	return EntityIndex < EntitySlots.size() ? EntitySlots[EntityIndex] : InvalidSlot;
+}
+
+uint32_t PVulkanSceneBuffer::GetCapacity() const
+{
+	return Capacity;
+}
+
+uint32_t PVulkanSceneBuffer::GetMaxCapacity() const
+{
+	const VkPhysicalDeviceProperties PhysicalDeviceProperties = GetRHI()->GetDevice()->GetPhysicalDeviceProperties();
+	return static_cast<uint32_t>(PhysicalDeviceProperties.limits.maxStorageBufferRange / sizeof(SShaderStorageBufferObject));
+}
+
+uint32_t PVulkanSceneBuffer::GetSlotCount() const
+{
+	return static_cast<uint32_t>(SlotEntities.size());
+}
+
+const std::vector<PVulkanSceneBuffer::SMeshRecord>& PVulkanSceneBuffer::GetMeshRecords() const
+{
+	return MeshRecords;
+}
+
+PVulkanBuffer* PVulkanSceneBuffer::GetInstanceBuffer() const
+{
+	return InstanceBuffer;
+}
+
+PVulkanBuffer* PVulkanSceneBuffer::GetInstanceMeshBuffer() const
+{
+	return InstanceMeshBuffer;
+}
+
+void PVulkanSceneBuffer::Connect(PRegistry* InRegistry)
+{
+	Registry = InRegistry;
+	Registry->OnConstruct<SMeshComponent>().connect<&PVulkanSceneBuffer::OnMeshConstructed>(*this);
+	Registry->OnDestroy<SMeshComponent>().connect<&PVulkanSceneBuffer::OnMeshDestroyed>(*this);
+	Registry->OnUpdate<STransformComponent>().connect<&PVulkanSceneBuffer::OnTransformUpdated>(*this);
+
+	Registry->View<SMeshComponent>([this](SEntityID EntityID, const SMeshComponent& MeshComponent)
+	{
+		AllocateSlot(EntityID, MeshComponent.Mesh);
+	});
+
+	Registry->View<STransformComponent, SMeshComponent>([this](SEntityID EntityID, const STransformComponent& TransformComponent, const SMeshComponent& MeshComponent)
+	{
+		RecordUpdate(GetInstanceSlot(EntityID), TransformComponent);
+	});
+}
+
+void PVulkanSceneBuffer::Disconnect()
+{
+	if (!Registry)
+	{
+		return;
+	}
+
+	Registry->OnConstruct<SMeshComponent>().disconnect<&PVulkanSceneBuffer::OnMeshConstructed>(*this);
+	Registry->OnDestroy<SMeshComponent>().disconnect<&PVulkanSceneBuffer::OnMeshDestroyed>(*this);
+	Registry->OnUpdate<STransformComponent>().disconnect<&PVulkanSceneBuffer::OnTransformUpdated>(*this);
+	Registry = nullptr;
+}
+
+void PVulkanSceneBuffer::OnMeshConstructed(SRegistry& InRegistry, SEntityID EntityID)
+{
+	const uint32_t Slot = AllocateSlot(EntityID, InRegistry.get<SMeshComponent>(EntityID).Mesh);
+
+	// A transform added later is uploaded once PRegistry::UpdateTransforms has resolved it.
+	if (const STransformComponent* TransformComponent = InRegistry.try_get<STransformComponent>(EntityID))
+	{
+		RecordUpdate(Slot, *TransformComponent);
+	}
+}
+
+void PVulkanSceneBuffer::OnMeshDestroyed(SRegistry& InRegistry, SEntityID EntityID)
+{
+	const size_t EntityIndex = static_cast<size_t>(entt::to_entity(EntityID));
+	const uint32_t Slot = EntitySlots[EntityIndex];
+
+	// The CPU path stops drawing the slot right away, GPU culling once the upload cleared its mesh index.
+	EntitySlots[EntityIndex] = InvalidSlot;
+	SlotEntities[Slot] = entt::null;
+	FreeSlots.push_back(Slot);
+
+	MeshRecords[SlotMeshes[Slot]].InstanceCount--;
+	SlotMeshes[Slot] = InvalidMeshIndex;
+	GetPendingUpdate(Slot).MeshIndex = InvalidMeshIndex;
+}
+
+void PVulkanSceneBuffer::OnTransformUpdated(SRegistry& InRegistry, SEntityID EntityID)
+{
+	const uint32_t Slot = GetInstanceSlot(EntityID);
+	if (Slot != InvalidSlot)
+	{
+		RecordUpdate(Slot, InRegistry.get<STransformComponent>(EntityID));
+	}
+}
+
+uint32_t PVulkanSceneBuffer::AllocateSlot(SEntityID EntityID, IMesh* Mesh)
+{
+	const uint32_t MeshIndex = RegisterMesh(Mesh);
+	MeshRecords[MeshIndex].InstanceCount++;
+
+	uint32_t Slot;
+	if (!FreeSlots.empty())
+	{
+		Slot = FreeSlots.back();
+		FreeSlots.pop_back();
+		SlotEntities[Slot] = EntityID;
+		SlotMeshes[Slot] = MeshIndex;
+	}
+	else
+	{
+		Slot = static_cast<uint32_t>(SlotEntities.size());
+		SlotEntities.push_back(EntityID);
+		SlotMeshes.push_back(MeshIndex);
+		SlotUpdateIndices.push_back(InvalidSlot);
+	}
+
+	const size_t EntityIndex = static_cast<size_t>(entt::to_entity(EntityID));
+	if (EntityIndex >= EntitySlots.size())
+	{
+		EntitySlots.resize(EntityIndex + 1, InvalidSlot);
+	}
+	EntitySlots[EntityIndex] = Slot;
+
+	return Slot;
+}
+
+uint32_t PVulkanSceneBuffer::RegisterMesh(IMesh* Mesh)
+{
+	const auto [Iterator, bInserted] = MeshIndices.try_emplace(Mesh, static_cast<uint32_t>(MeshRecords.size()));
+	if (bInserted)
+	{
+		MeshRecords.push_back({ Mesh, 0 });
+	}
+	return Iterator->second;
+}
+
+SInstanceUpdate& PVulkanSceneBuffer::GetPendingUpdate(uint32_t Slot)
+{
+	// Slots updated more than once before the upload overwrite their earlier entry.
+	if (SlotUpdateIndices[Slot] == InvalidSlot)
+	{
+		SlotUpdateIndices[Slot] = static_cast<uint32_t>(PendingUpdates.size());
+		PendingUpdates.emplace_back().Slot = Slot;
+	}
+
+	return PendingUpdates[SlotUpdateIndices[Slot]];
+}
+
+void PVulkanSceneBuffer::RecordUpdate(uint32_t Slot, const STransformComponent& TransformComponent)
+{
+	SInstanceUpdate& Update = GetPendingUpdate(Slot);
+	Update.MeshIndex = SlotMeshes[Slot];
+	Update.ModelMatrix = TransformComponent.WorldMatrix;
+	Update.NormalMatrix = TransformComponent.NormalMatrix;
+}
+
+void PVulkanSceneBuffer::GrowInstanceBuffer(VkCommandBuffer CommandBuffer, uint32_t RequiredCapacity)
+{
+	// Doubling stops at the most a binding can address.
+	const uint32_t MaxCapacity = GetMaxCapacity();
+	RK_ASSERT(RequiredCapacity <= MaxCapacity, "More instances than a storage buffer binding can address.");
+	const uint32_t NewCapacity = std::max(RequiredCapacity, std::min(Capacity * 2, MaxCapacity));
+	PVulkanBuffer* NewInstanceBuffer = Utils::CreateInstanceBuffer(NewCapacity);
+	PVulkanBuffer* NewInstanceMeshBuffer = Utils::CreateInstanceMeshBuffer(NewCapacity);
+
+	// Slots without an update this frame keep their data, so the old contents move over on the GPU.
+	VulkanUtils::InsertMemoryBarrier(CommandBuffer,
+		VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+		VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_READ_BIT);
+
+	VkBufferCopy BufferCopy{};
+	BufferCopy.srcOffset = 0;
+	BufferCopy.dstOffset = 0;
+	BufferCopy.size = static_cast<VkDeviceSize>(Capacity) * sizeof(SShaderStorageBufferObject);
+	vkCmdCopyBuffer(CommandBuffer, InstanceBuffer->Buffer, NewInstanceBuffer->Buffer, 1, &BufferCopy);
+
+	BufferCopy.size = static_cast<VkDeviceSize>(Capacity) * sizeof(uint32_t);
+	vkCmdCopyBuffer(CommandBuffer, InstanceMeshBuffer->Buffer, NewInstanceMeshBuffer->Buffer, 1, &BufferCopy);
+	vkCmdFillBuffer(CommandBuffer, NewInstanceMeshBuffer->Buffer, BufferCopy.size, VK_WHOLE_SIZE, InvalidMeshIndex);
+
+	VulkanUtils::InsertMemoryBarrier(CommandBuffer,
+		VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+		VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+
+	// The previous frame may still be reading the old buffer, and this frame copies from it.
+	RetiredBuffers.Retire(InstanceBuffer, static_cast<uint32_t>(FrameResources.size()));
+	RetiredBuffers.Retire(InstanceMeshBuffer, static_cast<uint32_t>(FrameResources.size()));
+
+	RK_LOG_INFO("Instance buffer grew from {} to {} slots", Capacity, NewCapacity);
+
+	InstanceBuffer = NewInstanceBuffer;
+	InstanceMeshBuffer = NewInstanceMeshBuffer;
+	Capacity = NewCapacity;
+	Generation++;
+}
+
+void PVulkanSceneBuffer::WriteInstanceBinding(SInstanceBinding& InstanceBinding)
+{
+	VulkanUtils::WriteStorageBufferDescriptor(InstanceBinding.DescriptorSet, InstanceBinding.Binding, InstanceBuffer->Buffer);
+	InstanceBinding.Generation = Generation;
+}
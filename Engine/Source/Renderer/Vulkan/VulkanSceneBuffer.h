@@ -0,0 +1,132 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+#include "Renderer/Vulkan/VulkanBuffer.h"
+#include "Scene/Registry.h"
+
+class IMesh;
+class PVulkanComputePipeline;
+class PVulkanFrame;
+class PVulkanShader;
+struct STransformComponent;
+
+// One changed instance, laid out like SInstanceUpdate in InstanceScatter.hlsl
+struct SInstanceUpdate
+{
+	uint32_t Slot;
+	uint32_t MeshIndex;
+	uint32_t Padding[2];
+	alignas(16) glm::mat4 ModelMatrix;
+	alignas(16) glm::mat4 NormalMatrix;
+};
+
+// GPU-resident instance data of every entity with a mesh, bound as the vertex shader's SSBO by every material.
+// Entities keep their slot for as long as they have a mesh, so a frame only uploads the transforms that changed,
+// as a compact list that a compute shader scatters into place. The buffer doubles when it runs out of slots.
+// Alongside, every slot stores the index of its mesh, for PVulkanGPUCuller to find the mesh's bounds and draw.
+class PVulkanSceneBuffer
+{
+public:
+	static constexpr uint32_t InvalidSlot = UINT32_MAX;
+	static constexpr uint32_t InvalidMeshIndex = UINT32_MAX;
+
+	// Meshes are indexed in the order they first appear and keep their index, InstanceCount is the number of slots using them.
+	struct SMeshRecord
+	{
+		IMesh* Mesh;
+		uint32_t InstanceCount;
+	};
+
+	void Init();
+	void Shutdown();
+
+	// Points the binding at the instance buffer. The binding is rewritten before the frame renders again whenever the buffer was reallocated.
+	void AddInstanceBinding(PVulkanFrame* Frame, VkDescriptorSet DescriptorSet, uint32_t Binding);
+
+	// Records the upload of this frame's changes into its command buffer, must run outside of rendering.
+	void Upload(PVulkanFrame* Frame);
+
+	// Index of the entity's instance data, pushed as the ObjectID of its draws. InvalidSlot without a mesh.
+	uint32_t GetInstanceSlot(SEntityID EntityID) const;
+
+	uint32_t GetCapacity() const;
+
+	// Most slots a storage buffer binding can address on this device (maxStorageBufferRange)
+	uint32_t GetMaxCapacity() const;
+
+	// Slots in use or freed, GPU passes over every slot dispatch this many threads.
+	uint32_t GetSlotCount() const;
+
+	const std::vector<SMeshRecord>& GetMeshRecords() const;
+
+	// Valid after Upload, until the next frame's upload reallocates them
+	PVulkanBuffer* GetInstanceBuffer() const;
+	PVulkanBuffer* GetInstanceMeshBuffer() const;
+
+private:
+	struct SInstanceBinding
+	{
+		PVulkanFrame* Frame;
+		VkDescriptorSet DescriptorSet;
+		uint32_t Binding;
+
+		// Generation of the instance buffer the descriptor points at
+		uint32_t Generation;
+	};
+
+	struct SFrameResources
+	{
+		PVulkanFrame* Frame;
+		VkDescriptorSet ScatterDescriptorSet;
+
+		// Host-visible staging of the frame's updates, reallocated when a frame has more updates than fit
+		PVulkanBuffer* UpdateBuffer = nullptr;
+		uint32_t UpdateCapacity = 0;
+	};
+
+	void Connect(PRegistry* InRegistry);
+	void Disconnect();
+
+	void OnMeshConstructed(SRegistry& InRegistry, SEntityID EntityID);
+	void OnMeshDestroyed(SRegistry& InRegistry, SEntityID EntityID);
+	void OnTransformUpdated(SRegistry& InRegistry, SEntityID EntityID);
+
+	uint32_t AllocateSlot(SEntityID EntityID, IMesh* Mesh);
+	uint32_t RegisterMesh(IMesh* Mesh);
+
+	SInstanceUpdate& GetPendingUpdate(uint32_t Slot);
+	void RecordUpdate(uint32_t Slot, const STransformComponent& TransformComponent);
+
+	void GrowInstanceBuffer(VkCommandBuffer CommandBuffer, uint32_t RequiredCapacity);
+	void WriteInstanceBinding(SInstanceBinding& InstanceBinding);
+
+	PRegistry* Registry = nullptr;
+
+	PVulkanBuffer* InstanceBuffer = nullptr;
+	PVulkanBuffer* InstanceMeshBuffer = nullptr;
+	uint32_t Capacity = 0;
+	uint32_t Generation = 0;
+
+	// Indexed by entity index and by slot respectively
+	std::vector<uint32_t> EntitySlots;
+	std::vector<SEntityID> SlotEntities;
+	std::vector<uint32_t> SlotMeshes;
+	std::vector<uint32_t> FreeSlots;
+
+	std::vector<SMeshRecord> MeshRecords;
+	std::unordered_map<IMesh*, uint32_t> MeshIndices;
+
+	// At most one update per slot, SlotUpdateIndices maps a slot to its entry in PendingUpdates
+	std::vector<SInstanceUpdate> PendingUpdates;
+	std::vector<uint32_t> SlotUpdateIndices;
+
+	std::vector<SInstanceBinding> InstanceBindings;
+	std::vector<SFrameResources> FrameResources;
+	PVulkanRetiredBuffers RetiredBuffers;
+
+	PVulkanShader* ScatterShader = nullptr;
+	PVulkanComputePipeline* ScatterPipeline = nullptr;
+};
@@ -4,12 +4,17 @@
 #include "Renderer/Vulkan/VulkanAllocator.h"
 #include "Renderer/Vulkan/VulkanFrame.h"
 #include "Renderer/Vulkan/VulkanDevice.h"
+#include "Renderer/Vulkan/VulkanGPUCuller.h"
 #include "Renderer/Vulkan/VulkanImage.h"
 #include "Renderer/Vulkan/VulkanSwapchain.h"
+#include "Renderer/Vulkan/VulkanHeadlessSwapchain.h"
+#include "Renderer/Vulkan/VulkanQuery.h"
 #include "Renderer/Vulkan/VulkanPipeline.h"
 #include "Renderer/Vulkan/VulkanCommand.h"
 #include "Renderer/Vulkan/VulkanOverlay.h"
 #include "Renderer/Vulkan/VulkanRenderGraph.h"
+#include "Renderer/Vulkan/VulkanSceneBuffer.h"
+#include "Utils/Stats.h"
 
 // 3 swapchain images, 2 frames.
 // 1 frame is currently being processed by CPU, 1 is being drawn by GPU, hence no need for a third frame.
@@ -19,13 +24,15 @@ static constexpr size_t ImmediateFrameCount = 1;
 void PVulkanSceneRenderer::Init()
 {
 	Allocator = new PVulkanAllocator();
-	Swapchain = new PVulkanSwapchain();
+	Swapchain = GetWindow()->IsHeadless() ? new PVulkanHeadlessSwapchain() : new PVulkanSwapchain();
 	DrawImage = new PVulkanImage();
 	DepthImage = new PVulkanImage();
 	RenderGraph = new PVulkanRenderGraph();
 	OverlayRenderGraph = new PVulkanRenderGraph();
 	ParallelFramePool = new PVulkanFramePool(DeferredFrameCount);
 	ImmediateFramePool = new PVulkanFramePool(ImmediateFrameCount);
+	SceneBuffer = new PVulkanSceneBuffer();
+	GPUCuller = new PVulkanGPUCuller();
 	GOverlay = new PVulkanOverlay();
 
 	Allocator->Init();
@@ -35,19 +42,24 @@ void PVulkanSceneRenderer::Init()
 	DrawImage->CreateImage(VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT);
 	DrawImage->CreateImageView(VK_IMAGE_ASPECT_COLOR_BIT);
 	
+	// Sampled by the depth pyramid of GPU culling
 	DepthImage->Init(GetSwapchain()->GetVkExtent(), VK_FORMAT_D32_SFLOAT);
-	DepthImage->CreateImage(VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT);
+	DepthImage->CreateImage(VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
 	DepthImage->CreateImageView(VK_IMAGE_ASPECT_DEPTH_BIT);
 	
 	ParallelFramePool->CreateFramePool();
 	ImmediateFramePool->CreateFramePool();
 
+	SceneBuffer->Init();
+	GPUCuller->Init();
 	GOverlay->Init();
 }
 
 void PVulkanSceneRenderer::Shutdown()
 {
 	GOverlay->Shutdown();
+	GPUCuller->Shutdown();
+	SceneBuffer->Shutdown();
 	ParallelFramePool->FreeFramePool();
 	ImmediateFramePool->FreeFramePool();
 	DrawImage->DestroyImage();
@@ -58,6 +70,8 @@ void PVulkanSceneRenderer::Shutdown()
 	Allocator->Shutdown();
 
 	delete GOverlay;
+	delete GPUCuller;
+	delete SceneBuffer;
 	delete ParallelFramePool;
 	delete ImmediateFramePool;
 	delete DrawImage;
@@ -84,8 +98,10 @@ void PVulkanSceneRenderer::Resize()
 	DepthImage->DestroyImageView();
 	DepthImage->Reset();
 	DepthImage->Init(GetSwapchain()->GetVkExtent(), VK_FORMAT_D32_SFLOAT);
-	DepthImage->CreateImage(VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT);
-	DepthImage->CreateImageView(VK_IMAGE_ASPECT_DEPTH_BIT);	
+	DepthImage->CreateImage(VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+	DepthImage->CreateImageView(VK_IMAGE_ASPECT_DEPTH_BIT);
+
+	GPUCuller->Resize();
 }
 
 void PVulkanSceneRenderer::Render()
@@ -95,22 +111,94 @@ void PVulkanSceneRenderer::Render()
 	PVulkanFrame* Frame = ParallelFramePool->GetCurrentFrame();
 	Frame->BeginFrame();
 
+	PVulkanTimestampQueryPool* TimestampQueryPool = Frame->GetTimestampQueryPool();
+	TimestampQueryPool->BeginScope(Frame->GetCommandBuffer(), "Frame");
+
+	PCamera* Camera = GetScene()->GetCamera();
+	const glm::mat4 ViewProjection = Camera->GetProjectionMatrix() * Camera->GetViewMatrix();
+	const bool bGPUCulling = GPUCuller->IsEnabled();
+
+	// Before any draw is recorded, the draw path only submits what survived.
+	if (!bGPUCulling)
+	{
+		GetScene()->GetFrustumCuller()->Cull(*Camera);
+	}
+
+	// Compute work, so it is recorded before rendering begins.
+	TimestampQueryPool->BeginScope(Frame->GetCommandBuffer(), "SceneUpload");
+	SceneBuffer->Upload(Frame);
+	TimestampQueryPool->EndScope(Frame->GetCommandBuffer());
+
+	if (bGPUCulling)
+	{
+		TimestampQueryPool->BeginScope(Frame->GetCommandBuffer(), "GPUCullEarly");
+		GPUCuller->CullEarly(Frame, ViewProjection);
+		TimestampQueryPool->EndScope(Frame->GetCommandBuffer());
+	}
+
+	// Setup commands run once, every scene pass below only repeats the draws.
+	RenderGraph->ExecuteSetup(Frame);
+
 	DrawImage->TransitionImageLayout(Frame->GetCommandBuffer(), VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
 	DepthImage->TransitionImageLayout(Frame->GetCommandBuffer(), VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL);
-	RenderGraph->BeginRendering();
-	RenderGraph->Execute(Frame);
-	RenderGraph->EndRendering();
+	ExecuteScenePasses(Frame, true, "DepthPrePass", "Scene");
+
+	// Instances hidden behind last frame's depth are tested against this frame's, those that were not draw on top.
+	if (bGPUCulling)
+	{
+		TimestampQueryPool->BeginScope(Frame->GetCommandBuffer(), "GPUCullLate");
+		GPUCuller->CullLate(Frame);
+		TimestampQueryPool->EndScope(Frame->GetCommandBuffer());
+
+		ExecuteScenePasses(Frame, false, "DepthPrePassLate", "SceneLate");
+	}
+
 	DrawImage->TransitionImageLayout(Frame->GetCommandBuffer(), VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
 
+	TimestampQueryPool->BeginScope(Frame->GetCommandBuffer(), "Blit");
 	Swapchain->GetSwapchainImages()[Frame->GetTransientFrameData().NextImageIndex]->TransitionImageLayout(Frame->GetCommandBuffer(), VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 	DrawImage->CopyImageRegion(Frame->GetCommandBuffer(), Swapchain->GetSwapchainImages()[Frame->GetTransientFrameData().NextImageIndex]->GetVkImage(), DrawImage->GetImageExtent2D(), Swapchain->GetVkExtent());
+	TimestampQueryPool->EndScope(Frame->GetCommandBuffer());
+
+	TimestampQueryPool->BeginScope(Frame->GetCommandBuffer(), "Overlay");
 	OverlayRenderGraph->Execute(Frame);
-	Swapchain->GetSwapchainImages()[Frame->GetTransientFrameData().NextImageIndex]->TransitionImageLayout(Frame->GetCommandBuffer(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+	Swapchain->GetSwapchainImages()[Frame->GetTransientFrameData().NextImageIndex]->TransitionImageLayout(Frame->GetCommandBuffer(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, Swapchain->GetFinalImageLayout());
+	TimestampQueryPool->EndScope(Frame->GetCommandBuffer());
 
+	TimestampQueryPool->EndScope(Frame->GetCommandBuffer());
 	Frame->EndFrame();
 	ParallelFramePool->FrameIndex++;
 }
 
+void PVulkanSceneRenderer::ExecuteScenePasses(PVulkanFrame* Frame, bool bClear, const char* DepthPrePassName, const char* ColorPassName)
+{
+	PVulkanTimestampQueryPool* TimestampQueryPool = Frame->GetTimestampQueryPool();
+	const bool bDepthPrePass = GetScene()->IsDepthPrePassEnabled();
+
+	if (bDepthPrePass)
+	{
+		ScenePass = EScenePass::DepthPrePass;
+		TimestampQueryPool->BeginScope(Frame->GetCommandBuffer(), DepthPrePassName, true);
+		RenderGraph->BeginRendering(bClear);
+		RenderGraph->Execute(Frame);
+		RenderGraph->EndRendering();
+		TimestampQueryPool->EndScope(Frame->GetCommandBuffer());
+	}
+
+	// After the pre-pass every pixel holds its nearest depth, only the fragment that wrote it passes the equal test
+	// and the expensive shading runs once per pixel.
+	ScenePass = EScenePass::Color;
+	TimestampQueryPool->BeginScope(Frame->GetCommandBuffer(), ColorPassName, true);
+	RenderGraph->BeginRendering(bClear && !bDepthPrePass);
+	if (bDepthPrePass)
+	{
+		RenderGraph->SetDepthTest(VK_COMPARE_OP_EQUAL, false);
+	}
+	RenderGraph->Execute(Frame);
+	RenderGraph->EndRendering();
+	TimestampQueryPool->EndScope(Frame->GetCommandBuffer());
+}
+
 PVulkanAllocator* PVulkanSceneRenderer::GetAllocator() const
 {
 	return Allocator;
@@ -146,6 +234,21 @@ PVulkanFramePool* PVulkanSceneRenderer::GetParallelFramePool() const
 	return ParallelFramePool;
 }
 
+PVulkanSceneBuffer* PVulkanSceneRenderer::GetSceneBuffer() const
+{
+	return SceneBuffer;
+}
+
+PVulkanGPUCuller* PVulkanSceneRenderer::GetGPUCuller() const
+{
+	return GPUCuller;
+}
+
+EScenePass PVulkanSceneRenderer::GetScenePass() const
+{
+	return ScenePass;
+}
+
 // TODO: Move to Command
 void PVulkanSceneRenderer::ImmediateSubmit(std::function<void(PVulkanCommandBuffer* CommandBuffer)>&& Func)
 {
@@ -169,6 +272,7 @@ void PVulkanSceneRenderer::ImmediateSubmit(std::function<void(PVulkanCommandBuff
 	RK_ASSERT(Result == VK_SUCCESS, "Failed to begin command buffer.");
 
 	Func(ImmediateFramePool->Pool[0]->GetCommandBuffer());
+	PStats::Add(EStat::ImmediateSubmits);
 
 	Result = vkEndCommandBuffer(CommandBufferPointer);
 	RK_ASSERT(Result == VK_SUCCESS, "Failed to end command buffer..");
@@ -11,6 +11,16 @@ class PVulkanImage;
 class PVulkanSwapchain;
 class PVulkanCommandBuffer;
 class PVulkanAllocator;
+class PVulkanSceneBuffer;
+class PVulkanGPUCuller;
+class PVulkanFrame;
+
+// Pass of the scene the render graph is executing, materials bind the pipeline of the pass.
+enum class EScenePass : uint8_t
+{
+	DepthPrePass,	// Depth only, less with depth writes
+	Color			// Less with depth writes, or equal without them after a depth pre-pass
+};
 
 class PVulkanSceneRenderer : public IRenderer
 {
@@ -21,6 +31,9 @@ public:
 		DrawImage = nullptr;
 		ParallelFramePool = nullptr;
 		ImmediateFramePool = nullptr;
+		SceneBuffer = nullptr;
+		GPUCuller = nullptr;
+		ScenePass = EScenePass::Color;
 	}
 
 	void Init();
@@ -35,10 +48,17 @@ public:
 	PVulkanRenderGraph* GetRenderGraph() const;
 	PVulkanRenderGraph* GetOverlayRenderGraph() const;
 	PVulkanFramePool* GetParallelFramePool() const;
+	PVulkanSceneBuffer* GetSceneBuffer() const;
+	PVulkanGPUCuller* GetGPUCuller() const;
+	EScenePass GetScenePass() const;
 
 	void ImmediateSubmit(std::function<void(PVulkanCommandBuffer*)>&& Func);
 
 private:
+	// Executes the render graph in a depth pre-pass if the scene enabled it, then in the color pass. Both passes
+	// collect pipeline statistics under their names. bClear clears the attachments before the first pass.
+	void ExecuteScenePasses(PVulkanFrame* Frame, bool bClear, const char* DepthPrePassName, const char* ColorPassName);
+
 	PVulkanAllocator* Allocator;
 	PVulkanSwapchain* Swapchain;
 	PVulkanImage* DrawImage;
@@ -47,4 +67,7 @@ private:
 	PVulkanRenderGraph* OverlayRenderGraph;
 	PVulkanFramePool* ParallelFramePool;
 	PVulkanFramePool* ImmediateFramePool;
+	PVulkanSceneBuffer* SceneBuffer;
+	PVulkanGPUCuller* GPUCuller;
+	EScenePass ScenePass;
 };
@@ -34,9 +34,12 @@ void PVulkanShader::CreateShader(std::vector<SShaderModuleBinary> ShaderBinaryOb
 		{
 			case spv::ExecutionModelVertex: ShaderModule.Flag = VK_SHADER_STAGE_VERTEX_BIT; break;
 			case spv::ExecutionModelFragment: ShaderModule.Flag = VK_SHADER_STAGE_FRAGMENT_BIT; break;
+			case spv::ExecutionModelGLCompute: ShaderModule.Flag = VK_SHADER_STAGE_COMPUTE_BIT; break;
 			default: break;
 		}
 
+		const EDescriptorSetBindingFlag BindingFlag = ShaderModule.Flag == VK_SHADER_STAGE_COMPUTE_BIT ? EDescriptorSetBindingFlag::Compute : EDescriptorSetBindingFlag::Vertex;
+
 		std::unordered_map<uint32_t, std::vector<SDescriptorSetBindingLayout>> Sets;
 		for (const auto& Resource : Resources.uniform_buffers)
 		{
@@ -49,7 +52,7 @@ void PVulkanShader::CreateShader(std::vector<SShaderModuleBinary> ShaderBinaryOb
 			SDescriptorSetBindingLayout DescriptorSetBinding;
 			DescriptorSetBinding.Name = Compiler.get_name(Resource.id);
 			DescriptorSetBinding.Binding = Binding;
-			DescriptorSetBinding.Flag = EDescriptorSetBindingFlag::Vertex;
+			DescriptorSetBinding.Flag = BindingFlag;
 			DescriptorSetBinding.Type = EDescriptorSetBindingType::Uniform;
 			DescriptorSetBinding.Size = BufferStride;
 
@@ -84,12 +87,37 @@ void PVulkanShader::CreateShader(std::vector<SShaderModuleBinary> ShaderBinaryOb
 			DescriptorSetBinding.Name = Compiler.get_name(Resource.id);
 			DescriptorSetBinding.Binding = Binding;
 			DescriptorSetBinding.Size = BufferStride * 1024 * 10;
-			DescriptorSetBinding.Flag = EDescriptorSetBindingFlag::Vertex;
+			DescriptorSetBinding.Flag = BindingFlag;
 			DescriptorSetBinding.Type = EDescriptorSetBindingType::Storage;
 
 			Sets[Set].push_back(DescriptorSetBinding);
 		}
 
+		// Texture2D and RWTexture2D, written by the owner of the image (e.g. the depth pyramid of PVulkanGPUCuller).
+		for (const auto& Resource : Resources.separate_images)
+		{
+			SDescriptorSetBindingLayout DescriptorSetBinding;
+			DescriptorSetBinding.Name = Compiler.get_name(Resource.id);
+			DescriptorSetBinding.Binding = Compiler.get_decoration(Resource.id, spv::DecorationBinding);
+			DescriptorSetBinding.Size = 0;
+			DescriptorSetBinding.Flag = BindingFlag;
+			DescriptorSetBinding.Type = EDescriptorSetBindingType::SampledImage;
+
+			Sets[Compiler.get_decoration(Resource.id, spv::DecorationDescriptorSet)].push_back(DescriptorSetBinding);
+		}
+
+		for (const auto& Resource : Resources.storage_images)
+		{
+			SDescriptorSetBindingLayout DescriptorSetBinding;
+			DescriptorSetBinding.Name = Compiler.get_name(Resource.id);
+			DescriptorSetBinding.Binding = Compiler.get_decoration(Resource.id, spv::DecorationBinding);
+			DescriptorSetBinding.Size = 0;
+			DescriptorSetBinding.Flag = BindingFlag;
+			DescriptorSetBinding.Type = EDescriptorSetBindingType::StorageImage;
+
+			Sets[Compiler.get_decoration(Resource.id, spv::DecorationDescriptorSet)].push_back(DescriptorSetBinding);
+		}
+
 		for (const auto& PushConstant : Resources.push_constant_buffers)
 		{
 			//VkPushConstantRange pushConstantRange = {};
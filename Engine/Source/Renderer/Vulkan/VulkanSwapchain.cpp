@@ -136,6 +136,36 @@ void PVulkanSwapchain::Shutdown()
 	vkDestroySwapchainKHR(GetRHI()->GetDevice()->GetVkDevice(), SwapchainKHR, nullptr);
 }
 
+bool PVulkanSwapchain::AcquireNextImage(VkSemaphore SignalSemaphore, uint32_t& ImageIndex)
+{
+	vkAcquireNextImageKHR(GetRHI()->GetDevice()->GetVkDevice(), SwapchainKHR, UINT64_MAX, SignalSemaphore, nullptr, &ImageIndex);
+	return true;
+}
+
+void PVulkanSwapchain::Present(VkSemaphore WaitSemaphore, uint32_t ImageIndex)
+{
+	VkPresentInfoKHR PresentInfo = {};
+	PresentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+	PresentInfo.pNext = nullptr;
+	PresentInfo.pSwapchains = &SwapchainKHR;
+	PresentInfo.swapchainCount = 1;
+	PresentInfo.pWaitSemaphores = &WaitSemaphore;
+	PresentInfo.waitSemaphoreCount = 1;
+	PresentInfo.pImageIndices = &ImageIndex;
+
+	vkQueuePresentKHR(GetRHI()->GetDevice()->GetGraphicsQueue(), &PresentInfo);
+}
+
+VkImageLayout PVulkanSwapchain::GetFinalImageLayout() const
+{
+	return VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+}
+
+bool PVulkanSwapchain::IsPresentable() const
+{
+	return true;
+}
+
 VkSwapchainKHR PVulkanSwapchain::GetVkSwapchain() const
 {
 	return SwapchainKHR;
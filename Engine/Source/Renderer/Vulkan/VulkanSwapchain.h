@@ -6,17 +6,30 @@ class PVulkanRHI;
 class PVulkanImage;
 
 struct VkSwapchainKHR_T;
+struct VkSemaphore_T;
 struct VkSurfaceFormatKHR;
 struct VkExtent2D;
 enum VkPresentModeKHR;
+enum VkImageLayout;
 
 typedef struct VkSwapchainKHR_T* VkSwapchainKHR;
+typedef struct VkSemaphore_T* VkSemaphore;
 
 class PVulkanSwapchain
 {
 public:
-	void Init();
-	void Shutdown();
+	virtual ~PVulkanSwapchain() = default;
+
+	virtual void Init();
+	virtual void Shutdown();
+
+	// Signals the semaphore once the image can be written to. Returns false if the semaphore will not be signaled.
+	virtual bool AcquireNextImage(VkSemaphore SignalSemaphore, uint32_t& ImageIndex);
+	virtual void Present(VkSemaphore WaitSemaphore, uint32_t ImageIndex);
+
+	// Layout the image is left in at the end of the frame.
+	virtual VkImageLayout GetFinalImageLayout() const;
+	virtual bool IsPresentable() const;
 
 	VkSwapchainKHR GetVkSwapchain() const;
 	VkExtent2D GetVkExtent() const;
@@ -24,7 +37,7 @@ public:
 
 	const std::vector<PVulkanImage*>& GetSwapchainImages() const;
 
-private:
+protected:
 	VkSwapchainKHR SwapchainKHR;
 	
 	// Defines pixel format of the images in the swapchain. (Color format and Depth/Stencil format)
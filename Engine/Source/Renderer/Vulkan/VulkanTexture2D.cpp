@@ -9,6 +9,7 @@
 #include "Renderer/Vulkan/VulkanAllocator.h"
 #include "Renderer/Vulkan/VulkanCommand.h"
 #include "Renderer/Vulkan/VulkanSampler.h"
+#include "Utils/Stats.h"
 
 void PVulkanTexture2D::CreateTexture2D(unsigned char* Data)
 {
@@ -26,6 +27,7 @@ void PVulkanTexture2D::CreateTexture2D(unsigned char* Data)
     vmaMapMemory(GetRHI()->GetSceneRenderer()->GetAllocator()->GetMemoryAllocator(), StagingBuffer.Allocation, &MappedData);
     memcpy(MappedData, Data, Width * Height * Channels);
     vmaUnmapMemory(GetRHI()->GetSceneRenderer()->GetAllocator()->GetMemoryAllocator(), StagingBuffer.Allocation);
+    PStats::Add(EStat::StagingBufferBytes, Width * Height * Channels);
 
     GetRHI()->GetSceneRenderer()->ImmediateSubmit([&](PVulkanCommandBuffer* CommandBuffer)
     {
@@ -0,0 +1,40 @@
+#include "EnginePCH.h"
+#include "VulkanUtils.h"
+
+#include "Renderer/Vulkan/VulkanDevice.h"
+
+void VulkanUtils::InsertMemoryBarrier(VkCommandBuffer CommandBuffer, VkPipelineStageFlags2 SrcStageMask, VkAccessFlags2 SrcAccessMask, VkPipelineStageFlags2 DstStageMask, VkAccessFlags2 DstAccessMask)
+{
+    VkMemoryBarrier2 MemoryBarrier{};
+    MemoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+    MemoryBarrier.srcStageMask = SrcStageMask;
+    MemoryBarrier.srcAccessMask = SrcAccessMask;
+    MemoryBarrier.dstStageMask = DstStageMask;
+    MemoryBarrier.dstAccessMask = DstAccessMask;
+
+    VkDependencyInfo DependencyInfo{};
+    DependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    DependencyInfo.memoryBarrierCount = 1;
+    DependencyInfo.pMemoryBarriers = &MemoryBarrier;
+
+    vkCmdPipelineBarrier2(CommandBuffer, &DependencyInfo);
+}
+
+void VulkanUtils::WriteStorageBufferDescriptor(VkDescriptorSet DescriptorSet, uint32_t Binding, VkBuffer Buffer)
+{
+    VkDescriptorBufferInfo DescriptorBufferInfo{};
+    DescriptorBufferInfo.buffer = Buffer;
+    DescriptorBufferInfo.offset = 0;
+    DescriptorBufferInfo.range = VK_WHOLE_SIZE;
+
+    VkWriteDescriptorSet WriteDescriptorSet{};
+    WriteDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    WriteDescriptorSet.dstSet = DescriptorSet;
+    WriteDescriptorSet.dstBinding = Binding;
+    WriteDescriptorSet.dstArrayElement = 0;
+    WriteDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    WriteDescriptorSet.descriptorCount = 1;
+    WriteDescriptorSet.pBufferInfo = &DescriptorBufferInfo;
+
+    vkUpdateDescriptorSets(GetRHI()->GetDevice()->GetVkDevice(), 1, &WriteDescriptorSet, 0, nullptr);
+}
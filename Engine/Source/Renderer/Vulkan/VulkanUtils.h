@@ -0,0 +1,13 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+// Small recording helpers shared by the renderer's compute passes.
+namespace VulkanUtils
+{
+    // Global memory barrier, for passes that hand buffers to each other within a command buffer.
+    void InsertMemoryBarrier(VkCommandBuffer CommandBuffer, VkPipelineStageFlags2 SrcStageMask, VkAccessFlags2 SrcAccessMask, VkPipelineStageFlags2 DstStageMask, VkAccessFlags2 DstAccessMask);
+
+    // Points Binding of DescriptorSet at the whole of Buffer.
+    void WriteStorageBufferDescriptor(VkDescriptorSet DescriptorSet, uint32_t Binding, VkBuffer Buffer);
+}
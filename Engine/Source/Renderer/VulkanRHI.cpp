@@ -13,6 +13,12 @@ void PVulkanRHI::Init()
 	Extensions.InstanceExtensions.push_back("VK_EXT_debug_utils");
 #endif
 
+	// Offscreen rendering does not present, so the swapchain extension is not required (e.g. for lavapipe on display-less hosts).
+	if (GetWindow()->IsHeadless())
+	{
+		Extensions.PhysicalDeviceExtensions.clear();
+	}
+
 	Instance = new PVulkanInstance();
 	Device = new PVulkanDevice();
 	SceneRenderer = new PVulkanSceneRenderer();
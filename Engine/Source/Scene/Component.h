@@ -1,8 +1,13 @@
 #pragma once
 
+#include "Math/Bounds.h"
 #include "Math/Transform.h"
 #include "Utils/UUID64.h"
 #include "Renderer/Common/Mesh.h"
+#include "Scene/Registry.h"
+
+struct SLODChain;
+struct SOccluderGeometry;
 
 struct IComponent {};
 
@@ -11,12 +16,33 @@ struct STagComponent : IComponent
     std::string Tag;
 };
 
+// Transform relative to the parent (see SHierarchyComponent), or to the world for root entities. The matrices are
+// cached and only recomputed by PRegistry::UpdateTransforms, so after changing Transform call PRegistry::MarkTransformDirty.
 struct STransformComponent : IComponent
 {
     STransformComponent() = default;
     STransformComponent(const STransform& InTransform) : Transform(InTransform) {}
 
     STransform Transform;
+
+    glm::mat4 LocalMatrix = glm::mat4(1.0f);
+    glm::mat4 WorldMatrix = glm::mat4(1.0f);
+
+    // Inverse transpose of the world matrix's upper 3x3, only that part is read by the shaders
+    glm::mat4 NormalMatrix = glm::mat4(1.0f);
+
+    // Set while the entity is queued for UpdateTransforms, which recomputes the local matrix of dirty entities only
+    bool bDirty = true;
+};
+
+// Links an entity into the transform hierarchy, only present on entities with a parent or children.
+// Children form an intrusive list through their siblings, edited with PRegistry::SetParent.
+struct SHierarchyComponent : IComponent
+{
+    SEntityID Parent = entt::null;
+    SEntityID FirstChild = entt::null;
+    SEntityID PreviousSibling = entt::null;
+    SEntityID NextSibling = entt::null;
 };
 
 struct SUUIDComponent : IComponent
@@ -32,10 +58,63 @@ struct SMeshComponent : IComponent
     IMesh* Mesh;
 };
 
+// World space bounds of an entity's mesh, added with the SMeshComponent and kept current by PSpatialIndex.
+struct SBoundsComponent : IComponent
+{
+    SAABB WorldBounds;
+    SBoundingSphere WorldBoundingSphere;
+
+    // Leaf of the entity in the spatial index's BVH
+    uint32_t ProxyID = UINT32_MAX;
+
+    // Element of the entity in the spatial index's bounds streams, changes as other entities are removed
+    uint32_t StreamIndex = UINT32_MAX;
+};
+
+// Rasterized into the occlusion buffer every frame, objects behind it are not drawn (see POcclusionCuller).
+// The geometry is shared by every entity using it and must outlive them.
+struct SOccluderComponent : IComponent
+{
+    SOccluderComponent() = default;
+    SOccluderComponent(const SOccluderGeometry* InGeometry) : Geometry(InGeometry) {}
+
+    const SOccluderGeometry* Geometry = nullptr;
+};
+
+// Draws the entity with the level of the chain that matches its projected size instead of its SMeshComponent's mesh,
+// which still provides the bounds (see PLODSelector). The chain is shared by every entity using it and must outlive them.
+struct SLODComponent : IComponent
+{
+    SLODComponent() = default;
+    SLODComponent(const SLODChain* InChain) : Chain(InChain) {}
+
+    const SLODChain* Chain = nullptr;
+
+    // Level drawn in the last frame the entity was visible, the level count while it was too small to be drawn
+    uint32_t CurrentLevel = 0;
+};
+
 struct SInstancedMeshComponent : IComponent
 {
     SInstancedMeshComponent() = default;
     SInstancedMeshComponent(IMesh* InMesh) : Mesh(InMesh) {}
 
     IMesh* Mesh;
-};
\ No newline at end of file
+};
+// Marks an entity as dynamic, its transform is animated every frame by the motion subsystem.
+struct SMotionComponent : IComponent
+{
+    SMotionComponent() = default;
+    SMotionComponent(const glm::vec3& InAngularVelocity, const glm::vec3& InOscillationAxis, float InOscillationFrequency)
+        : AngularVelocity(InAngularVelocity), OscillationAxis(InOscillationAxis), OscillationFrequency(InOscillationFrequency) {}
+
+    // Radians per second around each axis
+    glm::vec3 AngularVelocity = glm::vec3(0.0f);
+
+    // Direction and amplitude of the positional oscillation around the origin
+    glm::vec3 OscillationAxis = glm::vec3(0.0f);
+    float OscillationFrequency = 0.0f;
+
+    glm::vec3 Origin = glm::vec3(0.0f);
+    float Phase = 0.0f;
+};
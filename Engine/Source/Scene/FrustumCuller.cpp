@@ -0,0 +1,64 @@
+#include "EnginePCH.h"
+#include "FrustumCuller.h"
+
+#include "Core/Camera.h"
+#include "Core/WorkerPool.h"
+#include "Scene/LODSelector.h"
+#include "Scene/OcclusionCuller.h"
+#include "Scene/SpatialIndex.h"
+#include "Utils/Stats.h"
+#include "Utils/Timer.h"
+
+PFrustumCuller::PFrustumCuller(const PSpatialIndex* InSpatialIndex, POcclusionCuller* InOcclusionCuller, PLODSelector* InLODSelector)
+    : SpatialIndex(InSpatialIndex), OcclusionCuller(InOcclusionCuller), LODSelector(InLODSelector)
+{
+}
+
+void PFrustumCuller::Cull(const PCamera& Camera)
+{
+    PROFILE_FUNC_SCOPE("PFrustumCuller::Cull")
+
+    STimer Timer;
+
+    const glm::mat4 ViewProjection = Camera.GetProjectionMatrix() * Camera.GetViewMatrix();
+
+    const SBoundsStreams& Streams = SpatialIndex->GetBoundsStreams();
+    const SFrustum Frustum = SFrustum::FromMatrix(ViewProjection);
+
+    SubmittedCount = Streams.GetSize();
+    VisibleIndices.resize(SubmittedCount);
+    BatchVisibleCounts.assign((SubmittedCount + BatchSize - 1) / BatchSize, 0);
+
+    GetEngine()->GetWorkerPool()->ParallelFor(SubmittedCount, BatchSize, [&](size_t Begin, size_t End)
+    {
+        BatchVisibleCounts[Begin / BatchSize] = FrustumCull::Cull(Frustum, Streams, Begin, End - Begin, &VisibleIndices[Begin]);
+    });
+
+    const std::vector<SEntityID>& Entities = SpatialIndex->GetStreamEntities();
+    const std::vector<IMesh*>& Meshes = SpatialIndex->GetStreamMeshes();
+
+    VisibleObjects.clear();
+    for (size_t Batch = 0; Batch < BatchVisibleCounts.size(); ++Batch)
+    {
+        const uint32_t* BatchIndices = &VisibleIndices[Batch * BatchSize];
+        for (size_t Index = 0; Index < BatchVisibleCounts[Batch]; ++Index)
+        {
+            VisibleObjects.push_back({ Entities[BatchIndices[Index]], Meshes[BatchIndices[Index]], BatchIndices[Index] });
+        }
+    }
+
+    // Before occlusion, objects too small to draw need no occlusion test.
+    if (LODSelector)
+    {
+        LODSelector->Select(Camera.GetPosition(), Camera.GetProjectionMatrix(), VisibleObjects);
+    }
+
+    if (OcclusionCuller)
+    {
+        OcclusionCuller->Cull(ViewProjection, VisibleObjects);
+    }
+
+    PStats::Add(EStat::CullSubmittedObjects, SubmittedCount);
+    PStats::Add(EStat::CullVisibleObjects, VisibleObjects.size());
+    LastCullSeconds = Timer.GetElapsedTimeAsSeconds();
+}
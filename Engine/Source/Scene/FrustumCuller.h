@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Scene/Registry.h"
+
+class IMesh;
+class PCamera;
+class PLODSelector;
+class POcclusionCuller;
+class PSpatialIndex;
+
+struct SVisibleObject
+{
+    SEntityID EntityID;
+    IMesh* Mesh;
+
+    // Element of the object in the spatial index's bounds streams
+    uint32_t StreamIndex;
+};
+
+// Tests the world bounds of every entity with a mesh against the camera frustum, in batches spread over the engine's
+// worker pool, and compacts the survivors into the list the draw path submits. The LOD selector, if any, then picks
+// the mesh level of the survivors and drops those too small to see, and the occlusion culler, if any, removes those
+// hidden behind occluders.
+class PFrustumCuller
+{
+public:
+    PFrustumCuller(const PSpatialIndex* InSpatialIndex, POcclusionCuller* InOcclusionCuller = nullptr, PLODSelector* InLODSelector = nullptr);
+
+    // Replaces the visible objects with those inside the camera's frustum, large enough and not occluded, in the spatial index's stream order.
+    void Cull(const PCamera& Camera);
+
+    [[nodiscard]] const std::vector<SVisibleObject>& GetVisibleObjects() const
+    {
+        return VisibleObjects;
+    }
+
+    // Objects tested by the last Cull
+    [[nodiscard]] size_t GetSubmittedCount() const
+    {
+        return SubmittedCount;
+    }
+
+    [[nodiscard]] double GetLastCullSeconds() const
+    {
+        return LastCullSeconds;
+    }
+
+    // Elements per batch of a worker, large enough to amortize claiming it
+    static constexpr size_t BatchSize = 4096;
+
+private:
+    const PSpatialIndex* SpatialIndex;
+    POcclusionCuller* OcclusionCuller;
+    PLODSelector* LODSelector;
+
+    // Each batch writes its visible stream indices into its own range, they are compacted afterwards.
+    std::vector<uint32_t> VisibleIndices;
+    std::vector<size_t> BatchVisibleCounts;
+
+    std::vector<SVisibleObject> VisibleObjects;
+
+    size_t SubmittedCount = 0;
+    double LastCullSeconds = 0.0;
+};
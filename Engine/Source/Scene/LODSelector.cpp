@@ -0,0 +1,185 @@
+#include "EnginePCH.h"
+#include "LODSelector.h"
+
+#include <limits>
+
+#include "Core/CommandLine.h"
+#include "Core/WorkerPool.h"
+#include "Scene/Component.h"
+#include "Scene/SpatialIndex.h"
+#include "Utils/Stats.h"
+
+namespace Utils
+{
+    // Level for ScreenSize without hysteresis
+    static uint32_t FindLevel(const SLODChain& Chain, float ScreenSize)
+    {
+        const uint32_t LevelCount = static_cast<uint32_t>(Chain.Levels.size());
+        if (ScreenSize < Chain.MinScreenSize)
+        {
+            return LevelCount;
+        }
+
+        for (uint32_t Level = 0; Level < LevelCount; ++Level)
+        {
+            if (ScreenSize >= Chain.Levels[Level].ScreenSize)
+            {
+                return Level;
+            }
+        }
+
+        return LevelCount - 1;
+    }
+}
+
+PLODSelector::PLODSelector(PRegistry* InRegistry, const PSpatialIndex* InSpatialIndex)
+    : Registry(InRegistry), SpatialIndex(InSpatialIndex)
+{
+    bEnabled = !PCommandLine::HasOption("--no-lod");
+}
+
+void PLODSelector::Select(const glm::vec3& ViewPosition, const glm::mat4& Projection, std::vector<SVisibleObject>& VisibleObjects)
+{
+    PROFILE_FUNC_SCOPE("PLODSelector::Select")
+
+    SelectedCount = 0;
+    TransitionCount = 0;
+    CulledCount = 0;
+    if (!bEnabled || VisibleObjects.empty())
+    {
+        return;
+    }
+
+    const SBoundsStreams& Streams = SpatialIndex->GetBoundsStreams();
+    StreamLODComponents.assign(Streams.GetSize(), nullptr);
+
+    bool bHasLODs = false;
+    Registry->View<SLODComponent, SBoundsComponent>([&](SLODComponent& LODComponent, SBoundsComponent& BoundsComponent)
+    {
+        if (LODComponent.Chain && !LODComponent.Chain->Levels.empty() && BoundsComponent.StreamIndex < StreamLODComponents.size())
+        {
+            StreamLODComponents[BoundsComponent.StreamIndex] = &LODComponent;
+            bHasLODs = true;
+        }
+    });
+
+    if (!bHasLODs)
+    {
+        return;
+    }
+
+    const size_t BatchCount = (VisibleObjects.size() + BatchSize - 1) / BatchSize;
+    CulledFlags.assign(VisibleObjects.size(), 0);
+    BatchSelectedCounts.assign(BatchCount, 0);
+    BatchTransitionCounts.assign(BatchCount, 0);
+
+    // Reads the spatial index's streams rather than the registry, which is not touched from the workers.
+    GetEngine()->GetWorkerPool()->ParallelFor(VisibleObjects.size(), BatchSize, [&](size_t Begin, size_t End)
+    {
+        size_t Selected = 0;
+        size_t Transitions = 0;
+        for (size_t Index = Begin; Index < End; ++Index)
+        {
+            SVisibleObject& VisibleObject = VisibleObjects[Index];
+            SLODComponent* LODComponent = StreamLODComponents[VisibleObject.StreamIndex];
+            if (!LODComponent)
+            {
+                continue;
+            }
+
+            const uint32_t StreamIndex = VisibleObject.StreamIndex;
+            const glm::vec3 Center(Streams.CenterX[StreamIndex], Streams.CenterY[StreamIndex], Streams.CenterZ[StreamIndex]);
+            const float ScreenSize = GetScreenSize(Projection, Streams.Radius[StreamIndex], glm::length(Center - ViewPosition));
+
+            const SLODChain& Chain = *LODComponent->Chain;
+            const uint32_t Level = SelectLevel(Chain, LODComponent->CurrentLevel, ScreenSize);
+            Transitions += Level != LODComponent->CurrentLevel;
+            LODComponent->CurrentLevel = Level;
+            ++Selected;
+
+            if (Level < Chain.Levels.size())
+            {
+                VisibleObject.Mesh = Chain.Levels[Level].Mesh;
+            }
+            else
+            {
+                CulledFlags[Index] = 1;
+            }
+        }
+
+        BatchSelectedCounts[Begin / BatchSize] = Selected;
+        BatchTransitionCounts[Begin / BatchSize] = Transitions;
+    });
+
+    size_t VisibleCount = 0;
+    for (size_t Index = 0; Index < VisibleObjects.size(); ++Index)
+    {
+        VisibleObjects[VisibleCount] = VisibleObjects[Index];
+        VisibleCount += !CulledFlags[Index];
+    }
+
+    CulledCount = VisibleObjects.size() - VisibleCount;
+    VisibleObjects.resize(VisibleCount);
+
+    for (size_t Batch = 0; Batch < BatchCount; ++Batch)
+    {
+        SelectedCount += BatchSelectedCounts[Batch];
+        TransitionCount += BatchTransitionCounts[Batch];
+    }
+
+    PStats::Add(EStat::LODSelectedObjects, SelectedCount);
+    PStats::Add(EStat::LODTransitions, TransitionCount);
+    PStats::Add(EStat::LODCulledObjects, CulledCount);
+}
+
+uint32_t PLODSelector::SelectLevel(const SLODChain& Chain, uint32_t CurrentLevel, float ScreenSize)
+{
+    const uint32_t LevelCount = static_cast<uint32_t>(Chain.Levels.size());
+    CurrentLevel = std::min(CurrentLevel, LevelCount);
+
+    // The size is judged larger than it is before going coarser and smaller before going finer, so between the two
+    // the current level holds.
+    const uint32_t CoarserLevel = Utils::FindLevel(Chain, ScreenSize * (1.0f + Hysteresis));
+    if (CoarserLevel > CurrentLevel)
+    {
+        return CoarserLevel;
+    }
+
+    const uint32_t FinerLevel = Utils::FindLevel(Chain, ScreenSize * (1.0f - Hysteresis));
+    if (FinerLevel < CurrentLevel)
+    {
+        return FinerLevel;
+    }
+
+    return CurrentLevel;
+}
+
+float PLODSelector::GetScreenSize(const glm::mat4& Projection, float Radius, float Distance)
+{
+    // Projection[1][1] scales view space heights to half the screen, it is negative with Vulkan's flipped Y.
+    const float Scale = std::abs(Projection[1][1]);
+
+    // Orthographic projections keep w at 1, sizes do not shrink with distance.
+    if (Projection[3][3] != 0.0f)
+    {
+        return Radius * Scale;
+    }
+
+    if (Distance <= Radius)
+    {
+        return std::numeric_limits<float>::max();
+    }
+
+    return Radius * Scale / Distance;
+}
+
+float PLODSelector::GetScreenSizeForError(float GeometricError, float Radius, float MaxScreenError)
+{
+    // Error and radius shrink alike with distance, their projected ratio is that of the object space values.
+    if (GeometricError <= 0.0f)
+    {
+        return std::numeric_limits<float>::max();
+    }
+
+    return MaxScreenError * Radius / GeometricError;
+}
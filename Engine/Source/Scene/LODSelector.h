@@ -0,0 +1,99 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Scene/FrustumCuller.h"
+
+class IMesh;
+class PSpatialIndex;
+struct SLODComponent;
+
+struct SLODLevel
+{
+    IMesh* Mesh = nullptr;
+
+    // Smallest projected size the level is drawn at, as the share of the screen height covered by the bounding
+    // sphere's diameter. Below it the error of the next level is small enough to go unnoticed.
+    float ScreenSize = 0.0f;
+};
+
+// Mesh levels of an object, shared by every entity using it (see SLODComponent). Must outlive them.
+struct SLODChain
+{
+    // Finest first, with decreasing ScreenSize
+    std::vector<SLODLevel> Levels;
+
+    // Below this projected size the object is not drawn at all
+    float MinScreenSize = 0.0f;
+};
+
+// Swaps the mesh of visible objects with an SLODComponent for the level matching their projected size, and removes
+// those smaller than their chain's MinScreenSize. A level only changes once the size has moved past its threshold by
+// the Hysteresis margin, so objects hovering around a threshold do not pop back and forth. Runs on the frustum
+// culler's survivors in batches spread over the engine's worker pool.
+class PLODSelector
+{
+public:
+    PLODSelector(PRegistry* InRegistry, const PSpatialIndex* InSpatialIndex);
+
+    // Projected sizes are measured from ViewPosition with Projection. Keeps the order of the remaining objects.
+    // Does nothing with --no-lod, objects are then drawn with the mesh of their SMeshComponent.
+    void Select(const glm::vec3& ViewPosition, const glm::mat4& Projection, std::vector<SVisibleObject>& VisibleObjects);
+
+    // Level for an object of ScreenSize that was drawn at CurrentLevel, Chain.Levels.size() if it is too small to be drawn.
+    static uint32_t SelectLevel(const SLODChain& Chain, uint32_t CurrentLevel, float ScreenSize);
+
+    // Share of the screen height covered by a sphere of Radius, Distance away from the view.
+    static float GetScreenSize(const glm::mat4& Projection, float Radius, float Distance);
+
+    // Screen size below which a level with GeometricError (see SMeshLOD::Error), on an object of Radius in the same
+    // space, deviates less than MaxScreenError of the screen height. It is the ScreenSize of the level before it.
+    static float GetScreenSizeForError(float GeometricError, float Radius, float MaxScreenError);
+
+    // Objects with an SLODComponent seen by the last Select
+    [[nodiscard]] size_t GetSelectedCount() const
+    {
+        return SelectedCount;
+    }
+
+    // Objects that changed level in the last Select, including to and from being culled
+    [[nodiscard]] size_t GetTransitionCount() const
+    {
+        return TransitionCount;
+    }
+
+    // Objects removed by the last Select for being too small
+    [[nodiscard]] size_t GetCulledCount() const
+    {
+        return CulledCount;
+    }
+
+    // Relative margin past a threshold before the level changes
+    static constexpr float Hysteresis = 0.1f;
+
+    // Visible objects per batch of a worker
+    static constexpr size_t BatchSize = 1024;
+
+private:
+    PRegistry* Registry;
+    const PSpatialIndex* SpatialIndex;
+
+    bool bEnabled = true;
+
+    // Per stream element of the spatial index, the LOD component of the entity or nullptr. Workers write the
+    // selected level through it, no two visible objects share an entity.
+    std::vector<SLODComponent*> StreamLODComponents;
+
+    // Per visible object, written by the batches and compacted afterwards
+    std::vector<uint8_t> CulledFlags;
+
+    // Per batch, summed once every batch is done
+    std::vector<size_t> BatchSelectedCounts;
+    std::vector<size_t> BatchTransitionCounts;
+
+    size_t SelectedCount = 0;
+    size_t TransitionCount = 0;
+    size_t CulledCount = 0;
+};
@@ -0,0 +1,23 @@
+#include "EnginePCH.h"
+#include "MotionSubsystem.h"
+
+#include <glm/gtc/constants.hpp>
+
+void PMotionSubsystem::OnUpdate(float DeltaTime)
+{
+    PROFILE_FUNC_SCOPE("PMotionSubsystem::OnUpdate")
+
+    PRegistry* Registry = GetScene()->GetRegistry();
+    Registry->View<STransformComponent, SMotionComponent>([&](SEntityID EntityID, STransformComponent& TransformComponent, SMotionComponent& MotionComponent)
+    {
+        MotionComponent.Phase += DeltaTime * MotionComponent.OscillationFrequency * glm::two_pi<float>();
+
+        TransformComponent.Transform.Translation = MotionComponent.Origin + MotionComponent.OscillationAxis * glm::sin(MotionComponent.Phase);
+        TransformComponent.Transform.Rotation += MotionComponent.AngularVelocity * DeltaTime;
+
+        // Also raises the registry's dirty flag, which on-demand rendering waits for.
+        Registry->MarkTransformDirty(EntityID);
+    });
+}
+
+REGISTER_SUBSYSTEM(PMotionSubsystem)
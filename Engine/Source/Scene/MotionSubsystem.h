@@ -0,0 +1,10 @@
+#pragma once
+
+#include "Core/Subsystem.h"
+
+// Animates entities with a SMotionComponent, used to give generated stress scenes a dynamic share.
+class PMotionSubsystem : public ISubsystem
+{
+public:
+    virtual void OnUpdate(float DeltaTime) override;
+};
@@ -0,0 +1,112 @@
+#include "EnginePCH.h"
+#include "OcclusionCuller.h"
+
+#include "Core/CommandLine.h"
+#include "Core/WorkerPool.h"
+#include "Renderer/Common/Mesh.h"
+#include "Scene/Component.h"
+#include "Scene/SpatialIndex.h"
+#include "Utils/Stats.h"
+
+POcclusionCuller::POcclusionCuller(PRegistry* InRegistry, const PSpatialIndex* InSpatialIndex)
+    : Registry(InRegistry), SpatialIndex(InSpatialIndex)
+{
+    Buffer.Resize(BufferWidth, BufferHeight);
+    bEnabled = !PCommandLine::HasOption("--no-occlusion-culling");
+}
+
+void POcclusionCuller::Cull(const glm::mat4& ViewProjection, std::vector<SVisibleObject>& VisibleObjects)
+{
+    PROFILE_FUNC_SCOPE("POcclusionCuller::Cull")
+
+    OccludedCount = 0;
+    if (!bEnabled || VisibleObjects.empty())
+    {
+        return;
+    }
+
+    const SFrustum Frustum = SFrustum::FromMatrix(ViewProjection);
+
+    // Setup is serial, occluders are meant to be a few low-poly meshes.
+    Buffer.Clear();
+    Registry->View<SOccluderComponent, STransformComponent>([&](SOccluderComponent& OccluderComponent, STransformComponent& TransformComponent)
+    {
+        const SOccluderGeometry* Geometry = OccluderComponent.Geometry;
+        if (!Geometry || Geometry->Indices.empty() || !Frustum.Intersects(Geometry->LocalBounds.Transform(TransformComponent.WorldMatrix)))
+        {
+            return;
+        }
+
+        Buffer.AddOccluder(ViewProjection * TransformComponent.WorldMatrix, Geometry->Positions.data(), Geometry->Positions.size(),
+            Geometry->Indices.data(), Geometry->Indices.size());
+    });
+
+    if (Buffer.GetTriangleCount() == 0)
+    {
+        return;
+    }
+
+    const EOcclusionRasterKernel Kernel = OcclusionRaster::GetBestKernel();
+    GetEngine()->GetWorkerPool()->ParallelFor(Buffer.GetBandCount(), 1, [&](size_t Begin, size_t End)
+    {
+        for (size_t Band = Begin; Band < End; ++Band)
+        {
+            Buffer.RasterizeBand(static_cast<uint32_t>(Band), Kernel);
+        }
+    });
+
+    const SBoundsStreams& Streams = SpatialIndex->GetBoundsStreams();
+    OccluderStreamFlags.assign(Streams.GetSize(), 0);
+    Registry->View<SOccluderComponent, SBoundsComponent>([&](SOccluderComponent&, SBoundsComponent& BoundsComponent)
+    {
+        if (BoundsComponent.StreamIndex < OccluderStreamFlags.size())
+        {
+            OccluderStreamFlags[BoundsComponent.StreamIndex] = 1;
+        }
+    });
+
+    // Reads the spatial index's streams rather than the registry, which is not touched from the workers.
+    OccludedFlags.assign(VisibleObjects.size(), 0);
+    GetEngine()->GetWorkerPool()->ParallelFor(VisibleObjects.size(), BatchSize, [&](size_t Begin, size_t End)
+    {
+        for (size_t Index = Begin; Index < End; ++Index)
+        {
+            const uint32_t StreamIndex = VisibleObjects[Index].StreamIndex;
+            if (OccluderStreamFlags[StreamIndex])
+            {
+                continue;
+            }
+
+            const glm::vec3 Center(Streams.CenterX[StreamIndex], Streams.CenterY[StreamIndex], Streams.CenterZ[StreamIndex]);
+            const glm::vec3 Extent(Streams.ExtentX[StreamIndex], Streams.ExtentY[StreamIndex], Streams.ExtentZ[StreamIndex]);
+            OccludedFlags[Index] = Buffer.IsOccluded(ViewProjection, SAABB(Center - Extent, Center + Extent));
+        }
+    });
+
+    size_t VisibleCount = 0;
+    for (size_t Index = 0; Index < VisibleObjects.size(); ++Index)
+    {
+        VisibleObjects[VisibleCount] = VisibleObjects[Index];
+        VisibleCount += !OccludedFlags[Index];
+    }
+
+    OccludedCount = VisibleObjects.size() - VisibleCount;
+    VisibleObjects.resize(VisibleCount);
+
+    PStats::Add(EStat::OccluderTriangles, Buffer.GetTriangleCount());
+    PStats::Add(EStat::OccludedObjects, OccludedCount);
+}
+
+SOccluderGeometry POcclusionCuller::CreateGeometry(const SMeshBinaryData& MeshData)
+{
+    SOccluderGeometry Geometry;
+    Geometry.Positions.reserve(MeshData.Vertices.size());
+    for (const SVertex& Vertex : MeshData.Vertices)
+    {
+        Geometry.Positions.push_back(Vertex.Position);
+    }
+
+    Geometry.Indices = MeshData.Indices;
+    Geometry.LocalBounds = Bounds::ComputeAABB(Geometry.Positions.data(), Geometry.Positions.size(), sizeof(glm::vec3));
+    return Geometry;
+}
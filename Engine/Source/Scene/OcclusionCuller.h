@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Math/OcclusionBuffer.h"
+#include "Scene/FrustumCuller.h"
+
+struct SMeshBinaryData;
+class PSpatialIndex;
+
+// Removes objects hidden behind occluders (entities with an SOccluderComponent) from the frustum culler's visible
+// objects. The occluders inside the frustum are rasterized into a low resolution POcclusionBuffer, one band per
+// batch of the engine's worker pool, then the world bounds of every visible object are tested against it.
+// Runs entirely on the CPU within the frame, so unlike GPU occlusion queries nothing lags behind the camera.
+class POcclusionCuller
+{
+public:
+    POcclusionCuller(PRegistry* InRegistry, const PSpatialIndex* InSpatialIndex);
+
+    // Keeps the order of the remaining objects. Does nothing without occluders in the frustum or with --no-occlusion-culling.
+    void Cull(const glm::mat4& ViewProjection, std::vector<SVisibleObject>& VisibleObjects);
+
+    // The mesh's own triangles as occluder geometry, for meshes that were authored as occluders (see SMeshBinaryData::bOccluder).
+    static SOccluderGeometry CreateGeometry(const SMeshBinaryData& MeshData);
+
+    [[nodiscard]] const POcclusionBuffer& GetBuffer() const
+    {
+        return Buffer;
+    }
+
+    // Objects removed by the last Cull
+    [[nodiscard]] size_t GetOccludedCount() const
+    {
+        return OccludedCount;
+    }
+
+    // Large enough to hide objects a few pixels wide, small enough to rasterize in a fraction of a millisecond.
+    static constexpr uint32_t BufferWidth = 256;
+    static constexpr uint32_t BufferHeight = 144;
+
+    // Visible objects per batch of a worker when testing them
+    static constexpr size_t BatchSize = 1024;
+
+private:
+    PRegistry* Registry;
+    const PSpatialIndex* SpatialIndex;
+
+    POcclusionBuffer Buffer;
+
+    bool bEnabled = true;
+
+    // Per stream element of the spatial index, set for occluders. They are never tested, their bounds lie on their
+    // own rasterized surface and rounding alone could hide them behind themselves.
+    std::vector<uint8_t> OccluderStreamFlags;
+
+    // Per visible object, written by the batches and compacted afterwards
+    std::vector<uint8_t> OccludedFlags;
+
+    size_t OccludedCount = 0;
+};
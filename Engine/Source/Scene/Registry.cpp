@@ -1,19 +1,230 @@
 #include "EnginePCH.h"
 #include "Registry.h"
 
+PRegistry::PRegistry()
+{
+    // New transforms start dirty, queueing them here covers every way a component is added.
+    Registry.on_construct<STransformComponent>().connect<&PRegistry::OnTransformConstructed>(*this);
+}
+
 SEntity PRegistry::CreateEntity()
 {
     SEntity Entity{};
     Entity.EntityID = Registry.create();
+    EntityCount++;
+    MarkDirty();
     return Entity;
 }
 
 void PRegistry::DestroyEntity(SEntityID EntityID)
 {
+    if (Registry.all_of<SHierarchyComponent>(EntityID))
+    {
+        DetachFromHierarchy(EntityID);
+    }
+
     Registry.destroy(EntityID);
+    EntityCount--;
+    MarkDirty();
 }
 
 bool PRegistry::IsValid(SEntityID EntityID) const
 {
     return Registry.valid(EntityID);
 }
+
+void PRegistry::SetParent(SEntityID EntityID, SEntityID ParentID)
+{
+    RK_ASSERT(IsValid(EntityID), "Invalid EntityID.");
+    RK_ASSERT(ParentID == entt::null || IsValid(ParentID), "Invalid ParentID.");
+    RK_ASSERT(ParentID == entt::null || Registry.all_of<STransformComponent>(ParentID), "Parent has no STransformComponent.");
+
+    // Unlink from the previous parent
+    if (SHierarchyComponent* Hierarchy = Registry.try_get<SHierarchyComponent>(EntityID); Hierarchy && Hierarchy->Parent != entt::null)
+    {
+        if (Hierarchy->PreviousSibling != entt::null)
+        {
+            Registry.get<SHierarchyComponent>(Hierarchy->PreviousSibling).NextSibling = Hierarchy->NextSibling;
+        }
+        else
+        {
+            Registry.get<SHierarchyComponent>(Hierarchy->Parent).FirstChild = Hierarchy->NextSibling;
+        }
+
+        if (Hierarchy->NextSibling != entt::null)
+        {
+            Registry.get<SHierarchyComponent>(Hierarchy->NextSibling).PreviousSibling = Hierarchy->PreviousSibling;
+        }
+
+        Hierarchy->Parent = entt::null;
+        Hierarchy->PreviousSibling = entt::null;
+        Hierarchy->NextSibling = entt::null;
+    }
+
+    if (ParentID != entt::null)
+    {
+#ifdef RK_DEBUG
+        for (SEntityID AncestorID = ParentID; AncestorID != entt::null;)
+        {
+            RK_ASSERT(AncestorID != EntityID, "An entity cannot be parented to its own descendant.");
+            const SHierarchyComponent* AncestorHierarchy = Registry.try_get<SHierarchyComponent>(AncestorID);
+            AncestorID = AncestorHierarchy ? AncestorHierarchy->Parent : entt::null;
+        }
+#endif
+
+        // Emplacing may move the storage, so references are only taken afterwards.
+        Registry.get_or_emplace<SHierarchyComponent>(EntityID);
+        SHierarchyComponent& ParentHierarchy = Registry.get_or_emplace<SHierarchyComponent>(ParentID);
+        SHierarchyComponent& Hierarchy = Registry.get<SHierarchyComponent>(EntityID);
+
+        Hierarchy.Parent = ParentID;
+        Hierarchy.NextSibling = ParentHierarchy.FirstChild;
+        if (ParentHierarchy.FirstChild != entt::null)
+        {
+            Registry.get<SHierarchyComponent>(ParentHierarchy.FirstChild).PreviousSibling = EntityID;
+        }
+        ParentHierarchy.FirstChild = EntityID;
+    }
+
+    if (Registry.all_of<STransformComponent>(EntityID))
+    {
+        MarkTransformDirty(EntityID);
+    }
+}
+
+void PRegistry::MarkTransformDirty(SEntityID EntityID)
+{
+    STransformComponent& Transform = Registry.get<STransformComponent>(EntityID);
+    if (!Transform.bDirty)
+    {
+        Transform.bDirty = true;
+        DirtyTransforms.push_back(EntityID);
+    }
+    MarkDirty();
+}
+
+void PRegistry::SetTransform(SEntityID EntityID, const STransform& Transform)
+{
+    RK_ASSERT(IsValid(EntityID), "Invalid EntityID.");
+    Registry.get<STransformComponent>(EntityID).Transform = Transform;
+    MarkTransformDirty(EntityID);
+}
+
+void PRegistry::UpdateTransforms()
+{
+    if (DirtyTransforms.empty())
+    {
+        return;
+    }
+
+    PROFILE_FUNC_SCOPE("PRegistry::UpdateTransforms")
+
+    // Only the topmost dirty entity of each subtree starts a traversal, dirty descendants are reached from it.
+    TransformQueue.clear();
+    for (SEntityID EntityID : DirtyTransforms)
+    {
+        if (!Registry.valid(EntityID) || !Registry.all_of<STransformComponent>(EntityID))
+        {
+            continue;
+        }
+
+        bool bHasDirtyAncestor = false;
+        if (const SHierarchyComponent* Hierarchy = Registry.try_get<SHierarchyComponent>(EntityID))
+        {
+            for (SEntityID AncestorID = Hierarchy->Parent; AncestorID != entt::null && !bHasDirtyAncestor;)
+            {
+                const STransformComponent* AncestorTransform = Registry.try_get<STransformComponent>(AncestorID);
+                bHasDirtyAncestor = AncestorTransform && AncestorTransform->bDirty;
+                AncestorID = Registry.get<SHierarchyComponent>(AncestorID).Parent;
+            }
+        }
+
+        if (!bHasDirtyAncestor)
+        {
+            TransformQueue.push_back(EntityID);
+        }
+    }
+    DirtyTransforms.clear();
+
+    // Roots depend on no other transform, they are converted in one pass by the batch kernel.
+    BatchedTransforms.clear();
+    for (SEntityID EntityID : TransformQueue)
+    {
+        const SHierarchyComponent* Hierarchy = Registry.try_get<SHierarchyComponent>(EntityID);
+        if (!Hierarchy || Hierarchy->Parent == entt::null)
+        {
+            BatchedTransforms.push_back(EntityID);
+        }
+    }
+
+    TransformStreams.Resize(BatchedTransforms.size());
+    TransformMatrices.resize(BatchedTransforms.size());
+    for (size_t Index = 0; Index < BatchedTransforms.size(); ++Index)
+    {
+        TransformStreams.Set(Index, Registry.get<STransformComponent>(BatchedTransforms[Index]).Transform);
+    }
+
+    TransformBatch::ComputeMatrices(TransformStreams, 0, BatchedTransforms.size(), TransformMatrices.data());
+
+    for (size_t Index = 0; Index < BatchedTransforms.size(); ++Index)
+    {
+        STransformComponent& Transform = Registry.get<STransformComponent>(BatchedTransforms[Index]);
+        Transform.LocalMatrix = TransformMatrices[Index].ModelMatrix;
+        Transform.WorldMatrix = TransformMatrices[Index].ModelMatrix;
+        Transform.NormalMatrix = TransformMatrices[Index].NormalMatrix;
+        Transform.bDirty = false;
+
+        Registry.patch<STransformComponent>(BatchedTransforms[Index]);
+    }
+
+    // Breadth-first, so parents are always resolved before their children. The queue grows while it is walked.
+    for (size_t Index = 0; Index < TransformQueue.size(); ++Index)
+    {
+        const SEntityID EntityID = TransformQueue[Index];
+        const SHierarchyComponent* Hierarchy = Registry.try_get<SHierarchyComponent>(EntityID);
+
+        // Roots were resolved by the batch kernel above
+        if (Hierarchy && Hierarchy->Parent != entt::null)
+        {
+            STransformComponent& Transform = Registry.get<STransformComponent>(EntityID);
+            if (Transform.bDirty)
+            {
+                Transform.LocalMatrix = Transform.Transform.ToMatrix();
+                Transform.bDirty = false;
+            }
+
+            // A parent whose transform was removed since SetParent counts as the identity.
+            const STransformComponent* ParentTransform = Registry.try_get<STransformComponent>(Hierarchy->Parent);
+            Transform.WorldMatrix = ParentTransform ? ParentTransform->WorldMatrix * Transform.LocalMatrix : Transform.LocalMatrix;
+            Transform.NormalMatrix = glm::mat4(glm::transpose(glm::inverse(glm::mat3(Transform.WorldMatrix))));
+
+            Registry.patch<STransformComponent>(EntityID);
+        }
+
+        if (Hierarchy)
+        {
+            for (SEntityID ChildID = Hierarchy->FirstChild; ChildID != entt::null; ChildID = Registry.get<SHierarchyComponent>(ChildID).NextSibling)
+            {
+                TransformQueue.push_back(ChildID);
+            }
+        }
+    }
+}
+
+void PRegistry::OnTransformConstructed(SRegistry& InRegistry, SEntityID EntityID)
+{
+    InRegistry.get<STransformComponent>(EntityID).bDirty = true;
+    DirtyTransforms.push_back(EntityID);
+}
+
+void PRegistry::DetachFromHierarchy(SEntityID EntityID)
+{
+    SetParent(EntityID, entt::null);
+
+    // Children keep their local transform, which now is relative to the world.
+    SHierarchyComponent& Hierarchy = Registry.get<SHierarchyComponent>(EntityID);
+    while (Hierarchy.FirstChild != entt::null)
+    {
+        SetParent(Hierarchy.FirstChild, entt::null);
+    }
+}
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <entt/entt.hpp>
+#include <type_traits>
+#include <vector>
 
 #include "Core/Assert.h"
+#include "Math/TransformBatch.h"
 
 using SRegistry = entt::registry;
 using SEntityID = entt::entity;
@@ -12,13 +15,28 @@ struct SEntity;
 class PRegistry
 {
 public:
+    PRegistry();
+
+    // Storage signals are connected to this instance, a copy or move would leave them calling the original.
+    PRegistry(const PRegistry&) = delete;
+    PRegistry(PRegistry&&) = delete;
+    PRegistry& operator=(const PRegistry&) = delete;
+    PRegistry& operator=(PRegistry&&) = delete;
+
     SEntity CreateEntity();
     void DestroyEntity(SEntityID EntityID);
     bool IsValid(SEntityID EntityID) const;
 
+    [[nodiscard]] size_t GetEntityCount() const
+    {
+        return EntityCount;
+    }
+
     template <typename TComponent, typename... TArgs>
     TComponent& AddComponent(SEntityID EntityID, TArgs... Args);
 
+    // Does not mark the registry dirty, reading is far more common than writing. Callers that change the component
+    // call MarkDirty, or SetTransform / MarkTransformDirty for transforms.
     template<typename TComponent>
     TComponent& GetComponent(SEntityID EntityID);
 
@@ -28,17 +46,67 @@ public:
     template<typename TComponent>
     void RemoveComponent(SEntityID EntityID);
 
+    // Func receives the components, optionally preceded by the SEntityID.
     template<typename... TComponents, typename TFunc>
     void View(TFunc&& Func);
 
+    // Signals of the component storage, for systems outside the scene that mirror components. Connected handlers
+    // receive (SRegistry&, SEntityID).
+    template<typename TComponent>
+    auto OnConstruct();
+
+    template<typename TComponent>
+    auto OnUpdate();
+
+    template<typename TComponent>
+    auto OnDestroy();
+
+    // Attaches EntityID below ParentID in the transform hierarchy, entt::null detaches it. Its transform becomes
+    // relative to the parent. Both entities need an STransformComponent.
+    void SetParent(SEntityID EntityID, SEntityID ParentID);
+
+    // Queues the entity's transform and its subtree for the next UpdateTransforms, required after changing STransformComponent::Transform.
+    void MarkTransformDirty(SEntityID EntityID);
+
+    // Replaces the entity's local transform and marks it dirty.
+    void SetTransform(SEntityID EntityID, const STransform& Transform);
+
+    // Recomputes the cached matrices of every dirty transform and, breadth-first, of its descendants, and raises
+    // OnUpdate<STransformComponent> for each of them. Costs nothing while no transform changed.
+    void UpdateTransforms();
+
+    // Raised by every mutating call, consumed by the frame pacer to decide whether an on-demand frame needs to be rendered.
+    bool IsDirty() const;
+    void MarkDirty();
+    void ClearDirty();
+
 private:
+    void OnTransformConstructed(SRegistry& InRegistry, SEntityID EntityID);
+
+    // Unlinks the entity from its parent and turns its children into roots.
+    void DetachFromHierarchy(SEntityID EntityID);
+
     SRegistry Registry;
+
+    size_t EntityCount = 0;
+
+    // Entities whose STransformComponent::bDirty is set, in the order they were marked
+    std::vector<SEntityID> DirtyTransforms;
+
+    // Scratch state of UpdateTransforms, kept to avoid allocating every frame
+    std::vector<SEntityID> TransformQueue;
+    std::vector<SEntityID> BatchedTransforms;
+    STransformStreams TransformStreams;
+    std::vector<STransformMatrices> TransformMatrices;
+
+    bool bDirty = true;
 };
 
 template<typename TComponent, typename ... TArgs>
 TComponent& PRegistry::AddComponent(SEntityID EntityID, TArgs... Args)
 {
     RK_ASSERT(IsValid(EntityID), "Invalid EntityID.");
+    MarkDirty();
     return Registry.emplace<TComponent>(EntityID, std::forward<TArgs>(Args)...);
 }
 
@@ -60,6 +128,7 @@ template<typename TComponent>
 void PRegistry::RemoveComponent(SEntityID EntityID)
 {
     RK_ASSERT(IsValid(EntityID), "Invalid EntityID.");
+    MarkDirty();
     Registry.remove<TComponent>(EntityID);
 }
 
@@ -67,8 +136,51 @@ template<typename ... TComponents, typename TFunc>
 void PRegistry::View(TFunc&& Func)
 {
     auto View = Registry.view<TComponents...>();
-    View.each([&](TComponents&... Components)
+    if constexpr (std::is_invocable_v<TFunc, SEntityID, TComponents&...>)
+    {
+        View.each([&](SEntityID EntityID, TComponents&... Components)
+        {
+            Func(EntityID, Components...);
+        });
+    }
+    else
     {
-        Func(Components...);
-    });
+        View.each([&](TComponents&... Components)
+        {
+            Func(Components...);
+        });
+    }
+}
+
+template<typename TComponent>
+auto PRegistry::OnConstruct()
+{
+    return Registry.on_construct<TComponent>();
+}
+
+template<typename TComponent>
+auto PRegistry::OnUpdate()
+{
+    return Registry.on_update<TComponent>();
+}
+
+template<typename TComponent>
+auto PRegistry::OnDestroy()
+{
+    return Registry.on_destroy<TComponent>();
+}
+
+inline bool PRegistry::IsDirty() const
+{
+    return bDirty;
+}
+
+inline void PRegistry::MarkDirty()
+{
+    bDirty = true;
+}
+
+inline void PRegistry::ClearDirty()
+{
+    bDirty = false;
 }
\ No newline at end of file
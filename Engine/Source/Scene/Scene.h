@@ -1,8 +1,13 @@
 #pragma once 
 
 #include "Core/Camera.h"
+#include "Core/CommandLine.h"
 #include "Core/Engine.h"
+#include "Scene/FrustumCuller.h"
+#include "Scene/LODSelector.h"
+#include "Scene/OcclusionCuller.h"
 #include "Scene/Registry.h"
+#include "Scene/SpatialIndex.h"
 
 struct SMeshComponent;
 struct STransformComponent;
@@ -14,16 +19,27 @@ public:
 	{
 		Camera = new PCamera();
 		Registry = new PRegistry();
+		SpatialIndex = new PSpatialIndex(Registry);
+		OcclusionCuller = new POcclusionCuller(Registry, SpatialIndex);
+		LODSelector = new PLODSelector(Registry, SpatialIndex);
+		FrustumCuller = new PFrustumCuller(SpatialIndex, OcclusionCuller, LODSelector);
+		bDepthPrePass = PCommandLine::HasOption("--depth-prepass");
 	}
 
+	// Runs after the subsystems have updated, before the frame is rendered.
 	void Update()
 	{
-
+		Registry->UpdateTransforms();
+		SpatialIndex->Update();
 	}
 
 	void Cleanup() 
 	{
 		delete Camera;
+		delete FrustumCuller;
+		delete OcclusionCuller;
+		delete LODSelector;
+		delete SpatialIndex;
 		delete Registry;
 	}
 
@@ -37,10 +53,55 @@ public:
 		return Registry;
 	}
 
+	[[nodiscard]] PSpatialIndex* GetSpatialIndex() const
+	{
+		return SpatialIndex;
+	}
+
+	// Run by the renderer, which draws the visible objects of the last cull
+	[[nodiscard]] PFrustumCuller* GetFrustumCuller() const
+	{
+		return FrustumCuller;
+	}
+
+	// Run by the frustum culler on its survivors
+	[[nodiscard]] POcclusionCuller* GetOcclusionCuller() const
+	{
+		return OcclusionCuller;
+	}
+
+	// Run by the frustum culler on its survivors
+	[[nodiscard]] PLODSelector* GetLODSelector() const
+	{
+		return LODSelector;
+	}
+
+	// Lays down depth before shading, so scenes with heavy overdraw shade each pixel about once. Costs a second
+	// geometry pass, which scenes with little overdraw do not win back.
+	void SetDepthPrePass(bool bEnabled)
+	{
+		bDepthPrePass = bEnabled;
+	}
+
+	[[nodiscard]] bool IsDepthPrePassEnabled() const
+	{
+		return bDepthPrePass;
+	}
+
 private:
 	PCamera* Camera;
 
 	PRegistry* Registry;
+
+	PSpatialIndex* SpatialIndex;
+
+	PFrustumCuller* FrustumCuller;
+
+	POcclusionCuller* OcclusionCuller;
+
+	PLODSelector* LODSelector;
+
+	bool bDepthPrePass = false;
 };
 
 inline static PScene* GetScene()
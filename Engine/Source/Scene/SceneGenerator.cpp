@@ -0,0 +1,249 @@
+#include "EnginePCH.h"
+#include "SceneGenerator.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include "Format/HLSL.h"
+#include "Renderer/Common/Material.h"
+#include "Renderer/Common/Mesh.h"
+#include "Renderer/Common/Resource.h"
+#include "Renderer/Common/Shader.h"
+#include "Utils/Random.h"
+
+namespace Utils
+{
+    static SMeshBinaryData CreateSphere(uint32_t Rings, uint32_t Segments, float Radius)
+    {
+        SMeshBinaryData MeshBinaryData;
+
+        for (uint32_t Ring = 0; Ring <= Rings; ++Ring)
+        {
+            const float Theta = glm::pi<float>() * static_cast<float>(Ring) / static_cast<float>(Rings);
+            for (uint32_t Segment = 0; Segment <= Segments; ++Segment)
+            {
+                const float Phi = glm::two_pi<float>() * static_cast<float>(Segment) / static_cast<float>(Segments);
+
+                SVertex Vertex;
+                Vertex.Normal = glm::vec3(glm::sin(Theta) * glm::cos(Phi), glm::cos(Theta), glm::sin(Theta) * glm::sin(Phi));
+                Vertex.Position = Vertex.Normal * Radius;
+                Vertex.TexCoord = glm::vec2(static_cast<float>(Segment) / static_cast<float>(Segments), static_cast<float>(Ring) / static_cast<float>(Rings));
+                Vertex.Tangent = glm::vec3(-glm::sin(Phi), 0.0f, glm::cos(Phi));
+                Vertex.Bitangent = glm::cross(Vertex.Normal, Vertex.Tangent);
+                MeshBinaryData.Vertices.push_back(Vertex);
+            }
+        }
+
+        for (uint32_t Ring = 0; Ring < Rings; ++Ring)
+        {
+            for (uint32_t Segment = 0; Segment < Segments; ++Segment)
+            {
+                const uint32_t Current = Ring * (Segments + 1) + Segment;
+                const uint32_t Next = Current + Segments + 1;
+
+                MeshBinaryData.Indices.insert(MeshBinaryData.Indices.end(), { Current, Next, Current + 1 });
+                MeshBinaryData.Indices.insert(MeshBinaryData.Indices.end(), { Current + 1, Next, Next + 1 });
+            }
+        }
+
+        MeshBinaryData.ComputeBounds();
+        return MeshBinaryData;
+    }
+
+    static SMeshBinaryData CreateBox(float HalfExtent)
+    {
+        SMeshBinaryData MeshBinaryData;
+
+        const glm::vec3 Normals[6] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+        for (const glm::vec3& Normal : Normals)
+        {
+            const glm::vec3 Tangent = glm::abs(Normal.y) > 0.5f ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0);
+            const glm::vec3 Bitangent = glm::cross(Normal, Tangent);
+            const uint32_t BaseIndex = static_cast<uint32_t>(MeshBinaryData.Vertices.size());
+
+            const glm::vec2 Corners[4] = { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } };
+            for (const glm::vec2& Corner : Corners)
+            {
+                SVertex Vertex;
+                Vertex.Position = (Normal + Tangent * Corner.x + Bitangent * Corner.y) * HalfExtent;
+                Vertex.Normal = Normal;
+                Vertex.TexCoord = Corner * 0.5f + 0.5f;
+                Vertex.Tangent = Tangent;
+                Vertex.Bitangent = Bitangent;
+                MeshBinaryData.Vertices.push_back(Vertex);
+            }
+
+            MeshBinaryData.Indices.insert(MeshBinaryData.Indices.end(), { BaseIndex, BaseIndex + 1, BaseIndex + 2, BaseIndex, BaseIndex + 2, BaseIndex + 3 });
+        }
+
+        MeshBinaryData.ComputeBounds();
+        return MeshBinaryData;
+    }
+
+    static float GetUnitFloat()
+    {
+        return SRandom::GetFloatValue(0.0f, 1.0f);
+    }
+
+    // https://en.wikipedia.org/wiki/Box%E2%80%93Muller_transform
+    static glm::vec3 GetNormalVector()
+    {
+        glm::vec3 Result;
+        for (int32_t Axis = 0; Axis < 3; ++Axis)
+        {
+            const float U1 = std::max(GetUnitFloat(), 1e-7f);
+            const float U2 = GetUnitFloat();
+            Result[Axis] = glm::sqrt(-2.0f * glm::log(U1)) * glm::cos(glm::two_pi<float>() * U2);
+        }
+        return Result;
+    }
+}
+
+const char* GetSpatialDistributionName(ESpatialDistribution Distribution)
+{
+    switch (Distribution)
+    {
+        case ESpatialDistribution::Uniform: return "Uniform";
+        case ESpatialDistribution::Grid: return "Grid";
+        case ESpatialDistribution::Clustered: return "Clustered";
+        default: return "Unknown";
+    }
+}
+
+std::optional<ESpatialDistribution> ParseSpatialDistribution(const std::string& Name)
+{
+    for (uint8_t Index = 0; Index < static_cast<uint8_t>(ESpatialDistribution::Count); ++Index)
+    {
+        if (Name == GetSpatialDistributionName(static_cast<ESpatialDistribution>(Index)))
+        {
+            return static_cast<ESpatialDistribution>(Index);
+        }
+    }
+    return std::nullopt;
+}
+
+void PSceneGenerator::CreateAssets(uint32_t MaterialCount, uint32_t MeshCount)
+{
+    RK_ASSERT(Materials.empty() && Meshes.empty(), "Scene generator assets have already been created.");
+    RK_ASSERT(MaterialCount > 0 && MeshCount > 0, "Scene generator requires at least one material and one mesh.");
+
+    if (MaterialCount > MeshCount)
+    {
+        RK_LOG_WARNING("Scene generator: {} materials requested for {} meshes, only {} materials will be drawn.", MaterialCount, MeshCount, MeshCount);
+    }
+
+    const FHLSL VertexShader = Format::ImportHLSL(RK_ENGINE_DIR "/Shaders/HLSL/Vertex.hlsl", "main", "vs_6_0");
+    const FHLSL PixelShader = Format::ImportHLSL(RK_ENGINE_DIR "/Shaders/HLSL/Pixel.hlsl", "main", "ps_6_0");
+
+    // Every material owns its pipeline and descriptor sets, which is what the material count is meant to stress.
+    for (uint32_t Index = 0; Index < MaterialCount; ++Index)
+    {
+        IShader* Shader = NewObject<IShader>();
+        Shader->CreateShader({ { VertexShader.Data, VertexShader.Size }, { PixelShader.Data, PixelShader.Size } });
+
+        IMaterial* Material = NewObject<IMaterial>();
+        Material->SetShader(Shader);
+
+        Shaders.push_back(Shader);
+        Materials.push_back(Material);
+    }
+
+    // Alternate boxes and spheres of growing tessellation, so meshes differ in vertex count.
+    for (uint32_t Index = 0; Index < MeshCount; ++Index)
+    {
+        const uint32_t Detail = 8 + 4 * (Index / 2);
+        const SMeshBinaryData MeshBinaryData = Index % 2 == 0 ? Utils::CreateSphere(Detail, Detail * 2, 0.5f) : Utils::CreateBox(0.5f);
+
+        IMesh* Mesh = NewObject<IMesh>();
+        Mesh->SetMaterial(Materials[Index % MaterialCount]);
+        Mesh->CreateMesh(MeshBinaryData);
+
+        Meshes.push_back(Mesh);
+    }
+}
+
+void PSceneGenerator::Generate(const SSceneGeneratorSettings& Settings)
+{
+    RK_ASSERT(!Meshes.empty(), "Scene generator assets must be created before generating a scene.");
+
+    SRandom::SetSeed(Settings.Seed);
+
+    std::vector<glm::vec3> ClusterCenters;
+    if (Settings.Distribution == ESpatialDistribution::Clustered)
+    {
+        for (uint32_t Index = 0; Index < std::max(Settings.ClusterCount, 1u); ++Index)
+        {
+            ClusterCenters.push_back(glm::vec3(SRandom::GetFloatValue(-Settings.Extent, Settings.Extent), SRandom::GetFloatValue(-Settings.Extent, Settings.Extent), SRandom::GetFloatValue(-Settings.Extent, Settings.Extent)));
+        }
+    }
+
+    const uint32_t GridSide = std::max(static_cast<uint32_t>(std::ceil(std::cbrt(static_cast<double>(Settings.EntityCount)))), 1u);
+    const float GridSpacing = 2.0f * Settings.Extent / static_cast<float>(GridSide);
+    const float ClusterDeviation = Settings.Extent / (2.0f * std::cbrt(static_cast<float>(std::max(Settings.ClusterCount, 1u))));
+
+    PRegistry* Registry = GetScene()->GetRegistry();
+    Entities.reserve(Entities.size() + Settings.EntityCount);
+
+    for (uint32_t Index = 0; Index < Settings.EntityCount; ++Index)
+    {
+        STransform Transform;
+
+        switch (Settings.Distribution)
+        {
+            case ESpatialDistribution::Uniform:
+            {
+                Transform.Translation = glm::vec3(SRandom::GetFloatValue(-Settings.Extent, Settings.Extent), SRandom::GetFloatValue(-Settings.Extent, Settings.Extent), SRandom::GetFloatValue(-Settings.Extent, Settings.Extent));
+                break;
+            }
+            case ESpatialDistribution::Grid:
+            {
+                const glm::vec3 Cell(static_cast<float>(Index % GridSide), static_cast<float>((Index / GridSide) % GridSide), static_cast<float>(Index / (GridSide * GridSide)));
+                Transform.Translation = (Cell + 0.5f) * GridSpacing - Settings.Extent;
+                break;
+            }
+            case ESpatialDistribution::Clustered:
+            {
+                const glm::vec3& Center = ClusterCenters[SRandom::GetUInt32Value() % ClusterCenters.size()];
+                Transform.Translation = Center + Utils::GetNormalVector() * ClusterDeviation;
+                break;
+            }
+            default: break;
+        }
+
+        Transform.Rotation = glm::vec3(SRandom::GetFloatValue(0.0f, glm::two_pi<float>()), SRandom::GetFloatValue(0.0f, glm::two_pi<float>()), SRandom::GetFloatValue(0.0f, glm::two_pi<float>()));
+        Transform.Scale = glm::vec3(SRandom::GetFloatValue(Settings.MinScale, Settings.MaxScale));
+
+        IMesh* Mesh = Meshes[SRandom::GetUInt32Value() % Meshes.size()];
+
+        SEntity Entity = Registry->CreateEntity();
+        Entity.AddComponent<STransformComponent>(Transform);
+        Entity.AddComponent<SMeshComponent>(Mesh);
+
+        // Spreads the dynamic entities evenly over the index range, yielding exactly EntityCount * DynamicRatio of them.
+        const bool bDynamic = std::floor((Index + 1) * Settings.DynamicRatio) > std::floor(Index * Settings.DynamicRatio);
+        if (bDynamic)
+        {
+            SMotionComponent& MotionComponent = Entity.AddComponent<SMotionComponent>();
+            MotionComponent.AngularVelocity = glm::vec3(SRandom::GetFloatValue(-1.0f, 1.0f), SRandom::GetFloatValue(-1.0f, 1.0f), SRandom::GetFloatValue(-1.0f, 1.0f));
+            MotionComponent.OscillationAxis = glm::vec3(SRandom::GetFloatValue(-1.0f, 1.0f), SRandom::GetFloatValue(-1.0f, 1.0f), SRandom::GetFloatValue(-1.0f, 1.0f));
+            MotionComponent.OscillationFrequency = SRandom::GetFloatValue(0.1f, 1.0f);
+            MotionComponent.Origin = Transform.Translation;
+        }
+
+        Entities.push_back(Entity.GetEntityID());
+    }
+
+    RK_LOG_INFO("Generated {} entities ({} distribution, {:.0f}% dynamic) across {} meshes and {} materials", Settings.EntityCount, GetSpatialDistributionName(Settings.Distribution), Settings.DynamicRatio * 100.0f, Meshes.size(), Materials.size());
+}
+
+void PSceneGenerator::Clear()
+{
+    PRegistry* Registry = GetScene()->GetRegistry();
+    for (SEntityID EntityID : Entities)
+    {
+        if (Registry->IsValid(EntityID))
+        {
+            Registry->DestroyEntity(EntityID);
+        }
+    }
+    Entities.clear();
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Scene/Registry.h"
+
+class IMaterial;
+class IMesh;
+class IShader;
+
+enum class ESpatialDistribution : uint8_t
+{
+    Uniform,    // Uniformly inside a cube of half-size Extent
+    Grid,       // Regular grid filling the cube, no overlap
+    Clustered,  // Normally distributed around ClusterCount random centers
+    Count
+};
+
+const char* GetSpatialDistributionName(ESpatialDistribution Distribution);
+std::optional<ESpatialDistribution> ParseSpatialDistribution(const std::string& Name);
+
+struct SSceneGeneratorSettings
+{
+    uint32_t EntityCount = 1000;
+
+    // Share of entities that receive a SMotionComponent, between 0 and 1
+    float DynamicRatio = 0.0f;
+
+    ESpatialDistribution Distribution = ESpatialDistribution::Uniform;
+
+    // Half-size of the volume entities are placed in, in world units
+    float Extent = 50.0f;
+    uint32_t ClusterCount = 8;
+
+    float MinScale = 0.5f;
+    float MaxScale = 1.5f;
+
+    uint32_t Seed = 1;
+};
+
+// Fills the scene registry with procedurally placed entities for load tests. Materials and meshes are created once
+// and shared by every population generated afterwards, since render graph commands cannot be removed again.
+class PSceneGenerator
+{
+public:
+    // Creates MaterialCount materials and MeshCount procedural meshes of increasing tessellation.
+    // Every mesh is bound to one material (MeshIndex % MaterialCount), so at most MeshCount materials are in use.
+    void CreateAssets(uint32_t MaterialCount, uint32_t MeshCount);
+
+    // Seeds SRandom with the settings' seed, the same settings always produce the same scene.
+    void Generate(const SSceneGeneratorSettings& Settings);
+
+    // Destroys every entity created by Generate.
+    void Clear();
+
+    [[nodiscard]] size_t GetEntityCount() const
+    {
+        return Entities.size();
+    }
+
+    [[nodiscard]] size_t GetMaterialCount() const
+    {
+        return Materials.size();
+    }
+
+    [[nodiscard]] size_t GetMeshCount() const
+    {
+        return Meshes.size();
+    }
+
+private:
+    std::vector<IShader*> Shaders;
+    std::vector<IMaterial*> Materials;
+    std::vector<IMesh*> Meshes;
+
+    std::vector<SEntityID> Entities;
+};
@@ -0,0 +1,109 @@
+#include "EnginePCH.h"
+#include "SpatialIndex.h"
+
+PSpatialIndex::PSpatialIndex(PRegistry* InRegistry)
+    : Registry(InRegistry)
+{
+    Registry->OnConstruct<SMeshComponent>().connect<&PSpatialIndex::OnMeshConstructed>(*this);
+    Registry->OnDestroy<SMeshComponent>().connect<&PSpatialIndex::OnMeshDestroyed>(*this);
+    Registry->OnDestroy<SBoundsComponent>().connect<&PSpatialIndex::OnBoundsDestroyed>(*this);
+    Registry->OnUpdate<STransformComponent>().connect<&PSpatialIndex::OnTransformUpdated>(*this);
+}
+
+PSpatialIndex::~PSpatialIndex()
+{
+    Registry->OnConstruct<SMeshComponent>().disconnect<&PSpatialIndex::OnMeshConstructed>(*this);
+    Registry->OnDestroy<SMeshComponent>().disconnect<&PSpatialIndex::OnMeshDestroyed>(*this);
+    Registry->OnDestroy<SBoundsComponent>().disconnect<&PSpatialIndex::OnBoundsDestroyed>(*this);
+    Registry->OnUpdate<STransformComponent>().disconnect<&PSpatialIndex::OnTransformUpdated>(*this);
+}
+
+void PSpatialIndex::Update()
+{
+    PROFILE_FUNC_SCOPE("PSpatialIndex::Update")
+
+    BVH.Update();
+}
+
+bool PSpatialIndex::RayCast(const SRay& Ray, float MaxDistance, SSpatialRayHit& Hit) const
+{
+    SBVHRayHit BVHHit;
+    if (!BVH.RayCast(Ray, MaxDistance, BVHHit))
+    {
+        return false;
+    }
+
+    Hit.EntityID = static_cast<SEntityID>(BVHHit.UserData);
+    Hit.Distance = BVHHit.Distance;
+    return true;
+}
+
+void PSpatialIndex::OnMeshConstructed(SRegistry& InRegistry, SEntityID EntityID)
+{
+    // A transform added later moves the bounds once PRegistry::UpdateTransforms has resolved it.
+    SBoundsComponent& BoundsComponent = InRegistry.emplace<SBoundsComponent>(EntityID);
+    UpdateWorldBounds(InRegistry, EntityID, BoundsComponent);
+    BoundsComponent.ProxyID = BVH.CreateProxy(BoundsComponent.WorldBounds, entt::to_integral(EntityID));
+
+    BoundsComponent.StreamIndex = static_cast<uint32_t>(StreamEntities.size());
+    BoundsStreams.Resize(StreamEntities.size() + 1);
+    BoundsStreams.Set(BoundsComponent.StreamIndex, BoundsComponent.WorldBounds, BoundsComponent.WorldBoundingSphere);
+    StreamEntities.push_back(EntityID);
+    StreamMeshes.push_back(InRegistry.get<SMeshComponent>(EntityID).Mesh);
+}
+
+void PSpatialIndex::OnMeshDestroyed(SRegistry& InRegistry, SEntityID EntityID)
+{
+    InRegistry.remove<SBoundsComponent>(EntityID);
+}
+
+void PSpatialIndex::OnBoundsDestroyed(SRegistry& InRegistry, SEntityID EntityID)
+{
+    // Also raised when the entity is destroyed, whichever of its components goes first.
+    const SBoundsComponent& BoundsComponent = InRegistry.get<SBoundsComponent>(EntityID);
+    BVH.DestroyProxy(BoundsComponent.ProxyID);
+
+    // The last element takes the removed one's place.
+    const uint32_t StreamIndex = BoundsComponent.StreamIndex;
+    const SEntityID LastEntityID = StreamEntities.back();
+    if (LastEntityID != EntityID)
+    {
+        InRegistry.get<SBoundsComponent>(LastEntityID).StreamIndex = StreamIndex;
+        StreamEntities[StreamIndex] = LastEntityID;
+        StreamMeshes[StreamIndex] = StreamMeshes.back();
+    }
+
+    BoundsStreams.RemoveSwap(StreamIndex);
+    StreamEntities.pop_back();
+    StreamMeshes.pop_back();
+}
+
+void PSpatialIndex::OnTransformUpdated(SRegistry& InRegistry, SEntityID EntityID)
+{
+    if (SBoundsComponent* BoundsComponent = InRegistry.try_get<SBoundsComponent>(EntityID))
+    {
+        UpdateWorldBounds(InRegistry, EntityID, *BoundsComponent);
+        BVH.MoveProxy(BoundsComponent->ProxyID, BoundsComponent->WorldBounds);
+        BoundsStreams.Set(BoundsComponent->StreamIndex, BoundsComponent->WorldBounds, BoundsComponent->WorldBoundingSphere);
+    }
+}
+
+void PSpatialIndex::UpdateWorldBounds(SRegistry& InRegistry, SEntityID EntityID, SBoundsComponent& BoundsComponent)
+{
+    const SMeshComponent& MeshComponent = InRegistry.get<SMeshComponent>(EntityID);
+    const STransformComponent* TransformComponent = InRegistry.try_get<STransformComponent>(EntityID);
+    const glm::mat4 WorldMatrix = TransformComponent ? TransformComponent->WorldMatrix : glm::mat4(1.0f);
+
+    // Meshes without vertices still need a leaf, they are indexed as a point at their origin.
+    if (!MeshComponent.Mesh || !MeshComponent.Mesh->GetLocalBounds().IsValid())
+    {
+        const glm::vec3 Position = glm::vec3(WorldMatrix[3]);
+        BoundsComponent.WorldBounds = SAABB(Position, Position);
+        BoundsComponent.WorldBoundingSphere.Center = Position;
+        BoundsComponent.WorldBoundingSphere.Radius = 0.0f;
+        return;
+    }
+
+    BoundsComponent.WorldBounds = MeshComponent.Mesh->GetLocalBounds().Transform(WorldMatrix);
+    BoundsComponent.WorldBoundingSphere = MeshComponent.Mesh->GetLocalBoundingSphere().Transform(WorldMatrix);
+}
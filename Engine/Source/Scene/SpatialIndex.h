@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Math/BVH.h"
+#include "Math/FrustumCull.h"
+#include "Scene/Registry.h"
+
+class IMesh;
+
+struct SSpatialRayHit
+{
+    SEntityID EntityID = entt::null;
+    float Distance = 0.0f;
+};
+
+// Spatial index over the entities with a mesh. Keeps their SBoundsComponent in sync with the transforms, which
+// PRegistry::UpdateTransforms reports, and a BVH over the world bounds that Update brings up to date once per frame.
+// Base for culling, picking and streaming queries, which see the scene as of the last Update. The world bounds are
+// also mirrored into dense streams for brute-force SIMD tests such as PFrustumCuller's.
+class PSpatialIndex
+{
+public:
+    explicit PSpatialIndex(PRegistry* InRegistry);
+    ~PSpatialIndex();
+
+    void Update();
+
+    // Func(SEntityID) for every entity whose bounds are at least partially inside the frustum.
+    template<typename TFunc>
+    void QueryFrustum(const SFrustum& Frustum, TFunc&& Func) const;
+
+    // Func(SEntityID) for every entity whose bounds overlap Box.
+    template<typename TFunc>
+    void QueryOverlap(const SAABB& Box, TFunc&& Func) const;
+
+    // Entity whose bounds the ray enters first within MaxDistance.
+    bool RayCast(const SRay& Ray, float MaxDistance, SSpatialRayHit& Hit) const;
+
+    [[nodiscard]] const PBVH& GetBVH() const
+    {
+        return BVH;
+    }
+
+    // Element i of the streams belongs to StreamEntities[i], whose mesh is StreamMeshes[i]. Current as soon as a
+    // transform update is reported, unlike the BVH.
+    [[nodiscard]] const SBoundsStreams& GetBoundsStreams() const
+    {
+        return BoundsStreams;
+    }
+
+    [[nodiscard]] const std::vector<SEntityID>& GetStreamEntities() const
+    {
+        return StreamEntities;
+    }
+
+    [[nodiscard]] const std::vector<IMesh*>& GetStreamMeshes() const
+    {
+        return StreamMeshes;
+    }
+
+private:
+    void OnMeshConstructed(SRegistry& InRegistry, SEntityID EntityID);
+    void OnMeshDestroyed(SRegistry& InRegistry, SEntityID EntityID);
+    void OnBoundsDestroyed(SRegistry& InRegistry, SEntityID EntityID);
+    void OnTransformUpdated(SRegistry& InRegistry, SEntityID EntityID);
+
+    // Recomputes the world bounds from the mesh's local bounds and the world matrix.
+    static void UpdateWorldBounds(SRegistry& InRegistry, SEntityID EntityID, SBoundsComponent& BoundsComponent);
+
+    PRegistry* Registry;
+
+    PBVH BVH;
+
+    SBoundsStreams BoundsStreams;
+    std::vector<SEntityID> StreamEntities;
+    std::vector<IMesh*> StreamMeshes;
+};
+
+template<typename TFunc>
+void PSpatialIndex::QueryFrustum(const SFrustum& Frustum, TFunc&& Func) const
+{
+    BVH.QueryFrustum(Frustum, [&](uint32_t UserData) { Func(static_cast<SEntityID>(UserData)); });
+}
+
+template<typename TFunc>
+void PSpatialIndex::QueryOverlap(const SAABB& Box, TFunc&& Func) const
+{
+    BVH.QueryOverlap(Box, [&](uint32_t UserData) { Func(static_cast<SEntityID>(UserData)); });
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <rapidjson/document.h>
+
+namespace JSON
+{
+    // Reads a member written as [X, Y, Z], Default if it is missing or not an array of three elements.
+    inline glm::vec3 ReadVector3(const rapidjson::Value& Object, const char* Name, const glm::vec3& Default)
+    {
+        if (!Object.HasMember(Name) || !Object[Name].IsArray() || Object[Name].Size() != 3)
+        {
+            return Default;
+        }
+
+        const rapidjson::Value& Array = Object[Name];
+        return glm::vec3(Array[0].GetFloat(), Array[1].GetFloat(), Array[2].GetFloat());
+    }
+}
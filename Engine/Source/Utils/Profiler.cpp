@@ -1,81 +1,342 @@
 #include "EnginePCH.h"
 #include "Profiler.h"
 
-#include <fstream>
-#include <rapidjson/rapidjson.h>
-#include <rapidjson/document.h>
-#include <rapidjson/writer.h>
-#include <rapidjson/stringbuffer.h>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
 
-struct SEvent
+#include "Utils/ProfilerSampler.h"
+#include "Utils/ProfilerTrace.h"
+
+// Buffers are registered once per thread and never freed, events of exited threads are still flushed.
+static std::mutex ThreadBufferMutex;
+static std::vector<SProfilerThreadBuffer*> ThreadBuffers;
+
+// Guarded by ThreadBufferMutex, which serializes every consumer of the rings.
+static PProfilerTraceWriter TraceWriter;
+
+// Guarded by ThreadBufferMutex as well, so listeners never run concurrently.
+static std::vector<IProfilerEventListener*> EventListeners;
+
+// Guarded by ThreadBufferMutex. bSampled stays set once sampling ran, so later captures still record the modules.
+static bool bSampling = false;
+static bool bSampled = false;
+
+// Runs while there is a capture or a listener, started and stopped by the thread that configures the profiler.
+static std::thread FlushThread;
+static std::mutex FlushThreadMutex;
+static std::condition_variable FlushThreadCondition;
+static bool bFlushThreadRunning = false;
+
+// Written by the render thread only, so it keeps the single-producer contract of the rings.
+static SProfilerThreadBuffer* GPUThreadBuffer = nullptr;
+
+// Node-based, so locations handed out stay valid while others are added.
+static std::mutex NamedSourceLocationMutex;
+static std::unordered_map<const char*, SProfilerSourceLocation> NamedSourceLocations;
+
+// Trace timestamps are relative to profiler start-up rather than the engine, so events can be recorded without one.
+static const uint64_t ProfilerStartTimestamp = PProfiler::GetTimestamp();
+
+namespace Utils
+{
+    // Expects ThreadBufferMutex to be held. Written at the start and end of a capture, so libraries loaded
+    // in between (e.g. the Vulkan driver) can be symbolized as well. Converters ignore duplicates.
+    static void WriteModules()
+    {
+        ProfilerSampler::EnumerateModules([](uint64_t Start, uint64_t Size, uint64_t Bias, const char* Path)
+        {
+            TraceWriter.WriteModule(Start, Size, Bias, Path);
+        });
+    }
+
+    // Starts the flush thread once the rings have a consumer and stops it when the last one is gone, so events never
+    // pile up and nothing drains them on the frame thread. Expects ThreadBufferMutex not to be held, the thread takes it.
+    static void UpdateFlushThread()
+    {
+        bool bConsumed = false;
+        {
+            std::lock_guard<std::mutex> Lock(ThreadBufferMutex);
+            bConsumed = TraceWriter.IsOpen() || !EventListeners.empty();
+        }
+
+        if (bConsumed && !FlushThread.joinable())
+        {
+            bFlushThreadRunning = true;
+            FlushThread = std::thread([]()
+            {
+                std::unique_lock<std::mutex> Lock(FlushThreadMutex);
+                while (bFlushThreadRunning)
+                {
+                    FlushThreadCondition.wait_for(Lock, std::chrono::milliseconds(PProfiler::FlushIntervalMilliseconds));
+
+                    Lock.unlock();
+                    PProfiler::Flush();
+                    Lock.lock();
+                }
+            });
+        }
+        else if (!bConsumed && FlushThread.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> Lock(FlushThreadMutex);
+                bFlushThreadRunning = false;
+            }
+            FlushThreadCondition.notify_one();
+            FlushThread.join();
+        }
+    }
+}
+
+SProfilerThreadBuffer* PProfiler::RegisterThread()
 {
-    const char* Name;
-    const char* Phase;
-    int64_t Timestamp;
-    uint32_t ThreadID;
-    uint32_t ProcessID;
+    SProfilerThreadBuffer* Buffer = new SProfilerThreadBuffer();
+    Buffer->ThreadID = static_cast<uint32_t>(gettid());
+    Buffer->ProcessID = static_cast<uint32_t>(getpid());
+    ProfilerSampler::GetThreadStack(Buffer->StackLow, Buffer->StackHigh);
 
-    bool IsComplete() const
+    std::lock_guard<std::mutex> Lock(ThreadBufferMutex);
+    ThreadBuffers.push_back(Buffer);
+    if (bSampling)
     {
-        return std::strcmp(Phase, "E") == 0;
+        Buffer->SampleBuffer.store(new SProfilerSampleBuffer(), std::memory_order_release);
     }
-};
 
-std::vector<SEvent> Timeline;
+    ThreadBuffer = Buffer;
+    return Buffer;
+}
+
+void PProfiler::RecordGPUEvent(const SProfilerSourceLocation* Location, EProfilerEventType Type, uint64_t Timestamp)
+{
+    if (!GPUThreadBuffer)
+    {
+        GPUThreadBuffer = new SProfilerThreadBuffer();
+        GPUThreadBuffer->ThreadID = GPUThreadID;
+        GPUThreadBuffer->ProcessID = static_cast<uint32_t>(getpid());
+
+        std::lock_guard<std::mutex> Lock(ThreadBufferMutex);
+        ThreadBuffers.push_back(GPUThreadBuffer);
+    }
+
+    PushEvent(GPUThreadBuffer, Location, Type, Timestamp);
+}
+
+void PProfiler::RecordCounter(const SProfilerSourceLocation* Location, uint64_t Value)
+{
+    PushEvent(ThreadBuffer ? ThreadBuffer : RegisterThread(), Location, EProfilerEventType::Counter, GetTimestamp(), Value);
+}
+
+const SProfilerSourceLocation* PProfiler::GetNamedSourceLocation(const char* Name, const char* Category)
+{
+    std::lock_guard<std::mutex> Lock(NamedSourceLocationMutex);
+
+    auto Iterator = NamedSourceLocations.find(Name);
+    if (Iterator == NamedSourceLocations.end())
+    {
+        Iterator = NamedSourceLocations.emplace(Name, SProfilerSourceLocation { Name, Category, 0 }).first;
+    }
+    return &Iterator->second;
+}
+
+void PProfiler::StartCapture(const std::string& Path)
+{
+    {
+        std::lock_guard<std::mutex> Lock(ThreadBufferMutex);
+        RK_ASSERT(!TraceWriter.IsOpen(), "A profiler capture is already running.");
+
+        if (!TraceWriter.Open(Path, ProfilerStartTimestamp, static_cast<uint32_t>(getpid())))
+        {
+            RK_LOG_ERROR("Failed to open profiler capture {}", Path);
+            return;
+        }
+
+        if (bSampled)
+        {
+            Utils::WriteModules();
+        }
+    }
+
+    Utils::UpdateFlushThread();
+
+    RK_LOG_INFO("Profiler capture started, writing to {}", Path);
+}
+
+void PProfiler::StopCapture()
+{
+    if (!IsCapturing())
+    {
+        return;
+    }
+
+    Flush();
+
+    {
+        std::lock_guard<std::mutex> Lock(ThreadBufferMutex);
+        if (bSampled)
+        {
+            Utils::WriteModules();
+        }
+
+        RK_LOG_INFO("Profiler capture stopped, {} KiB written", TraceWriter.GetBytesWritten() / 1024);
+        TraceWriter.Close();
+    }
+
+    Utils::UpdateFlushThread();
+}
+
+bool PProfiler::IsCapturing()
+{
+    std::lock_guard<std::mutex> Lock(ThreadBufferMutex);
+    return TraceWriter.IsOpen();
+}
 
 void PProfiler::Flush()
 {
-    rapidjson::Document Document;
-    Document.SetObject();
-    rapidjson::Document::AllocatorType& Allocator = Document.GetAllocator();
+    std::lock_guard<std::mutex> Lock(ThreadBufferMutex);
+    for (SProfilerThreadBuffer* Buffer : ThreadBuffers)
+    {
+        const uint64_t WriteIndex = Buffer->WriteIndex.load(std::memory_order_acquire);
+
+        SProfilerSampleBuffer* SampleBuffer = Buffer->SampleBuffer.load(std::memory_order_acquire);
+        const uint64_t SampleWriteIndex = SampleBuffer ? SampleBuffer->WriteIndex.load(std::memory_order_acquire) : 0;
+        uint64_t SampleReadIndex = SampleBuffer ? SampleBuffer->ReadIndex.load(std::memory_order_relaxed) : 0;
+
+        // Samples are interleaved with the events by timestamp, deltas within a thread section must not go backwards.
+        auto WriteSamples = [&](uint64_t Timestamp)
+        {
+            for (; SampleReadIndex < SampleWriteIndex; ++SampleReadIndex)
+            {
+                const SProfilerSample& Sample = SampleBuffer->Samples[SampleReadIndex & (SProfilerSampleBuffer::Capacity - 1)];
+                if (Sample.Timestamp > Timestamp)
+                {
+                    break;
+                }
+
+                if (TraceWriter.IsOpen())
+                {
+                    TraceWriter.WriteSample(Buffer->ThreadID, Sample);
+                }
+            }
+        };
+
+        if (TraceWriter.IsOpen() || !EventListeners.empty())
+        {
+            for (uint64_t ReadIndex = Buffer->ReadIndex.load(std::memory_order_relaxed); ReadIndex < WriteIndex; ++ReadIndex)
+            {
+                const SProfilerEvent& Event = Buffer->Events[ReadIndex & (SProfilerThreadBuffer::Capacity - 1)];
+                WriteSamples(Event.Timestamp);
+
+                if (TraceWriter.IsOpen())
+                {
+                    TraceWriter.WriteEvent(Buffer->ThreadID, Event);
+                }
+
+                for (IProfilerEventListener* Listener : EventListeners)
+                {
+                    Listener->OnEvent(Buffer->ThreadID, Event);
+                }
+            }
+        }
+        Buffer->ReadIndex.store(WriteIndex, std::memory_order_release);
+
+        WriteSamples(UINT64_MAX);
+        if (SampleBuffer)
+        {
+            SampleBuffer->ReadIndex.store(SampleWriteIndex, std::memory_order_release);
+        }
+
+        uint64_t DroppedEventCount = Buffer->DroppedEventCount.exchange(0, std::memory_order_relaxed);
+        if (SampleBuffer)
+        {
+            DroppedEventCount += SampleBuffer->DroppedSampleCount.exchange(0, std::memory_order_relaxed);
+        }
+        if (DroppedEventCount > 0 && TraceWriter.IsOpen())
+        {
+            TraceWriter.WriteDroppedEvents(Buffer->ThreadID, DroppedEventCount);
+        }
+    }
+
+    // Partial chunks are written too, a crash loses at most one flush interval.
+    TraceWriter.FlushChunk();
 
-    rapidjson::Value TraceEvents(rapidjson::kArrayType);
-    for (const auto& Event : Timeline) 
+    for (IProfilerEventListener* Listener : EventListeners)
     {
-        rapidjson::Value EventObject(rapidjson::kObjectType);
+        Listener->OnFlush();
+    }
+}
+
+void PProfiler::StartSampling(uint32_t Frequency)
+{
+    // The calling thread is sampled even if it has not recorded an event yet.
+    if (!ThreadBuffer)
+    {
+        RegisterThread();
+    }
 
-        EventObject.AddMember("name", rapidjson::Value(Event.Name, Allocator), Allocator);
-        EventObject.AddMember("ph", rapidjson::Value(Event.Phase, Allocator), Allocator);
-        EventObject.AddMember("ts", Event.Timestamp, Allocator);
-        EventObject.AddMember("pid", Event.ProcessID, Allocator);
-        EventObject.AddMember("tid", Event.ThreadID, Allocator);
+    {
+        std::lock_guard<std::mutex> Lock(ThreadBufferMutex);
+        for (SProfilerThreadBuffer* Buffer : ThreadBuffers)
+        {
+            if (Buffer != GPUThreadBuffer && !Buffer->SampleBuffer.load(std::memory_order_relaxed))
+            {
+                Buffer->SampleBuffer.store(new SProfilerSampleBuffer(), std::memory_order_release);
+            }
+        }
+        bSampling = true;
+        bSampled = true;
 
-        TraceEvents.PushBack(EventObject, Allocator);
+        if (TraceWriter.IsOpen())
+        {
+            Utils::WriteModules();
+        }
     }
 
-    Document.AddMember("traceEvents", TraceEvents, Allocator);
+    if (!ProfilerSampler::Start(Frequency))
+    {
+        std::lock_guard<std::mutex> Lock(ThreadBufferMutex);
+        bSampling = false;
 
-    rapidjson::StringBuffer Buffer;
-    rapidjson::Writer<rapidjson::StringBuffer> Writer(Buffer);
-    Document.Accept(Writer);
+        RK_LOG_WARNING("Sampling profiler is not supported on this platform");
+        return;
+    }
 
-    std::ofstream File("trace.json");
-    File << Buffer.GetString();
-    File.close();
+    RK_LOG_INFO("Sampling profiler started at {} Hz", Frequency);
+}
 
-    Timeline.clear();
+void PProfiler::StopSampling()
+{
+    std::lock_guard<std::mutex> Lock(ThreadBufferMutex);
+    if (bSampling)
+    {
+        ProfilerSampler::Stop();
+        bSampling = false;
+    }
 }
 
-void PProfiler::StartEventBlock(const char* Name)
+void PProfiler::AddEventListener(IProfilerEventListener* Listener)
 {
-    Timeline.emplace_back();
-
-    SEvent& EventData = Timeline.back();
-    EventData.Timestamp = static_cast<int64_t>(GetEngine()->Time.GetElapsedTimeAsMicroseconds());
-    EventData.Name = Name;
-    EventData.Phase = "B";
-    EventData.ProcessID = getpid();
-    EventData.ThreadID = gettid();
+    {
+        std::lock_guard<std::mutex> Lock(ThreadBufferMutex);
+        EventListeners.push_back(Listener);
+    }
+    Utils::UpdateFlushThread();
 }
 
-void PProfiler::EndEventBlock(const char* Name)
+void PProfiler::RemoveEventListener(IProfilerEventListener* Listener)
 {
-    Timeline.emplace_back();
-
-    SEvent& EventData = Timeline.back();
-    EventData.Name = Name;
-    EventData.Phase = "E";
-    EventData.Timestamp = static_cast<int64_t>(GetEngine()->Time.GetElapsedTimeAsMicroseconds());
-    EventData.ProcessID = getpid();
-    EventData.ThreadID = gettid();
-}
\ No newline at end of file
+    {
+        std::lock_guard<std::mutex> Lock(ThreadBufferMutex);
+        EventListeners.erase(std::remove(EventListeners.begin(), EventListeners.end(), Listener), EventListeners.end());
+    }
+    Utils::UpdateFlushThread();
+}
+
+void PProfiler::Reset()
+{
+    std::lock_guard<std::mutex> Lock(ThreadBufferMutex);
+    for (SProfilerThreadBuffer* Buffer : ThreadBuffers)
+    {
+        Buffer->ReadIndex.store(Buffer->WriteIndex.load(std::memory_order_acquire), std::memory_order_release);
+        Buffer->DroppedEventCount.store(0, std::memory_order_relaxed);
+    }
+}
@@ -1,32 +1,200 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "Utils/TickClock.h"
+
+// Emitted once per instrumented scope as a static, events only store a pointer to it.
+struct SProfilerSourceLocation
+{
+    const char* Name;
+    const char* File;
+    uint32_t Line;
+};
+
+enum class EProfilerEventType : uint8_t
+{
+    Begin,
+    End,
+    Counter
+};
+
+struct SProfilerSampleBuffer;
+
+struct SProfilerEvent
+{
+    // Raw PProfiler::GetTimestamp value, converted when the trace is written
+    uint64_t Timestamp;
+    const SProfilerSourceLocation* Location;
+    EProfilerEventType Type;
+
+    // Sampled value of Counter events
+    uint64_t Value;
+};
+
+// Single-producer, single-consumer ring. Only the owning thread writes, Flush is the only reader.
+// Events recorded while the ring is full are dropped and counted, never overwritten.
+struct SProfilerThreadBuffer
+{
+    // Large enough to bridge a few flush intervals of a busy thread
+    static constexpr uint64_t Capacity = 1 << 16;
+
+    uint32_t ThreadID = 0;
+    uint32_t ProcessID = 0;
+
+    // Stack of the owning thread, bounds the stack walks of the sampling profiler
+    uintptr_t StackLow = 0;
+    uintptr_t StackHigh = 0;
+
+    alignas(64) std::atomic<uint64_t> WriteIndex = 0;
+    alignas(64) std::atomic<uint64_t> ReadIndex = 0;
+    std::atomic<uint64_t> DroppedEventCount = 0;
+
+    // Only allocated while the sampling profiler runs
+    std::atomic<SProfilerSampleBuffer*> SampleBuffer = nullptr;
+
+    std::array<SProfilerEvent, Capacity> Events;
+};
+
+// Receives every event drained from the rings, in recording order per thread.
+// Called from whichever thread runs PProfiler::Flush, with the profiler's lock held.
+class IProfilerEventListener
+{
+public:
+    virtual ~IProfilerEventListener() = default;
+
+    virtual void OnEvent(uint32_t ThreadID, const SProfilerEvent& Event) = 0;
+
+    // Called once per flush, after the events of every thread.
+    virtual void OnFlush()
+    {
+    }
+};
+
 class PProfiler
 {
 public:
+    static constexpr uint32_t FlushIntervalMilliseconds = 20;
+
+    // Streams recorded events into a binary capture (see ProfilerTrace.h). While there is a capture or an event
+    // listener, a background thread drains every thread's ring each FlushIntervalMilliseconds.
+    static void StartCapture(const std::string& Path);
+
+    // Writes the remaining events and closes the capture, the background thread stops unless listeners remain.
+    static void StopCapture();
+
+    [[nodiscard]] static bool IsCapturing();
+
+    // Drains every thread's ring into the open capture and the event listeners.
+    // Events are discarded when there is neither a capture nor a listener.
     static void Flush();
 
-    static void StartEventBlock(const char* Name);
-    static void EndEventBlock(const char* Name);
+    // Samples the call stacks of every thread with a profiler buffer Frequency times per second of CPU time
+    // (see ProfilerSampler.h). Samples are written into the capture next to the instrumented scopes.
+    static void StartSampling(uint32_t Frequency);
+    static void StopSampling();
+
+    // Not from a listener callback, adding the first or removing the last listener starts or joins the flush thread.
+    static void AddEventListener(IProfilerEventListener* Listener);
+    static void RemoveEventListener(IProfilerEventListener* Listener);
+
+    // Drops every recorded event without writing them.
+    static void Reset();
+
+    static void StartEventBlock(const SProfilerSourceLocation* Location)
+    {
+        RecordEvent(Location, EProfilerEventType::Begin);
+    }
+
+    static void EndEventBlock(const SProfilerSourceLocation* Location)
+    {
+        RecordEvent(Location, EProfilerEventType::End);
+    }
+
+    // Thread ID of the track GPU scopes are recorded on
+    static constexpr uint32_t GPUThreadID = UINT32_MAX;
+
+    // Stable location for events named by a static string rather than PROFILE_FUNC_SCOPE, Category is shown as its file.
+    // Takes a lock, callers resolve each name once and keep the location.
+    static const SProfilerSourceLocation* GetNamedSourceLocation(const char* Name, const char* Category);
+
+    // Records a GPU scope event on the GPU track, Timestamp must already be in the GetTimestamp domain.
+    // Location comes from GetNamedSourceLocation with the "GPU" category. Only the render thread may call this.
+    static void RecordGPUEvent(const SProfilerSourceLocation* Location, EProfilerEventType Type, uint64_t Timestamp);
+
+    // Records a sample of a counter track on the calling thread, Location comes from GetNamedSourceLocation with
+    // the "Counter" category.
+    static void RecordCounter(const SProfilerSourceLocation* Location, uint64_t Value);
+
+    static uint64_t GetTimestamp()
+    {
+        return PTickClock::Now();
+    }
+
+    // Buffer of the calling thread, null until the thread records its first event
+    static SProfilerThreadBuffer* GetThreadBuffer()
+    {
+        return ThreadBuffer;
+    }
+
+    static uint64_t GetTicksPerSecond()
+    {
+        return PTickClock::GetTicksPerSecond();
+    }
+
+private:
+    static void RecordEvent(const SProfilerSourceLocation* Location, EProfilerEventType Type)
+    {
+        PushEvent(ThreadBuffer ? ThreadBuffer : RegisterThread(), Location, Type, GetTimestamp());
+    }
+
+    static void PushEvent(SProfilerThreadBuffer* Buffer, const SProfilerSourceLocation* Location, EProfilerEventType Type, uint64_t Timestamp, uint64_t Value = 0)
+    {
+        const uint64_t WriteIndex = Buffer->WriteIndex.load(std::memory_order_relaxed);
+        if (WriteIndex - Buffer->ReadIndex.load(std::memory_order_acquire) >= SProfilerThreadBuffer::Capacity)
+        {
+            Buffer->DroppedEventCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        SProfilerEvent& Event = Buffer->Events[WriteIndex & (SProfilerThreadBuffer::Capacity - 1)];
+        Event.Timestamp = Timestamp;
+        Event.Location = Location;
+        Event.Type = Type;
+        Event.Value = Value;
+
+        Buffer->WriteIndex.store(WriteIndex + 1, std::memory_order_release);
+    }
+
+    // Allocates the calling thread's buffer and caches its thread and process IDs.
+    static SProfilerThreadBuffer* RegisterThread();
+
+    static inline thread_local SProfilerThreadBuffer* ThreadBuffer = nullptr;
 };
 
 struct SProfilerScope
 {
-    SProfilerScope(const char* InName)
-        : Name(InName)
+    SProfilerScope(const SProfilerSourceLocation* InLocation)
+        : Location(InLocation)
     {
-        PProfiler::StartEventBlock(Name);
+        PProfiler::StartEventBlock(Location);
     }
 
     ~SProfilerScope()
     {
-        PProfiler::EndEventBlock(Name);
+        PProfiler::EndEventBlock(Location);
     }
 
-    const char* Name;
+    const SProfilerSourceLocation* Location;
 };
 
 #ifdef RK_PROFILE
-#define PROFILE_FUNC_SCOPE(Name) SProfilerScope _PROFILE_FUNC_SCOPE_(Name);
+#define PROFILE_FUNC_SCOPE(Name) \
+    static constexpr SProfilerSourceLocation _PROFILE_SOURCE_LOCATION_ { Name, __FILE__, __LINE__ }; \
+    SProfilerScope _PROFILE_FUNC_SCOPE_(&_PROFILE_SOURCE_LOCATION_);
 #else
 #define PROFILE_FUNC_SCOPE(...)
-#endif
\ No newline at end of file
+#endif
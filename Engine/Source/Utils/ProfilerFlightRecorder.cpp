@@ -0,0 +1,137 @@
+#include "EnginePCH.h"
+#include "ProfilerFlightRecorder.h"
+
+#include <filesystem>
+
+#include "Utils/ProfilerTrace.h"
+
+PProfilerFlightRecorder::~PProfilerFlightRecorder()
+{
+    Wait();
+}
+
+void PProfilerFlightRecorder::Configure(const SFlightRecorderSettings& InSettings)
+{
+    Settings = InSettings;
+}
+
+void PProfilerFlightRecorder::OnEvent(uint32_t ThreadID, const SProfilerEvent& Event)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    Events.push_back({ ThreadID, Event });
+    if (Events.size() > MaxEventCount)
+    {
+        Events.pop_front();
+    }
+}
+
+bool PProfilerFlightRecorder::EndFrame(uint64_t FrameStart, uint64_t FrameEnd)
+{
+    FrameIndex++;
+
+    {
+        // Events arrive in flush order, GPU events slightly out of order, so the window edge is approximate.
+        const uint64_t WindowTicks = PTickClock::SecondsToTicks(Settings.WindowSeconds);
+        const uint64_t OldestTimestamp = FrameEnd > WindowTicks ? FrameEnd - WindowTicks : 0;
+
+        std::lock_guard<std::mutex> Lock(Mutex);
+        while (!Events.empty() && Events.front().Event.Timestamp < OldestTimestamp)
+        {
+            Events.pop_front();
+        }
+    }
+
+    if (PendingDumpFrameCount > 0)
+    {
+        return --PendingDumpFrameCount == 0;
+    }
+
+    const uint64_t FrameTicks = FrameEnd - FrameStart;
+    if (PTickClock::TicksToMilliseconds(FrameTicks) <= Settings.BudgetMilliseconds)
+    {
+        return false;
+    }
+
+    const bool bRateLimited = DumpCount >= Settings.MaxDumpCount || (DumpCount > 0 && FrameEnd - LastDumpTimestamp < PTickClock::SecondsToTicks(Settings.MinDumpIntervalSeconds));
+    if (bRateLimited)
+    {
+        SuppressedHitchCount++;
+        return false;
+    }
+
+    RK_LOG_WARNING("Frame {} took {:.2f} ms, over the {:.2f} ms budget", FrameIndex, PTickClock::TicksToMilliseconds(FrameTicks), Settings.BudgetMilliseconds);
+
+    LastDumpTimestamp = FrameEnd;
+    DumpCount++;
+
+    PendingFrameIndex = FrameIndex;
+    PendingFrameTicks = FrameTicks;
+    PendingDumpFrameCount = Settings.DumpDelayFrameCount;
+
+    return PendingDumpFrameCount == 0;
+}
+
+void PProfilerFlightRecorder::Dump(SFlightRecorderContext Context)
+{
+    std::vector<SRecordedEvent> Window;
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        Window.assign(Events.begin(), Events.end());
+    }
+
+    Context.insert(Context.begin(),
+    {
+        { "FrameIndex", std::to_string(PendingFrameIndex) },
+        { "FrameMilliseconds", std::format("{:.3f}", PTickClock::TicksToMilliseconds(PendingFrameTicks)) },
+        { "BudgetMilliseconds", std::format("{:.3f}", Settings.BudgetMilliseconds) },
+        { "SuppressedHitches", std::to_string(SuppressedHitchCount) }
+    });
+
+    const std::string Path = (std::filesystem::path(Settings.OutputDirectory) / std::format("hitch_{}.rktrace", PendingFrameIndex)).string();
+
+    // Dumps are rate-limited, so the previous one has long finished unless the disk is very slow.
+    Wait();
+    DumpThread = std::thread(&PProfilerFlightRecorder::WriteDump, Path, std::move(Window), std::move(Context));
+}
+
+void PProfilerFlightRecorder::Wait()
+{
+    if (DumpThread.joinable())
+    {
+        DumpThread.join();
+    }
+}
+
+void PProfilerFlightRecorder::WriteDump(const std::string& Path, std::vector<SRecordedEvent> Events, const SFlightRecorderContext& Context)
+{
+    std::error_code ErrorCode;
+    std::filesystem::create_directories(std::filesystem::path(Path).parent_path(), ErrorCode);
+
+    uint64_t StartTimestamp = UINT64_MAX;
+    for (const SRecordedEvent& Event : Events)
+    {
+        StartTimestamp = std::min(StartTimestamp, Event.Event.Timestamp);
+    }
+
+    PProfilerTraceWriter Writer;
+    if (!Writer.Open(Path, Events.empty() ? 0 : StartTimestamp, static_cast<uint32_t>(getpid())))
+    {
+        RK_LOG_ERROR("Failed to open hitch capture {}", Path);
+        return;
+    }
+
+    for (const auto& [Key, Value] : Context)
+    {
+        Writer.WriteMetadata(Key, Value);
+    }
+
+    for (const SRecordedEvent& Event : Events)
+    {
+        Writer.WriteEvent(Event.ThreadID, Event.Event);
+    }
+
+    Writer.Close();
+
+    RK_LOG_INFO("Hitch capture with {} events written to {}", Events.size(), Path);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Utils/Profiler.h"
+
+struct SFlightRecorderSettings
+{
+    // Frames whose CPU time exceeds this are dumped
+    double BudgetMilliseconds = 50.0;
+
+    // Events older than this are discarded, a dump covers this much time before the hitch
+    double WindowSeconds = 5.0;
+
+    // Rate limit, hitches within this interval of the previous dump are only counted
+    double MinDumpIntervalSeconds = 30.0;
+    uint32_t MaxDumpCount = 10;
+
+    // Frames to wait after a hitch before dumping, so the GPU timings of the hitch frame have been resolved
+    uint32_t DumpDelayFrameCount = 3;
+
+    std::string OutputDirectory = "hitches";
+};
+
+// Free-form context written into the header of a dump
+using SFlightRecorderContext = std::vector<std::pair<std::string, std::string>>;
+
+// Keeps the last few seconds of profiler events (scopes, counters and GPU timings) in memory and writes them
+// to a capture (see ProfilerTrace.h) when a frame exceeds the budget. Fed by PProfiler::Flush as an event listener.
+class PProfilerFlightRecorder : public IProfilerEventListener
+{
+public:
+    // Upper bound of retained events, in case the window holds more than expected
+    static constexpr size_t MaxEventCount = 1 << 20;
+
+    ~PProfilerFlightRecorder();
+
+    void Configure(const SFlightRecorderSettings& InSettings);
+
+    virtual void OnEvent(uint32_t ThreadID, const SProfilerEvent& Event) override;
+
+    // Checks a finished frame against the budget, timestamps are PProfiler::GetTimestamp values.
+    // Returns true once a dump is due, the caller then flushes the profiler and calls Dump.
+    bool EndFrame(uint64_t FrameStart, uint64_t FrameEnd);
+
+    // Writes the retained window on a background thread, Context is stored alongside the hitch details.
+    void Dump(SFlightRecorderContext Context);
+
+    // Waits for a dump in progress.
+    void Wait();
+
+private:
+    struct SRecordedEvent
+    {
+        uint32_t ThreadID;
+        SProfilerEvent Event;
+    };
+
+    static void WriteDump(const std::string& Path, std::vector<SRecordedEvent> Events, const SFlightRecorderContext& Context);
+
+    SFlightRecorderSettings Settings;
+
+    std::mutex Mutex;
+    std::deque<SRecordedEvent> Events;
+
+    uint64_t FrameIndex = 0;
+    uint64_t LastDumpTimestamp = 0;
+    uint32_t DumpCount = 0;
+    uint32_t SuppressedHitchCount = 0;
+
+    // Details of the hitch waiting for DumpDelayFrameCount frames
+    uint32_t PendingDumpFrameCount = 0;
+    uint64_t PendingFrameIndex = 0;
+    uint64_t PendingFrameTicks = 0;
+
+    std::thread DumpThread;
+};
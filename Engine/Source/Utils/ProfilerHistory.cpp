@@ -0,0 +1,98 @@
+#include "EnginePCH.h"
+#include "ProfilerHistory.h"
+
+void PProfilerHistory::OnEvent(uint32_t ThreadID, const SProfilerEvent& Event)
+{
+    if (Event.Type == EProfilerEventType::Counter)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    SThreadState& State = Threads[ThreadID];
+    State.History.ThreadID = ThreadID;
+
+    if (Event.Type == EProfilerEventType::Begin)
+    {
+        State.Stack.push_back({ Event.Location, Event.Timestamp, 0 });
+        return;
+    }
+
+    // An end without its begin was recorded before the history was attached, or its begin was dropped.
+    if (State.Stack.empty() || State.Stack.back().Location != Event.Location)
+    {
+        State.Stack.clear();
+        return;
+    }
+
+    const SOpenScope Scope = State.Stack.back();
+    State.Stack.pop_back();
+
+    const uint64_t Duration = Event.Timestamp - Scope.Start;
+    if (!State.Stack.empty())
+    {
+        State.Stack.back().ChildTicks += Duration;
+    }
+
+    SProfilerScopeRecord Record;
+    Record.Location = Scope.Location;
+    Record.Start = Scope.Start;
+    Record.End = Event.Timestamp;
+    Record.SelfTicks = Duration - std::min(Scope.ChildTicks, Duration);
+    Record.Depth = static_cast<uint32_t>(State.Stack.size());
+    State.History.Scopes.push_back(Record);
+}
+
+void PProfilerHistory::MarkFrame(uint64_t Timestamp)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    if (CurrentFrameStart != 0)
+    {
+        Frames.push_back({ CurrentFrameStart, Timestamp });
+        if (Frames.size() > MaxFrameCount)
+        {
+            Frames.pop_front();
+        }
+    }
+    CurrentFrameStart = Timestamp;
+
+    if (Frames.empty())
+    {
+        return;
+    }
+
+    // Scopes are ordered by end timestamp, so everything that ended before the oldest frame is at the front.
+    const uint64_t OldestTimestamp = Frames.front().Start;
+    for (auto& [ThreadID, State] : Threads)
+    {
+        while (!State.History.Scopes.empty() && State.History.Scopes.front().End < OldestTimestamp)
+        {
+            State.History.Scopes.pop_front();
+        }
+    }
+}
+
+void PProfilerHistory::GetSnapshot(SProfilerHistorySnapshot& Snapshot) const
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    Snapshot.Frames.assign(Frames.begin(), Frames.end());
+
+    Snapshot.Threads.clear();
+    Snapshot.Threads.reserve(Threads.size());
+    for (const auto& [ThreadID, State] : Threads)
+    {
+        if (!State.History.Scopes.empty())
+        {
+            Snapshot.Threads.push_back(State.History);
+        }
+    }
+
+    // Stable track order, the GPU track (PProfiler::GPUThreadID) ends up last.
+    std::sort(Snapshot.Threads.begin(), Snapshot.Threads.end(), [](const SProfilerThreadHistory& A, const SProfilerThreadHistory& B)
+    {
+        return A.ThreadID < B.ThreadID;
+    });
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "Utils/Profiler.h"
+
+struct SProfilerFrame
+{
+    // PProfiler::GetTimestamp values
+    uint64_t Start;
+    uint64_t End;
+};
+
+struct SProfilerScopeRecord
+{
+    const SProfilerSourceLocation* Location;
+    uint64_t Start;
+    uint64_t End;
+
+    // Time not spent in nested scopes of the same thread
+    uint64_t SelfTicks;
+    uint32_t Depth;
+};
+
+struct SProfilerThreadHistory
+{
+    uint32_t ThreadID = 0;
+
+    // Closed scopes, ordered by end timestamp
+    std::deque<SProfilerScopeRecord> Scopes;
+};
+
+struct SProfilerHistorySnapshot
+{
+    std::vector<SProfilerFrame> Frames;
+    std::vector<SProfilerThreadHistory> Threads;
+};
+
+// Keeps the scopes of the last MaxFrameCount frames in memory for in-engine inspection.
+// Fed by PProfiler::Flush as an event listener, frames are delimited by MarkFrame.
+class PProfilerHistory : public IProfilerEventListener
+{
+public:
+    static constexpr size_t MaxFrameCount = 240;
+
+    virtual void OnEvent(uint32_t ThreadID, const SProfilerEvent& Event) override;
+
+    // Ends the current frame and begins the next one at Timestamp.
+    void MarkFrame(uint64_t Timestamp);
+
+    // Copies the completed frames and every scope that overlaps them.
+    void GetSnapshot(SProfilerHistorySnapshot& Snapshot) const;
+
+private:
+    struct SOpenScope
+    {
+        const SProfilerSourceLocation* Location;
+        uint64_t Start;
+        uint64_t ChildTicks;
+    };
+
+    struct SThreadState
+    {
+        SProfilerThreadHistory History;
+        std::vector<SOpenScope> Stack;
+    };
+
+    mutable std::mutex Mutex;
+
+    std::deque<SProfilerFrame> Frames;
+    uint64_t CurrentFrameStart = 0;
+
+    std::unordered_map<uint32_t, SThreadState> Threads;
+};
@@ -0,0 +1,187 @@
+#include "EnginePCH.h"
+#include "ProfilerSampler.h"
+
+#include "Utils/Profiler.h"
+
+#ifdef RK_PLATFORM_LINUX
+    #include <csignal>
+    #include <link.h>
+    #include <pthread.h>
+    #include <sys/time.h>
+    #include <ucontext.h>
+#endif
+
+#ifdef RK_PLATFORM_LINUX
+namespace Utils
+{
+    static struct sigaction PreviousSignalAction;
+
+    // Program counter and frame pointer of the interrupted code
+    static bool GetInterruptedFrame(const void* Context, uintptr_t& ProgramCounter, uintptr_t& FramePointer)
+    {
+        const mcontext_t& MachineContext = static_cast<const ucontext_t*>(Context)->uc_mcontext;
+#if defined(__x86_64__)
+        ProgramCounter = static_cast<uintptr_t>(MachineContext.gregs[REG_RIP]);
+        FramePointer = static_cast<uintptr_t>(MachineContext.gregs[REG_RBP]);
+        return true;
+#elif defined(__aarch64__)
+        ProgramCounter = static_cast<uintptr_t>(MachineContext.pc);
+        FramePointer = static_cast<uintptr_t>(MachineContext.regs[29]);
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Follows the frame pointer chain, where every frame starts with the caller's frame pointer followed by the
+    // return address. Only reads inside the thread's stack and only towards its base, so frames of code built
+    // without frame pointers end the walk early rather than faulting. Plain loads, unlike backtrace() which takes
+    // the dynamic loader's lock and can deadlock when the signal lands in dlopen or exception unwinding.
+    static uint32_t WalkFramePointers(uintptr_t FramePointer, uintptr_t StackLow, uintptr_t StackHigh, uintptr_t* Frames, uint32_t MaxFrameCount)
+    {
+        uint32_t FrameCount = 0;
+        while (FrameCount < MaxFrameCount && FramePointer >= StackLow && FramePointer <= StackHigh - 2 * sizeof(uintptr_t)
+            && FramePointer % sizeof(uintptr_t) == 0)
+        {
+            const uintptr_t* Frame = reinterpret_cast<const uintptr_t*>(FramePointer);
+            const uintptr_t CallerFramePointer = Frame[0];
+            const uintptr_t ReturnAddress = Frame[1];
+            if (ReturnAddress == 0)
+            {
+                break;
+            }
+
+            Frames[FrameCount++] = ReturnAddress;
+            if (CallerFramePointer <= FramePointer)
+            {
+                break;
+            }
+            FramePointer = CallerFramePointer;
+        }
+        return FrameCount;
+    }
+
+    static void HandleProfilingSignal(int Signal, siginfo_t* Info, void* Context)
+    {
+        const int SavedErrno = errno;
+
+        SProfilerThreadBuffer* ThreadBuffer = PProfiler::GetThreadBuffer();
+        SProfilerSampleBuffer* Buffer = ThreadBuffer ? ThreadBuffer->SampleBuffer.load(std::memory_order_acquire) : nullptr;
+        uintptr_t ProgramCounter = 0;
+        uintptr_t FramePointer = 0;
+        if (Buffer && GetInterruptedFrame(Context, ProgramCounter, FramePointer))
+        {
+            const uint64_t WriteIndex = Buffer->WriteIndex.load(std::memory_order_relaxed);
+            if (WriteIndex - Buffer->ReadIndex.load(std::memory_order_acquire) >= SProfilerSampleBuffer::Capacity)
+            {
+                Buffer->DroppedSampleCount.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                SProfilerSample& Sample = Buffer->Samples[WriteIndex & (SProfilerSampleBuffer::Capacity - 1)];
+                Sample.Timestamp = PProfiler::GetTimestamp();
+                Sample.Frames[0] = ProgramCounter;
+                Sample.FrameCount = 1 + WalkFramePointers(FramePointer, ThreadBuffer->StackLow, ThreadBuffer->StackHigh,
+                    Sample.Frames.data() + 1, SProfilerSample::MaxFrameCount - 1);
+
+                Buffer->WriteIndex.store(WriteIndex + 1, std::memory_order_release);
+            }
+        }
+
+        errno = SavedErrno;
+    }
+}
+#endif
+
+bool ProfilerSampler::Start(uint32_t Frequency)
+{
+#ifdef RK_PLATFORM_LINUX
+    struct sigaction SignalAction = {};
+    SignalAction.sa_sigaction = &Utils::HandleProfilingSignal;
+    SignalAction.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&SignalAction.sa_mask);
+    if (sigaction(SIGPROF, &SignalAction, &Utils::PreviousSignalAction) != 0)
+    {
+        return false;
+    }
+
+    // setitimer rejects microseconds of a second or more, whole seconds go into tv_sec.
+    const uint32_t Interval = std::max(1000000u / std::max(Frequency, 1u), 1u);
+
+    itimerval Timer = {};
+    Timer.it_interval.tv_sec = static_cast<time_t>(Interval / 1000000);
+    Timer.it_interval.tv_usec = static_cast<suseconds_t>(Interval % 1000000);
+    Timer.it_value = Timer.it_interval;
+    if (setitimer(ITIMER_PROF, &Timer, nullptr) != 0)
+    {
+        sigaction(SIGPROF, &Utils::PreviousSignalAction, nullptr);
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ProfilerSampler::Stop()
+{
+#ifdef RK_PLATFORM_LINUX
+    itimerval Timer = {};
+    setitimer(ITIMER_PROF, &Timer, nullptr);
+
+    sigaction(SIGPROF, &Utils::PreviousSignalAction, nullptr);
+#endif
+}
+
+void ProfilerSampler::EnumerateModules(const std::function<void(uint64_t Start, uint64_t Size, uint64_t Bias, const char* Path)>& Func)
+{
+#ifdef RK_PLATFORM_LINUX
+    dl_iterate_phdr([](dl_phdr_info* Info, size_t, void* Data) -> int
+    {
+        const auto& Func = *static_cast<const std::function<void(uint64_t, uint64_t, uint64_t, const char*)>*>(Data);
+
+        // The executable reports an empty name, the vDSO has no file to symbolize from.
+        std::string Path = Info->dlpi_name ? Info->dlpi_name : "";
+        if (Path.empty())
+        {
+            char Buffer[4096];
+            const ssize_t Length = readlink("/proc/self/exe", Buffer, sizeof(Buffer) - 1);
+            Path.assign(Buffer, Length > 0 ? static_cast<size_t>(Length) : 0);
+        }
+        if (Path.empty() || Path.find("linux-vdso") != std::string::npos)
+        {
+            return 0;
+        }
+
+        for (ElfW(Half) Index = 0; Index < Info->dlpi_phnum; ++Index)
+        {
+            const ElfW(Phdr)& Header = Info->dlpi_phdr[Index];
+            if (Header.p_type == PT_LOAD && (Header.p_flags & PF_X))
+            {
+                Func(Info->dlpi_addr + Header.p_vaddr, Header.p_memsz, Info->dlpi_addr, Path.c_str());
+            }
+        }
+        return 0;
+    }, const_cast<void*>(static_cast<const void*>(&Func)));
+#endif
+}
+
+void ProfilerSampler::GetThreadStack(uintptr_t& Low, uintptr_t& High)
+{
+    Low = 0;
+    High = 0;
+#ifdef RK_PLATFORM_LINUX
+    pthread_attr_t Attributes;
+    if (pthread_getattr_np(pthread_self(), &Attributes) == 0)
+    {
+        void* Address = nullptr;
+        size_t Size = 0;
+        if (pthread_attr_getstack(&Attributes, &Address, &Size) == 0)
+        {
+            Low = reinterpret_cast<uintptr_t>(Address);
+            High = Low + Size;
+        }
+        pthread_attr_destroy(&Attributes);
+    }
+#endif
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+struct SProfilerSample
+{
+    // Innermost frames kept per sample, deeper stacks are truncated at the root
+    static constexpr uint32_t MaxFrameCount = 32;
+
+    uint64_t Timestamp;
+    uint32_t FrameCount;
+
+    // Return addresses, innermost first. The first one is the interrupted instruction.
+    std::array<uintptr_t, MaxFrameCount> Frames;
+};
+
+// Single-producer, single-consumer ring like SProfilerThreadBuffer. The producer is the sampling signal handler
+// running on the owning thread, PProfiler::Flush is the only reader.
+struct SProfilerSampleBuffer
+{
+    // At 1 kHz this bridges about a second of a single busy thread
+    static constexpr uint64_t Capacity = 1 << 10;
+
+    alignas(64) std::atomic<uint64_t> WriteIndex = 0;
+    alignas(64) std::atomic<uint64_t> ReadIndex = 0;
+    std::atomic<uint64_t> DroppedSampleCount = 0;
+
+    std::array<SProfilerSample, Capacity> Samples;
+};
+
+// Platform part of the sampling profiler, driven by PProfiler::StartSampling. On Linux a SIGPROF interval timer
+// interrupts whichever thread is consuming CPU, and the handler captures its call stack into the thread's
+// SProfilerSampleBuffer. Threads without a profiler buffer are not sampled. Other platforms do not sample.
+// Stacks are walked along frame pointers, which is safe inside a signal handler. Profile builds keep them
+// (-fno-omit-frame-pointer), a library built without them ends the stack at its first frame, and a function
+// interrupted in its prologue loses its caller.
+namespace ProfilerSampler
+{
+    // Frequency is in samples per second of process CPU time. Returns false if sampling is not supported.
+    bool Start(uint32_t Frequency);
+    void Stop();
+
+    // Executable segments of the loaded modules, as needed to symbolize the sampled addresses offline.
+    // Bias is the load address, subtracted from a sampled address to get the address inside Path.
+    void EnumerateModules(const std::function<void(uint64_t Start, uint64_t Size, uint64_t Bias, const char* Path)>& Func);
+
+    // Address range of the calling thread's stack, which bounds the stack walks of its samples. Both are 0 where
+    // it is unknown, its samples then only hold the interrupted instruction.
+    void GetThreadStack(uintptr_t& Low, uintptr_t& High);
+}
@@ -0,0 +1,231 @@
+#include "EnginePCH.h"
+#include "ProfilerStream.h"
+
+#ifdef RK_PLATFORM_LINUX
+    #include <sys/socket.h>
+    #include <sys/un.h>
+#endif
+
+#ifdef RK_PLATFORM_LINUX
+namespace Utils
+{
+    static bool SendAll(int Socket, const std::vector<uint8_t>& Data)
+    {
+        for (size_t Offset = 0; Offset < Data.size();)
+        {
+            // MSG_NOSIGNAL, a client that went away must not raise SIGPIPE in the engine
+            const ssize_t Sent = send(Socket, Data.data() + Offset, Data.size() - Offset, MSG_NOSIGNAL);
+            if (Sent < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (Sent <= 0)
+            {
+                return false;
+            }
+            Offset += static_cast<size_t>(Sent);
+        }
+        return true;
+    }
+}
+#endif
+
+PProfilerStream::~PProfilerStream()
+{
+    Stop();
+}
+
+bool PProfilerStream::Start(const std::string& SocketPath)
+{
+#ifdef RK_PLATFORM_LINUX
+    sockaddr_un Address = {};
+    Address.sun_family = AF_UNIX;
+    if (SocketPath.empty() || SocketPath.size() >= sizeof(Address.sun_path))
+    {
+        RK_LOG_ERROR("Profiler stream socket path {} is empty or too long", SocketPath);
+        return false;
+    }
+    std::memcpy(Address.sun_path, SocketPath.c_str(), SocketPath.size());
+
+    ListenSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (ListenSocket < 0)
+    {
+        RK_LOG_ERROR("Failed to create the profiler stream socket: {}", std::strerror(errno));
+        return false;
+    }
+
+    unlink(SocketPath.c_str());
+    if (bind(ListenSocket, reinterpret_cast<const sockaddr*>(&Address), sizeof(Address)) != 0 || listen(ListenSocket, 1) != 0)
+    {
+        RK_LOG_ERROR("Failed to listen on {}: {}", SocketPath, std::strerror(errno));
+        close(ListenSocket);
+        ListenSocket = -1;
+        return false;
+    }
+
+    Path = SocketPath;
+    bRunning = true;
+    Thread = std::thread(&PProfilerStream::Run, this);
+
+    RK_LOG_INFO("Profiler stream listening on {}", Path);
+    return true;
+#else
+    RK_LOG_WARNING("Profiler streaming is not supported on this platform");
+    return false;
+#endif
+}
+
+void PProfilerStream::Stop()
+{
+#ifdef RK_PLATFORM_LINUX
+    if (!Thread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        bRunning = false;
+
+        // Wakes the thread from a blocking accept or send.
+        shutdown(ListenSocket, SHUT_RDWR);
+        if (ClientSocket >= 0)
+        {
+            shutdown(ClientSocket, SHUT_RDWR);
+        }
+    }
+    Condition.notify_one();
+    Thread.join();
+
+    close(ListenSocket);
+    ListenSocket = -1;
+    unlink(Path.c_str());
+#endif
+}
+
+void PProfilerStream::OnEvent(uint32_t ThreadID, const SProfilerEvent& Event)
+{
+    if (!bAttached.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (!Writer.IsOpen())
+    {
+        return;
+    }
+
+    if (QueuedBytes + Writer.GetPendingBytes() >= MaxQueuedBytes)
+    {
+        PendingDroppedCounts[ThreadID]++;
+        DroppedEventCount++;
+        return;
+    }
+
+    for (const auto& [DroppedThreadID, Count] : PendingDroppedCounts)
+    {
+        Writer.WriteDroppedEvents(DroppedThreadID, Count);
+    }
+    PendingDroppedCounts.clear();
+
+    Writer.WriteEvent(ThreadID, Event);
+}
+
+void PProfilerStream::OnFlush()
+{
+    if (!bAttached.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    // Sends partial chunks as well, the client sees events one flush interval after they were recorded.
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Writer.FlushChunk();
+}
+
+void PProfilerStream::Run()
+{
+#ifdef RK_PLATFORM_LINUX
+    while (true)
+    {
+        const int Socket = accept4(ListenSocket, nullptr, nullptr, SOCK_CLOEXEC);
+        if (Socket < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+            // Stop shut the listening socket down
+            return;
+        }
+
+        Attach(Socket);
+
+        std::unique_lock<std::mutex> Lock(Mutex);
+        while (bRunning)
+        {
+            Condition.wait(Lock, [this]() { return !bRunning || !Queue.empty(); });
+            if (Queue.empty())
+            {
+                break;
+            }
+
+            std::vector<uint8_t> Chunk = std::move(Queue.front());
+            Queue.pop_front();
+            QueuedBytes -= Chunk.size();
+
+            Lock.unlock();
+            const bool bSent = Utils::SendAll(Socket, Chunk);
+            Lock.lock();
+
+            // The client detached
+            if (!bSent)
+            {
+                break;
+            }
+        }
+        Lock.unlock();
+
+        Detach();
+    }
+#endif
+}
+
+void PProfilerStream::Attach(int Socket)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    ClientSocket = Socket;
+    DroppedEventCount = 0;
+
+    // Called with Mutex held, by OnEvent and OnFlush through the writer
+    Writer.Open([this](const uint8_t* Data, size_t Size)
+    {
+        Queue.emplace_back(Data, Data + Size);
+        QueuedBytes += Size;
+        Condition.notify_one();
+        return true;
+    }, PProfiler::GetTimestamp(), static_cast<uint32_t>(getpid()));
+
+    bAttached.store(true, std::memory_order_relaxed);
+
+    RK_LOG_INFO("Profiler stream client attached");
+}
+
+void PProfilerStream::Detach()
+{
+#ifdef RK_PLATFORM_LINUX
+    std::lock_guard<std::mutex> Lock(Mutex);
+    bAttached.store(false, std::memory_order_relaxed);
+
+    Writer.Close();
+    Queue.clear();
+    QueuedBytes = 0;
+    PendingDroppedCounts.clear();
+
+    close(ClientSocket);
+    ClientSocket = -1;
+
+    RK_LOG_INFO("Profiler stream client detached, {} events dropped", DroppedEventCount);
+#endif
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Utils/Profiler.h"
+#include "Utils/ProfilerTrace.h"
+
+// Serves profiler events and counters over a Unix domain socket to a local viewer or recorder (Linux only).
+// One client at a time can attach and detach while the engine runs. Events are only encoded while a client is attached,
+// and each client receives a capture in the .rktrace format (see ProfilerTrace.h) that starts when it attached.
+// Fed by PProfiler::Flush as an event listener. Chunks are sent from a background thread and queue up to MaxQueuedBytes.
+// Past that, events are dropped and reported as Dropped records, so a slow client never stalls the engine.
+class PProfilerStream : public IProfilerEventListener
+{
+public:
+    static constexpr size_t MaxQueuedBytes = 16 * 1024 * 1024;
+
+    ~PProfilerStream();
+
+    // Listens on SocketPath, a stale socket file left by a crashed instance is replaced.
+    bool Start(const std::string& SocketPath);
+
+    // Disconnects the client and removes the socket file.
+    void Stop();
+
+    virtual void OnEvent(uint32_t ThreadID, const SProfilerEvent& Event) override;
+    virtual void OnFlush() override;
+
+private:
+    void Run();
+    void Attach(int Socket);
+    void Detach();
+
+    std::string Path;
+    int ListenSocket = -1;
+    std::thread Thread;
+
+    std::mutex Mutex;
+    std::condition_variable Condition;
+
+    // Guarded by Mutex
+    bool bRunning = false;
+    int ClientSocket = -1;
+    PProfilerTraceWriter Writer;
+    std::deque<std::vector<uint8_t>> Queue;
+    size_t QueuedBytes = 0;
+
+    // Events dropped since the last Dropped records were written, per thread, and in total for the attached client
+    std::unordered_map<uint32_t, uint64_t> PendingDroppedCounts;
+    uint64_t DroppedEventCount = 0;
+
+    // Lets OnEvent skip the lock while nobody is attached
+    std::atomic<bool> bAttached = false;
+};
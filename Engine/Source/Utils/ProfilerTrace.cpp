@@ -0,0 +1,619 @@
+#include "EnginePCH.h"
+#include "ProfilerTrace.h"
+
+#include <filesystem>
+#include <map>
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/writer.h>
+#include <set>
+
+#include "Utils/Profiler.h"
+#include "Utils/ProfilerSampler.h"
+
+namespace Utils
+{
+    // Worst case for a tag byte and a handful of 64-bit varints
+    static constexpr size_t MaxVarintRecordSize = 1 + 4 * 10;
+
+    static void WriteString(std::vector<uint8_t>& Buffer, const char* String)
+    {
+        const size_t Length = std::strlen(String);
+        ProfilerTrace::WriteVarint(Buffer, Length);
+        Buffer.insert(Buffer.end(), String, String + Length);
+    }
+
+    static bool ReadString(const uint8_t*& Cursor, const uint8_t* End, std::string& String)
+    {
+        uint64_t Length = 0;
+        if (!ProfilerTrace::ReadVarint(Cursor, End, Length) || Length > static_cast<uint64_t>(End - Cursor))
+        {
+            return false;
+        }
+
+        String.assign(reinterpret_cast<const char*>(Cursor), Length);
+        Cursor += Length;
+        return true;
+    }
+
+    struct SModule
+    {
+        uint64_t Start;
+        uint64_t Size;
+        uint64_t Bias;
+        std::string Path;
+    };
+
+    static const SModule* FindModule(const std::map<uint64_t, SModule>& Modules, uint64_t Address)
+    {
+        auto Iterator = Modules.upper_bound(Address);
+        if (Iterator == Modules.begin())
+        {
+            return nullptr;
+        }
+
+        --Iterator;
+        return Address < Iterator->second.Start + Iterator->second.Size ? &Iterator->second : nullptr;
+    }
+
+    // Resolves function names with addr2line, one process per module and batch of addresses.
+    // Addresses that cannot be resolved are named by their module and offset.
+    static std::unordered_map<uint64_t, std::string> SymbolizeAddresses(const std::map<uint64_t, SModule>& Modules, const std::set<uint64_t>& Addresses)
+    {
+        constexpr size_t BatchSize = 128;
+
+        std::unordered_map<uint64_t, std::string> Symbols;
+        std::map<const SModule*, std::vector<uint64_t>> ModuleAddresses;
+        for (uint64_t Address : Addresses)
+        {
+            if (const SModule* Module = FindModule(Modules, Address))
+            {
+                ModuleAddresses[Module].push_back(Address);
+            }
+            else
+            {
+                Symbols[Address] = std::format("0x{:x}", Address);
+            }
+        }
+
+        for (const auto& [Module, ModuleAddressList] : ModuleAddresses)
+        {
+            const std::string ModuleName = std::filesystem::path(Module->Path).filename().string();
+            for (size_t First = 0; First < ModuleAddressList.size(); First += BatchSize)
+            {
+                const size_t Last = std::min(First + BatchSize, ModuleAddressList.size());
+
+#ifdef RK_PLATFORM_LINUX
+                std::string Command = std::format("addr2line -f -C -e '{}'", Module->Path);
+                for (size_t Index = First; Index < Last; ++Index)
+                {
+                    Command += std::format(" 0x{:x}", ModuleAddressList[Index] - Module->Bias);
+                }
+
+                // Two lines per address, the function and its file and line
+                if (FILE* Pipe = popen(Command.c_str(), "r"))
+                {
+                    char Function[1024];
+                    char Location[1024];
+                    for (size_t Index = First; Index < Last && std::fgets(Function, sizeof(Function), Pipe) && std::fgets(Location, sizeof(Location), Pipe); ++Index)
+                    {
+                        std::string Name = Function;
+                        Name.erase(Name.find_last_not_of("\r\n") + 1);
+                        if (Name != "??")
+                        {
+                            Symbols[ModuleAddressList[Index]] = std::move(Name);
+                        }
+                    }
+                    pclose(Pipe);
+                }
+#endif
+
+                for (size_t Index = First; Index < Last; ++Index)
+                {
+                    Symbols.try_emplace(ModuleAddressList[Index], std::format("{}+0x{:x}", ModuleName, ModuleAddressList[Index] - Module->Bias));
+                }
+            }
+        }
+
+        return Symbols;
+    }
+}
+
+bool PProfilerTraceWriter::Open(const std::string& Path, uint64_t InStartTimestamp, uint32_t ProcessID)
+{
+    File.open(Path, std::ios::binary | std::ios::trunc);
+    if (!File.is_open())
+    {
+        return false;
+    }
+
+    return Open([this](const uint8_t* Data, size_t Size)
+    {
+        File.write(reinterpret_cast<const char*>(Data), static_cast<std::streamsize>(Size));
+        File.flush();
+        return File.good();
+    }, InStartTimestamp, ProcessID);
+}
+
+bool PProfilerTraceWriter::Open(TSink&& InSink, uint64_t InStartTimestamp, uint32_t ProcessID)
+{
+    Sink = std::move(InSink);
+    StartTimestamp = InStartTimestamp;
+
+    ProfilerTrace::SFileHeader Header = {};
+    Header.Magic = ProfilerTrace::Magic;
+    Header.Version = ProfilerTrace::Version;
+    Header.TicksPerSecond = PProfiler::GetTicksPerSecond();
+    Header.StartTimestamp = StartTimestamp;
+    Header.ProcessID = ProcessID;
+
+    if (!Sink(reinterpret_cast<const uint8_t*>(&Header), sizeof(Header)))
+    {
+        Close();
+        return false;
+    }
+    BytesWritten = sizeof(Header);
+
+    Chunk.reserve(sizeof(ProfilerTrace::SChunkHeader) + ProfilerTrace::ChunkSize);
+    return true;
+}
+
+void PProfilerTraceWriter::Close()
+{
+    FlushChunk();
+    Sink = nullptr;
+    if (File.is_open())
+    {
+        File.close();
+    }
+
+    Chunk.clear();
+    LocationIDs.clear();
+    bThreadSectionOpen = false;
+}
+
+void PProfilerTraceWriter::BeginRecord(uint32_t ThreadID, size_t MaxRecordSize)
+{
+    if (Chunk.size() + MaxRecordSize + Utils::MaxVarintRecordSize > ProfilerTrace::ChunkSize)
+    {
+        FlushChunk();
+    }
+
+    if (!bThreadSectionOpen || CurrentThreadID != ThreadID)
+    {
+        Chunk.push_back(static_cast<uint8_t>(ProfilerTrace::ERecordType::Thread));
+        ProfilerTrace::WriteVarint(Chunk, ThreadID);
+
+        CurrentThreadID = ThreadID;
+        bThreadSectionOpen = true;
+        PreviousTimestamp = StartTimestamp;
+    }
+}
+
+void PProfilerTraceWriter::WriteEvent(uint32_t ThreadID, const SProfilerEvent& Event)
+{
+    auto Iterator = LocationIDs.find(Event.Location);
+    if (Iterator == LocationIDs.end())
+    {
+        // Definitions are not tied to a thread section, but may still force a new chunk.
+        const size_t DefinitionSize = Utils::MaxVarintRecordSize + std::strlen(Event.Location->Name) + std::strlen(Event.Location->File);
+        BeginRecord(ThreadID, DefinitionSize);
+
+        const uint32_t LocationID = static_cast<uint32_t>(LocationIDs.size());
+        Chunk.push_back(static_cast<uint8_t>(ProfilerTrace::ERecordType::Location));
+        ProfilerTrace::WriteVarint(Chunk, LocationID);
+        Utils::WriteString(Chunk, Event.Location->Name);
+        Utils::WriteString(Chunk, Event.Location->File);
+        ProfilerTrace::WriteVarint(Chunk, Event.Location->Line);
+
+        Iterator = LocationIDs.emplace(Event.Location, LocationID).first;
+    }
+
+    BeginRecord(ThreadID, Utils::MaxVarintRecordSize);
+
+    // Events of one thread are recorded in order, clamping only guards against events older than the capture.
+    const uint64_t Timestamp = std::max(Event.Timestamp, PreviousTimestamp);
+
+    switch (Event.Type)
+    {
+        case EProfilerEventType::Begin: Chunk.push_back(static_cast<uint8_t>(ProfilerTrace::ERecordType::Begin)); break;
+        case EProfilerEventType::End: Chunk.push_back(static_cast<uint8_t>(ProfilerTrace::ERecordType::End)); break;
+        case EProfilerEventType::Counter: Chunk.push_back(static_cast<uint8_t>(ProfilerTrace::ERecordType::Counter)); break;
+    }
+    ProfilerTrace::WriteVarint(Chunk, Iterator->second);
+    ProfilerTrace::WriteVarint(Chunk, Timestamp - PreviousTimestamp);
+    if (Event.Type == EProfilerEventType::Counter)
+    {
+        ProfilerTrace::WriteVarint(Chunk, Event.Value);
+    }
+
+    PreviousTimestamp = Timestamp;
+}
+
+void PProfilerTraceWriter::WriteDroppedEvents(uint32_t ThreadID, uint64_t Count)
+{
+    BeginRecord(ThreadID, Utils::MaxVarintRecordSize);
+
+    Chunk.push_back(static_cast<uint8_t>(ProfilerTrace::ERecordType::Dropped));
+    ProfilerTrace::WriteVarint(Chunk, ThreadID);
+    ProfilerTrace::WriteVarint(Chunk, Count);
+}
+
+void PProfilerTraceWriter::WriteMetadata(const std::string& Key, const std::string& Value)
+{
+    // Not part of a thread section, so no Thread record is needed.
+    if (Chunk.size() + Utils::MaxVarintRecordSize + Key.size() + Value.size() > ProfilerTrace::ChunkSize)
+    {
+        FlushChunk();
+    }
+
+    Chunk.push_back(static_cast<uint8_t>(ProfilerTrace::ERecordType::Metadata));
+    Utils::WriteString(Chunk, Key.c_str());
+    Utils::WriteString(Chunk, Value.c_str());
+}
+
+void PProfilerTraceWriter::WriteSample(uint32_t ThreadID, const SProfilerSample& Sample)
+{
+    BeginRecord(ThreadID, 10 * (2 + static_cast<size_t>(Sample.FrameCount)));
+
+    const uint64_t Timestamp = std::max(Sample.Timestamp, PreviousTimestamp);
+
+    Chunk.push_back(static_cast<uint8_t>(ProfilerTrace::ERecordType::Sample));
+    ProfilerTrace::WriteVarint(Chunk, Timestamp - PreviousTimestamp);
+    ProfilerTrace::WriteVarint(Chunk, Sample.FrameCount);
+    for (uint32_t Index = 0; Index < Sample.FrameCount; ++Index)
+    {
+        ProfilerTrace::WriteVarint(Chunk, Sample.Frames[Index]);
+    }
+
+    PreviousTimestamp = Timestamp;
+}
+
+void PProfilerTraceWriter::WriteModule(uint64_t Start, uint64_t Size, uint64_t Bias, const char* Path)
+{
+    if (Chunk.size() + Utils::MaxVarintRecordSize + std::strlen(Path) > ProfilerTrace::ChunkSize)
+    {
+        FlushChunk();
+    }
+
+    Chunk.push_back(static_cast<uint8_t>(ProfilerTrace::ERecordType::Module));
+    ProfilerTrace::WriteVarint(Chunk, Start);
+    ProfilerTrace::WriteVarint(Chunk, Size);
+    ProfilerTrace::WriteVarint(Chunk, Bias);
+    Utils::WriteString(Chunk, Path);
+}
+
+void PProfilerTraceWriter::FlushChunk()
+{
+    if (Chunk.empty() || !Sink)
+    {
+        return;
+    }
+
+    // The header is prepended in place, so sinks always receive a chunk in a single call.
+    ProfilerTrace::SChunkHeader Header = {};
+    Header.PayloadSize = static_cast<uint32_t>(Chunk.size());
+    Chunk.insert(Chunk.begin(), reinterpret_cast<const uint8_t*>(&Header), reinterpret_cast<const uint8_t*>(&Header) + sizeof(Header));
+
+    const bool bWritten = Sink(Chunk.data(), Chunk.size());
+    BytesWritten += Chunk.size();
+
+    Chunk.clear();
+    bThreadSectionOpen = false;
+
+    if (!bWritten)
+    {
+        Close();
+    }
+}
+
+bool ProfilerTrace::ConvertToChromeJSON(const std::string& TracePath, const std::string& OutputPath)
+{
+    std::ifstream Input(TracePath, std::ios::binary);
+    if (!Input.is_open())
+    {
+        RK_LOG_ERROR("Failed to open profiler capture {}", TracePath);
+        return false;
+    }
+
+    SFileHeader FileHeader = {};
+    if (!Input.read(reinterpret_cast<char*>(&FileHeader), sizeof(FileHeader)) || FileHeader.Magic != Magic || FileHeader.Version != Version)
+    {
+        RK_LOG_ERROR("{} is not a supported profiler capture", TracePath);
+        return false;
+    }
+
+    std::ofstream Output(OutputPath);
+    rapidjson::OStreamWrapper Stream(Output);
+    rapidjson::Writer<rapidjson::OStreamWrapper> Writer(Stream);
+
+    Writer.StartObject();
+    Writer.Key("traceEvents");
+    Writer.StartArray();
+
+    struct SLocation
+    {
+        std::string Name;
+        std::string File;
+        uint64_t Line;
+    };
+    std::vector<SLocation> Locations;
+    std::vector<std::pair<std::string, std::string>> Metadata;
+
+    struct SSample
+    {
+        uint64_t ThreadID;
+        uint64_t Timestamp;
+        std::vector<uint64_t> Frames;
+    };
+    std::vector<SSample> Samples;
+    std::map<uint64_t, Utils::SModule> Modules;
+
+    // Names the GPU track, which is not a real thread
+    Writer.StartObject();
+    Writer.Key("name"); Writer.String("thread_name");
+    Writer.Key("ph"); Writer.String("M");
+    Writer.Key("pid"); Writer.Uint(FileHeader.ProcessID);
+    Writer.Key("tid"); Writer.Uint64(PProfiler::GPUThreadID);
+    Writer.Key("args");
+    Writer.StartObject();
+    Writer.Key("name"); Writer.String("GPU");
+    Writer.EndObject();
+    Writer.EndObject();
+
+    const double MicrosecondsPerTick = 1e6 / static_cast<double>(FileHeader.TicksPerSecond);
+
+    uint64_t ChunkCount = 0;
+    uint64_t EventCount = 0;
+    std::vector<uint8_t> Payload;
+
+    SChunkHeader ChunkHeader = {};
+    while (Input.read(reinterpret_cast<char*>(&ChunkHeader), sizeof(ChunkHeader)))
+    {
+        Payload.resize(ChunkHeader.PayloadSize);
+        if (!Input.read(reinterpret_cast<char*>(Payload.data()), ChunkHeader.PayloadSize))
+        {
+            RK_LOG_WARNING("Profiler capture {} ends with a truncated chunk, it was skipped", TracePath);
+            break;
+        }
+
+        const uint8_t* Cursor = Payload.data();
+        const uint8_t* End = Payload.data() + Payload.size();
+
+        uint64_t ThreadID = 0;
+        uint64_t Timestamp = FileHeader.StartTimestamp;
+
+        bool bValid = true;
+        while (bValid && Cursor < End)
+        {
+            const ERecordType Type = static_cast<ERecordType>(*Cursor++);
+            switch (Type)
+            {
+                case ERecordType::Location:
+                {
+                    uint64_t LocationID = 0;
+                    SLocation Location;
+                    bValid = ReadVarint(Cursor, End, LocationID) && Utils::ReadString(Cursor, End, Location.Name) && Utils::ReadString(Cursor, End, Location.File) && ReadVarint(Cursor, End, Location.Line);
+                    if (bValid)
+                    {
+                        Locations.resize(std::max<size_t>(Locations.size(), LocationID + 1));
+                        Locations[LocationID] = std::move(Location);
+                    }
+                    break;
+                }
+                case ERecordType::Thread:
+                {
+                    bValid = ReadVarint(Cursor, End, ThreadID);
+                    Timestamp = FileHeader.StartTimestamp;
+                    break;
+                }
+                case ERecordType::Begin:
+                case ERecordType::End:
+                {
+                    uint64_t LocationID = 0;
+                    uint64_t Delta = 0;
+                    bValid = ReadVarint(Cursor, End, LocationID) && ReadVarint(Cursor, End, Delta) && LocationID < Locations.size();
+                    if (bValid)
+                    {
+                        Timestamp += Delta;
+
+                        Writer.StartObject();
+                        Writer.Key("name"); Writer.String(Locations[LocationID].Name.c_str());
+                        Writer.Key("ph"); Writer.String(Type == ERecordType::Begin ? "B" : "E");
+                        Writer.Key("ts"); Writer.Double(static_cast<double>(Timestamp - FileHeader.StartTimestamp) * MicrosecondsPerTick);
+                        Writer.Key("pid"); Writer.Uint(FileHeader.ProcessID);
+                        Writer.Key("tid"); Writer.Uint64(ThreadID);
+                        if (Type == ERecordType::Begin)
+                        {
+                            Writer.Key("args");
+                            Writer.StartObject();
+                            Writer.Key("file"); Writer.String(Locations[LocationID].File.c_str());
+                            Writer.Key("line"); Writer.Uint64(Locations[LocationID].Line);
+                            Writer.EndObject();
+                        }
+                        Writer.EndObject();
+
+                        EventCount++;
+                    }
+                    break;
+                }
+                case ERecordType::Counter:
+                {
+                    uint64_t LocationID = 0;
+                    uint64_t Delta = 0;
+                    uint64_t Value = 0;
+                    bValid = ReadVarint(Cursor, End, LocationID) && ReadVarint(Cursor, End, Delta) && ReadVarint(Cursor, End, Value) && LocationID < Locations.size();
+                    if (bValid)
+                    {
+                        Timestamp += Delta;
+
+                        // Counter tracks belong to the process, the thread that sampled them is irrelevant.
+                        Writer.StartObject();
+                        Writer.Key("name"); Writer.String(Locations[LocationID].Name.c_str());
+                        Writer.Key("ph"); Writer.String("C");
+                        Writer.Key("ts"); Writer.Double(static_cast<double>(Timestamp - FileHeader.StartTimestamp) * MicrosecondsPerTick);
+                        Writer.Key("pid"); Writer.Uint(FileHeader.ProcessID);
+                        Writer.Key("args");
+                        Writer.StartObject();
+                        Writer.Key("value"); Writer.Uint64(Value);
+                        Writer.EndObject();
+                        Writer.EndObject();
+
+                        EventCount++;
+                    }
+                    break;
+                }
+                case ERecordType::Metadata:
+                {
+                    std::string Key;
+                    std::string Value;
+                    bValid = Utils::ReadString(Cursor, End, Key) && Utils::ReadString(Cursor, End, Value);
+                    if (bValid)
+                    {
+                        Metadata.emplace_back(std::move(Key), std::move(Value));
+                    }
+                    break;
+                }
+                case ERecordType::Sample:
+                {
+                    uint64_t Delta = 0;
+                    uint64_t FrameCount = 0;
+                    bValid = ReadVarint(Cursor, End, Delta) && ReadVarint(Cursor, End, FrameCount);
+
+                    SSample Sample;
+                    Sample.ThreadID = ThreadID;
+                    for (uint64_t Index = 0; bValid && Index < FrameCount; ++Index)
+                    {
+                        uint64_t Address = 0;
+                        bValid = ReadVarint(Cursor, End, Address);
+
+                        // Callers are return addresses, step back into the call instruction.
+                        Sample.Frames.push_back(Index > 0 && Address > 0 ? Address - 1 : Address);
+                    }
+
+                    if (bValid)
+                    {
+                        Timestamp += Delta;
+                        Sample.Timestamp = Timestamp;
+                        Samples.push_back(std::move(Sample));
+                    }
+                    break;
+                }
+                case ERecordType::Module:
+                {
+                    Utils::SModule Module;
+                    bValid = ReadVarint(Cursor, End, Module.Start) && ReadVarint(Cursor, End, Module.Size) && ReadVarint(Cursor, End, Module.Bias) && Utils::ReadString(Cursor, End, Module.Path);
+                    if (bValid)
+                    {
+                        Modules.try_emplace(Module.Start, std::move(Module));
+                    }
+                    break;
+                }
+                case ERecordType::Dropped:
+                {
+                    uint64_t DroppedThreadID = 0;
+                    uint64_t Count = 0;
+                    bValid = ReadVarint(Cursor, End, DroppedThreadID) && ReadVarint(Cursor, End, Count);
+                    if (bValid)
+                    {
+                        const std::string Name = std::format("Dropped {} events", Count);
+
+                        Writer.StartObject();
+                        Writer.Key("name"); Writer.String(Name.c_str());
+                        Writer.Key("ph"); Writer.String("i");
+                        Writer.Key("s"); Writer.String("t");
+                        Writer.Key("ts"); Writer.Double(static_cast<double>(Timestamp - FileHeader.StartTimestamp) * MicrosecondsPerTick);
+                        Writer.Key("pid"); Writer.Uint(FileHeader.ProcessID);
+                        Writer.Key("tid"); Writer.Uint64(DroppedThreadID);
+                        Writer.EndObject();
+                    }
+                    break;
+                }
+                default:
+                {
+                    bValid = false;
+                    break;
+                }
+            }
+        }
+
+        if (!bValid)
+        {
+            RK_LOG_WARNING("Profiler capture {} contains a malformed chunk, the rest of it was skipped", TracePath);
+        }
+
+        ChunkCount++;
+    }
+
+    // Stack frames form a tree shared by all samples, each node is a function below its caller.
+    std::set<uint64_t> Addresses;
+    for (const SSample& Sample : Samples)
+    {
+        Addresses.insert(Sample.Frames.begin(), Sample.Frames.end());
+    }
+    const std::unordered_map<uint64_t, std::string> Symbols = Utils::SymbolizeAddresses(Modules, Addresses);
+
+    struct SStackFrame
+    {
+        uint64_t ParentID;
+        const std::string* Name;
+    };
+    std::vector<SStackFrame> StackFrames;
+    std::map<std::pair<uint64_t, const std::string*>, uint64_t> StackFrameIDs;
+
+    for (const SSample& Sample : Samples)
+    {
+        // IDs start at 1, 0 is the root
+        uint64_t StackFrameID = 0;
+        for (auto Iterator = Sample.Frames.rbegin(); Iterator != Sample.Frames.rend(); ++Iterator)
+        {
+            const std::string* Name = &Symbols.at(*Iterator);
+            auto [Node, bInserted] = StackFrameIDs.try_emplace({ StackFrameID, Name }, StackFrames.size() + 1);
+            if (bInserted)
+            {
+                StackFrames.push_back({ StackFrameID, Name });
+            }
+            StackFrameID = Node->second;
+        }
+
+        Writer.StartObject();
+        Writer.Key("name"); Writer.String("Sample");
+        Writer.Key("ph"); Writer.String("P");
+        Writer.Key("ts"); Writer.Double(static_cast<double>(Sample.Timestamp - FileHeader.StartTimestamp) * MicrosecondsPerTick);
+        Writer.Key("pid"); Writer.Uint(FileHeader.ProcessID);
+        Writer.Key("tid"); Writer.Uint64(Sample.ThreadID);
+        Writer.Key("sf"); Writer.Uint64(StackFrameID);
+        Writer.EndObject();
+    }
+
+    Writer.EndArray();
+
+    Writer.Key("stackFrames");
+    Writer.StartObject();
+    for (size_t Index = 0; Index < StackFrames.size(); ++Index)
+    {
+        Writer.Key(std::to_string(Index + 1).c_str());
+        Writer.StartObject();
+        Writer.Key("name"); Writer.String(StackFrames[Index].Name->c_str());
+        if (StackFrames[Index].ParentID != 0)
+        {
+            Writer.Key("parent"); Writer.Uint64(StackFrames[Index].ParentID);
+        }
+        Writer.EndObject();
+    }
+    Writer.EndObject();
+
+    Writer.Key("metadata");
+    Writer.StartObject();
+    for (const auto& [Key, Value] : Metadata)
+    {
+        Writer.Key(Key.c_str());
+        Writer.String(Value.c_str());
+    }
+    Writer.EndObject();
+
+    Writer.EndObject();
+    Output.close();
+
+    RK_LOG_INFO("Converted {} events and {} samples from {} chunks of {} into {}", EventCount, Samples.size(), ChunkCount, TracePath, OutputPath);
+    return true;
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct SProfilerEvent;
+struct SProfilerSample;
+struct SProfilerSourceLocation;
+
+// Binary capture format written by the profiler (.rktrace). A file header is followed by chunks of at most
+// ChunkSize payload bytes, each flushed to disk as a whole, so a crash only loses the chunk being written.
+// Live streams (see ProfilerStream.h) send the same bytes, a recorded stream is a valid capture.
+//
+// Payload records start with an ERecordType byte followed by LEB128 varints:
+//   Location  Id, NameLength, Name, FileLength, File, Line   defined once, before its first use
+//   Thread    ThreadID                                       following events belong to this thread
+//   Begin/End LocationId, DeltaTicks                         delta to the previous event of the thread
+//   Dropped   ThreadID, Count                                events lost because the thread's ring was full
+//   Counter   LocationId, DeltaTicks, Value                  sample of the counter track named by the location
+//   Metadata  KeyLength, Key, ValueLength, Value             free-form context of the capture (e.g. hitch dumps)
+//   Sample    DeltaTicks, FrameCount, Address...             sampled call stack of the thread, innermost first
+//   Module    Start, Size, Bias, PathLength, Path            executable segment used to symbolize sample addresses
+// Deltas restart from the file's StartTimestamp after every Thread record.
+namespace ProfilerTrace
+{
+    constexpr uint32_t Magic = 0x52544B52; // "RKTR"
+    constexpr uint32_t Version = 4;
+    constexpr size_t ChunkSize = 64 * 1024;
+
+    enum class ERecordType : uint8_t
+    {
+        Location,
+        Thread,
+        Begin,
+        End,
+        Dropped,
+        Counter,
+        Metadata,
+        Sample,
+        Module
+    };
+
+    struct SFileHeader
+    {
+        uint32_t Magic;
+        uint32_t Version;
+        uint64_t TicksPerSecond;
+        uint64_t StartTimestamp;
+        uint32_t ProcessID;
+        uint32_t Reserved;
+    };
+
+    struct SChunkHeader
+    {
+        uint32_t PayloadSize;
+        uint32_t Reserved;
+    };
+
+    inline void WriteVarint(std::vector<uint8_t>& Buffer, uint64_t Value)
+    {
+        while (Value >= 0x80)
+        {
+            Buffer.push_back(static_cast<uint8_t>(Value | 0x80));
+            Value >>= 7;
+        }
+        Buffer.push_back(static_cast<uint8_t>(Value));
+    }
+
+    inline bool ReadVarint(const uint8_t*& Cursor, const uint8_t* End, uint64_t& Value)
+    {
+        Value = 0;
+        for (uint32_t Shift = 0; Cursor < End && Shift < 64; Shift += 7)
+        {
+            const uint8_t Byte = *Cursor++;
+            Value |= static_cast<uint64_t>(Byte & 0x7F) << Shift;
+            if ((Byte & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Converts a capture into the Chrome trace event JSON format (chrome://tracing, ui.perfetto.dev).
+    // Sampled stacks are symbolized with addr2line against the recorded modules, so the conversion has to run
+    // on a machine with the same binaries. A truncated final chunk is skipped. Returns false if the capture could not be read.
+    bool ConvertToChromeJSON(const std::string& TracePath, const std::string& OutputPath);
+}
+
+// Encodes profiler events into chunks and appends them to a capture file or a stream. Not thread-safe, owned by the profiler.
+class PProfilerTraceWriter
+{
+public:
+    // Receives the file header and then every chunk as a whole. Returning false closes the writer.
+    using TSink = std::function<bool(const uint8_t* Data, size_t Size)>;
+
+    bool Open(const std::string& Path, uint64_t StartTimestamp, uint32_t ProcessID);
+    bool Open(TSink&& InSink, uint64_t StartTimestamp, uint32_t ProcessID);
+    void Close();
+
+    [[nodiscard]] bool IsOpen() const
+    {
+        return static_cast<bool>(Sink);
+    }
+
+    // Size of the chunk being encoded, not yet passed to the sink
+    [[nodiscard]] size_t GetPendingBytes() const
+    {
+        return Chunk.size();
+    }
+
+    void WriteEvent(uint32_t ThreadID, const SProfilerEvent& Event);
+    void WriteDroppedEvents(uint32_t ThreadID, uint64_t Count);
+    void WriteMetadata(const std::string& Key, const std::string& Value);
+    void WriteSample(uint32_t ThreadID, const SProfilerSample& Sample);
+    void WriteModule(uint64_t Start, uint64_t Size, uint64_t Bias, const char* Path);
+
+    // Writes the pending chunk, if any, and flushes the file.
+    void FlushChunk();
+
+    [[nodiscard]] uint64_t GetBytesWritten() const
+    {
+        return BytesWritten;
+    }
+
+private:
+    void BeginRecord(uint32_t ThreadID, size_t MaxRecordSize);
+
+    std::ofstream File;
+    TSink Sink;
+    uint64_t StartTimestamp = 0;
+    uint64_t BytesWritten = 0;
+
+    std::vector<uint8_t> Chunk;
+    std::unordered_map<const SProfilerSourceLocation*, uint32_t> LocationIDs;
+
+    // Valid until the chunk is flushed, every chunk restarts its thread sections
+    uint32_t CurrentThreadID = 0;
+    bool bThreadSectionOpen = false;
+    uint64_t PreviousTimestamp = 0;
+};
@@ -21,6 +21,27 @@ struct SWELL512
         State = 0;
     }
 
+    explicit SWELL512(uint32_t Seed)
+    {
+        SetSeed(Seed);
+    }
+
+    // Expands the seed into the full state with SplitMix64, so nearby seeds still produce unrelated sequences.
+    void SetSeed(uint32_t Seed)
+    {
+        uint64_t Value = Seed;
+        for (int32_t Index = 0; Index < 16; ++Index)
+        {
+            Value += 0x9E3779B97F4A7C15ull;
+            uint64_t Mixed = Value;
+            Mixed = (Mixed ^ (Mixed >> 30)) * 0xBF58476D1CE4E5B9ull;
+            Mixed = (Mixed ^ (Mixed >> 27)) * 0x94D049BB133111EBull;
+            StateArray[Index] = static_cast<uint32_t>(Mixed ^ (Mixed >> 31));
+        }
+
+        State = 0;
+    }
+
     uint32_t Generate()
     {
         uint32_t A, B, C, D;
@@ -54,64 +75,70 @@ private:
 
 struct SRandom
 {
+    // Reseeds the calling thread's generator, every value drawn afterwards on this thread is reproducible.
+    static void SetSeed(uint32_t Seed)
+    {
+        GetInstance().SetSeed(Seed);
+    }
+
     static int32_t GetInt32Value()
     {
-        thread_local SWELL512 Instance;
+        SWELL512& Instance = GetInstance();
         const int32_t Value = static_cast<int32_t>(Instance.Generate());
         return Value;
     }
 
     static int32_t GetInt32Value(int32_t Min, int32_t Max)
     {
-        thread_local SWELL512 Instance;
+        SWELL512& Instance = GetInstance();
         const double NormalizedValue = static_cast<double>(Instance.Generate()) / static_cast<double>(std::numeric_limits<uint32_t>::max());
         return Min + NormalizedValue * (Max - Min);
     }
 
     static uint32_t GetUInt32Value()
     {
-        thread_local SWELL512 Instance;
+        SWELL512& Instance = GetInstance();
         return Instance.Generate();
     }
 
     static uint32_t GetUInt32Value(uint32_t Min, uint32_t Max)
     {
-        thread_local SWELL512 Instance;
+        SWELL512& Instance = GetInstance();
         const double NormalizedValue = static_cast<double>(Instance.Generate()) / static_cast<double>(std::numeric_limits<uint32_t>::max());
         return Min + NormalizedValue * (Max - Min);
     }
 
     static float GetFloatValue()
     {
-        thread_local SWELL512 Instance;
+        SWELL512& Instance = GetInstance();
         const double NormalizedValue = static_cast<double>(Instance.Generate()) / static_cast<double>(std::numeric_limits<uint32_t>::max());
         return FLOAT_VALUE_MIN + NormalizedValue * (FLOAT_VALUE_MAX - FLOAT_VALUE_MIN);
     }
 
     static float GetFloatValue(float Min, float Max)
     {
-        thread_local SWELL512 Instance;
+        SWELL512& Instance = GetInstance();
         const double NormalizedValue = static_cast<double>(Instance.Generate()) / static_cast<double>(std::numeric_limits<uint32_t>::max());
         return Min + NormalizedValue * (Max - Min);
     }
 
     static double GetDoubleValue()
     {
-        thread_local SWELL512 Instance;
+        SWELL512& Instance = GetInstance();
         const double NormalizedValue = static_cast<double>(Instance.Generate()) / static_cast<double>(std::numeric_limits<uint32_t>::max());
         return DOUBLE_VALUE_MIN + NormalizedValue * (DOUBLE_VALUE_MAX - DOUBLE_VALUE_MIN);
     }
 
     static double GetDoubleValue(double Min, double Max)
     {
-        thread_local SWELL512 Instance;
+        SWELL512& Instance = GetInstance();
         const double NormalizedValue = static_cast<double>(Instance.Generate()) / static_cast<double>(std::numeric_limits<uint32_t>::max());
         return Min + NormalizedValue * (Max - Min);
     }
 
     static uint64_t GetUInt64Value()
     {
-        thread_local SWELL512 Instance;
+        SWELL512& Instance = GetInstance();
         uint64_t Low = static_cast<uint64_t>(Instance.Generate());
         uint64_t High = static_cast<uint64_t>(Instance.Generate());
         return (High << 32) | Low;
@@ -119,7 +146,7 @@ struct SRandom
 
     static uint64_t GetUInt64Value(uint64_t Min, uint64_t Max)
     {
-        thread_local SWELL512 Instance;
+        SWELL512& Instance = GetInstance();
         uint64_t Low = static_cast<uint64_t>(Instance.Generate());
         uint64_t High = static_cast<uint64_t>(Instance.Generate());
         uint64_t Value = (High << 32) | Low;
@@ -129,7 +156,7 @@ struct SRandom
 
     static int64_t GetInt64Value()
     {
-        thread_local SWELL512 Instance;
+        SWELL512& Instance = GetInstance();
         uint64_t Low = static_cast<uint64_t>(Instance.Generate());
         uint64_t High = static_cast<uint64_t>(Instance.Generate());
         return static_cast<int64_t>((High << 32) | Low);
@@ -137,11 +164,19 @@ struct SRandom
 
     static int64_t GetInt64Value(int64_t Min, int64_t Max)
     {
-        thread_local SWELL512 Instance;
+        SWELL512& Instance = GetInstance();
         int64_t Low = static_cast<int64_t>(Instance.Generate());
         int64_t High = static_cast<int64_t>(Instance.Generate());
         int64_t Value = (High << 32) | Low;
         double NormalizedValue = static_cast<double>(Value) / static_cast<double>(std::numeric_limits<uint64_t>::max());
         return Min + static_cast<int64_t>(NormalizedValue * (Max - Min));
     }
+
+private:
+    // Shared by all functions on a thread, so seeding affects every distribution.
+    static SWELL512& GetInstance()
+    {
+        thread_local SWELL512 Instance;
+        return Instance;
+    }
 };
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+struct SSampleStatistics
+{
+    size_t Count = 0;
+
+    double Min = 0.0;
+    double Max = 0.0;
+    double Mean = 0.0;
+    double StandardDeviation = 0.0;
+
+    double P50 = 0.0;
+    double P95 = 0.0;
+    double P99 = 0.0;
+};
+
+namespace Statistics
+{
+    // Nearest-rank percentile (https://en.wikipedia.org/wiki/Percentile#The_nearest-rank_method), expects sorted samples.
+    inline double Percentile(const std::vector<double>& SortedSamples, double Percent)
+    {
+        if (SortedSamples.empty())
+        {
+            return 0.0;
+        }
+
+        const size_t Rank = static_cast<size_t>(std::ceil(Percent / 100.0 * static_cast<double>(SortedSamples.size())));
+        return SortedSamples[std::clamp<size_t>(Rank, 1, SortedSamples.size()) - 1];
+    }
+
+    inline SSampleStatistics Summarize(std::vector<double> Samples)
+    {
+        SSampleStatistics Result;
+        if (Samples.empty())
+        {
+            return Result;
+        }
+
+        std::sort(Samples.begin(), Samples.end());
+
+        double Sum = 0.0;
+        for (double Sample : Samples)
+        {
+            Sum += Sample;
+        }
+
+        Result.Count = Samples.size();
+        Result.Min = Samples.front();
+        Result.Max = Samples.back();
+        Result.Mean = Sum / static_cast<double>(Samples.size());
+
+        double Variance = 0.0;
+        for (double Sample : Samples)
+        {
+            Variance += (Sample - Result.Mean) * (Sample - Result.Mean);
+        }
+        Result.StandardDeviation = std::sqrt(Variance / static_cast<double>(Samples.size()));
+
+        Result.P50 = Percentile(Samples, 50.0);
+        Result.P95 = Percentile(Samples, 95.0);
+        Result.P99 = Percentile(Samples, 99.0);
+
+        return Result;
+    }
+
+    // Writes a summary as a JSON object, TWriter is any rapidjson writer.
+    template<typename TWriter>
+    void WriteJSON(TWriter& Writer, const std::vector<double>& Samples)
+    {
+        const SSampleStatistics Summary = Summarize(Samples);
+
+        Writer.StartObject();
+        Writer.Key("Samples"); Writer.Uint64(Summary.Count);
+        Writer.Key("Min"); Writer.Double(Summary.Min);
+        Writer.Key("Mean"); Writer.Double(Summary.Mean);
+        Writer.Key("StdDev"); Writer.Double(Summary.StandardDeviation);
+        Writer.Key("P50"); Writer.Double(Summary.P50);
+        Writer.Key("P95"); Writer.Double(Summary.P95);
+        Writer.Key("P99"); Writer.Double(Summary.P99);
+        Writer.Key("Max"); Writer.Double(Summary.Max);
+        Writer.EndObject();
+    }
+}
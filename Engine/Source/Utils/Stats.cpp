@@ -0,0 +1,129 @@
+#include "EnginePCH.h"
+#include "Stats.h"
+
+#include <fstream>
+#include <mutex>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+#include "Utils/Profiler.h"
+
+// Blocks are registered once per thread and never freed, counters of exited threads are still drained.
+static std::mutex ThreadBlockMutex;
+static std::vector<SStatsThreadBlock*> ThreadBlocks;
+
+static SStatsFrame LastFrame;
+
+// Running aggregates rather than samples, so long runs do not grow the summary.
+static uint64_t FrameCount = 0;
+static std::array<uint64_t, StatCount> Totals = {};
+static std::array<uint64_t, StatCount> Minimums = {};
+static std::array<uint64_t, StatCount> Maximums = {};
+
+#ifdef RK_PROFILE
+// Counter tracks of the stats, resolved on the first EndFrame since resolving a name takes the profiler's lock.
+static std::array<const SProfilerSourceLocation*, StatCount> CounterLocations = {};
+#endif
+
+const char* GetStatName(EStat Stat)
+{
+    switch (Stat)
+    {
+        case EStat::DrawCalls: return "DrawCalls";
+        case EStat::Triangles: return "Triangles";
+        case EStat::PipelineBinds: return "PipelineBinds";
+        case EStat::DescriptorSetBinds: return "DescriptorSetBinds";
+        case EStat::StorageBufferBytes: return "StorageBufferBytes";
+        case EStat::UniformBufferBytes: return "UniformBufferBytes";
+        case EStat::StagingBufferBytes: return "StagingBufferBytes";
+        case EStat::ImmediateSubmits: return "ImmediateSubmits";
+        case EStat::CullSubmittedObjects: return "CullSubmittedObjects";
+        case EStat::CullVisibleObjects: return "CullVisibleObjects";
+        case EStat::OccluderTriangles: return "OccluderTriangles";
+        case EStat::OccludedObjects: return "OccludedObjects";
+        case EStat::LODSelectedObjects: return "LODSelectedObjects";
+        case EStat::LODTransitions: return "LODTransitions";
+        case EStat::LODCulledObjects: return "LODCulledObjects";
+        default: return "Unknown";
+    }
+}
+
+SStatsThreadBlock* PStats::RegisterThread()
+{
+    SStatsThreadBlock* Block = new SStatsThreadBlock();
+
+    std::lock_guard<std::mutex> Lock(ThreadBlockMutex);
+    ThreadBlocks.push_back(Block);
+
+    ThreadBlock = Block;
+    return Block;
+}
+
+void PStats::EndFrame()
+{
+    LastFrame = {};
+    {
+        std::lock_guard<std::mutex> Lock(ThreadBlockMutex);
+        for (SStatsThreadBlock* Block : ThreadBlocks)
+        {
+            for (size_t Index = 0; Index < StatCount; ++Index)
+            {
+                LastFrame.Values[Index] += Block->Values[Index].exchange(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    for (size_t Index = 0; Index < StatCount; ++Index)
+    {
+        const uint64_t Value = LastFrame.Values[Index];
+        Totals[Index] += Value;
+        Minimums[Index] = FrameCount == 0 ? Value : std::min(Minimums[Index], Value);
+        Maximums[Index] = std::max(Maximums[Index], Value);
+
+#ifdef RK_PROFILE
+        if (!CounterLocations[Index])
+        {
+            CounterLocations[Index] = PProfiler::GetNamedSourceLocation(GetStatName(static_cast<EStat>(Index)), "Counter");
+        }
+        PProfiler::RecordCounter(CounterLocations[Index], Value);
+#endif
+    }
+
+    FrameCount++;
+}
+
+const SStatsFrame& PStats::GetLastFrame()
+{
+    return LastFrame;
+}
+
+void PStats::WriteSummary(const std::string& Path)
+{
+    rapidjson::StringBuffer Buffer;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> Writer(Buffer);
+
+    Writer.StartObject();
+    Writer.Key("Frames"); Writer.Uint64(FrameCount);
+    Writer.Key("Counters");
+    Writer.StartObject();
+
+    for (size_t Index = 0; Index < StatCount; ++Index)
+    {
+        Writer.Key(GetStatName(static_cast<EStat>(Index)));
+        Writer.StartObject();
+        Writer.Key("Total"); Writer.Uint64(Totals[Index]);
+        Writer.Key("Mean"); Writer.Double(FrameCount > 0 ? static_cast<double>(Totals[Index]) / static_cast<double>(FrameCount) : 0.0);
+        Writer.Key("Min"); Writer.Uint64(Minimums[Index]);
+        Writer.Key("Max"); Writer.Uint64(Maximums[Index]);
+        Writer.EndObject();
+    }
+
+    Writer.EndObject();
+    Writer.EndObject();
+
+    std::ofstream File(Path);
+    File << Buffer.GetString();
+    File.close();
+
+    RK_LOG_INFO("Stats summary of {} frames written to {}", FrameCount, Path);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+enum class EStat : uint8_t
+{
+    DrawCalls,
+    Triangles,
+    PipelineBinds,
+    DescriptorSetBinds,
+    StorageBufferBytes,
+    UniformBufferBytes,
+    StagingBufferBytes,
+    ImmediateSubmits,
+    CullSubmittedObjects,
+    CullVisibleObjects,
+    OccluderTriangles,
+    OccludedObjects,
+    LODSelectedObjects,
+    LODTransitions,
+    LODCulledObjects,
+    Count
+};
+
+constexpr size_t StatCount = static_cast<size_t>(EStat::Count);
+
+const char* GetStatName(EStat Stat);
+
+// Counters of one thread, written by the owning thread and drained by PStats::EndFrame.
+struct alignas(64) SStatsThreadBlock
+{
+    std::array<std::atomic<uint64_t>, StatCount> Values = {};
+};
+
+struct SStatsFrame
+{
+    std::array<uint64_t, StatCount> Values = {};
+
+    uint64_t operator[](EStat Stat) const
+    {
+        return Values[static_cast<size_t>(Stat)];
+    }
+};
+
+// Per-frame engine counters. Any thread may add to a counter, the main thread aggregates them once per frame.
+class PStats
+{
+public:
+    static void Add(EStat Stat, uint64_t Value = 1)
+    {
+        SStatsThreadBlock* Block = ThreadBlock ? ThreadBlock : RegisterThread();
+
+        // Uncontended, the block's cache line is only shared with EndFrame.
+        Block->Values[static_cast<size_t>(Stat)].fetch_add(Value, std::memory_order_relaxed);
+    }
+
+    // Sums and resets the counters of every thread into the last frame, updates the per-run summary and
+    // emits the values as counter tracks of the profiler capture.
+    static void EndFrame();
+
+    // Counters of the frame most recently ended by EndFrame.
+    static const SStatsFrame& GetLastFrame();
+
+    // Writes total, mean, min and max per frame of every counter over the run to Path as JSON.
+    static void WriteSummary(const std::string& Path);
+
+private:
+    static SStatsThreadBlock* RegisterThread();
+
+    static inline thread_local SStatsThreadBlock* ThreadBlock = nullptr;
+};
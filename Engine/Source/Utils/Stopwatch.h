@@ -1,38 +1,33 @@
 #pragma once
 
 #include "Core/Logger.h"
-#include <chrono>
-#include <iostream>
+#include "Utils/TickClock.h"
 
 #define STOPWATCH(DebugName) SStopwatch Stopwatch(DebugName)
 
 class SStopwatch
 {
 public:
-    using Clock = std::chrono::high_resolution_clock;
-    using TimePoint = std::chrono::time_point<Clock>;
-
     explicit SStopwatch(const char* InDebugName)
-        : StartTime(Clock::now()), DebugName(InDebugName)
+        : StartTime(PTickClock::Now()), DebugName(InDebugName)
     {
     }
 
     ~SStopwatch()
     {
-        const auto EndTime = Clock::now();
-        const auto Elapsed = EndTime - StartTime;
+        const uint64_t Elapsed = PTickClock::TicksToNanoseconds(PTickClock::Now() - StartTime);
 
         // Total time in seconds, milliseconds, and nanoseconds
-        const long DurationS = std::chrono::duration_cast<std::chrono::seconds>(Elapsed).count();
-        const long DurationMS = std::chrono::duration_cast<std::chrono::milliseconds>(Elapsed).count() % 1000;  // Remaining milliseconds after seconds
-        const long DurationNS = std::chrono::duration_cast<std::chrono::nanoseconds>(Elapsed).count() % 1000000; // Remaining nanoseconds after milliseconds
+        const uint64_t DurationS = Elapsed / 1000000000;
+        const uint64_t DurationMS = Elapsed / 1000000 % 1000;  // Remaining milliseconds after seconds
+        const uint64_t DurationNS = Elapsed % 1000000; // Remaining nanoseconds after milliseconds
 
         // Log the properly formatted duration
         RK_LOG_TRACE("({}) Elapsed time: {}s:{}ms:{}ns", DebugName, DurationS, DurationMS, DurationNS);    
     }
 
 private:
-    TimePoint StartTime;
+    uint64_t StartTime;
 
     const char* DebugName;
 };
\ No newline at end of file
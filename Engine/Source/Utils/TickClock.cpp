@@ -0,0 +1,71 @@
+#include "EnginePCH.h"
+#include "TickClock.h"
+
+#if RK_TICK_CLOCK_TSC && !defined(_MSC_VER)
+    #include <cpuid.h>
+#endif
+
+namespace Utils
+{
+    // Read latency over this window bounds the rate error to a few ppm, short enough not to be noticed at start-up
+    static constexpr std::chrono::milliseconds CalibrationDuration = std::chrono::milliseconds(20);
+
+    static bool HasInvariantTSC()
+    {
+#if RK_TICK_CLOCK_TSC
+        // CPUID.80000007H:EDX[8]
+    #ifdef _MSC_VER
+        int Registers[4] = {};
+        __cpuid(Registers, 0x80000000);
+        if (static_cast<uint32_t>(Registers[0]) < 0x80000007)
+        {
+            return false;
+        }
+        __cpuid(Registers, 0x80000007);
+        return (Registers[3] & (1 << 8)) != 0;
+    #else
+        unsigned int Eax = 0, Ebx = 0, Ecx = 0, Edx = 0;
+        if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007 || !__get_cpuid(0x80000007, &Eax, &Ebx, &Ecx, &Edx))
+        {
+            return false;
+        }
+        return (Edx & (1 << 8)) != 0;
+    #endif
+#else
+        return false;
+#endif
+    }
+}
+
+STickClockCalibration PTickClock::Calibrate()
+{
+    STickClockCalibration Calibration;
+    Calibration.TicksPerSecond = 1000000000ull;
+
+#if RK_TICK_CLOCK_TSC
+    if (!Utils::HasInvariantTSC())
+    {
+        return Calibration;
+    }
+
+    // Reads are taken back to back, their skew is a single read latency against the whole window.
+    const auto SteadyStart = std::chrono::steady_clock::now();
+    const uint64_t TSCStart = __rdtsc();
+
+    std::this_thread::sleep_for(Utils::CalibrationDuration);
+
+    const auto SteadyEnd = std::chrono::steady_clock::now();
+    const uint64_t TSCEnd = __rdtsc();
+
+    const double Seconds = std::chrono::duration<double>(SteadyEnd - SteadyStart).count();
+    if (Seconds <= 0.0 || TSCEnd <= TSCStart)
+    {
+        return Calibration;
+    }
+
+    Calibration.bInvariantTSC = true;
+    Calibration.TicksPerSecond = static_cast<uint64_t>(static_cast<double>(TSCEnd - TSCStart) / Seconds);
+#endif
+
+    return Calibration;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define RK_TICK_CLOCK_TSC 1
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #else
+        #include <x86intrin.h>
+    #endif
+#else
+    #define RK_TICK_CLOCK_TSC 0
+#endif
+
+struct STickClockCalibration
+{
+    // Set when the CPU reports an invariant TSC, which ticks at a constant rate across cores and power states
+    bool bInvariantTSC = false;
+    uint64_t TicksPerSecond = 0;
+};
+
+// Monotonic 64-bit tick clock shared by the timers and the profiler. Reads the invariant TSC where available,
+// calibrated once against the steady clock (CLOCK_MONOTONIC on Linux), and falls back to steady clock nanoseconds.
+// Ticks only compare within one process, convert them with the helpers below.
+class PTickClock
+{
+public:
+    static uint64_t Now()
+    {
+#if RK_TICK_CLOCK_TSC
+        if (GetCalibration().bInvariantTSC)
+        {
+            return __rdtsc();
+        }
+#endif
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    static uint64_t GetTicksPerSecond()
+    {
+        return GetCalibration().TicksPerSecond;
+    }
+
+    static bool IsInvariantTSC()
+    {
+        return GetCalibration().bInvariantTSC;
+    }
+
+    static double TicksToSeconds(uint64_t Ticks)
+    {
+        return static_cast<double>(Ticks) / static_cast<double>(GetTicksPerSecond());
+    }
+
+    static double TicksToMilliseconds(uint64_t Ticks)
+    {
+        return TicksToSeconds(Ticks) * 1e3;
+    }
+
+    // Exact for any uptime, splitting off whole seconds keeps the product from overflowing.
+    static uint64_t TicksToNanoseconds(uint64_t Ticks)
+    {
+        const uint64_t TicksPerSecond = GetTicksPerSecond();
+        return Ticks / TicksPerSecond * 1000000000ull + Ticks % TicksPerSecond * 1000000000ull / TicksPerSecond;
+    }
+
+    static uint64_t SecondsToTicks(double Seconds)
+    {
+        return static_cast<uint64_t>(Seconds * static_cast<double>(GetTicksPerSecond()));
+    }
+
+private:
+    // Calibrated on first use, which static initialization of the profiler guarantees happens at start-up.
+    static const STickClockCalibration& GetCalibration()
+    {
+        static const STickClockCalibration Calibration = Calibrate();
+        return Calibration;
+    }
+
+    static STickClockCalibration Calibrate();
+};
@@ -1,63 +1,76 @@
 #pragma once
 
-#include <chrono>
+#include <cstdint>
 
-using SClock = std::chrono::high_resolution_clock;
-using STimePoint = std::chrono::time_point<SClock>;
-using SDuration = std::chrono::duration<float>;
+#include "Utils/TickClock.h"
 
 struct STimer
 {
-	STimePoint Start;
+	uint64_t Start;
 
 	STimer()
 	{
-		Start = SClock::now();
+		Start = PTickClock::Now();
 	}
 
-	inline float GetElapsedTimeAsSeconds() const
+	inline uint64_t GetElapsedTicks() const
 	{
-		return std::chrono::duration<float>(SClock::now() - Start).count();
+		return PTickClock::Now() - Start;
 	}
 
-	inline float GetElapsedTimeAsMilliseconds() const
+	inline double GetElapsedTimeAsSeconds() const
+	{
+		return PTickClock::TicksToSeconds(GetElapsedTicks());
+	}
+
+	inline double GetElapsedTimeAsMilliseconds() const
     {
         return GetElapsedTimeAsSeconds() * 1e3;
     }
 
-	inline float GetElapsedTimeAsMicroseconds() const
+	inline double GetElapsedTimeAsMicroseconds() const
     {
         return GetElapsedTimeAsSeconds() * 1e6;
     }
 
-    inline long long GetElapsedTimeAsNanoseconds() const
+    inline uint64_t GetElapsedTimeAsNanoseconds() const
     {
-        return GetElapsedTimeAsSeconds() * 1e9;
+        return PTickClock::TicksToNanoseconds(GetElapsedTicks());
     }
 };
 
 struct STimestep
 {
-	STimer Time;
-	STimePoint Current;
-	SDuration DeltaTime;
+	uint64_t Current;
+	float DeltaTime;
+
+	// Overrides the measured delta time when greater than zero (e.g. deterministic benchmark runs).
+	float FixedDeltaTime;
 
 	STimestep()
 	{
-		DeltaTime = SDuration(0);
+		Current = PTickClock::Now();
+		DeltaTime = 0.0f;
+		FixedDeltaTime = 0.0f;
 	}
 
 	void Reset()
 	{
-		STimePoint PreviousTime = SClock::now();
+		const uint64_t Now = PTickClock::Now();
 
-		DeltaTime = PreviousTime - Current;
+		// Converted from the tick difference, the delta stays exact however long the engine has been running.
+		DeltaTime = FixedDeltaTime > 0.0f ? FixedDeltaTime : static_cast<float>(PTickClock::TicksToSeconds(Now - Current));
 
-		Current = PreviousTime;
+		Current = Now;
+	}
+
+	inline void SetFixedDeltaTime(float Seconds)
+	{
+		FixedDeltaTime = Seconds;
 	}
 
 	inline float GetDeltaTime() const
 	{
-		return DeltaTime.count();
+		return DeltaTime;
 	}
-};
\ No newline at end of file
+};
@@ -0,0 +1,20 @@
+#include "Core/Logger.h"
+#include "Utils/ProfilerTrace.h"
+
+// Converts a binary profiler capture (.rktrace) into Chrome trace event JSON for chrome://tracing or ui.perfetto.dev.
+// Usage: TraceConverter <Capture> [Output], the output defaults to the capture path with a .json extension.
+int main(int argc, char** argv)
+{
+    PLogger::Init();
+
+    if (argc < 2)
+    {
+        RK_LOG_ERROR("Usage: TraceConverter <Capture> [Output]");
+        return 1;
+    }
+
+    const std::string TracePath = argv[1];
+    const std::string OutputPath = argc > 2 ? argv[2] : std::filesystem::path(TracePath).replace_extension(".json").string();
+
+    return ProfilerTrace::ConvertToChromeJSON(TracePath, OutputPath) ? 0 : 1;
+}
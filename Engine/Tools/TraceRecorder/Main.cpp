@@ -0,0 +1,86 @@
+#include "Core/Logger.h"
+
+#include <csignal>
+#include <fstream>
+
+#ifdef RK_PLATFORM_LINUX
+    #include <sys/socket.h>
+    #include <sys/un.h>
+#endif
+
+static volatile std::sig_atomic_t bInterrupted = 0;
+
+// Attaches to an engine started with --profile-stream <Socket> and records the live stream into a capture (.rktrace),
+// which TraceConverter turns into Chrome trace JSON. Recording stops when the engine exits or on Ctrl+C.
+// Usage: TraceRecorder <Socket> [Output], the output defaults to stream.rktrace.
+int main(int argc, char** argv)
+{
+    PLogger::Init();
+
+    if (argc < 2)
+    {
+        RK_LOG_ERROR("Usage: TraceRecorder <Socket> [Output]");
+        return 1;
+    }
+
+#ifdef RK_PLATFORM_LINUX
+    const std::string SocketPath = argv[1];
+    const std::string OutputPath = argc > 2 ? argv[2] : "stream.rktrace";
+
+    sockaddr_un Address = {};
+    Address.sun_family = AF_UNIX;
+    if (SocketPath.size() >= sizeof(Address.sun_path))
+    {
+        RK_LOG_ERROR("Socket path {} is too long", SocketPath);
+        return 1;
+    }
+    std::memcpy(Address.sun_path, SocketPath.c_str(), SocketPath.size());
+
+    const int Socket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (Socket < 0 || connect(Socket, reinterpret_cast<const sockaddr*>(&Address), sizeof(Address)) != 0)
+    {
+        RK_LOG_ERROR("Failed to attach to {}: {}", SocketPath, std::strerror(errno));
+        return 1;
+    }
+
+    std::ofstream Output(OutputPath, std::ios::binary | std::ios::trunc);
+    if (!Output.is_open())
+    {
+        RK_LOG_ERROR("Failed to open {}", OutputPath);
+        close(Socket);
+        return 1;
+    }
+
+    // Without SA_RESTART, so Ctrl+C interrupts the blocking recv
+    struct sigaction SignalAction = {};
+    SignalAction.sa_handler = [](int) { bInterrupted = 1; };
+    sigemptyset(&SignalAction.sa_mask);
+    sigaction(SIGINT, &SignalAction, nullptr);
+
+    RK_LOG_INFO("Recording {} to {}, press Ctrl+C to stop", SocketPath, OutputPath);
+
+    uint64_t BytesReceived = 0;
+    char Buffer[64 * 1024];
+    while (!bInterrupted)
+    {
+        const ssize_t Received = recv(Socket, Buffer, sizeof(Buffer), 0);
+        if (Received <= 0)
+        {
+            break;
+        }
+
+        Output.write(Buffer, Received);
+        BytesReceived += static_cast<uint64_t>(Received);
+    }
+
+    close(Socket);
+    Output.close();
+
+    // A chunk cut off by the detach is skipped by the converter.
+    RK_LOG_INFO("Recorded {} KiB to {}", BytesReceived / 1024, OutputPath);
+    return 0;
+#else
+    RK_LOG_ERROR("Profiler streaming is not supported on this platform");
+    return 1;
+#endif
+}